@@ -0,0 +1,138 @@
+/*------------------------------------------------------------------------------
+* BucketUtil.cpp : bandwidth budget shared by the processes (file-backed token bucket)
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "BucketUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define BUCKETFILE ".good_bucket"    /* name of the bucket files, followed by the budget class */
+#define BURSTSECS  5.0               /* depth of the bucket in seconds of the budget */
+#define MAXWAIT    5.0               /* maximum sleep (s) before the bucket is checked again */
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* wall-clock time in seconds, shared by the processes */
+static double WallTime()
+{
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Update - refill a bucket by the time passed and take some tokens from it
+* @param[I]: tag (budget class of the bucket, i.e., 'inter' or 'back')
+* @param[I]: rate (budget in KB/s)
+* @param[I]: cost (tokens to be taken in KB, 0: only refill)
+* @param[O]: balance (tokens left in KB, negative if the bucket is in debt)
+* @return  : true:ok, false:error (the budget is not enforced)
+* @note    : the bucket file is read and written under its lock, as it is shared by all the processes
+**/
+bool BucketUtil::Update(const string &tag, int rate, double cost, double &balance)
+{
+    string file = (_dir.empty() ? string(BUCKETFILE) : _dir + FILEPATHSEP + BUCKETFILE) + "." + tag;
+    string lockFile = file + ".lock";
+    LockUtil lock;
+    if (!lock.Lock(lockFile, true)) return false;
+
+    /* one line: balance(KB)  time(s), a new bucket is full */
+    double depth = rate * BURSTSECS, now = WallTime(), t = now;
+    balance = depth;
+    StringUtil str;
+    std::vector<string> lines;
+    if (str.ReadLines(file, lines) && !lines.empty())
+    {
+        istringstream iss(lines[0]);
+        if (!(iss >> balance >> t))
+        {
+            balance = depth;
+            t = now;
+        }
+    }
+    if (t > now) t = now;
+    balance += rate * (now - t);
+    if (balance > depth) balance = depth;
+    balance -= cost;
+
+    ostringstream outFile;
+    outFile << "# balance(KB)  time(s)" << endl;
+    outFile << fixed << setprecision(3) << balance << "  " << now << endl;
+    if (!str.WriteFile(file, outFile.str()))
+    {
+        cerr << "*** ERROR(BucketUtil::Update): write bucket file " << file << " FAILED!" << endl;
+
+        return false;
+    }
+
+    return true;
+} /* end of Update */
+
+/**
+* @brief   : Open - set the directory of the bucket files
+* @param[I]: dir (the directory where the bucket files are stored, "" for current directory)
+* @param[O]: none
+* @return  : none
+* @note    : the bucket of each budget class is stored in the hidden file '.good_bucket.<tag>' of the directory
+**/
+void BucketUtil::Open(const string &dir)
+{
+    _dir = dir;
+} /* end of Open */
+
+/**
+* @brief   : Take - wait until the bucket of a budget class is out of debt
+* @param[I]: tag (budget class of the bucket, i.e., 'inter' or 'back')
+* @param[I]: rate (budget in KB/s, 0: unlimited)
+* @param[O]: none
+* @return  : the time waited in seconds
+* @note    : the bytes of a batch are known only after it, so they are charged by 'Charge' and the next
+*            batch of any process waits here until the bucket has been refilled
+**/
+double BucketUtil::Take(const string &tag, int rate)
+{
+    if (rate <= 0) return 0.0;
+
+    double t0 = WallTime(), balance = 0.0;
+    bool waited = false;
+    while (Update(tag, rate, 0.0, balance) && balance < 0.0)
+    {
+        if (!waited)
+        {
+            cout << "*** INFO(BucketUtil::Take): the bandwidth budget '" << tag << "' is used up, waiting " <<
+                fixed << setprecision(1) << -balance / rate << " s" << endl;
+            waited = true;
+        }
+        double secs = -balance / rate;
+        std::this_thread::sleep_for(std::chrono::duration<double>(secs < MAXWAIT ? secs : MAXWAIT));
+    }
+
+    return WallTime() - t0;
+} /* end of Take */
+
+/**
+* @brief   : Charge - take the bytes downloaded by a batch from the bucket of a budget class
+* @param[I]: tag (budget class of the bucket, i.e., 'inter' or 'back')
+* @param[I]: rate (budget in KB/s, 0: unlimited)
+* @param[I]: bytes (bytes downloaded)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void BucketUtil::Charge(const string &tag, int rate, long long bytes)
+{
+    if (rate <= 0 || bytes <= 0) return;
+
+    double balance;
+    Update(tag, rate, bytes / 1024.0, balance);
+} /* end of Charge */
\ No newline at end of file
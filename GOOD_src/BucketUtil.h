@@ -0,0 +1,62 @@
+/*------------------------------------------------------------------------------
+* BucketUtil.h : header file of BucketUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class BucketUtil
+{
+private:
+    string _dir;                                    /* the directory where the bucket files are stored */
+
+    /**
+    * @brief   : Update - refill a bucket by the time passed and take some tokens from it
+    * @param[I]: tag (budget class of the bucket, i.e., 'inter' or 'back')
+    * @param[I]: rate (budget in KB/s)
+    * @param[I]: cost (tokens to be taken in KB, 0: only refill)
+    * @param[O]: balance (tokens left in KB, negative if the bucket is in debt)
+    * @return  : true:ok, false:error (the budget is not enforced)
+    * @note    : the bucket file is read and written under its lock, as it is shared by all the processes
+    **/
+    bool Update(const string &tag, int rate, double cost, double &balance);
+
+public:
+    BucketUtil()
+	{
+
+	}
+	~BucketUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Open - set the directory of the bucket files
+    * @param[I]: dir (the directory where the bucket files are stored, "" for current directory)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the bucket of each budget class is stored in the hidden file '.good_bucket.<tag>' of the directory
+    **/
+    void Open(const string &dir);
+
+    /**
+    * @brief   : Take - wait until the bucket of a budget class is out of debt
+    * @param[I]: tag (budget class of the bucket, i.e., 'inter' or 'back')
+    * @param[I]: rate (budget in KB/s, 0: unlimited)
+    * @param[O]: none
+    * @return  : the time waited in seconds
+    * @note    : the bytes of a batch are known only after it, so they are charged by 'Charge' and the next
+    *            batch of any process waits here until the bucket has been refilled
+    **/
+    double Take(const string &tag, int rate);
+
+    /**
+    * @brief   : Charge - take the bytes downloaded by a batch from the bucket of a budget class
+    * @param[I]: tag (budget class of the bucket, i.e., 'inter' or 'back')
+    * @param[I]: rate (budget in KB/s, 0: unlimited)
+    * @param[I]: bytes (bytes downloaded)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Charge(const string &tag, int rate, long long bytes);
+};
\ No newline at end of file
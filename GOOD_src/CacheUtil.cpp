@@ -0,0 +1,159 @@
+/*------------------------------------------------------------------------------
+* CacheUtil.cpp : negative cache of the files that are not yet available on the archive
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "CacheUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define MISSFILE   ".good_missing"   /* name of the negative cache file in each directory */
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Read - read the entries of the negative cache file
+* @param[I]: none
+* @param[O]: none
+* @return  : true:ok, false:the file does not exist
+* @note    :
+**/
+bool CacheUtil::Read()
+{
+    StringUtil str;
+    std::vector<string> lines;
+    if (!str.ReadLines(_file, lines)) return false;
+
+    /* one entry per line: local-name  expire-mjd  expire-sod  count */
+    for (const string &line : lines)
+    {
+        istringstream iss(line);
+        missent_t ent;
+        if (!(iss >> ent.name >> ent.expire.mjd >> ent.expire.sod >> ent.count)) continue;
+        _ents[ent.name] = ent;
+    }
+
+    return true;
+} /* end of Read */
+
+/**
+* @brief   : Load - load the negative cache of a directory
+* @param[I]: dir (the directory where the files are stored)
+* @param[O]: none
+* @return  : true:ok, false:the cache does not exist (an empty cache is used)
+* @note    : the cache is stored in the hidden file '.good_missing' of the directory
+**/
+bool CacheUtil::Load(const string &dir)
+{
+    _ents.clear();
+    _chg.clear();
+    _file = dir + FILEPATHSEP + MISSFILE;
+
+    return Read();
+} /* end of Load */
+
+/**
+* @brief   : Save - save the negative cache to the file it was loaded from
+* @param[I]: none
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the file is read again under its lock ('.good_missing.lock') and only the entries updated or
+*            removed by this process change the ones on disk
+**/
+bool CacheUtil::Save()
+{
+    if (_file.empty()) return false;
+    if (_chg.empty()) return true;
+
+    LockUtil lock;
+    auto merge = [this, &lock]() { lock.Overlay(_ents, _chg, [this]() { Read(); }); };
+    auto text = [this]() {
+        /* an empty cache is not kept on disk */
+        if (_ents.empty()) return string();
+
+        ostringstream missFile;
+        missFile << "# local-name  expire-mjd  expire-sod  count" << endl;
+        for (auto &it : _ents)
+        {
+            const missent_t &ent = it.second;
+            missFile << ent.name << "  " << ent.expire.mjd << "  " << fixed << setprecision(0) <<
+                ent.expire.sod << "  " << ent.count << endl;
+        }
+
+        return missFile.str();
+    };
+    if (!lock.SaveTable(_file, merge, text))
+    {
+        cerr << "*** ERROR(CacheUtil::Save): write negative cache file " << _file << " FAILED!" << endl;
+
+        return false;
+    }
+
+    return true;
+} /* end of Save */
+
+/**
+* @brief   : Dir - get the directory of the loaded negative cache
+* @param[I]: none
+* @param[O]: none
+* @return  : the directory, "" if nothing has been loaded
+* @note    :
+**/
+string CacheUtil::Dir()
+{
+    if (_file.empty()) return "";
+
+    return _file.substr(0, _file.size() - strlen(MISSFILE) - 1);
+} /* end of Dir */
+
+/**
+* @brief   : Find - find the negative cache entry of a local file
+* @param[I]: name (local file name)
+* @param[O]: ent (negative cache entry)
+* @return  : true:found, false:not found
+* @note    :
+**/
+bool CacheUtil::Find(const string &name, missent_t &ent)
+{
+    auto it = _ents.find(name);
+    if (it == _ents.end()) return false;
+    ent = it->second;
+
+    return true;
+} /* end of Find */
+
+/**
+* @brief   : Update - add or replace the negative cache entry of a local file
+* @param[I]: ent (negative cache entry)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void CacheUtil::Update(const missent_t &ent)
+{
+    _ents[ent.name] = ent;
+    _chg.insert(ent.name);
+} /* end of Update */
+
+/**
+* @brief   : Remove - remove the negative cache entry of a local file
+* @param[I]: name (local file name)
+* @param[O]: none
+* @return  : true:removed, false:not found
+* @note    :
+**/
+bool CacheUtil::Remove(const string &name)
+{
+    if (_ents.erase(name) == 0) return false;
+    _chg.insert(name);
+
+    return true;
+} /* end of Remove */
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*------------------------------------------------------------------------------
+* CacheUtil.h : header file of CacheUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class CacheUtil
+{
+private:
+    string _file;                                   /* full path of the negative cache file */
+    std::unordered_map<string, missent_t> _ents;    /* negative cache entries indexed by local file name */
+    std::unordered_set<string> _chg;                /* entries updated or removed since 'Load', the others are read again by 'Save' */
+
+    /**
+    * @brief   : Read - read the entries of the negative cache file
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:ok, false:the file does not exist
+    * @note    :
+    **/
+    bool Read();
+
+public:
+    CacheUtil()
+	{
+
+	}
+	~CacheUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Load - load the negative cache of a directory
+    * @param[I]: dir (the directory where the files are stored)
+    * @param[O]: none
+    * @return  : true:ok, false:the cache does not exist (an empty cache is used)
+    * @note    : the cache is stored in the hidden file '.good_missing' of the directory
+    **/
+    bool Load(const string &dir);
+
+    /**
+    * @brief   : Save - save the negative cache to the file it was loaded from
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the file is read again under its lock ('.good_missing.lock') and only the entries updated or
+    *            removed by this process change the ones on disk
+    **/
+    bool Save();
+
+    /**
+    * @brief   : Dir - get the directory of the loaded negative cache
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : the directory, "" if nothing has been loaded
+    * @note    :
+    **/
+    string Dir();
+
+    /**
+    * @brief   : Find - find the negative cache entry of a local file
+    * @param[I]: name (local file name)
+    * @param[O]: ent (negative cache entry)
+    * @return  : true:found, false:not found
+    * @note    :
+    **/
+    bool Find(const string &name, missent_t &ent);
+
+    /**
+    * @brief   : Update - add or replace the negative cache entry of a local file
+    * @param[I]: ent (negative cache entry)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Update(const missent_t &ent);
+
+    /**
+    * @brief   : Remove - remove the negative cache entry of a local file
+    * @param[I]: name (local file name)
+    * @param[O]: none
+    * @return  : true:removed, false:not found
+    * @note    :
+    **/
+    bool Remove(const string &name);
+};
\ No newline at end of file
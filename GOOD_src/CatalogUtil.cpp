@@ -0,0 +1,193 @@
+/*------------------------------------------------------------------------------
+* CatalogUtil.cpp : freshness catalog of the downloaded files
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "CatalogUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define CATFILE    ".good_catalog"   /* name of the catalog file in each directory */
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Read - read the entries of one catalog file
+* @param[I]: file (full path of the catalog file)
+* @param[I]: own (whether the entries are the ones of the shard)
+* @param[O]: none
+* @return  : true:ok, false:the file does not exist
+* @note    :
+**/
+bool CatalogUtil::Read(const string &file, bool own)
+{
+    StringUtil str;
+    std::vector<string> lines;
+    if (!str.ReadLines(file, lines)) return false;
+
+    /* one entry per line: local-name  remote-name  size  mtime  etag */
+    for (const string &line : lines)
+    {
+        istringstream iss(line);
+        catent_t ent;
+        if (!(iss >> ent.name >> ent.remote >> ent.size >> ent.mtime >> ent.etag)) continue;
+        _ents[ent.name] = ent;
+        if (own) _own.insert(ent.name);
+    }
+
+    return true;
+} /* end of Read */
+
+/**
+* @brief   : Load - load the freshness catalog of a directory
+* @param[I]: dir (the directory where the files are stored, "" for current directory)
+* @param[I]: shard (shard of the downloading process, i.e., '2of4', "" if not sharded)
+* @param[O]: none
+* @return  : true:ok, false:the catalog does not exist (an empty catalog is used)
+* @note    : the catalog is stored in the hidden file '.good_catalog' of the directory; a shard reads it and
+*            its own '.good_catalog.2of4' but saves only the latter, which 'Merge' takes in after the run
+**/
+bool CatalogUtil::Load(const string &dir, const string &shard)
+{
+    _ents.clear();
+    _own.clear();
+    _chg.clear();
+    _shard = shard;
+    string mainFile = dir.empty() ? string(CATFILE) : dir + FILEPATHSEP + CATFILE;
+    _file = shard.empty() ? mainFile : mainFile + "." + shard;
+
+    bool ok = Read(mainFile, false);
+    if (!shard.empty()) ok = Read(_file, true) || ok;
+
+    return ok;
+} /* end of Load */
+
+/**
+* @brief   : Save - save the freshness catalog to the file it was loaded from
+* @param[I]: none
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the file is read again under its lock ('.good_catalog.lock') and only the entries updated by
+*            this process replace the ones on disk, so the processes sharing a directory never drop the
+*            entries of each other
+**/
+bool CatalogUtil::Save()
+{
+    if (_file.empty()) return false;
+    if (_chg.empty()) return true;
+
+    /* a shard reads the catalog of the directory again as well, as 'Load' did */
+    LockUtil lock;
+    auto read = [this]() {
+        if (!_shard.empty()) Read(_file.substr(0, _file.size() - _shard.size() - 1), false);
+        Read(_file, !_shard.empty());
+    };
+    auto merge = [this, &lock, &read]() { lock.Overlay(_ents, _chg, read); };
+    auto text = [this]() {
+        ostringstream catFile;
+        catFile << "# local-name  remote-name  size  mtime  etag" << endl;
+        for (auto &it : _ents)
+        {
+            const catent_t &ent = it.second;
+            if (!_shard.empty() && _own.count(ent.name) == 0) continue;
+            catFile << ent.name << "  " << ent.remote << "  " << ent.size << "  " << ent.mtime << "  " <<
+                ent.etag << endl;
+        }
+
+        return catFile.str();
+    };
+    if (!lock.SaveTable(_file, merge, text))
+    {
+        cerr << "*** ERROR(CatalogUtil::Save): write catalog file " << _file << " FAILED!" << endl;
+
+        return false;
+    }
+
+    return true;
+} /* end of Save */
+
+/**
+* @brief   : Find - find the catalog entry of a local file
+* @param[I]: name (local file name)
+* @param[O]: ent (catalog entry)
+* @return  : true:found, false:not found
+* @note    :
+**/
+bool CatalogUtil::Find(const string &name, catent_t &ent)
+{
+    auto it = _ents.find(name);
+    if (it == _ents.end()) return false;
+    ent = it->second;
+
+    return true;
+} /* end of Find */
+
+/**
+* @brief   : Update - add or replace the catalog entry of a local file
+* @param[I]: ent (catalog entry)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void CatalogUtil::Update(const catent_t &ent)
+{
+    _ents[ent.name] = ent;
+    _chg.insert(ent.name);
+    if (!_shard.empty()) _own.insert(ent.name);
+} /* end of Update */
+
+/**
+* @brief   : IsSame - whether two entries describe the same remote file version
+* @param[I]: a, b (catalog entries)
+* @param[O]: none
+* @return  : true:same, false:changed
+* @note    : unknown fields ('-' or -1) on either side are not compared
+**/
+bool CatalogUtil::IsSame(const catent_t &a, const catent_t &b)
+{
+    if (a.remote != b.remote) return false;
+    if (a.etag != "-" && b.etag != "-") return a.etag == b.etag;
+    if (a.size >= 0 && b.size >= 0 && a.size != b.size) return false;
+    if (a.mtime != "-" && b.mtime != "-" && a.mtime != b.mtime) return false;
+
+    return true;
+} /* end of IsSame */
+
+/**
+* @brief   : Merge - merge the catalogs of the shards of a directory into its catalog
+* @param[I]: dir (the directory where the files are stored, "" for current directory)
+* @param[O]: none
+* @return  : number of the shard catalogs merged (and removed), -1:error
+* @note    : the shards are taken in the order of their names, an entry of a later shard replaces the one of
+*            an earlier shard or of the catalog
+**/
+int CatalogUtil::Merge(const string &dir)
+{
+    StringUtil str;
+    std::vector<string> names, shardFiles;
+    str.ListDir(dir.empty() ? "." : dir, names);
+    std::sort(names.begin(), names.end());
+    string prefix = string(CATFILE) + ".";
+    for (const string &name : names)
+    {
+        if (name.compare(0, prefix.size(), prefix) != 0 || !str.IsShardTag(name.substr(prefix.size()))) continue;
+        shardFiles.push_back(dir.empty() ? name : dir + FILEPATHSEP + name);
+    }
+    if (shardFiles.empty()) return 0;
+
+    Load(dir);
+    for (const string &shardFile : shardFiles) Read(shardFile, false);
+    for (auto &it : _ents) _chg.insert(it.first);
+    if (!Save()) return -1;
+    for (const string &shardFile : shardFiles) remove(shardFile.c_str());
+
+    return (int)shardFiles.size();
+} /* end of Merge */
\ No newline at end of file
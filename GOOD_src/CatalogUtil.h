@@ -0,0 +1,93 @@
+/*------------------------------------------------------------------------------
+* CatalogUtil.h : header file of CatalogUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class CatalogUtil
+{
+private:
+    string _file;                                   /* full path of the catalog file */
+    std::unordered_map<string, catent_t> _ents;     /* catalog entries indexed by local file name */
+    string _shard;                                  /* shard of the catalog, i.e., '2of4' ("" for the merged catalog) */
+    std::unordered_set<string> _own;                /* entries of the shard, the only ones a shard catalog saves */
+    std::unordered_set<string> _chg;                /* entries updated since 'Load', the others are read again by 'Save' */
+
+    /**
+    * @brief   : Read - read the entries of one catalog file
+    * @param[I]: file (full path of the catalog file)
+    * @param[I]: own (whether the entries are the ones of the shard)
+    * @param[O]: none
+    * @return  : true:ok, false:the file does not exist
+    * @note    :
+    **/
+    bool Read(const string &file, bool own);
+
+public:
+    CatalogUtil()
+	{
+
+	}
+	~CatalogUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Load - load the freshness catalog of a directory
+    * @param[I]: dir (the directory where the files are stored, "" for current directory)
+    * @param[I]: shard (shard of the downloading process, i.e., '2of4', "" if not sharded)
+    * @param[O]: none
+    * @return  : true:ok, false:the catalog does not exist (an empty catalog is used)
+    * @note    : the catalog is stored in the hidden file '.good_catalog' of the directory; a shard reads it and
+    *            its own '.good_catalog.2of4' but saves only the latter, which 'Merge' takes in after the run
+    **/
+    bool Load(const string &dir, const string &shard = "");
+
+    /**
+    * @brief   : Save - save the freshness catalog to the file it was loaded from
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the file is read again under its lock ('.good_catalog.lock') and only the entries updated by
+    *            this process replace the ones on disk, so the processes sharing a directory never drop the
+    *            entries of each other
+    **/
+    bool Save();
+
+    /**
+    * @brief   : Find - find the catalog entry of a local file
+    * @param[I]: name (local file name)
+    * @param[O]: ent (catalog entry)
+    * @return  : true:found, false:not found
+    * @note    :
+    **/
+    bool Find(const string &name, catent_t &ent);
+
+    /**
+    * @brief   : Update - add or replace the catalog entry of a local file
+    * @param[I]: ent (catalog entry)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Update(const catent_t &ent);
+
+    /**
+    * @brief   : IsSame - whether two entries describe the same remote file version
+    * @param[I]: a, b (catalog entries)
+    * @param[O]: none
+    * @return  : true:same, false:changed
+    * @note    : unknown fields ('-' or -1) on either side are not compared
+    **/
+    bool IsSame(const catent_t &a, const catent_t &b);
+
+    /**
+    * @brief   : Merge - merge the catalogs of the shards of a directory into its catalog
+    * @param[I]: dir (the directory where the files are stored, "" for current directory)
+    * @param[O]: none
+    * @return  : number of the shard catalogs merged (and removed), -1:error
+    * @note    : the shards are taken in the order of their names, an entry of a later shard replaces the one of
+    *            an earlier shard or of the catalog
+    **/
+    int Merge(const string &dir);
+};
\ No newline at end of file
@@ -0,0 +1,302 @@
+/*------------------------------------------------------------------------------
+* CheckUtil.cpp : integrity check of the downloaded files by the invariants of their formats
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*    [1] W. Gurtner, RINEX: The Receiver Independent Exchange Format Version 2.11, 2007
+*    [2] IGS RINEX Working Group and RTCM-SC104, RINEX: The Receiver Independent Exchange Format Version 3.05, 2020
+*    [3] S. Hilla, The Extended Standard Product 3 Orbit Format (SP3-d), 2016
+*    [4] J. Ray, W. Gurtner, RINEX Extensions to Handle Clock Information Version 3.02, 2010
+*    [5] S. Schaer, W. Gurtner, J. Feltens, IONEX: The IONosphere Map EXchange Format Version 1, 1998
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "TimeUtil.h"
+#include "StringUtil.h"
+#include "IndexUtil.h"
+#include "CheckUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define CHK_ANY    0                 /* any other file: not empty and not an error page of the server */
+#define CHK_OBS    1                 /* RINEX observation: header, increasing epochs, complete last record */
+#define CHK_NAV    2                 /* RINEX navigation: header */
+#define CHK_SP3    3                 /* SP3: increasing epochs as many as declared, 'EOF' line */
+#define CHK_CLK    4                 /* RINEX clock: header, complete records, satellites as many as declared */
+#define CHK_ION    5                 /* IONEX: header, TEC maps as many as declared, 'END OF FILE' line */
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* whether the extension is of the RINEX 2 short names, i.e., '21o' */
+static bool IsShortExt(const string &ext, const char *types)
+{
+    return ext.size() == 3 && isdigit((unsigned char)ext[0]) && isdigit((unsigned char)ext[1]) &&
+        strchr(types, ext[2]) != nullptr;
+}
+
+/* label of a header line (columns 61-80), "" if none */
+static string HeadLabel(const string &line)
+{
+    return line.size() > 60 ? line.substr(60) : "";
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Fail - record the invariant broken
+* @param[I]: why (the invariant broken)
+* @param[O]: none
+* @return  : false
+* @note    :
+**/
+bool CheckUtil::Fail(const string &why)
+{
+    if (_why.empty()) _why = why;
+
+    return false;
+} /* end of Fail */
+
+/**
+* @brief   : PutHead - check one header line of a RINEX observation, navigation, clock or IONEX file
+* @param[I]: line (header line)
+* @param[O]: none
+* @return  : true:go on, false:an invariant is broken
+* @note    :
+**/
+bool CheckUtil::PutHead(const string &line)
+{
+    string label = HeadLabel(line);
+    if (_nLine == 1 && label.find("VERSION / TYPE") == string::npos) return Fail("no 'VERSION / TYPE' header line");
+
+    if (_kind == CHK_OBS)
+    {
+        if (label.find("RINEX VERSION / TYPE") == 0) _ver = atof(line.substr(0, 9).c_str());
+        else if (label.find("# / TYPES OF OBSERV") == 0 && _nType == 0) _nType = atoi(line.substr(0, 6).c_str());
+        if (_scan.ScanHead(line) < 0) return Fail("not a RINEX 2 or 3 observation file");
+    }
+    else if (_kind == CHK_CLK && label.find("# OF SOLN SATS") == 0) _nDecl = atoi(line.substr(0, 6).c_str());
+    else if (_kind == CHK_ION && label.find("# OF MAPS IN FILE") == 0) _nDecl = atoi(line.substr(0, 6).c_str());
+    if (label.find("END OF HEADER") == 0) _inHead = false;
+
+    return true;
+} /* end of PutHead */
+
+/**
+* @brief   : PutObs - check one line of the data records of a RINEX observation file
+* @param[I]: line (line of the data records)
+* @param[O]: none
+* @return  : true:go on, false:an invariant is broken
+* @note    :
+**/
+bool CheckUtil::PutObs(const string &line)
+{
+    epochidx_t ep;
+    if (_scan.ScanEpoch(line, ep))
+    {
+        if (_ver >= 3.0 && _left > 0) return Fail("incomplete epoch record before line " + to_string(_nLine));
+
+        TimeUtil tu;
+        if (_nRec > 0 && tu.TimeDiff(ep.time, _tLast) <= 0.0)
+            return Fail("epochs not in increasing order at line " + to_string(_nLine));
+        _tLast = ep.time;
+        _nRec++;
+
+        /* RINEX 3: one line per satellite; RINEX 2: the satellite list, then 5 observations per line */
+        _left = _ver >= 3.0 ? ep.nsat : (ep.nsat - 1) / 12 + ep.nsat * ((_nType + 4) / 5);
+
+        return true;
+    }
+
+    /* the events of RINEX 3 (flag 2-5) and their special records come only after a complete record */
+    if (_ver >= 3.0 && !line.empty() && line[0] == '>')
+    {
+        if (_left > 0) return Fail("incomplete epoch record before line " + to_string(_nLine));
+
+        return true;
+    }
+    if (_left > 0) _left--;
+
+    return true;
+} /* end of PutObs */
+
+/**
+* @brief   : PutSp3 - check one line of an SP3 file
+* @param[I]: line (line in file order)
+* @param[O]: none
+* @return  : true:go on, false:an invariant is broken
+* @note    :
+**/
+bool CheckUtil::PutSp3(const string &line)
+{
+    /* the first line gives the version ('a'-'d') and the number of epochs (columns 33-39) */
+    if (_nLine == 1)
+    {
+        if (line.size() < 39 || line[0] != '#' || strchr("abcd", line[1]) == nullptr)
+            return Fail("no SP3 header line");
+        _nDecl = atoi(line.substr(32, 7).c_str());
+
+        return true;
+    }
+    if (line.size() < 2 || line[0] != '*' || line[1] != ' ') return true;
+
+    double date[6];
+    if (sscanf(line.c_str() + 1, "%lf %lf %lf %lf %lf %lf", &date[0], &date[1], &date[2], &date[3], &date[4],
+        &date[5]) < 6) return Fail("invalid epoch line at line " + to_string(_nLine));
+    TimeUtil tu;
+    gtime_t t = tu.ymdhms2time(date);
+    if (_nRec > 0 && tu.TimeDiff(t, _tLast) <= 0.0) return Fail("epochs not in increasing order at line " + to_string(_nLine));
+    _tLast = t;
+    _nRec++;
+
+    return true;
+} /* end of PutSp3 */
+
+/**
+* @brief   : PutClk - check one line of the data records of a RINEX clock file
+* @param[I]: line (line of the data records)
+* @param[O]: none
+* @return  : true:go on, false:an invariant is broken
+* @note    :
+**/
+bool CheckUtil::PutClk(const string &line)
+{
+    if (line.find_first_not_of(' ') == string::npos) return true;
+
+    /* the values beyond the second are on the continuation line */
+    istringstream iss(line);
+    string tok;
+    if (_left > 0)
+    {
+        while (_left > 0 && iss >> tok) _left--;
+
+        return true;
+    }
+
+    /* type, name, epoch, number of values (1-6), values */
+    string type, name;
+    double date[6];
+    int n;
+    if (!(iss >> type >> name >> date[0] >> date[1] >> date[2] >> date[3] >> date[4] >> date[5] >> n) ||
+        (type != "AR" && type != "AS" && type != "CR" && type != "DR" && type != "MS") || n < 1 || n > 6)
+        return Fail("invalid clock record at line " + to_string(_nLine));
+    _left = n;
+    while (_left > 0 && iss >> tok) _left--;
+    if (type == "AS") _sats.insert(name);
+    _nRec++;
+
+    return true;
+} /* end of PutClk */
+
+/**
+* @brief   : Reset - reset the checker for a new file
+* @param[I]: file (file name, the format is taken from its extension, i.e., '*.yyo', '*.sp3', '*.clk', '*.yyi')
+* @param[O]: none
+* @return  : none
+* @note    : the compression extensions ('.gz', '.Z', '.zst') are skipped
+**/
+void CheckUtil::Reset(const string &file)
+{
+    StringUtil str;
+    string name = file;
+    size_t pos = name.find_last_of("/\\");
+    if (pos != string::npos) name = name.substr(pos + 1);
+    str.ToLower(name);
+    for (const char *comp : { ".zst", ".gz", ".z" })
+    {
+        size_t len = strlen(comp);
+        if (name.size() > len && name.substr(name.size() - len) == comp) name = name.substr(0, name.size() - len);
+    }
+    pos = name.find_last_of('.');
+    string ext = pos == string::npos ? "" : name.substr(pos + 1);
+
+    /* RINEX 3 long names end with the data type, i.e., '_MO.rnx', '_MN.rnx' */
+    _kind = CHK_ANY;
+    if (ext == "sp3") _kind = CHK_SP3;
+    else if (ext.find("clk") == 0) _kind = CHK_CLK;
+    else if (ext == "inx" || IsShortExt(ext, "i")) _kind = CHK_ION;
+    else if (ext == "crx" || IsShortExt(ext, "od")) _kind = CHK_OBS;
+    else if (IsShortExt(ext, "nglp")) _kind = CHK_NAV;
+    else if (ext == "rnx" && name.size() > 6) _kind = name[name.size() - 5] == 'o' ? CHK_OBS : CHK_NAV;
+
+    _nLine = 0;
+    _inHead = _kind != CHK_ANY && _kind != CHK_SP3;
+    _why = "";
+    _last = "";
+    _ver = 0.0;
+    _nType = 0;
+    _scan.Reset();
+    _tLast.mjd = 0;
+    _tLast.sod = 0.0;
+    _nRec = 0;
+    _nEnd = 0;
+    _nDecl = -1;
+    _left = 0;
+    _sats.clear();
+} /* end of Reset */
+
+/**
+* @brief   : Put - check one line of the file
+* @param[I]: line (line in file order, without line end)
+* @param[O]: none
+* @return  : true:go on, false:an invariant is broken, the rest of the file is not needed
+* @note    :
+**/
+bool CheckUtil::Put(const string &line)
+{
+    if (!_why.empty()) return false;
+    _nLine++;
+
+    /* no format of the products starts with '<', which is an HTML or XML page of the server saved instead */
+    size_t pos = line.find_first_not_of(" \t");
+    if (_nLine == 1 && pos != string::npos && line[pos] == '<') return Fail("an HTML or XML page");
+    if (pos != string::npos) _last = line;
+
+    if (_kind == CHK_ANY) return true;
+    if (_kind == CHK_SP3) return PutSp3(line);
+    if (_inHead) return PutHead(line);
+    if (_kind == CHK_OBS) return PutObs(line);
+    if (_kind == CHK_CLK) return PutClk(line);
+    if (_kind == CHK_ION)
+    {
+        string label = HeadLabel(line);
+        if (label.find("START OF TEC MAP") == 0) _nRec++;
+        else if (label.find("END OF TEC MAP") == 0) _nEnd++;
+    }
+
+    return true;
+} /* end of Put */
+
+/**
+* @brief   : Finish - check the invariants at the end of the file
+* @param[I]: none
+* @param[O]: why (the invariant broken, i.e., "no 'EOF' line")
+* @return  : true:valid, false:invalid
+* @note    :
+**/
+bool CheckUtil::Finish(string &why)
+{
+    if (_why.empty())
+    {
+        if (_nLine == 0) Fail("empty file");
+        else if (_inHead) Fail("no 'END OF HEADER' line");
+        else if (_kind == CHK_OBS && _nRec == 0) Fail("no epochs");
+        else if (_kind == CHK_OBS && _left > 0) Fail("the last epoch record is truncated");
+        else if (_kind == CHK_SP3 && _nDecl >= 0 && _nRec != _nDecl)
+            Fail(to_string(_nRec) + " epochs, but " + to_string(_nDecl) + " in the header");
+        else if (_kind == CHK_SP3 && _last.substr(0, 3) != "EOF") Fail("no 'EOF' line");
+        else if (_kind == CHK_CLK && _nRec == 0) Fail("no clock records");
+        else if (_kind == CHK_CLK && _left > 0) Fail("the last clock record is truncated");
+        else if (_kind == CHK_CLK && _nDecl >= 0 && (int)_sats.size() > _nDecl)
+            Fail(to_string(_sats.size()) + " satellites, but " + to_string(_nDecl) + " in the header");
+        else if (_kind == CHK_ION && _nDecl >= 0 && (_nRec != _nDecl || _nEnd != _nDecl))
+            Fail(to_string(_nEnd) + " complete TEC maps, but " + to_string(_nDecl) + " in the header");
+        else if (_kind == CHK_ION && HeadLabel(_last).find("END OF FILE") != 0) Fail("no 'END OF FILE' line");
+    }
+    why = _why;
+
+    return _why.empty();
+} /* end of Finish */
\ No newline at end of file
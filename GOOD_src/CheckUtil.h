@@ -0,0 +1,105 @@
+/*------------------------------------------------------------------------------
+* CheckUtil.h : header file of CheckUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class CheckUtil
+{
+private:
+    int _kind;                                      /* format of the file being checked (CHK_??? in CheckUtil.cpp) */
+    long _nLine;                                    /* number of lines read */
+    bool _inHead;                                   /* whether the header is being read */
+    string _why;                                    /* the invariant broken ("": none) */
+    string _last;                                   /* last line that is not blank */
+    double _ver;                                    /* RINEX version of the observation file */
+    int _nType;                                     /* number of observation types of RINEX 2 */
+    IndexUtil _scan;                                /* epoch scanner of the observation file */
+    gtime_t _tLast;                                 /* time of the last epoch */
+    int _nRec;                                      /* number of epochs (observation, SP3), records (clock) or TEC maps (IONEX) */
+    int _nEnd;                                      /* number of the ends of the TEC maps (IONEX) */
+    int _nDecl;                                     /* number declared in the header (SP3: epochs, clock: satellites, IONEX: maps), -1: none */
+    int _left;                                      /* lines (observation) or values (clock) missing in the last record */
+    std::unordered_set<string> _sats;               /* satellites of the clock records */
+
+    /**
+    * @brief   : Fail - record the invariant broken
+    * @param[I]: why (the invariant broken)
+    * @param[O]: none
+    * @return  : false
+    * @note    :
+    **/
+    bool Fail(const string &why);
+
+    /**
+    * @brief   : PutHead - check one header line of a RINEX observation, navigation, clock or IONEX file
+    * @param[I]: line (header line)
+    * @param[O]: none
+    * @return  : true:go on, false:an invariant is broken
+    * @note    :
+    **/
+    bool PutHead(const string &line);
+
+    /**
+    * @brief   : PutObs - check one line of the data records of a RINEX observation file
+    * @param[I]: line (line of the data records)
+    * @param[O]: none
+    * @return  : true:go on, false:an invariant is broken
+    * @note    :
+    **/
+    bool PutObs(const string &line);
+
+    /**
+    * @brief   : PutSp3 - check one line of an SP3 file
+    * @param[I]: line (line in file order)
+    * @param[O]: none
+    * @return  : true:go on, false:an invariant is broken
+    * @note    :
+    **/
+    bool PutSp3(const string &line);
+
+    /**
+    * @brief   : PutClk - check one line of the data records of a RINEX clock file
+    * @param[I]: line (line of the data records)
+    * @param[O]: none
+    * @return  : true:go on, false:an invariant is broken
+    * @note    :
+    **/
+    bool PutClk(const string &line);
+
+public:
+    CheckUtil()
+	{
+		Reset("");
+	}
+	~CheckUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Reset - reset the checker for a new file
+    * @param[I]: file (file name, the format is taken from its extension, i.e., '*.yyo', '*.sp3', '*.clk', '*.yyi')
+    * @param[O]: none
+    * @return  : none
+    * @note    : the compression extensions ('.gz', '.Z', '.zst') are skipped
+    **/
+    void Reset(const string &file);
+
+    /**
+    * @brief   : Put - check one line of the file
+    * @param[I]: line (line in file order, without line end)
+    * @param[O]: none
+    * @return  : true:go on, false:an invariant is broken, the rest of the file is not needed
+    * @note    :
+    **/
+    bool Put(const string &line);
+
+    /**
+    * @brief   : Finish - check the invariants at the end of the file
+    * @param[I]: none
+    * @param[O]: why (the invariant broken, i.e., "no 'EOF' line")
+    * @return  : true:valid, false:invalid
+    * @note    :
+    **/
+    bool Finish(string &why);
+};
\ No newline at end of file
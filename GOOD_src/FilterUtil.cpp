@@ -0,0 +1,443 @@
+/*------------------------------------------------------------------------------
+* FilterUtil.cpp : decimation, GNSS system and signal filter of the RINEX observation files at conversion
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*    [1] W. Gurtner, RINEX: The Receiver Independent Exchange Format Version 2.11, 2007
+*    [2] IGS RINEX Working Group and RTCM-SC104, RINEX: The Receiver Independent Exchange Format Version 3.05, 2020
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "FilterUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define GRIDTOL    0.005             /* tolerance (s) of the epochs on the decimation grid */
+#define SATPERLINE 12                /* satellites per epoch line of RINEX 2 */
+#define OBSWIDTH   16                /* characters of one observation in the data lines */
+#define OBSPERLINE 5                 /* observations per data line of RINEX 2 */
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* strip the tail spaces of a line */
+static string TailTrim(const string &line)
+{
+    size_t pos = line.find_last_not_of(' ');
+
+    return pos == string::npos ? "" : line.substr(0, pos + 1);
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : KeepSys - whether the satellites of a GNSS system are kept
+* @param[I]: sys (system identifier, i.e., 'G', ' ' for GPS in RINEX 2)
+* @param[O]: none
+* @return  : true:kept, false:dropped
+* @note    :
+**/
+bool FilterUtil::KeepSys(char sys)
+{
+    if (!_sys.empty() && _sys.find(sys == ' ' ? 'G' : sys) == string::npos) return false;
+    if (_codes.empty() || _ver < 3.0) return true;
+
+    /* a system without any kept code is dropped as well, and so is a system without observation types */
+    auto it = _cols.find(sys);
+
+    return it == _cols.end() ? _inHead : !it->second.empty();
+} /* end of KeepSys */
+
+/**
+* @brief   : KeepCode - whether an observation code is kept
+* @param[I]: code (observation code, i.e., 'C1C', 'P2' in RINEX 2)
+* @param[O]: none
+* @return  : true:kept, false:dropped
+* @note    :
+**/
+bool FilterUtil::KeepCode(const string &code)
+{
+    if (_codes.empty()) return true;
+
+    StringUtil str;
+    string name = TailTrim(code);
+    for (const string &pat : _codes)
+    {
+        if (str.WildMatch(pat.c_str(), name.c_str())) return true;
+    }
+
+    return false;
+} /* end of KeepCode */
+
+/**
+* @brief   : PutTypes - write the observation types of a system with the kept codes only
+* @param[I]: out (output stream)
+* @param[O]: none
+* @return  : none
+* @note    : the columns of the kept codes are recorded for the data lines
+**/
+void FilterUtil::PutTypes(ostream &out)
+{
+    std::vector<int> &cols = _cols[_typSys];
+    cols.clear();
+    for (int i = 0; i < (int)_typs.size(); i++)
+    {
+        if (KeepCode(_typs[i])) cols.push_back(i);
+    }
+
+    /* the observation types of RINEX 2 are shared by all the systems, so they are always written */
+    if (_ver >= 3.0 && !KeepSys(_typSys)) cols.clear();
+    else if (cols.size() == _typs.size())
+    {
+        for (const string &line : _typLines) out << line << "\n";
+    }
+    else
+    {
+        /* RINEX 3: A1,2X,I3,13(1X,A3); RINEX 2: I6,9(4X,A2), the continuation lines are blank in the front */
+        int nPer = _ver >= 3.0 ? 13 : 9;
+        string label = _typLines[0].substr(60);
+        char buff[MAXCHARS];
+        for (int i = 0; i == 0 || i < (int)cols.size(); i += nPer)
+        {
+            if (i > 0) strcpy(buff, "      ");
+            else if (_ver >= 3.0) snprintf(buff, sizeof(buff), "%c  %3d", _typSys, (int)cols.size());
+            else snprintf(buff, sizeof(buff), "%6d", (int)cols.size());
+            string line = buff;
+            for (int k = i; k < i + nPer && k < (int)cols.size(); k++)
+            {
+                snprintf(buff, sizeof(buff), _ver >= 3.0 ? " %3s" : "%6s", _typs[cols[k]].c_str());
+                line += buff;
+            }
+            line.resize(60, ' ');
+            out << line << label << "\n";
+        }
+    }
+    _typs.clear();
+    _typLines.clear();
+} /* end of PutTypes */
+
+/**
+* @brief   : PickCols - pick the observations of the kept codes
+* @param[I]: obs (observations, 16 characters each)
+* @param[I]: cols (columns of the kept codes)
+* @param[O]: none
+* @return  : the observations picked, 16 characters each
+* @note    :
+**/
+string FilterUtil::PickCols(const string &obs, const std::vector<int> &cols)
+{
+    string picked;
+    for (int k : cols)
+    {
+        string one = (int)obs.size() > k * OBSWIDTH ? obs.substr(k * OBSWIDTH, OBSWIDTH) : "";
+        one.resize(OBSWIDTH, ' ');
+        picked += one;
+    }
+
+    return picked;
+} /* end of PickCols */
+
+/**
+* @brief   : OnGrid - whether an epoch is on the decimation grid
+* @param[I]: line (epoch line)
+* @param[O]: none
+* @return  : true:on the grid, false:not on the grid
+* @note    : the grid starts at 0h of the day, 5 ms off the grid is regarded as on it
+**/
+bool FilterUtil::OnGrid(const string &line)
+{
+    if (_interval <= 0) return true;
+
+    double date[6];
+    if (sscanf(line.c_str() + (_ver >= 3.0 ? 1 : 0), "%lf %lf %lf %lf %lf %lf", &date[0], &date[1], &date[2],
+        &date[3], &date[4], &date[5]) < 6) return true;
+    double sod = date[3] * 3600.0 + date[4] * 60.0 + date[5];
+    double off = fmod(sod, (double)_interval);
+
+    return off < GRIDTOL || _interval - off < GRIDTOL;
+} /* end of OnGrid */
+
+/**
+* @brief   : Flush - write the current epoch record, if it is kept
+* @param[I]: out (output stream)
+* @param[O]: none
+* @return  : none
+* @note    : the satellites of the dropped systems are left out, and the number of satellites is rewritten
+**/
+void FilterUtil::Flush(ostream &out)
+{
+    if (_rec.empty()) return;
+    if (!_keep || (_sys.empty() && _codes.empty()) || _recLeft > 0)
+    {
+        /* decimation only, or an incomplete record at the end of the file */
+        for (int i = 0; _keep && i < (int)_rec.size(); i++) out << _rec[i] << "\n";
+        _rec.clear();
+
+        return;
+    }
+
+    char buff[16];
+    if (_ver >= 3.0)
+    {
+        /* the satellite lines of the dropped systems are not held, so only the number is rewritten */
+        int nsat = (int)_rec.size() - 1;
+        if (nsat > 0 || atoi(_rec[0].substr(32, 3).c_str()) == 0)
+        {
+            snprintf(buff, sizeof(buff), "%3d", nsat);
+            if (_rec[0].size() < 35) _rec[0].resize(35, ' ');
+            _rec[0].replace(32, 3, buff);
+            for (const string &line : _rec) out << line << "\n";
+        }
+        _rec.clear();
+
+        return;
+    }
+
+    /* RINEX 2: the satellite list of the epoch lines, then the data lines of each satellite */
+    if (_rec[0].size() < 32) _rec[0].resize(32, ' ');
+    int nsat = atoi(_rec[0].substr(29, 3).c_str());
+    int nCont = nsat > 0 ? (nsat - 1) / SATPERLINE : 0;
+    int nLine = nsat > 0 ? ((int)_rec.size() - 1 - nCont) / nsat : 0;
+    string sats, kept;
+    for (int i = 0; i <= nCont; i++)
+    {
+        string line = _rec[i].size() < 68 ? _rec[i] + string(68 - _rec[i].size(), ' ') : _rec[i];
+        sats += line.substr(32, 3 * SATPERLINE);
+    }
+    std::vector<int> idx;
+    for (int i = 0; i < nsat; i++)
+    {
+        if (!KeepSys(sats[3 * i])) continue;
+        idx.push_back(i);
+        kept += sats.substr(3 * i, 3);
+    }
+    if (idx.empty() && nsat > 0)
+    {
+        _rec.clear();
+
+        return;
+    }
+
+    /* the receiver clock offset (columns 69-80) stays on the first epoch line */
+    snprintf(buff, sizeof(buff), "%3d", (int)idx.size());
+    for (int i = 0; i == 0 || i < (int)idx.size(); i += SATPERLINE)
+    {
+        string line = i == 0 ? _rec[0].substr(0, 29) + buff : string(32, ' ');
+        for (int k = i; k < i + SATPERLINE && k < (int)idx.size(); k++) line += kept.substr(3 * k, 3);
+        if (i == 0 && _rec[0].size() > 68) line += string(68 - line.size(), ' ') + _rec[0].substr(68);
+        out << line << "\n";
+    }
+    for (int i : idx)
+    {
+        if (_codes.empty())
+        {
+            for (int k = 0; k < nLine; k++) out << _rec[1 + nCont + i * nLine + k] << "\n";
+            continue;
+        }
+
+        /* the observations of the kept codes are packed again, 5 per line */
+        string obs;
+        for (int k = 0; k < nLine; k++)
+        {
+            string line = _rec[1 + nCont + i * nLine + k];
+            line.resize(OBSWIDTH * OBSPERLINE, ' ');
+            obs += line;
+        }
+        obs = PickCols(obs, _cols[' ']);
+        for (int k = 0; k < (int)obs.size(); k += OBSWIDTH * OBSPERLINE)
+            out << TailTrim(obs.substr(k, OBSWIDTH * OBSPERLINE)) << "\n";
+    }
+    _rec.clear();
+} /* end of Flush */
+
+/**
+* @brief   : Set - set the filter
+* @param[I]: interval (decimation interval in seconds, 0: all epochs)
+* @param[I]: sys (GNSS systems kept, i.e., "GE", "" for all)
+* @param[I]: codes (observation codes kept, i.e., "C1C,L1C,C2W,L2W" or "C1?,L1?" with wildcards, "" for all)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void FilterUtil::Set(int interval, const string &sys, const string &codes)
+{
+    _interval = interval;
+    _sys = sys;
+    _codes.clear();
+    size_t ps = 0, pe;
+    while (ps < codes.size())
+    {
+        pe = codes.find(',', ps);
+        if (pe == string::npos) pe = codes.size();
+        if (pe > ps) _codes.push_back(codes.substr(ps, pe - ps));
+        ps = pe + 1;
+    }
+} /* end of Set */
+
+/**
+* @brief   : IsOn - whether the filter changes anything
+* @param[I]: none
+* @param[O]: none
+* @return  : true:on, false:off
+* @note    :
+**/
+bool FilterUtil::IsOn()
+{
+    return _interval > 0 || !_sys.empty() || !_codes.empty();
+} /* end of IsOn */
+
+/**
+* @brief   : Reset - reset the filter for a new RINEX observation file
+* @param[I]: none
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void FilterUtil::Reset()
+{
+    _ver = 0.0;
+    _inHead = true;
+    _nType = 0;
+    _cols.clear();
+    _typSys = ' ';
+    _typN = 0;
+    _typs.clear();
+    _typLines.clear();
+    _headLabel = "";
+    _headDrop = false;
+    _keep = true;
+    _special = 0;
+    _recLeft = 0;
+    _rec.clear();
+} /* end of Reset */
+
+/**
+* @brief   : Put - filter one line of a RINEX 2 or 3 observation file
+* @param[I]: line (line in file order, without line end)
+* @param[I]: out (output stream of the filtered RINEX)
+* @param[O]: none
+* @return  : none
+* @note    : an epoch record is held until it is complete
+**/
+void FilterUtil::Put(const string &line, ostream &out)
+{
+    if (_inHead)
+    {
+        string label = line.size() > 60 ? line.substr(60) : "";
+        bool drop = false;
+        if (label.find("RINEX VERSION / TYPE") == 0) _ver = atof(line.substr(0, 9).c_str());
+        else if (label.find("# / TYPES OF OBSERV") == 0 || label.find("SYS / # / OBS TYPES") == 0)
+        {
+            /* the types are held until the last continuation line, then written with the kept codes only */
+            bool isV3 = label[0] == 'S';
+            if (_typLines.empty())
+            {
+                _typSys = isV3 ? line[0] : ' ';
+                _typN = atoi(line.substr(isV3 ? 3 : 0, isV3 ? 3 : 6).c_str());
+                if (!isV3 && _nType == 0) _nType = _typN;
+            }
+            for (int k = 0; k < (isV3 ? 13 : 9) && (int)_typs.size() < _typN; k++)
+                _typs.push_back(isV3 ? line.substr(7 + 4 * k, 3) : line.substr(10 + 6 * k, 2));
+            _typLines.push_back(line);
+            if ((int)_typs.size() >= _typN) PutTypes(out);
+
+            return;
+        }
+        else if (label.find("END OF HEADER") == 0) _inHead = false;
+        else if (label.find("# OF SATELLITES") == 0 || label.find("PRN / # OF OBS") == 0) drop = true;
+        else if (label.find("INTERVAL") == 0 && atof(line.substr(0, 10).c_str()) < _interval)
+        {
+            char buff[MAXCHARS];
+            snprintf(buff, sizeof(buff), "%10.3f%50s%-20s", (double)_interval, "", "INTERVAL");
+            out << buff << "\n";
+
+            return;
+        }
+        else if (label.find("SYS / ") == 0 || label.find("GLONASS ") == 0)
+        {
+            /* the lines without a system identifier continue the line before */
+            if (label.find("GLONASS ") == 0) drop = !KeepSys('R');
+            else if (line[0] != ' ') drop = !KeepSys(line[0]) ||
+                (label.find("SYS / PHASE SHIFT") == 0 && !KeepCode(line.substr(2, 3)));
+            else drop = label == _headLabel && _headDrop;
+            _headLabel = label;
+            _headDrop = drop;
+        }
+        if (!drop) out << line << "\n";
+
+        return;
+    }
+
+    /* the special records of an event are written as they are */
+    if (_special > 0)
+    {
+        _special--;
+        out << line << "\n";
+
+        return;
+    }
+
+    if (_ver >= 3.0)
+    {
+        if (!line.empty() && line[0] == '>')
+        {
+            Flush(out);
+            int flag = line.size() > 31 && line[31] != ' ' ? line[31] - '0' : 0;
+            if (flag >= 2 && flag <= 5)
+            {
+                _special = atoi(line.substr(32, 3).c_str());
+                out << line << "\n";
+
+                return;
+            }
+            _keep = OnGrid(line);
+            if (_keep) _rec.push_back(line);
+        }
+        else if (_keep && !_rec.empty() && (line.empty() || KeepSys(line[0])))
+        {
+            if (_codes.empty() || line.size() < 3) _rec.push_back(line);
+            else _rec.push_back(TailTrim(line.substr(0, 3) + PickCols(line.substr(3), _cols[line[0]])));
+        }
+
+        return;
+    }
+
+    /* RINEX 2: an epoch record is the epoch lines and the data lines of all of its satellites */
+    if (_recLeft > 0)
+    {
+        _recLeft--;
+        if (_keep) _rec.push_back(line);
+        if (_recLeft == 0) Flush(out);
+
+        return;
+    }
+    int flag = line.size() > 28 && line[28] != ' ' ? line[28] - '0' : 0;
+    int nsat = line.size() > 29 ? atoi(line.substr(29, 3).c_str()) : 0;
+    if (flag >= 2 && flag <= 5)
+    {
+        _special = nsat;
+        out << line << "\n";
+
+        return;
+    }
+    _keep = OnGrid(line);
+    _recLeft = (nsat > 0 ? (nsat - 1) / SATPERLINE : 0) + nsat * ((_nType + 4) / 5);
+    if (_keep) _rec.push_back(line);
+    if (_recLeft == 0) Flush(out);
+} /* end of Put */
+
+/**
+* @brief   : Finish - write what is held at the end of the file
+* @param[I]: out (output stream of the filtered RINEX)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void FilterUtil::Finish(ostream &out)
+{
+    Flush(out);
+} /* end of Finish */
\ No newline at end of file
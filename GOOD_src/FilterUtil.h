@@ -0,0 +1,141 @@
+/*------------------------------------------------------------------------------
+* FilterUtil.h : header file of FilterUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class FilterUtil
+{
+private:
+    int _interval;                                  /* decimation interval (s, 0: all epochs) */
+    string _sys;                                    /* GNSS systems kept, i.e., "GE" ("": all) */
+    std::vector<string> _codes;                     /* observation codes kept, wildcards allowed (empty: all) */
+    std::unordered_map<char, std::vector<int> > _cols;  /* columns of the kept codes of each system (' ' for RINEX 2) */
+    char _typSys;                                   /* system of the observation types being read */
+    int _typN;                                      /* number of the observation types being read */
+    std::vector<string> _typs;                      /* observation types being read */
+    std::vector<string> _typLines;                  /* header lines of the observation types being read */
+    double _ver;                                    /* RINEX version of the file being filtered (0: unknown) */
+    bool _inHead;                                   /* whether the header is being filtered */
+    int _nType;                                     /* number of observation types of RINEX 2 */
+    string _headLabel;                              /* label of the last header line with a system */
+    bool _headDrop;                                 /* whether the last header line with a system is dropped */
+    bool _keep;                                     /* whether the current epoch is kept */
+    int _special;                                   /* special records left of the current event */
+    int _recLeft;                                   /* lines left in the current epoch record of RINEX 2 */
+    std::vector<string> _rec;                       /* lines of the current epoch record */
+
+    /**
+    * @brief   : KeepSys - whether the satellites of a GNSS system are kept
+    * @param[I]: sys (system identifier, i.e., 'G', ' ' for GPS in RINEX 2)
+    * @param[O]: none
+    * @return  : true:kept, false:dropped
+    * @note    :
+    **/
+    bool KeepSys(char sys);
+
+    /**
+    * @brief   : KeepCode - whether an observation code is kept
+    * @param[I]: code (observation code, i.e., 'C1C', 'P2' in RINEX 2)
+    * @param[O]: none
+    * @return  : true:kept, false:dropped
+    * @note    :
+    **/
+    bool KeepCode(const string &code);
+
+    /**
+    * @brief   : PutTypes - write the observation types of a system with the kept codes only
+    * @param[I]: out (output stream)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the columns of the kept codes are recorded for the data lines
+    **/
+    void PutTypes(ostream &out);
+
+    /**
+    * @brief   : PickCols - pick the observations of the kept codes
+    * @param[I]: obs (observations, 16 characters each)
+    * @param[I]: cols (columns of the kept codes)
+    * @param[O]: none
+    * @return  : the observations picked, 16 characters each
+    * @note    :
+    **/
+    string PickCols(const string &obs, const std::vector<int> &cols);
+
+    /**
+    * @brief   : OnGrid - whether an epoch is on the decimation grid
+    * @param[I]: line (epoch line)
+    * @param[O]: none
+    * @return  : true:on the grid, false:not on the grid
+    * @note    : the grid starts at 0h of the day, 5 ms off the grid is regarded as on it
+    **/
+    bool OnGrid(const string &line);
+
+    /**
+    * @brief   : Flush - write the current epoch record, if it is kept
+    * @param[I]: out (output stream)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the satellites of the dropped systems are left out, and the number of satellites is rewritten;
+    *            the data lines of RINEX 2 are rebuilt with the observations of the kept codes
+    **/
+    void Flush(ostream &out);
+
+public:
+    FilterUtil()
+	{
+		_interval = 0;
+		Reset();
+	}
+	~FilterUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Set - set the filter
+    * @param[I]: interval (decimation interval in seconds, 0: all epochs)
+    * @param[I]: sys (GNSS systems kept, i.e., "GE", "" for all)
+    * @param[I]: codes (observation codes kept, i.e., "C1C,L1C,C2W,L2W" or "C1?,L1?" with wildcards, "" for all)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Set(int interval, const string &sys, const string &codes);
+
+    /**
+    * @brief   : IsOn - whether the filter changes anything
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:on, false:off
+    * @note    :
+    **/
+    bool IsOn();
+
+    /**
+    * @brief   : Reset - reset the filter for a new RINEX observation file
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Reset();
+
+    /**
+    * @brief   : Put - filter one line of a RINEX 2 or 3 observation file
+    * @param[I]: line (line in file order, without line end)
+    * @param[I]: out (output stream of the filtered RINEX)
+    * @param[O]: none
+    * @return  : none
+    * @note    : an epoch record is held until it is complete
+    **/
+    void Put(const string &line, ostream &out);
+
+    /**
+    * @brief   : Finish - write what is held at the end of the file
+    * @param[I]: out (output stream of the filtered RINEX)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Finish(ostream &out);
+};
\ No newline at end of file
@@ -29,6 +29,19 @@
 #include "Good.h"
 #include "TimeUtil.h"
 #include "StringUtil.h"
+#include "CatalogUtil.h"
+#include "CacheUtil.h"
+#include "RateUtil.h"
+#include "BucketUtil.h"
+#include "StoreUtil.h"
+#include "LockUtil.h"
+#include "ZstdUtil.h"
+#include "IndexUtil.h"
+#include "FilterUtil.h"
+#include "CheckUtil.h"
+#include "InventUtil.h"
+#include "SiteUtil.h"
+#include "PlanUtil.h"
 #include "FtpUtil.h"
 
 
@@ -50,76 +63,2837 @@
 #define IDX_ION    14   /* index for global ionosphere map (GIM) downloaded */
 #define IDX_ROTI   15   /* index for Rate of TEC index (ROTI) downloaded */
 #define IDX_ZTD    16   /* index for IGS final tropospheric product downloaded */
+#define NIDX       17   /* number of the indexes of the FTP archives */
+
+/* directory layout under the trees of the FTP archives (indexed by ARC_??? and IDX_???), in which '%Y' is the year,
+   '%y' the 2-digit year, '%D' the day of year, '%W' the GPS week and '%H' the hour */
+static const char *arcLayout[NARC][NIDX] = {
+    { "%Y/%D/%yd", "%Y/%D/%H", "%Y/%D/%yd/%H", "%Y/%D/%yd", "%Y/%D/%H", "%Y/%D/%yd/%H", "%Y/brdc", "%W", "%W", "%W",
+      "%W", "%W", "%W", "%Y", "%Y/%D", "%Y/%D", "%Y/%D" },                                      /* CDDIS */
+    { "%Y/%D", "%Y/%D", "%Y/%D", "%Y/%D", "%Y/%D", "%Y/%D", "%Y/%D", "%W", "%W", "%W",
+      "%W", "%W", "%W", "%Y", "%Y/%D", "%Y/%D", "%Y/%D" },                                      /* IGN */
+    { "%Y/%D/%yd", "%Y/%D/%H", "%Y/%D/%yd/%H", "%Y/%D/%yd", "%Y/%D/%H", "%Y/%D/%yd/%H", "%Y/brdc", "%W", "%W", "%W",
+      "%W", "%W", "%W", "%Y", "%Y/%D", "%Y/%D", "%Y/%D" }                                       /* WHU */
+};
+
+#define EUREFARC   "https://igs.bkg.bund.de/root_ftp/EUREF/obs"  /* EUREF Permanent GNSS Network (EPN) observation files */
+#define LISTAGE    3600 /* age (s) after which the cached sites of a network are listed again */
+#define LISTDAYS   14   /* the cached sites of a network are kept for good if the day is this many days ago */
+#define SHARDAGE   86400 /* age (s) after which the sites of a network resolved for the shards are listed again */
+#define STASNX     "https://files.igs.org/pub/station/general/igs_with_former.snx"  /* SINEX of the IGS stations */
+#define STAAGE     604800  /* age (s) after which the cached IGS station SINEX is taken again */
+
+static const char *getNames[NGET] = {                            /* kinds of the products (GET_???) for the size history */
+    "obs", "obm", "obc", "obg", "obh", "nav", "orbclk", "eop", "snx", "dcb", "ion", "roti", "trp", "rtorbclk",
+    "rtbias", "atx"
+};
+static const char *obsTypNames[] = { "daily", "hourly", "highrate", "30s", "5s", "1s" };  /* sub-directories of OBS_??? */
+static const char *navTypNames[] = { "daily", "hourly", "rtnav" };                          /* kinds of NAV_??? */
+
+struct arcinfo_t
+{                       /* FTP archive */
+    const char *name;   /* name of FTP archive */
+    int proto;          /* protocol of its FTP tree (PROTO_???), 'wget' */
+    int httpsProto;     /* protocol of its HTTPS tree (PROTO_HTTPS, 'curl'), -1 if it has none */
+};
+static const arcinfo_t arcTable[NARC] = {  /* FTP archives (ARC_???) */
+    { "CDDIS", PROTO_FTP, PROTO_HTTPS }, { "IGN", PROTO_FTP, -1 }, { "WHU", PROTO_FTP, -1 }
+};
+
+struct acinfo_t
+{                       /* analysis center of precise products */
+    const char *name;   /* three-char name of analysis center (lowercase) */
+    bool isMgex;        /* true: MGEX products, false: IGS products */
+    int step;           /* step (hours) of ultra-rapid products, 24 for final/rapid products */
+};
+static const acinfo_t acTable[NAC] = {  /* analysis centers (AC_???) */
+    { "igs", false, 24 }, { "igr", false, 24 }, { "igu", false,  6 }, { "cod", false, 24 },
+    { "esa", false, 24 }, { "gfz", false, 24 }, { "gfu", false,  3 }, { "grg", false, 24 },
+    { "jpl", false, 24 }, { "com", true,  24 }, { "gbm", true,  24 }, { "grm", true,  24 },
+    { "wum", true,  24 }, { "wuu", true,   1 }
+};
+
+enum
+{                       /* latency classes of the negative cache */
+    MISS_OBS = 0,       /* daily observation and broadcast ephemeris files */
+    MISS_OBSH,          /* hourly and high-rate observation files */
+    MISS_ULTRA,         /* ultra-rapid and real-time products */
+    MISS_RAPID,         /* rapid products */
+    MISS_FINAL,         /* final products (orbit, clock, EOP, SINEX, DCB, GIM, ROTI) */
+    MISS_TRP,           /* final tropospheric products */
+    MISS_RT,            /* CNES real-time products in offline mode */
+    MISS_STATIC,        /* table files (i.e., ANTEX) */
+    NMISS               /* number of latency classes */
+};
+
+struct missinfo_t
+{                       /* latency class of the negative cache */
+    double latency;     /* hours after the start of the day that the products are normally published */
+    double retry;       /* hours to wait before the next request once the products are overdue */
+};
+static const missinfo_t missTable[NMISS] = {  /* latency classes (MISS_???) */
+    {  26.0,  6.0 }, {   2.0, 1.0 }, {   0.0,  1.0 }, {  41.0,  3.0 },
+    { 336.0, 24.0 }, { 528.0, 24.0 }, {  26.0,  6.0 }, {   0.0, 24.0 }
+};
+#define MAXRETRY   168.0    /* maximum hours to wait before the next request (back-off limit) */
+#define MAXBATCH   100      /* maximum number of files requested in one FTP session (one 'wget' command line) */
+#define QUARDIR    "quarantine"  /* sub-directory of the files that failed the validation */
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* exit code of a command run by 'std::system' */
+static int ExitCode(int stat)
+{
+#ifdef _WIN32   /* for Windows */
+    return stat;
+#else           /* for Linux or Mac */
+    return (stat != -1 && WIFEXITED(stat)) ? WEXITSTATUS(stat) : -1;
+#endif
+}
+
+/* modification time of a file, 0 if it does not exist */
+static time_t FileTime(const string &file)
+{
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0) return 0;
+
+    return st.st_mtime;
+}
+
+/* status change time of a file (i.e., written, renamed or linked), 0 if it does not exist */
+static time_t FileChange(const string &file)
+{
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0) return 0;
+
+    return st.st_ctime;
+}
+
+/* time of a remote modification time of 'RemoteStat' (i.e., 'Sun,_18_Oct_2026_12:34:50_GMT', 'Oct_18_12:34' or
+   'Oct_18_2025'), 0 if it is unknown */
+static time_t RemoteTime(const string &mtime)
+{
+    static const char *months[12] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+    std::vector<string> fld;
+    size_t ipos = 0;
+    while (ipos <= mtime.size())
+    {
+        size_t jpos = mtime.find('_', ipos);
+        if (jpos == string::npos) jpos = mtime.size();
+        if (jpos > ipos) fld.push_back(mtime.substr(ipos, jpos - ipos));
+        ipos = jpos + 1;
+    }
+    if (fld.size() != 3 && fld.size() != 6) return 0;
+
+    /* HTTP: weekday, day, month, year, time, zone; FTP: month, day, time or year */
+    bool isHttp = fld.size() == 6;
+    string sMon = isHttp ? fld[2] : fld[0], sDay = fld[1], sLast = isHttp ? fld[4] : fld[2];
+    struct tm tt = {};
+    tt.tm_mon = -1;
+    for (int i = 0; i < 12; i++) if (strcasecmp(sMon.c_str(), months[i]) == 0) tt.tm_mon = i;
+    tt.tm_mday = atoi(sDay.c_str());
+    if (tt.tm_mon < 0 || tt.tm_mday < 1) return 0;
+
+    time_t now = time(NULL);
+    bool noYear = !isHttp && sLast.find(':') != string::npos;
+    if (isHttp) tt.tm_year = atoi(fld[3].c_str()) - 1900;
+    else if (noYear) tt.tm_year = gmtime(&now)->tm_year;
+    else tt.tm_year = atoi(sLast.c_str()) - 1900;
+    if (isHttp || noYear) sscanf(sLast.c_str(), "%d:%d:%d", &tt.tm_hour, &tt.tm_min, &tt.tm_sec);
+
+#ifdef _WIN32   /* for Windows */
+    time_t t = _mkgmtime(&tt);
+#else           /* for Linux or Mac */
+    time_t t = timegm(&tt);
+#endif
+    if (t == (time_t)-1) return 0;
+
+    /* the listing shows the year only for the files older than half a year */
+    if (noYear && t > now + 86400)
+    {
+        tt.tm_year--;
+#ifdef _WIN32   /* for Windows */
+        t = _mkgmtime(&tt);
+#else           /* for Linux or Mac */
+        t = timegm(&tt);
+#endif
+    }
+
+    return t;
+}
+
+/* modification date of an FTP listing, i.e., 'Oct_18_2025' for 'Oct 18 12:34' and 'Oct 18 2025' alike, as the
+   listing shows the time of a recent file and the year of a file older than half a year; "-" if it is unknown */
+static string ListDate(const string &sMon, const string &sDay, const string &sLast)
+{
+    time_t t = RemoteTime(sMon + "_" + sDay + "_" + sLast);
+    if (t == 0) return "-";
+    struct tm *tt = gmtime(&t);
+    char buff[32];
+    strftime(buff, sizeof(buff), "%b_%d_%Y", tt);
+
+    return buff;
+}
+
+/* whether a local file without a catalog entry is the version of the remote file: the same size if it is not
+   compressed remotely, otherwise not older than the remote one (true if the remote time is unknown) */
+static bool IsLocalCurrent(const string &landed, const string &file, const catent_t &ent)
+{
+    StringUtil str;
+    if (landed == file && ent.remote == file && ent.size >= 0) return str.FileSize(landed) == ent.size;
+    time_t tRemote = RemoteTime(ent.mtime);
+
+    return tRemote == 0 || FileTime(landed) >= tRemote;
+}
+
+/* the option '--cut-dirs=N ' of 'wget' that drops all the directories of a URL, i.e., 'ftp://host/a/b/c' -> 3 */
+static string CutDirs(const string &url)
+{
+    size_t ipos = url.find("://");
+    ipos = url.find('/', ipos == string::npos ? 0 : ipos + 3);
+    int n = 0;
+    while (ipos != string::npos && ipos + 1 < url.size())
+    {
+        n++;
+        ipos = url.find('/', ipos + 1);
+    }
+
+    return " --cut-dirs=" + to_string(n) + " ";
+}
+
+/* the text of a list with one item per line */
+static string ListText(const std::vector<string> &items)
+{
+    string text;
+    for (const string &item : items) text += item + "\n";
+
+    return text;
+}
+
+/* whether the accept patterns are all exact file names, i.e., without wildcards */
+static bool IsExactNames(const std::vector<string> &patterns)
+{
+    for (const string &pat : patterns)
+    {
+        if (pat.find_first_of("*?[") != string::npos) return false;
+    }
+
+    return true;
+}
+
+/* the 'curl' options that read and write the session cookies of the run, "" if there is no cookie file */
+static string CookieOpt(const string &cookieFile)
+{
+    return cookieFile.empty() ? "" : " -b " + cookieFile + " -c " + cookieFile;
+}
+
+/* remove an empty directory */
+static void RemoveDir(const string &dir)
+{
+#ifdef _WIN32   /* for Windows */
+    _rmdir(dir.c_str());
+#else           /* for Linux or Mac */
+    rmdir(dir.c_str());
+#endif
+}
+
+/* pass the whole lines of the next 'len' bytes of an open file to a line callback, false if it stopped */
+static bool ReadRange(ifstream &in, long long len, const linecb_t &onLine)
+{
+    string line;
+    while (len > 0 && getline(in, line))
+    {
+        len -= (long long)line.size() + 1;
+        while (!line.empty() && line[line.size() - 1] == '\r') line.pop_back();
+        if (!onLine(line.c_str())) return false;
+    }
+
+    return true;
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : init - Get FTP archive for CDDIS, IGN, or WHU
+* @param[I]: none
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void FtpUtil::init()
+{
+    for (int i = 0; i < NARC; i++)
+    {
+        _ftpArchive[i].clear();
+        _httpsArchive[i].clear();
+    }
+
+    _missCls = -1;
+    _rangeTs = _rangeTe = { 0, 0.0 };
+    _storeOn = false;
+    _zstdOn = false;
+    _getStart = 0;
+    _landed.clear();
+    _badCount.clear();
+    _requeue = false;
+    _netSites.clear();
+
+    /* FTP archive for CDDIS */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily");                /* IGS daily observation (30s) files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/hourly");               /* IGS hourly observation (30s) files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/highrate");             /* IGS high-rate observation (1s) files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily");                /* MGEX daily observation (30s) files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/hourly");               /* MGEX hourly observation (30s) files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/highrate");             /* MGEX high-rate observation (1s) files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily");                /* broadcast ephemeris files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products");                  /* IGS SP3 files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products");                  /* IGS CLK files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products");                  /* IGS EOP files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products");                  /* IGS weekly SINEX files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/mgex");             /* MGEX SP3 files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/mgex");             /* MGEX CLK files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/bias");             /* MGEX DCB files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/ionex");            /* global ionosphere map (GIM) files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/ionex");            /* Rate of TEC index (ROTI) files */
+    _ftpArchive[ARC_CDDIS].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/troposphere/zpd");  /* IGS final tropospheric product files */
+
+    /* FTP archive for IGN */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/data");                                         /* IGS daily observation (30s) files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/data/hourly");                                  /* IGS hourly observation (30s) files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/data/highrate");                                /* IGS high-rate observation (1s) files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/data");                                         /* MGEX daily observation (30s) files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/data/hourly");                                  /* MGEX hourly observation (30s) files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/data/highrate");                                /* MGEX high-rate observation (1s) files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/data");                                         /* broadcast ephemeris files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products");                                     /* IGS SP3 files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products");                                     /* IGS CLK files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products");                                     /* IGS EOP files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products");                                     /* IGS weekly SINEX files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products/mgex");                                /* MGEX SP3 files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products/mgex");                                /* MGEX CLK files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products/mgex/dcb");                            /* MGEX DCB files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products/ionosphere");                          /* global ionosphere map (GIM) files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products/ionosphere");                          /* Rate of TEC index (ROTI) files */
+    _ftpArchive[ARC_IGN].push_back("ftp://igs.ign.fr/pub/igs/products/troposphere");                         /* IGS final tropospheric product files */
+
+    /* FTP archive for WHU */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/data/daily");                               /* IGS daily observation (30s) files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/data/hourly");                              /* IGS hourly observation (30s) files */
+    _ftpArchive[ARC_WHU].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/highrate");               /* IGS high-rate observation (1s) files (of CDDIS) */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/data/daily");                               /* MGEX daily observation (30s) files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/data/hourly");                              /* MGEX hourly observation (30s) files */
+    _ftpArchive[ARC_WHU].push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/highrate");               /* MGEX high-rate observation (1s) files (of CDDIS) */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/data/daily");                               /* broadcast ephemeris files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products");                                 /* IGS SP3 files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products");                                 /* IGS CLK files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products");                                 /* IGS EOP files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products");                                 /* IGS weekly SINEX files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products/mgex");                            /* MGEX SP3 files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products/mgex");                            /* MGEX CLK files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products/mgex/dcb");                        /* MGEX DCB files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products/ionex");                           /* global ionosphere map (GIM) files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products/ionex");                           /* Rate of TEC index (ROTI) files */
+    _ftpArchive[ARC_WHU].push_back("ftp://igs.gnsswhu.cn/pub/gps/products/troposphere/new");                 /* IGS final tropospheric product files */
+
+    /* HTTPS archive for CDDIS (the same tree as FTP, the login is read from '.netrc') */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/data/daily");                     /* IGS daily observation (30s) files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/data/hourly");                    /* IGS hourly observation (30s) files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/data/highrate");                  /* IGS high-rate observation (1s) files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/data/daily");                     /* MGEX daily observation (30s) files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/data/hourly");                    /* MGEX hourly observation (30s) files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/data/highrate");                  /* MGEX high-rate observation (1s) files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/data/daily");                     /* broadcast ephemeris files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products");                       /* IGS SP3 files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products");                       /* IGS CLK files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products");                       /* IGS EOP files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products");                       /* IGS weekly SINEX files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products/mgex");                  /* MGEX SP3 files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products/mgex");                  /* MGEX CLK files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products/bias");                  /* MGEX DCB files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products/ionex");                 /* global ionosphere map (GIM) files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products/ionex");                 /* Rate of TEC index (ROTI) files */
+    _httpsArchive[ARC_CDDIS].push_back("https://cddis.nasa.gov/archive/gnss/products/troposphere/zpd");       /* IGS final tropospheric product files */
+} /* end of init */
+
+/**
+* @brief   : SetProtocol - select the protocol (FTP or HTTPS) of the FTP archive in use
+* @param[I]: fopt (FTP options)
+* @param[O]: none
+* @return  : none
+* @note    : the HTTPS tree is used only if the archive has one (see 'arcTable'); if 'ftpRoot' is set (i.e., a
+*            mirror or a local stand-in like 'https://localhost:8443'), it replaces the scheme and host of the
+*            HTTPS tree. Whatever the archive, the HTTP(S) URLs are fetched by 'curl' (see 'FetchCmd')
+**/
+void FtpUtil::SetProtocol(const ftpopt_t *fopt)
+{
+    int arc = fopt->ftpArc;
+    if (fopt->ftpProto != PROTO_HTTPS || arc < 0 || arc >= NARC) return;
+
+    if (arcTable[arc].httpsProto != PROTO_HTTPS || _httpsArchive[arc].size() != _ftpArchive[arc].size())
+    {
+        cout << "*** WARNING(FtpUtil::SetProtocol): no HTTPS tree for FTP archive " << fopt->ftpFrom <<
+            ", FTP is used instead" << endl;
+
+        return;
+    }
+
+    _ftpArchive[arc] = _httpsArchive[arc];
+    string root = fopt->ftpRoot;
+    if (root.empty()) return;
+    while (root.size() > 0 && root[root.size() - 1] == '/') root.erase(root.size() - 1);
+    for (size_t i = 0; i < _ftpArchive[arc].size(); i++)
+    {
+        /* 'https://host/path' -> 'root/path' */
+        string &url = _ftpArchive[arc][i];
+        size_t pos = url.find('/', url.find("://") + 3);
+        if (pos != string::npos) url = root + url.substr(pos);
+    }
+} /* end of SetProtocol */
+
+/**
+* @brief   : ArcUrl - get the remote directory of a product of the FTP archive in use
+* @param[I]: fopt (FTP options)
+* @param[I]: idx (index of the product, IDX_???)
+* @param[I]: ts (the day of the product)
+* @param[I]: sHh (the hour of the sub-daily observation files, i.e., '05', "" for the others)
+* @param[O]: none
+* @return  : the URL of the directory, i.e., 'ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily/2021/032/21d'
+* @note    : the tree of the archive is taken from '_ftpArchive' and the directories under it from the
+*            layout of the archive
+**/
+string FtpUtil::ArcUrl(const ftpopt_t *fopt, int idx, gtime_t ts, const string &sHh)
+{
+    TimeUtil tu;
+    StringUtil str;
+    int yyyy, doy, wwww;
+    tu.time2yrdoy(ts, &yyyy, &doy);
+    tu.time2gpst(ts, &wwww, nullptr);
+
+    string url = _ftpArchive[fopt->ftpArc][idx] + "/";
+    for (const char *p = arcLayout[fopt->ftpArc][idx]; *p; p++)
+    {
+        if (*p != '%' || !p[1])
+        {
+            url += *p;
+            continue;
+        }
+        switch (*++p)
+        {
+        case 'Y': url += str.yyyy2str(yyyy); break;
+        case 'y': url += str.yy2str(tu.yyyy2yy(yyyy)); break;
+        case 'D': url += str.doy2str(doy); break;
+        case 'W': url += str.wwww2str(wwww); break;
+        case 'H': url += sHh; break;
+        default:  url += *p; break;
+        }
+    }
+
+    return url;
+} /* end of ArcUrl */
+
+/**
+* @brief   : FindArc - find the FTP archive by its name
+* @param[I]: name (FTP archive name, i.e., CDDIS, IGN, or WHU, case-insensitive)
+* @param[O]: none
+* @return  : FTP archive (ARC_???), -1 if not found
+* @note    :
+**/
+int FtpUtil::FindArc(const char *name)
+{
+    for (int i = 0; i < NARC; i++)
+    {
+        if (strcasecmp(name, arcTable[i].name) == 0) return i;
+    }
+
+    return -1;
+} /* end of FindArc */
+
+/**
+* @brief   : FindAc - find the analysis center of precise products by its name
+* @param[I]: name (three-char name of analysis center, case-insensitive)
+* @param[O]: none
+* @return  : analysis center (AC_???), -1 if not found
+* @note    :
+**/
+int FtpUtil::FindAc(const char *name)
+{
+    for (int i = 0; i < NAC; i++)
+    {
+        if (strcasecmp(name, acTable[i].name) == 0) return i;
+    }
+
+    return -1;
+} /* end of FindAc */
+
+/**
+* @brief   : IsMgexAc - whether the analysis center provides MGEX products
+* @param[I]: ac (analysis center, AC_???)
+* @param[O]: none
+* @return  : true:MGEX products, false:IGS products
+* @note    :
+**/
+bool FtpUtil::IsMgexAc(int ac)
+{
+    return acTable[ac].isMgex;
+} /* end of IsMgexAc */
+
+/**
+* @brief   : UltraStep - get the step of the ultra-rapid products of the analysis center
+* @param[I]: ac (analysis center, AC_???)
+* @param[O]: none
+* @return  : step in hours (6 for igu, 3 for gfu, 1 for wuu), 24 for final/rapid products
+* @note    :
+**/
+int FtpUtil::UltraStep(int ac)
+{
+    if (ac < 0 || ac >= NAC) return 24;
+
+    return acTable[ac].step;
+} /* end of UltraStep */
+
+/**
+* @brief   : IsAllSites - whether the observation files in the whole directory are downloaded
+* @param[I]: fopt (FTP options)
+* @param[I]: sitOpt (all; the full path of 'site.list')
+* @param[O]: none
+* @return  : true:'all' is selected, false:site-by-site
+* @note    : the in-memory site list (fopt->sites) takes precedence over 'sitOpt'; 'all' is matched as a
+*            whole word without case, so a short site list path (i.e., 'a.lst') is not taken for it
+**/
+bool FtpUtil::IsAllSites(const ftpopt_t *fopt, const string &sitOpt)
+{
+    if (!fopt->sites.empty()) return false;
+
+    return strcasecmp(sitOpt.c_str(), "all") == 0;
+} /* end of IsAllSites */
+
+/**
+* @brief   : GetSiteList - get the site names from the in-memory site list or 'site.list' file
+* @param[I]: fopt (FTP options)
+* @param[I]: sitFile (the full path of 'site.list')
+* @param[O]: sites (site names without duplicates)
+* @return  : true:ok, false:error or 'site.list' is not found
+* @note    : besides the site names, the list may select the sites by wildcard patterns, networks, bounding
+*            boxes and exclusions (see 'SiteUtil::Parse'), which are resolved against the remote listings of
+*            the networks, the positions of the IGS station SINEX and those in the inventory of the current
+*            directory
+**/
+bool FtpUtil::GetSiteList(const ftpopt_t *fopt, const string &sitFile, std::vector<string> &sites)
+{
+    sites.clear();
+    std::vector<string> lines;
+    if (!fopt->sites.empty()) lines = fopt->sites;
+    else
+    {
+        if (access(sitFile.c_str(), 0) == -1) return false;
+
+        ifstream sitLst(sitFile.c_str());
+        if (!sitLst.is_open())
+        {
+            cerr << "*** ERROR(FtpUtil::GetSiteList): open site.list = " << sitFile << " file failed, please check it" << endl;
+
+            return false;
+        }
+
+        string line;
+        while (getline(sitLst, line))
+        {
+            if (!line.empty() && line[line.size() - 1] == '\r') line.pop_back();
+            lines.push_back(line);
+        }
+
+        /* close 'site.list' */
+        sitLst.close();
+    }
+
+    SiteUtil sel;
+    sel.Parse(lines);
+    std::vector<string> nets;
+    sel.Networks(nets);
+    for (const string &net : nets)
+    {
+        std::vector<string> netSites;
+        if (NetworkSites(fopt, net, netSites)) sel.AddNetwork(net, netSites);
+        else cout << "*** WARNING(FtpUtil::GetSiteList): the sites of network " << net << " are not available" << endl;
+        if (net == "euref")
+        {
+            cout << "*** INFO(FtpUtil::GetSiteList): '@euref' only selects the sites, their files are downloaded from " <<
+                arcTable[fopt->ftpArc >= 0 && fopt->ftpArc < NARC ? fopt->ftpArc : ARC_CDDIS].name << endl;
+        }
+    }
+    if (sel.HasBox())
+    {
+        string snxFile;
+        if (!StationSinex(fopt, snxFile) || sel.AddSinex(snxFile) <= 0)
+            cout << "*** WARNING(FtpUtil::GetSiteList): the positions of the IGS stations are not available" << endl;
+
+        /* the sites out of the IGS network are known by the inventory of the files downloaded before */
+        InventUtil inv;
+        inv.Load(".");
+        std::vector<invent_t> ents;
+        inv.Entries(ents);
+        for (const invent_t &ent : ents) sel.AddPosition(ent.site, ent.pos);
+    }
+    sel.Resolve(sites);
+
+    return true;
+} /* end of GetSiteList */
+
+/**
+* @brief   : NetworkSites - get the sites of a network on the day of the current product
+* @param[I]: fopt (FTP options)
+* @param[I]: net (network, i.e., 'igs', 'mgex' or 'euref')
+* @param[O]: sites (site names in lower case)
+* @return  : true:ok, false:the remote directory cannot be listed
+* @note    : the sites are those of the daily observation files in the remote directory of the network; the
+*            listing is taken once per run and cached in the directory ('.good_sites_igs2021032'), a dry run
+*            ('plan') uses the cached listing only. The shards of a run ('shard' = 1 i/K) take the sites from
+*            one listing ('.good_sites_igs2021032_of4'), resolved under a lock by the first of them and kept
+*            until 'FtpMerge', so that they agree on the sites to be spread. The EUREF sites are listed at BKG,
+*            but they are downloaded from the archive of 'ftpDownloading' like any other site, so '@euref' is a
+*            filter of the sites only
+**/
+bool FtpUtil::NetworkSites(const ftpopt_t *fopt, const string &net, std::vector<string> &sites)
+{
+    sites.clear();
+    TimeUtil tu;
+    int yyyy, doy;
+    tu.time2yrdoy(_missTs, &yyyy, &doy);
+    StringUtil str;
+    string sYyyy = str.yyyy2str(yyyy);
+    string sYy = str.yy2str(tu.yyyy2yy(yyyy));
+    string sDoy = str.doy2str(doy);
+    string key = net + sYyyy + sDoy;
+    auto it = _netSites.find(key);
+    if (it != _netSites.end())
+    {
+        sites = it->second;
+
+        return true;
+    }
+
+    /* the listing of a day long ago does not change any more, the one of a recent day grows until the files are in */
+    string cacheFile = ".good_sites_" + key;
+    bool isOld = tu.TimeDiff(tu.TimeNow(), _missTs) > LISTDAYS * 86400.0;
+
+    /* the listing of the shards is taken as it is, the lock is held until it is written */
+    LockUtil lock;
+    string shardFile;
+    if (fopt->shardCnt > 1)
+    {
+        shardFile = cacheFile + "_of" + to_string(fopt->shardCnt);
+        lock.Lock(shardFile + ".lock", true);
+        time_t mt = FileTime(shardFile);
+        if (mt > 0 && (isOld || difftime(time(nullptr), mt) < SHARDAGE) && str.ReadLines(shardFile, sites))
+        {
+            _netSites[key] = sites;
+
+            return true;
+        }
+    }
+
+    time_t mt = FileTime(cacheFile);
+    if (mt > 0 && (isOld || difftime(time(nullptr), mt) < LISTAGE) && str.ReadLines(cacheFile, sites))
+    {
+        if (!shardFile.empty()) str.WriteFile(shardFile, ListText(sites));
+        _netSites[key] = sites;
+
+        return true;
+    }
+    if (fopt->plan) return false;
+
+    int arc = fopt->ftpArc >= 0 && fopt->ftpArc < NARC ? fopt->ftpArc : ARC_CDDIS;
+    string url;
+    if (net == "euref") url = string(EUREFARC) + "/" + sYyyy + "/" + sDoy;
+    else
+    {
+        url = _ftpArchive[arc][net == "mgex" ? IDX_OBMD : IDX_OBSD] + "/" + sYyyy + "/" + sDoy;
+        if (arc != ARC_IGN) url += "/" + sYy + "d";
+    }
+    std::vector<string> names;
+    if (!RemoteList(fopt, url, names)) return false;
+
+    /* short names 'abmf0320.21d.Z' for IGS, long names 'ABMF00GLP_R_20210320000_01D_30S_MO.crx.gz' for MGEX and EUREF */
+    std::unordered_set<string> siteSet;
+    for (const string &name : names)
+    {
+        bool isShort = name.size() >= 12 && name.substr(4, 4) == sDoy + "0" && name.find("." + sYy + "d") == 8;
+        bool isLong = name.size() >= 38 && name[9] == '_' && name.substr(12, 7) == sYyyy + sDoy &&
+            name.find("_01D_") != string::npos && name.find("_MO.") != string::npos;
+        if (net == "igs" ? !isShort : !isLong) continue;
+        string site = name.substr(0, 4);
+        str.ToLower(site);
+        if (siteSet.insert(site).second) sites.push_back(site);
+    }
+
+    str.WriteFile(cacheFile, ListText(sites));
+    if (!shardFile.empty()) str.WriteFile(shardFile, ListText(sites));
+    _netSites[key] = sites;
+    cout << "*** INFO(FtpUtil::NetworkSites): " << sites.size() << " sites of network " << net << " are listed in " <<
+        url << endl;
+
+    return true;
+} /* end of NetworkSites */
+
+/**
+* @brief   : StationSinex - get the IGS station SINEX with the positions of the stations
+* @param[I]: fopt (FTP options)
+* @param[O]: file (local file name of the station SINEX)
+* @return  : true:ok, false:not available
+* @note    : the SINEX of the current and the former IGS stations is taken once a week and cached in the
+*            directory ('.good_sites_snx'), a dry run ('plan') uses the cached one only
+**/
+bool FtpUtil::StationSinex(const ftpopt_t *fopt, string &file)
+{
+    file = ".good_sites_snx";
+    time_t mt = FileTime(file);
+    if (mt > 0 && (fopt->plan || difftime(time(nullptr), mt) < STAAGE)) return true;
+    if (fopt->plan) return false;
+
+    StringUtil str;
+    string tmpFile = str.TmpName(file);
+    string cmd = CurlCmd(fopt, 1) + " --retry 2 -m 600 -o " + tmpFile + " " + STASNX;
+    if (ExitCode(std::system(cmd.c_str())) != 0 || str.FileSize(tmpFile) <= 0)
+    {
+        remove(tmpFile.c_str());
+
+        return mt > 0;  /* an outdated one is still good for the positions */
+    }
+    remove(file.c_str());
+    rename(tmpFile.c_str(), file.c_str());
+    cout << "*** INFO(FtpUtil::StationSinex): the positions of the IGS stations are taken from " << STASNX << endl;
+
+    return true;
+} /* end of StationSinex */
+
+/**
+* @brief   : Quarters - get the 15-minute files of an hour that overlap the time range requested
+* @param[I]: ts (start time of the day)
+* @param[I]: hh (hour)
+* @param[O]: none
+* @return  : bit mask of the 15-minute files (bit 0: 'hh:00', ..., bit 3: 'hh:45'), 0xF without time range
+* @note    : an hourly file is needed if the mask is not zero
+**/
+int FtpUtil::Quarters(gtime_t ts, int hh)
+{
+    if (_rangeTe.mjd == 0) return 0xF;
+
+    TimeUtil tu;
+    int mask = 0;
+    for (int k = 0; k < 4; k++)
+    {
+        gtime_t t0 = { ts.mjd, hh * 3600.0 + k * 900.0 };
+        gtime_t t1 = tu.TimeAdd(t0, 900.0);
+        if (tu.TimeDiff(t1, _rangeTs) > 0.0 && tu.TimeDiff(_rangeTe, t0) > 0.0) mask |= 1 << k;
+    }
+
+    return mask;
+} /* end of Quarters */
+
+/**
+* @brief   : QuarterPatterns - get the accept patterns of the 15-minute files of an hour in the time range requested
+* @param[I]: ts (start time of the day)
+* @param[I]: hh (hour)
+* @param[I]: head (part of the pattern before the minutes, i.e., '*032o')
+* @param[I]: tail (part of the pattern after the minutes, i.e., '.21d.*')
+* @param[O]: none
+* @return  : the patterns separated by ',' for the option '-A' of 'wget'
+* @note    :
+**/
+string FtpUtil::QuarterPatterns(gtime_t ts, int hh, const string &head, const string &tail)
+{
+    static const char *minu[] = { "00", "15", "30", "45" };
+    int mask = Quarters(ts, hh);
+    string pats;
+    for (int k = 0; k < 4; k++)
+    {
+        if ((mask >> k & 1) == 0) continue;
+        if (!pats.empty()) pats += ",";
+        pats += head + minu[k] + tail;
+    }
+
+    return pats;
+} /* end of QuarterPatterns */
+
+/**
+* @brief   : JobOpt - get the FTP options of one job (one product for one day)
+* @param[I]: popt (processing options of the day)
+* @param[I]: fopt (FTP options)
+* @param[I]: get (product, GET_???)
+* @param[O]: jopt (FTP options of the job)
+* @return  : none
+* @note    : the bandwidth budget, the conversion filter and the hours in the time range are set
+**/
+void FtpUtil::JobOpt(const prcopt_t *popt, const ftpopt_t *fopt, int get, ftpopt_t &jopt)
+{
+    /* the bandwidth budget of the job class: backfill for the days long past, interactive/real-time otherwise */
+    jopt = *fopt;
+    TimeUtil tu;
+    bool isBack = tu.TimeDiff(tu.TimeNow(), popt->ts) > (fopt->bwAge + 1) * 86400.0;
+    jopt.bwRate = isBack ? fopt->bwBack : fopt->bwInter;
+    jopt.bwIsBack = isBack;
+    if (jopt.bwRate > 0)
+    {
+        _jobQr = string(fopt->qr) + " --limit-rate=" + to_string(BwLimit(&jopt, 1)) + "k";
+        jopt.qr = _jobQr.c_str();
+    }
+
+    /* the system and signal filter of the observation product at conversion */
+    if (fopt->fltSys[get][0] != '\0') jopt.decSys = fopt->fltSys[get];
+    jopt.decCodes = fopt->fltCodes[get];
+
+    /* with a time range, the hours of the sub-daily files are the ones that overlap it (the 15-minute files by
+       'Quarters'), in place of the hours of the configuration */
+    _rangeTs = popt->rangeTs;
+    _rangeTe = popt->rangeTe;
+    if (_rangeTe.mjd != 0)
+    {
+        std::vector<int> keep;
+        for (int h = 0; h < 24; h++)
+        {
+            if (Quarters(popt->ts, h) != 0) keep.push_back(h);
+        }
+        jopt.hhObs = jopt.hhObm = jopt.hhObg = jopt.hhObh = jopt.hhNav = keep;
+    }
+} /* end of JobOpt */
+
+/**
+* @brief   : BwLimit - get the rate limit of one transfer under the bandwidth budget of the job
+* @param[I]: fopt (FTP options of the job, see 'JobOpt')
+* @param[I]: n (number of the concurrent transfers of the process)
+* @param[O]: none
+* @return  : the limit in KB/s (0: unlimited)
+* @note    : the budget is split over the shards and the concurrent transfers, so the processes of one
+*            sharded run never exceed it together; the shared bucket ('BucketUtil') paces the batches of
+*            all the processes on top of it
+**/
+int FtpUtil::BwLimit(const ftpopt_t *fopt, int n)
+{
+    if (fopt->bwRate <= 0) return 0;
+
+    int share = fopt->bwRate / ((fopt->shardCnt > 1 ? fopt->shardCnt : 1) * (n > 1 ? n : 1));
+
+    return share > 0 ? share : 1;
+} /* end of BwLimit */
+
+/**
+* @brief   : StoreScope - get the scope of the product names of a product in the store
+* @param[I]: fopt (FTP options of the job, see 'JobOpt')
+* @param[I]: get (product, GET_???)
+* @param[O]: none
+* @return  : the scope, i.e., 'orbclk' or 'obs/gdc.cddis.eosdis.nasa.gov/1a2b3c4d'
+* @note    : the observation files of the sources share their names, and the settings of the conversion
+*            (decimation, system and code filters, compact or zstd form) change their content but not their
+*            names, so they are scoped by the host and the hash of the settings
+**/
+string FtpUtil::StoreScope(const ftpopt_t *fopt, int get)
+{
+    if (get < 0 || get >= NGET) return "";
+    if (get > GET_OBH) return getNames[get];
+
+    StringUtil str;
+    string settings = to_string(fopt->decimate) + "|" + fopt->decSys + "|" + fopt->decCodes + "|" +
+        (fopt->keepCompact ? "1" : "0") + (fopt->zstdSeek ? "1" : "0");
+    char hash[16];
+    snprintf(hash, sizeof(hash), "%08x", str.Fnv1a(settings, false));
+
+    return string(getNames[get]) + "/" + PlanHost(fopt, get) + "/" + hash;
+} /* end of StoreScope */
+
+/**
+* @brief     : ShardJob - keep the part of one job (one product for one day) of the shard of this process
+* @param[I]  : popt (processing options of the day)
+* @param[I]  : get (product, GET_???)
+* @param[I/O]: jopt (FTP options of the job, see 'JobOpt'; the sites of the shard are set as the in-memory site list)
+* @return    : true:the job (or some of its sites) is downloaded by this process, false:by the other shards
+* @note      : the sites of an observation product are spread over the shards (see 'PlanUtil::IsMine'); the
+*              other products, and the observation products whose sites are unknown (i.e., 'all' of GA),
+*              go to one shard per day as a whole
+**/
+bool FtpUtil::ShardJob(const prcopt_t *popt, int get, ftpopt_t &jopt)
+{
+    if (jopt.shardCnt <= 1) return true;
+
+    TimeUtil tu;
+    StringUtil str;
+    int yyyy, doy;
+    tu.time2yrdoy(popt->ts, &yyyy, &doy);
+    string day = str.yyyy2str(yyyy) + str.doy2str(doy);
+    if (get > GET_OBH) return _plan.IsMine(getNames[get], day, "");
+
+    const char *dirs[] = { popt->obsDir, popt->obmDir, popt->obcDir, popt->obgDir, popt->obhDir };
+    const char *opts[] = { jopt.obsOpt, jopt.obmOpt, jopt.obcOpt, jopt.obgOpt, jopt.obhOpt };
+    int typs[] = { jopt.obsTyp, jopt.obmTyp, jopt.obcTyp, jopt.obgTyp, jopt.obhTyp };
+    int typ = typs[get];
+    if (typ < 0 || typ > OBS_1S) return _plan.IsMine(getNames[get], day, "");
+
+    /* the sites as the downloading resolves them, in the directory where it does */
+    string subDir = string(dirs[get]) + (char)FILEPATHSEP + obsTypNames[typ];
+    if (!jopt.plan && access(subDir.c_str(), 0) == -1)
+    {
+        /* If the directory does not exist, creat it */
+#ifdef _WIN32   /* for Windows */
+        string cmd = "mkdir " + subDir;
+#else           /* for Linux or Mac */
+        string cmd = "mkdir -p " + subDir;
+#endif
+        std::system(cmd.c_str());
+    }
+    if (access(subDir.c_str(), 0) == 0)
+    {
+#ifdef _WIN32   /* for Windows */
+        _chdir(subDir.c_str());
+#else           /* for Linux or Mac */
+        chdir(subDir.c_str());
+#endif
+    }
+    SetMissClass(popt->ts, -1);
+    std::vector<string> sites;
+    bool listed;
+    if (IsAllSites(&jopt, opts[get])) listed = (get == GET_OBS || get == GET_OBM) &&
+        NetworkSites(&jopt, get == GET_OBS ? "igs" : "mgex", sites);
+    else listed = GetSiteList(&jopt, opts[get], sites);
+    if (!listed) return _plan.IsMine(getNames[get], day, "");
+
+    std::vector<string> mine;
+    for (const string &site : sites)
+    {
+        if (_plan.IsMine(getNames[get], day, site)) mine.push_back(site);
+    }
+    if (mine.empty()) return false;
+    jopt.sites = mine;
+
+    return true;
+} /* end of ShardJob */
+
+/**
+* @brief   : PlanKind - get the kind of the files of a product for the size history
+* @param[I]: fopt (FTP options)
+* @param[I]: get (product, GET_???)
+* @param[O]: none
+* @return  : the kind, i.e., 'obs.daily', 'obm.highrate', 'nav.daily' or 'orbclk'
+* @note    :
+**/
+string FtpUtil::PlanKind(const ftpopt_t *fopt, int get)
+{
+    if (get < 0 || get >= NGET) return "";
+
+    string kind = getNames[get];
+    int typs[] = { fopt->obsTyp, fopt->obmTyp, fopt->obcTyp, fopt->obgTyp, fopt->obhTyp };
+    if (get <= GET_OBH && typs[get] >= 0 && typs[get] <= OBS_1S) kind += string(".") + obsTypNames[typs[get]];
+    else if (get == GET_NAV && fopt->navTyp >= 0 && fopt->navTyp <= NAV_RTNAV) kind += string(".") + navTypNames[fopt->navTyp];
+
+    return kind;
+} /* end of PlanKind */
+
+/**
+* @brief   : PlanHost - get the host from which a product is downloaded
+* @param[I]: fopt (FTP options)
+* @param[I]: get (product, GET_???)
+* @param[O]: none
+* @return  : the host name, i.e., 'gdc.cddis.eosdis.nasa.gov'
+* @note    :
+**/
+string FtpUtil::PlanHost(const ftpopt_t *fopt, int get)
+{
+    int arc = fopt->ftpArc >= 0 && fopt->ftpArc < NARC ? fopt->ftpArc : ARC_CDDIS;
+    int idx = -1;
+    switch (get)
+    {
+    case GET_OBS:    idx = IDX_OBSD + (fopt->obsTyp <= OBS_HIGHRATE ? fopt->obsTyp : 0); break;
+    case GET_OBM:    idx = IDX_OBMD + (fopt->obmTyp <= OBS_HIGHRATE ? fopt->obmTyp : 0); break;
+    case GET_OBC:    return "saegnss2.curtin.edu";
+    case GET_OBG:    return "ftp.data.gnss.ga.gov.au";
+    case GET_OBH:    return "ftp.geodetic.gov.hk";
+    case GET_NAV:    idx = IDX_NAV; break;
+    case GET_ORBCLK: idx = IsMgexAc(fopt->orbClkAc) ? IDX_SP3M : IDX_SP3; break;
+    case GET_EOP:    idx = IDX_EOP; break;
+    case GET_SNX:    idx = IDX_SNX; break;
+    case GET_DCB:    idx = IDX_DCBM; break;
+    case GET_ION:    idx = IDX_ION; break;
+    case GET_ROTI:   idx = IDX_ROTI; break;
+    case GET_TRP:    idx = IDX_ZTD; break;
+    case GET_RTORBCLK:
+    case GET_RTBIAS: return "www.ppp-wizard.net";
+    case GET_ATX:    return "files.igs.org";
+    }
+    if (idx < 0 || (size_t)idx >= _ftpArchive[arc].size()) return "-";
+
+    return _rate.Host(_ftpArchive[arc][idx]);
+} /* end of PlanHost */
+
+/**
+* @brief   : PlanGet - expand one job (one product for one day) into the planned requests
+* @param[I]: popt (processing options of the day)
+* @param[I]: fopt (FTP options of the job, see 'JobOpt')
+* @param[I]: get (product, GET_???)
+* @param[O]: none
+* @return  : none
+* @note    : the observation files are expanded site by site and hour by hour (15 minutes for the high-rate
+*            files) with their local names, the other products into their local names by 'PlanFiles'.
+*            Nothing is downloaded, the sites of 'all' are taken from the cached network listing only
+**/
+void FtpUtil::PlanGet(const prcopt_t *popt, const ftpopt_t *fopt, int get)
+{
+    string kind = PlanKind(fopt, get), host = PlanHost(fopt, get);
+    TimeUtil tu;
+    StringUtil str;
+    int yyyy, doy;
+    tu.time2yrdoy(popt->ts, &yyyy, &doy);
+    string sYy = str.yy2str(tu.yyyy2yy(yyyy));
+    string sDoy = str.doy2str(doy);
+    char sep = (char)FILEPATHSEP;
+
+    if (get <= GET_OBH)
+    {
+        const char *dirs[] = { popt->obsDir, popt->obmDir, popt->obcDir, popt->obgDir, popt->obhDir };
+        const char *opts[] = { fopt->obsOpt, fopt->obmOpt, fopt->obcOpt, fopt->obgOpt, fopt->obhOpt };
+        int typs[] = { fopt->obsTyp, fopt->obmTyp, fopt->obcTyp, fopt->obgTyp, fopt->obhTyp };
+        const std::vector<int> *hhs[] = { &fopt->hhObs, &fopt->hhObm, nullptr, &fopt->hhObg, &fopt->hhObh };
+        int typ = typs[get];
+        if (typ < 0 || typ > OBS_1S) return;
+        string subDir = string(dirs[get]) + sep + obsTypNames[typ];
+
+        /* the files of one site: the hour directory and the session of the file name, i.e., ('14', 'o30') */
+        static const char *minu[] = { "00", "15", "30", "45" };
+        std::vector<std::pair<string, string> > sess;
+        if (typ == OBS_DAILY || typ == OBS_30S || hhs[get] == nullptr) sess.push_back(std::make_pair(string(""), string("0")));
+        else
+        {
+            for (int hh : *hhs[get])
+            {
+                string sch(1, (char)('a' + hh));
+                int qmask = typ == OBS_HIGHRATE ? Quarters(popt->ts, hh) : 0x1;
+                for (int k = 0; k < 4; k++)
+                {
+                    if ((qmask >> k & 1) == 0) continue;
+                    sess.push_back(std::make_pair(str.hh2str(hh), sch + (typ == OBS_HIGHRATE ? minu[k] : "")));
+                }
+            }
+        }
+
+        /* the sites as the downloading resolves them, in the directory where it does */
+        SetMissClass(popt->ts, -1);
+        if (access(subDir.c_str(), 0) == 0)
+        {
+#ifdef _WIN32   /* for Windows */
+            _chdir(subDir.c_str());
+#else           /* for Linux or Mac */
+            chdir(subDir.c_str());
+#endif
+        }
+        std::vector<string> sites;
+        if (IsAllSites(fopt, opts[get]))
+        {
+            if ((get != GET_OBS && get != GET_OBM) || !NetworkSites(fopt, get == GET_OBS ? "igs" : "mgex", sites))
+            {
+                _plan.Unlisted(kind, host);
+
+                return;
+            }
+        }
+        else if (!GetSiteList(fopt, opts[get], sites)) return;
+
+        for (string site : sites)
+        {
+            str.ToLower(site);
+            int present = 0;
+            for (const std::pair<string, string> &ss : sess)
+            {
+                string path = subDir + (ss.first.empty() ? "" : sep + ss.first) + sep +
+                    ObsName(fopt, site + sDoy + ss.second + "." + sYy + "o");
+                if (!LandedFile(path).empty()) present++;
+            }
+            _plan.Add(kind, host, (int)sess.size(), present);
+        }
+
+        return;
+    }
+
+    /* the other products: the local files that the downloading lands for the day */
+    std::vector<string> paths;
+    if (!PlanFiles(popt, fopt, get, paths))
+    {
+        _plan.Unlisted(kind, host);
+
+        return;
+    }
+    if (paths.empty()) return;
+
+    int present = 0;
+    for (const string &path : paths)
+    {
+        if (!LandedFile(path).empty()) present++;
+    }
+    _plan.Add(kind, host, (int)paths.size(), present);
+} /* end of PlanGet */
+
+/**
+* @brief   : PlanFiles - get the local files of a product (other than the observations) for one day
+* @param[I]: popt (processing options of the day)
+* @param[I]: fopt (FTP options of the job, see 'JobOpt')
+* @param[I]: get (product, GET_???)
+* @param[O]: paths (full paths of the files, in the directories where the downloading lands them)
+* @return  : true:ok, false:the files depend on a site list of 'all', which is not known before downloading
+* @note    : the names follow those the getters (i.e., 'GetOrbClk') report by 'NotifyFile', so that a file
+*            of another day or another analysis center in the same directory is not taken as present
+**/
+bool FtpUtil::PlanFiles(const prcopt_t *popt, const ftpopt_t *fopt, int get, std::vector<string> &paths)
+{
+    paths.clear();
+    TimeUtil tu;
+    StringUtil str;
+    int yyyy, doy, wwww;
+    tu.time2yrdoy(popt->ts, &yyyy, &doy);
+    int dow = tu.time2gpst(popt->ts, &wwww, nullptr);
+    string sYyyy = str.yyyy2str(yyyy);
+    string sYy = str.yy2str(tu.yyyy2yy(yyyy));
+    string sDoy = str.doy2str(doy);
+    string sWwwd = str.wwww2str(wwww) + to_string(dow);
+    string sep(1, (char)FILEPATHSEP);
+
+    /* the GPS week and day of the day itself, and of the days before and after if they are downloaded too */
+    std::vector<string> wwwds(1, sWwwd);
+    bool around = fopt->minusAdd1day && (get == GET_RTORBCLK || (get == GET_ORBCLK && UltraStep(fopt->orbClkAc) >= 24));
+    for (int k = -1; around && k <= 1; k += 2)
+    {
+        int w, d = tu.time2gpst(tu.TimeAdd(popt->ts, k * 86400.0), &w, nullptr);
+        wwwds.push_back(str.wwww2str(w) + to_string(d));
+    }
+
+    switch (get)
+    {
+    case GET_NAV:
+        {
+            string nOpt(fopt->navOpt);
+            str.ToLower(nOpt);
+            string dayDir = string(popt->navDir) + sep + "daily" + sep;
+            if (fopt->navTyp == NAV_DAILY)
+            {
+                if (nOpt == "gps") paths.push_back(dayDir + "brdc" + sDoy + "0." + sYy + "n");
+                else if (nOpt == "glo") paths.push_back(dayDir + "brdc" + sDoy + "0." + sYy + "g");
+                else if (nOpt == "mixed") paths.push_back(dayDir + "brdm" + sDoy + "0." + sYy + "p");
+            }
+            else if (fopt->navTyp == NAV_RTNAV) paths.push_back(dayDir + "brdm" + sDoy + "z." + sYy + "p");
+            else if (fopt->navTyp == NAV_HOURLY)
+            {
+                /* the local suffixes of the short ('n', 'g') and long ('gn', 'rn', ...) names of each system */
+                std::vector<string> sufs;
+                if (nOpt == "gps") sufs = { "n", "gn" };
+                else if (nOpt == "glo") sufs = { "g", "rn" };
+                else if (nOpt == "bds") sufs = { "cn" };
+                else if (nOpt == "gal") sufs = { "en" };
+                else if (nOpt == "qzs") sufs = { "jn" };
+                else if (nOpt == "irn") sufs = { "in" };
+                else if (nOpt == "mixed") sufs = { "mn" };
+                else if (nOpt == "all") sufs = { "n", "gn", "g", "rn", "cn", "en", "jn", "in", "mn" };
+
+                string sitFile = fopt->get[GET_OBS] || !fopt->get[GET_OBM] ? fopt->obsOpt : fopt->obmOpt;
+                std::vector<string> sites;
+                if (!GetSiteList(fopt, sitFile, sites)) return true;
+                for (string site : sites)
+                {
+                    str.ToLower(site);
+                    for (int hh : fopt->hhNav)
+                    {
+                        string head = string(popt->navDir) + sep + "hourly" + sep + str.hh2str(hh) + sep + site +
+                            sDoy + (char)('a' + hh) + "." + sYy;
+                        for (const string &suf : sufs) paths.push_back(head + suf);
+                    }
+                }
+            }
+        }
+        break;
+    case GET_ORBCLK:
+        {
+            string ac(fopt->orbClkOpt);
+            int acId = fopt->orbClkAc;
+            if (acId < 0 || acId >= NAC) break;
+            string sp3Dir = string(popt->sp3Dir) + sep, clkDir = string(popt->clkDir) + sep;
+            if (UltraStep(acId) < 24)
+            {
+                for (int hh : fopt->hhOrbClk)
+                {
+                    if (acId == AC_WUU) paths.push_back(sp3Dir + "WUM0MGXULA_" + sYyyy + sDoy + str.hh2str(hh) +
+                        "00_01D_05M_ORB.SP3");
+                    else paths.push_back(sp3Dir + ac + sWwwd + "_" + str.hh2str(hh) + ".sp3");
+                }
+                break;
+            }
+            for (const string &wwwd : wwwds)
+            {
+                if (IsMgexAc(acId))
+                {
+                    /* the MGEX long names are renamed to the short ones */
+                    paths.push_back(sp3Dir + acTable[acId].name + wwwd + ".sp3");
+                    paths.push_back(clkDir + acTable[acId].name + wwwd + ".clk");
+                }
+                else
+                {
+                    paths.push_back(sp3Dir + ac + wwwd + (acId == AC_COD ? ".eph" : ".sp3"));
+                    paths.push_back(clkDir + ac + wwwd + (acId == AC_COD ? ".clk_05s" : (acId == AC_IGS ? ".clk_30s" : ".clk")));
+                }
+            }
+        }
+        break;
+    case GET_EOP:
+        {
+            string ac(fopt->eopOpt);
+            int acId = fopt->eopAc;
+            if (acId < 0 || acId >= NAC || IsMgexAc(acId)) break;
+            string eopDir = string(popt->eopDir) + sep;
+            if (UltraStep(acId) < 24)
+            {
+                for (int hh : fopt->hhEop) paths.push_back(eopDir + ac + sWwwd + "_" + str.hh2str(hh) + ".erp");
+            }
+            else if (acId == AC_IGR) paths.push_back(eopDir + ac + sWwwd + ".erp");
+            else paths.push_back(eopDir + ac + str.wwww2str(wwww) + "7.erp");
+        }
+        break;
+    case GET_SNX:
+        paths.push_back(string(popt->snxDir) + sep + "igs" + str.wwww2str(wwww) + ".snx");
+        break;
+    case GET_DCB:
+        {
+            /* the CODE DCB files are monthly, 'P2C2yymm_RINEX.DCB' is renamed to 'P2C2yymm.DCB' */
+            double date[6];
+            tu.time2ymdhms(popt->ts, date);
+            string yymm = sYy + str.mm2str((int)date[1]);
+            string dcbDir = string(popt->dcbDir) + sep;
+            paths.push_back(dcbDir + "P1P2" + yymm + ".DCB");
+            paths.push_back(dcbDir + "P1C1" + yymm + ".DCB");
+            paths.push_back(dcbDir + "P2C2" + yymm + ".DCB");
+            paths.push_back(dcbDir + "CAS0MGXRAP_" + sYyyy + sDoy + "0000_01D_01D_DCB.BSX");
+        }
+        break;
+    case GET_ION:
+        {
+            string ac(fopt->ionOpt);
+            str.ToLower(ac);
+            paths.push_back(string(popt->ionDir) + sep + ac + "g" + sDoy + "0." + sYy + "i");
+        }
+        break;
+    case GET_ROTI:
+        paths.push_back(string(popt->ionDir) + sep + "roti" + sDoy + "0." + sYy + "f");
+        break;
+    case GET_TRP:
+        if (fopt->trpAc == AC_IGS)
+        {
+            /* the IGS tropospheric product is site-specific, of the sites of 'getObs' (or 'getObm') */
+            string sitFile = fopt->get[GET_OBS] || !fopt->get[GET_OBM] ? fopt->obsOpt : fopt->obmOpt;
+            if (IsAllSites(fopt, sitFile)) return false;
+            std::vector<string> sites;
+            if (!GetSiteList(fopt, sitFile, sites)) break;
+            for (string site : sites)
+            {
+                str.ToLower(site);
+                paths.push_back(string(popt->ztdDir) + sep + site + sDoy + "0." + sYy + "zpd");
+            }
+        }
+        else if (fopt->trpAc == AC_COD) paths.push_back(string(popt->ztdDir) + sep + "COD" + sWwwd + ".TRO");
+        break;
+    case GET_RTORBCLK:
+        for (const string &wwwd : wwwds)
+        {
+            paths.push_back(string(popt->sp3Dir) + sep + "cnt" + wwwd + ".sp3");
+            paths.push_back(string(popt->clkDir) + sep + "cnt" + wwwd + ".clk");
+        }
+        break;
+    case GET_RTBIAS:
+        paths.push_back(string(popt->biaDir) + sep + "cnt" + sWwwd + ".bia");
+        break;
+    case GET_ATX:
+        paths.push_back(string(popt->tblDir) + sep + "igs14.atx");
+        break;
+    }
+
+    return true;
+} /* end of PlanFiles */
+
+/**
+* @brief   : NotifyFile - report one downloaded (or failed) file to the completion callback
+* @param[I]: fopt (FTP options)
+* @param[I]: file (file name in the current directory)
+* @param[O]: none
+* @return  : none
+* @note    : the file is regarded as landed if it (or its seekable zstd version) exists; with 'validate' a file
+*            changed in this run is held (with its lock) until 'ValidateFiles'
+**/
+void FtpUtil::NotifyFile(const ftpopt_t *fopt, const string &file)
+{
+    string landed = LandedFile(file);
+    if (_zstdOn && landed == file) landed = Recompress(fopt, file);
+    if (fopt->negCache) UpdateMissing(file, !landed.empty());
+
+    /* the files kept from the runs before are not validated again, neither are the ones linked by a symbolic link */
+    if (fopt->validate && !landed.empty() && FileChange(landed) >= _getStart)
+    {
+        char cwd[MAXSTRPATH] = { '\0' };
+#ifdef _WIN32   /* for Windows */
+        _getcwd(cwd, MAXSTRPATH);
+#else           /* for Linux or Mac */
+        if (getcwd(cwd, MAXSTRPATH) == nullptr) cwd[0] = '\0';
+#endif
+        landed_t lf = { cwd, file, landed };
+        _landed.push_back(lf);
+
+        return;
+    }
+    ReportFile(fopt, file, landed);
+} /* end of NotifyFile */
+
+/**
+* @brief   : ReportFile - put one landed file into the store, release its lock and report it to the callback
+* @param[I]: fopt (FTP options)
+* @param[I]: file (file name in the current directory)
+* @param[I]: landed (name under which it is kept, "" if it failed)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void FtpUtil::ReportFile(const ftpopt_t *fopt, const string &file, const string &landed)
+{
+    bool ok = !landed.empty();
+    if (!ok) _nFailed++;
+    if (ok && _storeOn)
+    {
+        _store.Put(landed);
+        string idxFile = _index.IdxName(landed);
+        if (access(idxFile.c_str(), 0) == 0) _store.Put(idxFile);
+    }
+    _lock.Unlock(LockFile(file));
+    if (!fopt->onFile) return;
+
+    char cwd[MAXSTRPATH] = { '\0' };
+#ifdef _WIN32   /* for Windows */
+    _getcwd(cwd, MAXSTRPATH);
+#else           /* for Linux or Mac */
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) cwd[0] = '\0';
+#endif
+    string path = ok ? landed : file;
+    if (cwd[0] != '\0') path = string(cwd) + (char)FILEPATHSEP + path;
+    fopt->onFile(path.c_str(), ok);
+} /* end of ReportFile */
+
+/**
+* @brief   : LockFile - get the lock file of a product
+* @param[I]: file (local file name)
+* @param[O]: none
+* @return  : full path of the lock file
+* @note    : the lock is taken in the store if it is used, otherwise in the current directory
+**/
+string FtpUtil::LockFile(const string &file)
+{
+    if (_storeOn) return _store.LockFile(file);
+
+    char cwd[MAXSTRPATH] = { '\0' };
+#ifdef _WIN32   /* for Windows */
+    _getcwd(cwd, MAXSTRPATH);
+#else           /* for Linux or Mac */
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) cwd[0] = '\0';
+#endif
+    string lockFile = "." + file + ".lock";
+    if (cwd[0] != '\0') lockFile = string(cwd) + (char)FILEPATHSEP + lockFile;
+
+    return lockFile;
+} /* end of LockFile */
+
+/**
+* @brief   : LandedFile - get the name under which a product is kept in the current directory
+* @param[I]: file (local file name)
+* @param[O]: none
+* @return  : 'file', or its seekable zstd version 'file.zst', "" if neither exists
+* @note    : a 'file.zst' whose recompression failed is kept as 'file' without '.zst', which is taken as well
+**/
+string FtpUtil::LandedFile(const string &file)
+{
+    if (access(file.c_str(), 0) == 0) return file;
+    string zstFile = file + ".zst";
+    if (access(zstFile.c_str(), 0) == 0) return zstFile;
+    size_t len = file.size();
+    if (len > 4 && file.compare(len - 4, 4, ".zst") == 0 && access(file.substr(0, len - 4).c_str(), 0) == 0)
+        return file.substr(0, len - 4);
+
+    return "";
+} /* end of LandedFile */
+
+/**
+* @brief   : Recompress - recompress a downloaded product to seekable zstd
+* @param[I]: fopt (FTP options)
+* @param[I]: file (local file name)
+* @param[O]: none
+* @return  : the name under which the product is kept, 'file' itself if the recompression failed
+* @note    : the original file is removed after the recompression
+**/
+string FtpUtil::Recompress(const ftpopt_t *fopt, const string &file)
+{
+    string zstFile = file + ".zst";
+    if (!_zstd.Compress(file, zstFile, fopt->zstdFrame, fopt->zstdLevel))
+    {
+        cout << "*** WARNING(FtpUtil::Recompress): " << file << " is kept uncompressed" << endl;
+
+        return file;
+    }
+    remove(file.c_str());
+
+    return zstFile;
+} /* end of Recompress */
+
+/**
+* @brief   : TakeShared - take a product from the shared cache, or claim it for downloading
+* @param[I]: file (local file name)
+* @param[I]: wait (true:wait for the process downloading the product, false:return at once)
+* @param[O]: none
+* @return  : 1:taken (no downloading), 0:to be downloaded by this process, -1:held by another process
+* @note    : with 0 the lock of the product is held until 'NotifyFile', so the concurrent GOOD processes
+*            never download (or extract) the same file at the same time; -1 is returned only if 'wait' is false
+**/
+int FtpUtil::TakeShared(const string &file, bool wait)
+{
+    string lockFile = LockFile(file);
+    if (!_lock.Lock(lockFile, wait)) return wait ? 0 : -1;
+
+    /* another process may have finished the product while this one was waiting for the lock */
+    if (!LandedFile(file).empty())
+    {
+        _lock.Unlock(lockFile);
+
+        return 1;
+    }
+    if (_storeOn && (_store.Link(file) || (_zstdOn && _store.Link(file + ".zst"))))
+    {
+        _store.Link(_index.IdxName(file));
+        cout << "*** INFO(FtpUtil::TakeShared): " << file << " is linked from the store " << _store.Root() << endl;
+        _lock.Unlock(lockFile);
+
+        return 1;
+    }
+
+    return 0;
+} /* end of TakeShared */
+
+/**
+* @brief   : WaitShared - wait for the products being downloaded by the other GOOD processes
+* @param[I]: fopt (FTP options)
+* @param[I]: files (local file names, for which 'TakeShared' returned -1)
+* @param[O]: none
+* @return  : none
+* @note    : the locks of this process are released first, so that two processes never wait for each other
+**/
+void FtpUtil::WaitShared(const ftpopt_t *fopt, const std::vector<string> &files)
+{
+    _lock.UnlockAll();
+    for (const string &file : files)
+    {
+        if (TakeShared(file) == 0) cout << "*** WARNING(FtpUtil::WaitShared): " << file <<
+            " was not downloaded by the other GOOD process" << endl;
+        NotifyFile(fopt, file);
+    }
+} /* end of WaitShared */
+
+/**
+* @brief   : ObsName - get the local name of an observation file as it is kept on disk
+* @param[I]: fopt (FTP options)
+* @param[I]: oFile (RINEX observation file name, i.e., 'abmf0320.21o')
+* @param[O]: none
+* @return  : 'oFile' itself, the compact RINEX + gzip name (i.e., 'abmf0320.21d.gz') if 'keepCompact' is on,
+*            or the seekable zstd name (i.e., 'abmf0320.21o.zst') if 'zstdSeek' is on
+* @note    : 'keepCompact' takes precedence, the compact RINEX can only be decoded from its start
+**/
+string FtpUtil::ObsName(const ftpopt_t *fopt, const string &oFile)
+{
+    if (oFile.empty()) return oFile;
+    if (fopt->keepCompact) return oFile.substr(0, oFile.size() - 1) + "d.gz";
+    if (fopt->zstdSeek) return oFile + ".zst";
+
+    return oFile;
+} /* end of ObsName */
+
+/**
+* @brief   : UnzipObs - extract a downloaded observation archive into its compact RINEX file
+* @param[I]: fopt (FTP options)
+* @param[I]: zFile (archive '*.gz' or '*.Z', it may contain wildcards)
+* @param[I]: crxFile (compact RINEX file name given to 'CrxToObs', "" for the archive name without its suffix)
+* @param[O]: none
+* @return  : none
+* @note    : with 'keepCompact' a gzip archive is kept as 'crxFile.gz', so that 'CrxToObs' keeps its original bytes
+*            instead of compressing the compact RINEX again; an archive that can not be extracted is removed then
+**/
+void FtpUtil::UnzipObs(const ftpopt_t *fopt, const string &zFile, const string &crxFile)
+{
+    const string gzExt = ".gz";
+    if (!fopt->keepCompact || zFile.size() <= gzExt.size() ||
+        zFile.compare(zFile.size() - gzExt.size(), gzExt.size(), gzExt) != 0)
+    {
+        string cmd = string(fopt->gzipFull) + " -d -f " + zFile;
+        std::system(cmd.c_str());
+
+        return;
+    }
+
+    /* the archive is resolved first, a wildcard can not name the extracted file */
+    StringUtil str;
+    string gzFile = zFile;
+    if (zFile.find_first_of("*?[") != string::npos)
+    {
+        vector<string> files;
+        str.ListDir(".", files);
+        gzFile.clear();
+        for (const string &file : files)
+        {
+            if (str.WildMatch(zFile.c_str(), file.c_str()))
+            {
+                gzFile = file;
+                break;
+            }
+        }
+    }
+    if (gzFile.empty() || access(gzFile.c_str(), 0) == -1) return;
+
+    string stem = gzFile.substr(0, gzFile.size() - gzExt.size());
+    string cmd = string(fopt->gzipFull) + " -d -c " + gzFile + " > " + stem;
+    if (ExitCode(std::system(cmd.c_str())) != 0 || str.FileSize(stem) <= 0)
+    {
+        /* a broken archive is not kept, it would be taken for the observation file */
+        cout << "*** WARNING(FtpUtil::UnzipObs): failed to extract " << gzFile << endl;
+        remove(stem.c_str());
+        remove(gzFile.c_str());
+
+        return;
+    }
+
+    string keepFile = (crxFile.empty() ? stem : crxFile) + gzExt;
+    if (keepFile != gzFile)
+    {
+        remove(keepFile.c_str());
+        rename(gzFile.c_str(), keepFile.c_str());
+    }
+} /* end of UnzipObs */
+
+/**
+* @brief   : CrxToObs - convert a downloaded compact RINEX file into the observation file kept on disk
+* @param[I]: fopt (FTP options)
+* @param[I]: crxFile (compact RINEX (Hatanaka) file, it may contain wildcards)
+* @param[I]: oFile (observation file from 'ObsName')
+* @param[O]: none
+* @return  : none
+* @note    : with 'keepCompact' the gzip archive kept by 'UnzipObs' is taken as it is (a '.Z' archive is gzipped
+*            again), which is about 8-10 times smaller than RINEX; with 'zstdSeek' the RINEX is recompressed to seekable zstd; with 'epochIndex' the epoch index of the
+*            RINEX is written next to it (i.e., 'abmf0320.21o.idx'); with 'decimate' only the epochs on the grid
+*            and the satellites of the systems kept are written, and with 'filterObs' etc. only the systems and
+*            the observation codes kept (not for 'keepCompact'); with 'inventory' its header is added to the
+*            inventory of the directory
+**/
+void FtpUtil::CrxToObs(const ftpopt_t *fopt, const string &crxFile, const string &oFile)
+{
+    string cmd, rnxFile = oFile;
+    FilterUtil filter;
+    filter.Set(fopt->decimate, fopt->decSys, fopt->decCodes);
+    bool isFilter = !fopt->keepCompact && filter.IsOn();
+    if (fopt->keepCompact)
+    {
+        /* the archive is kept byte for byte, so the same download always gives the same blob in the store; '-n'
+           leaves out the name and time stamp of an archive compressed again for the same reason */
+        string gzFile = crxFile + ".gz";
+        if (access(gzFile.c_str(), 0) == -1) cmd = string(fopt->gzipFull) + " -n -c " + crxFile + " > " + oFile;
+        else if (gzFile != oFile)
+        {
+            remove(oFile.c_str());
+            rename(gzFile.c_str(), oFile.c_str());
+        }
+    }
+    else
+    {
+        if (fopt->zstdSeek) rnxFile = oFile.substr(0, oFile.size() - 4);
+#ifdef _WIN32  /* for Windows */
+        cmd = string(fopt->crx2rnxFull) + " " + crxFile + " -f -";
+#else          /* for Linux or Mac */
+        cmd = "cat " + crxFile + " | " + fopt->crx2rnxFull + " -f -";
+#endif
+        if (!isFilter) cmd += " > " + rnxFile;
+    }
+    if (!isFilter)
+    {
+        if (!cmd.empty()) std::system(cmd.c_str());
+    }
+    else
+    {
+        /* the decimation and the system filter are applied in the decoding stream, the full RINEX is never written */
+        ofstream out(rnxFile.c_str(), ios::binary);
+        bool ok = out.is_open() && ReadCmd(cmd, [&](const char *line) { filter.Put(line, out); return true; });
+        filter.Finish(out);
+        out.close();
+        if (!ok || out.fail())
+        {
+            cout << "*** WARNING(FtpUtil::CrxToObs): failed to convert " << crxFile << endl;
+            remove(rnxFile.c_str());
+        }
+    }
+
+    /* the offsets of the epoch index are those in the RINEX, so it holds for the seekable zstd as well */
+    if (fopt->epochIndex && !fopt->keepCompact && access(rnxFile.c_str(), 0) == 0)
+        _index.Build(rnxFile, _index.IdxName(oFile));
+
+    /* the RINEX is kept as seekable zstd, or uncompressed if the recompression failed (i.e., no 'zstd' or a full
+       disk), so the only copy of the observations is never lost */
+    string landed = oFile;
+    if (rnxFile != oFile && access(rnxFile.c_str(), 0) == 0)
+    {
+        if (_zstd.Compress(rnxFile, oFile, fopt->zstdFrame, fopt->zstdLevel)) remove(rnxFile.c_str());
+        else
+        {
+            cout << "*** WARNING(FtpUtil::CrxToObs): " << rnxFile << " is kept uncompressed" << endl;
+            remove(oFile.c_str());
+            landed = rnxFile;
+        }
+    }
+
+    if (fopt->inventory && access(landed.c_str(), 0) == 0) AddInventory(fopt, landed);
+} /* end of CrxToObs */
+
+/**
+* @brief   : DecodeCmd - get the command line that writes the RINEX of an observation file to the standard output
+* @param[I]: fopt (FTP options)
+* @param[I]: file (RINEX, compact RINEX ('*.yyd', '*.crx'), optionally compressed by gzip ('*.gz', '*.Z') or zstd ('*.zst'))
+* @param[O]: none
+* @return  : the command line
+* @note    :
+**/
+string FtpUtil::DecodeCmd(const ftpopt_t *fopt, const string &file)
+{
+    StringUtil str;
+    string name = file, cmd;
+    size_t pos = name.find_last_of('.');
+    string ext = pos == string::npos ? "" : name.substr(pos);
+    if (ext == ".gz" || ext == ".Z")
+    {
+        name = name.substr(0, pos);
+        cmd = string(fopt->gzipFull) + " -d -c " + file;
+    }
+    else if (ext == ".zst")
+    {
+        name = name.substr(0, pos);
+        cmd = string(fopt->zstdFull) + " -q -d -c " + file;
+    }
+    else
+    {
+#ifdef _WIN32  /* for Windows */
+        cmd = "type " + file;
+#else          /* for Linux or Mac */
+        cmd = "cat " + file;
+#endif
+    }
+
+    string lName = name;
+    str.ToLower(lName);
+    bool isCrx = (lName.size() > 4 && lName.substr(lName.size() - 4) == ".crx") ||
+        (lName.size() > 1 && lName[lName.size() - 1] == 'd');
+    if (isCrx) cmd += " | " + string(fopt->crx2rnxFull) + " -f -";
+
+    return cmd;
+} /* end of DecodeCmd */
+
+/**
+* @brief   : ReadCmd - stream the standard output of a command line by line
+* @param[I]: cmd (command line)
+* @param[I]: onLine (callback of each line)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the command stops as soon as 'onLine' returns false
+**/
+bool FtpUtil::ReadCmd(const string &cmd, const linecb_t &onLine)
+{
+#ifdef _WIN32  /* for Windows */
+    FILE *fp = _popen(cmd.c_str(), "r");
+#else          /* for Linux or Mac */
+    FILE *fp = popen(cmd.c_str(), "r");
+#endif
+    if (fp == nullptr)
+    {
+        cerr << "*** ERROR(FtpUtil::ReadCmd): failed to run " << cmd << endl;
+
+        return false;
+    }
+
+    /* the lines of RINEX 3 observations may be longer than MAXCHARS */
+    char buff[MAXCHARS];
+    string line;
+    bool stop = false;
+    while (!stop && fgets(buff, MAXCHARS, fp) != nullptr)
+    {
+        line += buff;
+        if (line.empty() || line[line.size() - 1] != '\n') continue;
+        while (!line.empty() && (line[line.size() - 1] == '\n' || line[line.size() - 1] == '\r')) line.pop_back();
+        stop = !onLine(line.c_str());
+        line.clear();
+    }
+    if (!stop && !line.empty()) onLine(line.c_str());
+#ifdef _WIN32  /* for Windows */
+    int stat = _pclose(fp);
+#else          /* for Linux or Mac */
+    int stat = pclose(fp);
+#endif
+
+    return stop || ExitCode(stat) == 0;
+} /* end of ReadCmd */
+
+/**
+* @brief   : ReadObs - stream the RINEX of an observation file line by line, which is decoded on demand
+* @param[I]: fopt (FTP options, after 'FtpInit')
+* @param[I]: file (observation file, i.e., 'abmf0320.21d.gz' kept by 'keepCompact', 'abmf0320.21o.zst' kept by
+*                  'zstdSeek', or 'abmf0320.21o')
+* @param[I]: onLine (callback of each line)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : nothing is written to disk, the decoding stops as soon as 'onLine' returns false
+**/
+bool FtpUtil::ReadObs(const ftpopt_t *fopt, const string &file, const linecb_t &onLine)
+{
+    if (access(file.c_str(), 0) == -1)
+    {
+        cerr << "*** ERROR(FtpUtil::ReadObs): observation file " << file << " does not exist!" << endl;
+
+        return false;
+    }
+
+    return ReadCmd(DecodeCmd(fopt, file), onLine);
+} /* end of ReadObs */
+
+/**
+* @brief   : ReadObs - stream the header and the epochs in a time window of an observation file line by line
+* @param[I]: fopt (FTP options, after 'FtpInit')
+* @param[I]: file (observation file, i.e., 'abmf0320.21o.zst' kept by 'zstdSeek', or 'abmf0320.21o')
+* @param[I]: ts, te (time window [ts, te) in the time system of the file)
+* @param[I]: onLine (callback of each line)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the epoch index ('abmf0320.21o.idx') gives the range of the window, so only the range is read
+*            (seekable zstd: only its frames are decoded); a missing or stale index is built first
+**/
+bool FtpUtil::ReadObs(const ftpopt_t *fopt, const string &file, gtime_t ts, gtime_t te, const linecb_t &onLine)
+{
+    if (access(file.c_str(), 0) == -1)
+    {
+        cerr << "*** ERROR(FtpUtil::ReadObs): observation file " << file << " does not exist!" << endl;
+
+        return false;
+    }
+
+    /* the compact RINEX can only be decoded from its start */
+    StringUtil str;
+    string lName = file;
+    str.ToLower(lName);
+    size_t pos = lName.find_last_of('.');
+    string ext = pos == string::npos ? "" : lName.substr(pos);
+    bool isZst = ext == ".zst";
+    if (ext == ".gz" || ext == ".z" || ext == ".crx" || lName[lName.size() - 1] == 'd')
+    {
+        cerr << "*** ERROR(FtpUtil::ReadObs): " << file << " is not RINEX or seekable zstd, use 'ReadObs' without "
+            "the time window" << endl;
+
+        return false;
+    }
+
+    /* the size of the RINEX, which is the decompressed size for the seekable zstd */
+    long long rnxSize = str.FileSize(file);
+    std::vector<zstframe_t> frames;
+    if (isZst)
+    {
+        if (!_zstd.ReadTable(file, frames))
+        {
+            cerr << "*** ERROR(FtpUtil::ReadObs): " << file << " is not a seekable zstd file" << endl;
+
+            return false;
+        }
+        rnxSize = frames.empty() ? 0 : frames.back().dOff + frames.back().dSize;
+    }
+
+    /* a missing or stale index is built first, the seekable zstd is decoded once for it */
+    string idxFile = _index.IdxName(file);
+    string tmpFile = file + "." + to_string(getpid()) + ".win";
+    long long hdrSize = 0, off = 0, len = 0, start = 0;
+    if (!_index.Find(idxFile, rnxSize, ts, te, hdrSize, off, len))
+    {
+        bool ok = isZst ? _zstd.Extract(file, 0, 0, tmpFile, start) && _index.Build(tmpFile, idxFile) :
+            _index.Build(file, idxFile);
+        if (isZst) remove(tmpFile.c_str());
+        if (!ok || !_index.Find(idxFile, rnxSize, ts, te, hdrSize, off, len))
+        {
+            cerr << "*** ERROR(FtpUtil::ReadObs): failed to build the epoch index " << idxFile << endl;
+
+            return false;
+        }
+    }
+
+    /* the header and then the epochs of the window */
+    long long rngOff[2] = { 0, off }, rngLen[2] = { hdrSize, len };
+    bool ok = true;
+    for (int i = 0; i < 2 && ok; i++)
+    {
+        if (rngLen[i] <= 0) continue;
+        string rngFile = file;
+        start = 0;
+        if (isZst)
+        {
+            ok = _zstd.Extract(file, rngOff[i], rngLen[i], tmpFile, start);
+            rngFile = tmpFile;
+        }
+        ifstream in(rngFile.c_str(), ios::binary);
+        ok = ok && in.is_open();
+        if (!ok) break;
+        in.seekg(rngOff[i] - start);
+        if (!ReadRange(in, rngLen[i], onLine)) break;
+    }
+    if (isZst) remove(tmpFile.c_str());
+    if (!ok) cerr << "*** ERROR(FtpUtil::ReadObs): failed to read " << file << endl;
+
+    return ok;
+} /* end of ReadObs */
+
+/**
+* @brief   : SpliceSite - splice the hourly or high-rate observation files of one site into one daily file
+* @param[I]: fopt (FTP options)
+* @param[I]: frags (observation files of the site in time order)
+* @param[I]: outFile (daily observation file, i.e., 'abmf0320.21o', 'abmf0320.21o.zst' or 'abmf0320.21o.gz')
+* @param[O]: none
+* @return  : true:ok, false:error (nothing is written)
+* @note    : the files are streamed once: the header of the first one is kept, the headers of the others and
+*            the epochs not after the last one written are dropped
+**/
+bool FtpUtil::SpliceSite(const ftpopt_t *fopt, const std::vector<string> &frags, const string &outFile)
+{
+    string rnxFile = outFile;
+    size_t pos = rnxFile.find_last_of('.');
+    if (rnxFile.substr(pos) == ".zst" || rnxFile.substr(pos) == ".gz") rnxFile = rnxFile.substr(0, pos);
+    StringUtil str;
+    string tmpFile = str.TmpName(rnxFile + ".splice");
+    ofstream out(tmpFile.c_str(), ios::binary);
+    if (!out.is_open())
+    {
+        cerr << "*** ERROR(FtpUtil::SpliceSite): open file " << tmpFile << " FAILED!" << endl;
+
+        return false;
+    }
+
+    TimeUtil tu;
+    IndexUtil scan;
+    string typ0;
+    gtime_t last = { 0 };
+    bool first = true, any = false, ok = true;
+    for (const string &frag : frags)
+    {
+        scan.Reset();
+        int head = 0;
+        bool keep = first, bad = false;
+        string typ;
+        ok = ReadObs(fopt, frag, [&](const char *line)
+        {
+            string s = line;
+            if (head == 0)
+            {
+                head = scan.ScanHead(s);
+                string label = s.size() > 60 ? s.substr(60) : "";
+                if (label.find("TYPES OF OBSERV") != string::npos || label.find("OBS TYPES") != string::npos) typ += s;
+
+                /* the records that hold for the first file only are left out */
+                bool drop = label.find("TIME OF LAST OBS") == 0 || label.find("# OF SATELLITES") == 0 ||
+                    label.find("PRN / # OF OBS") == 0;
+                if (first && !drop) out << s << "\n";
+                if (head == 1 && first) typ0 = typ;
+                bad = head == -1 || (head == 1 && typ != typ0);
+
+                return !bad;
+            }
+
+            /* the epochs overlapping the files before are dropped with all of their lines */
+            epochidx_t ep;
+            if (scan.ScanEpoch(s, ep))
+            {
+                keep = !any || tu.TimeDiff(ep.time, last) > 1.0E-4;
+                if (keep)
+                {
+                    last = ep.time;
+                    any = true;
+                }
+            }
+            if (keep) out << s << "\n";
+
+            return true;
+        }) && head == 1 && !bad;
+        if (!ok)
+        {
+            cout << "*** WARNING(FtpUtil::SpliceSite): " << frag << " is not RINEX or has other observation types, " <<
+                outFile << " is not written" << endl;
+            break;
+        }
+        first = false;
+    }
+    out.close();
+    ok = ok && !out.fail();
+
+    /* the daily file is kept in the form of the other observation files, with its epoch index */
+    if (ok && fopt->epochIndex && !fopt->keepCompact) scan.Build(tmpFile, scan.IdxName(rnxFile));
+    if (ok && outFile != rnxFile)
+    {
+        string cmd = string(fopt->gzipFull) + " -n -c " + tmpFile + " > " + outFile;
+        ok = fopt->keepCompact ? ExitCode(std::system(cmd.c_str())) == 0 :
+            _zstd.Compress(tmpFile, outFile, fopt->zstdFrame, fopt->zstdLevel);
+    }
+    else if (ok)
+    {
+        remove(outFile.c_str());
+        ok = rename(tmpFile.c_str(), outFile.c_str()) == 0;
+    }
+    remove(tmpFile.c_str());
+
+    return ok;
+} /* end of SpliceSite */
+
+/**
+* @brief   : SpliceObs - splice the hourly or high-rate observation files of the day into daily files
+* @param[I]: fopt (FTP options)
+* @param[I]: ts (start time)
+* @param[I]: dir (the 'hourly' or 'highrate' directory)
+* @param[O]: none
+* @return  : none
+* @note    : the sites are spliced in parallel, the daily file (i.e., 'hourly/abmf0320.21o') is written only if
+*            it is missing or older than one of the files in 'hourly/HH/'
+**/
+void FtpUtil::SpliceObs(const ftpopt_t *fopt, gtime_t ts, const string &dir)
+{
+    TimeUtil tu;
+    int yyyy, doy;
+    tu.time2yrdoy(ts, &yyyy, &doy);
+    StringUtil str;
+    string sYy = str.yy2str(tu.yyyy2yy(yyyy));
+    string sDoy = str.doy2str(doy);
+
+    /* the sites that have files of the day in 'HH' */
+    std::vector<string> sites;
+    std::unordered_set<string> siteSet;
+    for (int hh = 0; hh < 24; hh++)
+    {
+        string hhDir = dir + (char)FILEPATHSEP + str.hh2str(hh);
+        std::vector<string> files;
+        str.ListDir(hhDir, files);
+        for (const string &file : files)
+        {
+            if (file.size() < 10 || file.substr(4, 3) != sDoy || !siteSet.insert(file.substr(0, 4)).second) continue;
+            sites.push_back(file.substr(0, 4));
+        }
+    }
+
+    /* the files of each site in time order: hourly 'abmf032a.21o', ..., high-rate 'abmf032a00.21o', ... */
+    const char *minu[] = { "", "00", "15", "30", "45" };
+    std::vector<std::vector<string> > frags;
+    std::vector<string> outFiles;
+    for (const string &site : sites)
+    {
+        std::vector<string> files;
+        time_t newest = 0;
+        for (int hh = 0; hh < 24; hh++)
+        {
+            for (int k = 0; k < 5; k++)
+            {
+                string file = ObsName(fopt, site + sDoy + (char)('a' + hh) + minu[k] + "." + sYy + "o");
+                string path = dir + (char)FILEPATHSEP + str.hh2str(hh) + (char)FILEPATHSEP + file;
+                time_t mt = FileTime(path);
+                if (mt == 0) continue;
+                files.push_back(path);
+                if (mt > newest) newest = mt;
+            }
+        }
+
+        /* the compact RINEX cannot be written back, so the daily file is RINEX + gzip with 'keepCompact' */
+        string outFile = dir + (char)FILEPATHSEP + site + sDoy + "0." + sYy + "o";
+        if (fopt->keepCompact) outFile += ".gz";
+        else if (fopt->zstdSeek) outFile += ".zst";
+        if (files.empty() || FileTime(outFile) >= newest) continue;
+        frags.push_back(files);
+        outFiles.push_back(outFile);
+    }
+    if (frags.empty()) return;
+
+    /* the sites are taken one by one by the threads */
+    int nThr = fopt->spliceThreads > 0 ? fopt->spliceThreads : (int)std::thread::hardware_concurrency();
+    if (nThr > (int)frags.size()) nThr = (int)frags.size();
+    if (nThr < 1) nThr = 1;
+    std::vector<char> done(frags.size(), 0);
+    std::mutex nextMutex;
+    int next = 0;
+    std::vector<std::thread> workers;
+    for (int k = 0; k < nThr; k++)
+    {
+        workers.push_back(std::thread([&]()
+        {
+            while (true)
+            {
+                int i;
+                {
+                    std::lock_guard<std::mutex> lock(nextMutex);
+                    i = next++;
+                }
+                if (i >= (int)frags.size()) break;
+                done[i] = SpliceSite(fopt, frags[i], outFiles[i]) ? 1 : 0;
+            }
+        }));
+    }
+    for (int k = 0; k < nThr; k++) workers[k].join();
+
+    for (int i = 0; i < (int)frags.size(); i++)
+    {
+        if (done[i] && fopt->inventory) AddInventory(fopt, outFiles[i]);
+        if (done[i]) cout << "*** INFO(FtpUtil::SpliceObs): " << frags[i].size() << " observation files are spliced into " <<
+            outFiles[i] << endl;
+        else cout << "*** WARNING(FtpUtil::SpliceObs): failed to splice the observation files into " << outFiles[i] << endl;
+    }
+} /* end of SpliceObs */
+
+/**
+* @brief   : ValidateFiles - validate the files held by 'NotifyFile'
+* @param[I]: fopt (FTP options)
+* @param[O]: none
+* @return  : none
+* @note    : the files are checked in parallel by the invariants of their formats; an invalid file is moved
+*            into 'quarantine/' of its directory and the product is re-queued, until 'validRetry' is used up
+**/
+void FtpUtil::ValidateFiles(const ftpopt_t *fopt)
+{
+    if (_landed.empty()) return;
+
+    /* the files are taken one by one by the threads, each file is decoded by its own process */
+    int nThr = fopt->validThreads > 0 ? fopt->validThreads : (int)std::thread::hardware_concurrency();
+    if (nThr > (int)_landed.size()) nThr = (int)_landed.size();
+    if (nThr < 1) nThr = 1;
+    std::vector<string> why(_landed.size());
+    std::mutex nextMutex;
+    int next = 0;
+    std::vector<std::thread> workers;
+    for (int k = 0; k < nThr; k++)
+    {
+        workers.push_back(std::thread([&]()
+        {
+            CheckUtil chk;
+            while (true)
+            {
+                int i;
+                {
+                    std::lock_guard<std::mutex> lock(nextMutex);
+                    i = next++;
+                }
+                if (i >= (int)_landed.size()) break;
+                string path = _landed[i].dir + (char)FILEPATHSEP + _landed[i].landed;
+                chk.Reset(path);
+                bool ok = ReadCmd(DecodeCmd(fopt, path), [&](const char *line) { return chk.Put(line); });
+                if (chk.Finish(why[i]) && !ok) why[i] = "failed to decode";
+            }
+        }));
+    }
+    for (int k = 0; k < nThr; k++) workers[k].join();
+
+    /* the store, the locks and the callback work in the directory of each file */
+    char cwd[MAXSTRPATH] = { '\0' };
+#ifdef _WIN32   /* for Windows */
+    _getcwd(cwd, MAXSTRPATH);
+#else           /* for Linux or Mac */
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) cwd[0] = '\0';
+#endif
+    for (int i = 0; i < (int)_landed.size(); i++)
+    {
+        const landed_t &lf = _landed[i];
+#ifdef _WIN32   /* for Windows */
+        _chdir(lf.dir.c_str());
+#else           /* for Linux or Mac */
+        chdir(lf.dir.c_str());
+#endif
+        if (why[i].empty())
+        {
+            ReportFile(fopt, lf.file, lf.landed);
+            continue;
+        }
+
+        /* a bad blob is not linked again, and the epoch index and inventory entry of a bad observation file are of no use */
+        if (_storeOn && _store.IsLinked(lf.landed)) _store.Drop(lf.landed);
+        remove(_index.IdxName(lf.landed).c_str());
+        if (_invent.Dir() == lf.dir) _invent.Remove(lf.landed);
+        if (access(QUARDIR, 0) == -1)
+        {
+#ifdef _WIN32   /* for Windows */
+            string cmd = string("mkdir ") + QUARDIR;
+#else           /* for Linux or Mac */
+            string cmd = string("mkdir -p ") + QUARDIR;
+#endif
+            std::system(cmd.c_str());
+        }
+        string quarFile = string(QUARDIR) + (char)FILEPATHSEP + lf.landed;
+        remove(quarFile.c_str());
+        if (rename(lf.landed.c_str(), quarFile.c_str()) != 0) remove(lf.landed.c_str());
+        cout << "*** WARNING(FtpUtil::ValidateFiles): " << lf.dir << (char)FILEPATHSEP << lf.landed << " is invalid (" <<
+            why[i] << "), it is moved into " << QUARDIR << endl;
+
+        int &nBad = _badCount[lf.dir + (char)FILEPATHSEP + lf.file];
+        if (++nBad <= fopt->validRetry)
+        {
+            _requeue = true;
+            _lock.Unlock(LockFile(lf.file));
+        }
+        else
+        {
+            cout << "*** WARNING(FtpUtil::ValidateFiles): " << lf.file << " is still invalid after " << fopt->validRetry <<
+                " retries, it is given up" << endl;
+            ReportFile(fopt, lf.file, "");
+        }
+    }
+    _landed.clear();
+#ifdef _WIN32   /* for Windows */
+    _chdir(cwd);
+#else           /* for Linux or Mac */
+    chdir(cwd);
+#endif
+} /* end of ValidateFiles */
+
+/**
+* @brief   : AddInventory - add or replace the inventory entry of an observation file
+* @param[I]: fopt (FTP options)
+* @param[I]: file (observation file, i.e., 'abmf0320.21o', 'abmf0320.21o.zst' or 'abmf0320.21d.gz')
+* @param[O]: none
+* @return  : none
+* @note    : only the header is decoded, the inventory of the directory of the file is saved by 'FtpGet'
+**/
+void FtpUtil::AddInventory(const ftpopt_t *fopt, const string &file)
+{
+    /* the file is in the current directory unless it has a path, i.e., the daily file of 'SpliceObs' */
+    string dir, name = file;
+    size_t ipos = file.find_last_of(FILEPATHSEP);
+    if (ipos != string::npos)
+    {
+        dir = file.substr(0, ipos);
+        name = file.substr(ipos + 1);
+    }
+    else
+    {
+        char cwd[MAXSTRPATH] = { '\0' };
+#ifdef _WIN32   /* for Windows */
+        _getcwd(cwd, MAXSTRPATH);
+#else           /* for Linux or Mac */
+        if (getcwd(cwd, MAXSTRPATH) == nullptr) cwd[0] = '\0';
+#endif
+        dir = cwd;
+    }
+
+    /* the files of a product are in one directory, so the inventory is loaded and saved once per product */
+    if (_invent.Dir() != dir)
+    {
+        _invent.Save();
+        _invent.Load(dir, _shardTag);
+    }
+    _invent.StartFile(name);
+    ReadCmd(DecodeCmd(fopt, file), [&](const char *line) { return _invent.PutHead(line); });
+} /* end of AddInventory */
+
+/**
+* @brief   : SetMissClass - set the product epoch and latency class for the negative cache
+* @param[I]: ts (start time of the product day)
+* @param[I]: cls (latency class, MISS_???; -1: the negative cache is not used)
+* @param[O]: none
+* @return  : none
+* @note    : it is called at the beginning of each product downloading
+**/
+void FtpUtil::SetMissClass(gtime_t ts, int cls)
+{
+    _missTs = ts;
+    _missCls = cls;
+} /* end of SetMissClass */
+
+/**
+* @brief   : LoadMissing - load the negative cache of the current directory if it is not loaded yet
+* @param[I]: none
+* @param[O]: none
+* @return  : none
+* @note    : the negative cache of the previous directory is saved first
+**/
+void FtpUtil::LoadMissing()
+{
+    char cwd[MAXSTRPATH] = { '\0' };
+#ifdef _WIN32   /* for Windows */
+    _getcwd(cwd, MAXSTRPATH);
+#else           /* for Linux or Mac */
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) strcpy(cwd, ".");
+#endif
+    if (_miss.Dir() == cwd) return;
+
+    _miss.Save();
+    _miss.Load(cwd);
+} /* end of LoadMissing */
+
+/**
+* @brief   : IsKnownMissing - whether the file is known to be not yet available on the archive
+* @param[I]: fopt (FTP options)
+* @param[I]: file (local file name in the current directory)
+* @param[O]: none
+* @return  : true:skip the downloading, false:go on downloading
+* @note    : the file is skipped until the expiry time in the negative cache
+**/
+bool FtpUtil::IsKnownMissing(const ftpopt_t *fopt, const string &file)
+{
+    if (!fopt->negCache || _missCls < 0 || access(file.c_str(), 0) == 0) return false;
+
+    LoadMissing();
+    missent_t ent;
+    if (!_miss.Find(file, ent)) return false;
+
+    TimeUtil tu;
+    if (tu.TimeDiff(ent.expire, tu.TimeNow()) <= 0.0) return false;
+
+    cout << "*** INFO(FtpUtil::IsKnownMissing): " << file << " is not yet available on the archive, skipped until " <<
+        tu.TimeStr(ent.expire, 0) << endl;
+
+    return true;
+} /* end of IsKnownMissing */
+
+/**
+* @brief   : UpdateMissing - update the negative cache according to the result of downloading
+* @param[I]: file (local file name in the current directory)
+* @param[I]: ok (true:the file is available, false:the file is missing)
+* @param[O]: none
+* @return  : none
+* @note    : the expiry time is the later one of the normal publishing time of the product and now plus
+*            the retry interval, which is doubled after each failed request (up to MAXRETRY hours). The cache
+*            is saved by 'FtpGet' once the product is done
+**/
+void FtpUtil::UpdateMissing(const string &file, bool ok)
+{
+    if (_missCls < 0 || _missCls >= NMISS) return;
+
+    LoadMissing();
+    if (ok)
+    {
+        _miss.Remove(file);
+
+        return;
+    }
+
+    /* an unexpired entry is kept as it is, i.e., the skipped file does not extend the expiry */
+    TimeUtil tu;
+    gtime_t now = tu.TimeNow();
+    missent_t ent;
+    if (_miss.Find(file, ent) && tu.TimeDiff(ent.expire, now) > 0.0) return;
+    if (_miss.Find(file, ent)) ent.count++;
+    else ent.count = 1;
+    ent.name = file;
+
+    double retry = missTable[_missCls].retry;
+    for (int i = 1; i < ent.count && retry < MAXRETRY; i++) retry *= 2.0;
+    if (retry > MAXRETRY) retry = MAXRETRY;
+    gtime_t tPub = tu.TimeAdd(_missTs, missTable[_missCls].latency * 3600.0);
+    gtime_t tRetry = tu.TimeAdd(now, retry * 3600.0);
+    ent.expire = tu.TimeDiff(tPub, tRetry) > 0.0 ? tPub : tRetry;
+
+    _miss.Update(ent);
+} /* end of UpdateMissing */
+
+/**
+* @brief   : FetchBatch - download many files under the same remote directory in one batch
+* @param[I]: fopt (FTP options)
+* @param[I]: url (the remote directory)
+* @param[I]: cutDirs (the option '--cut-dirs=N ' of 'wget')
+* @param[I]: patterns (accept patterns of the files, i.e., 'ABMF*_R_20210320000_01D_30S_MO.crx.*')
+* @param[O]: none
+* @return  : none
+* @note    : the batch runs with the concurrency learned for the host, then its aggregate throughput and
+*            errors are reported back to adjust the concurrency for the next batch (see 'RateUtil::Report')
+**/
+void FtpUtil::FetchBatch(const ftpopt_t *fopt, const string &url, const string &cutDirs,
+    const std::vector<string> &patterns)
+{
+    if (patterns.empty()) return;
+
+    string host = _rate.Host(url);
+    int conc = _rate.Conc(host), used = 0;
+    bool err = false;
+    int files0 = 0, files = 0;
+    long long bytes0 = BatchBytes(patterns, files0);
+
+    /* the bandwidth budget is shared by the processes: the batch waits until the bytes of the earlier batches
+       are paid off, then pays for its own */
+    string bwTag = fopt->bwIsBack ? "back" : "inter";
+    _bucket.Take(bwTag, fopt->bwRate);
+    auto t0 = std::chrono::steady_clock::now();
+
+    if (url.compare(0, 4, "http") != 0 || !HttpBatch(fopt, url, patterns, conc, used, err))
+        WgetBatch(fopt, url, cutDirs, patterns, conc, used, err);
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    long long bytes = BatchBytes(patterns, files) - bytes0;
+    _bucket.Charge(bwTag, fopt->bwRate, bytes);
+    int concNew = _rate.Report(host, used, bytes, secs, err);
+    _plan.Record(_planKind, files - files0, bytes);
+    if (concNew != conc)
+    {
+        cout << "*** INFO(FtpUtil::FetchBatch): concurrency of " << host << " " << conc << " -> " << concNew <<
+            (err ? " (errors)" : "") << ", " << fixed << setprecision(1) << bytes / 1024.0 / (secs > 0.0 ? secs : 1.0) <<
+            " KB/s" << endl;
+    }
+    _rate.Save();
+} /* end of FetchBatch */
+
+/**
+* @brief   : BatchBytes - get the total size of the local files matching the accept patterns
+* @param[I]: patterns (accept patterns of the files)
+* @param[O]: files (number of the files)
+* @return  : the total size in bytes
+* @note    :
+**/
+long long FtpUtil::BatchBytes(const std::vector<string> &patterns, int &files)
+{
+    StringUtil str;
+    std::vector<string> names;
+    str.ListDir(".", names);
+
+    long long bytes = 0;
+    files = 0;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        for (size_t j = 0; j < patterns.size(); j++)
+        {
+            if (!str.WildMatch(patterns[j].c_str(), names[i].c_str())) continue;
+            long long size = str.FileSize(names[i]);
+            if (size > 0)
+            {
+                bytes += size;
+                files++;
+            }
+            break;
+        }
+    }
+
+    return bytes;
+} /* end of BatchBytes */
+
+/**
+* @brief   : WgetBatch - download many files under the same remote directory by concurrent FTP sessions
+* @param[I]: fopt (FTP options)
+* @param[I]: url (the remote directory)
+* @param[I]: cutDirs (the option '--cut-dirs=N ' of 'wget')
+* @param[I]: patterns (accept patterns of the files)
+* @param[I]: conc (number of concurrent sessions)
+* @param[O]: used (number of sessions used)
+* @param[O]: err (true if a session met network failures, or error replies of the server to wildcards)
+* @return  : none
+* @note    : the patterns are dealt to the sessions and joined into one accept list per session, so that one
+*            login and one directory listing serve many files (MGET-style); the list is split every MAXBATCH
+*            patterns to keep the command line short. Each session works in its own part directory, named by
+*            the process ID, so that the '.listing' files of 'wget' clash neither between the sessions nor
+*            between the processes sharing the directory
+**/
+void FtpUtil::WgetBatch(const ftpopt_t *fopt, const string &url, const string &cutDirs,
+    const std::vector<string> &patterns, int conc, int &used, bool &err)
+{
+    int nSes = conc < (int)patterns.size() ? conc : (int)patterns.size();
+    if (nSes < 1) nSes = 1;
+    used = nSes;
+
+    std::vector<std::vector<string> > sesPats(nSes);
+    for (size_t i = 0; i < patterns.size(); i++) sesPats[i % nSes].push_back(patterns[i]);
+
+    /* the bandwidth budget of the job is shared by the sessions */
+    string wgetFull = fopt->wgetFull, qr = fopt->printInfoWget ? "-r" : "-qr";
+    if (fopt->bwRate > 0) qr += " --limit-rate=" + to_string(BwLimit(fopt, nSes)) + "k";
+    /* an error reply (8) to exact names is mostly a file that is not published yet (550), which says nothing
+       about the load of the server, so only a network failure (4) counts against the host */
+    bool exact = IsExactNames(patterns);
+    StringUtil str;
+    std::vector<int> sesErr(nSes, 0);
+    std::vector<string> partDirs(nSes);
+    std::vector<std::thread> sessions;
+    for (int k = 0; k < nSes; k++)
+    {
+        string partDir = partDirs[k] = str.TmpName(".good_part" + to_string(k));
+        sessions.push_back(std::thread([&, k, partDir]()
+        {
+            const std::vector<string> &pats = sesPats[k];
+            for (size_t i = 0; i < pats.size(); i += MAXBATCH)
+            {
+                string accList;
+                for (size_t j = i; j < pats.size() && j < i + MAXBATCH; j++)
+                {
+                    if (!accList.empty()) accList += ",";
+                    accList += pats[j];
+                }
+                string cmd = wgetFull + " " + qr + " -nH -P " + partDir + " -A " + accList + cutDirs + url;
+                int stat = ExitCode(std::system(cmd.c_str()));
+                if (stat == 4 || (stat == 8 && !exact)) sesErr[k] = stat;  /* network failure or server error reply */
+            }
+        }));
+    }
+    for (int k = 0; k < nSes; k++) sessions[k].join();
+
+    for (int k = 0; k < nSes; k++)
+    {
+        if (sesErr[k] != 0) err = true;
+
+        /* move the files of the part directory to the current directory */
+        const string &partDir = partDirs[k];
+        std::vector<string> files;
+        str.ListDir(partDir, files);
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            string src = partDir + FILEPATHSEP + files[i];
+            remove(files[i].c_str());
+            rename(src.c_str(), files[i].c_str());
+        }
+        RemoveDir(partDir);
+    }
+} /* end of WgetBatch */
+
+/**
+* @brief   : HttpBatch - download many files under the same remote directory over HTTP/2
+* @param[I]: fopt (FTP options)
+* @param[I]: url (the remote directory)
+* @param[I]: patterns (accept patterns of the files)
+* @param[I]: conc (number of concurrent streams)
+* @param[O]: used (number of streams used)
+* @param[O]: err (true if 'curl' failed on a listed file, i.e., refused, throttled, or timed out)
+* @return  : true:ok, false:the directory index is not available ('wget' is used instead)
+* @note    : the directory index is matched against the patterns, then all the matched files are requested
+*            by one 'curl --parallel' command, which multiplexes them over one TLS connection per host
+**/
+bool FtpUtil::HttpBatch(const ftpopt_t *fopt, const string &url, const std::vector<string> &patterns,
+    int conc, int &used, bool &err)
+{
+    std::vector<string> files;
+    if (!HttpMatch(fopt, url, patterns, files)) return false;
+
+    /* the exact names are not checked against an index, so an HTTP error reply (22) may be a file that is
+       not there yet rather than a refusal of the server */
+    bool exact = IsExactNames(patterns);
+    used = conc < (int)files.size() ? conc : (int)files.size();
+    for (size_t i = 0; i < files.size(); i += MAXBATCH)
+    {
+        string cmd = CurlCmd(fopt, used) + " --parallel --parallel-max " + to_string(conc) + " --remote-name-all";
+        for (size_t j = i; j < files.size() && j < i + MAXBATCH; j++) cmd += " " + url + "/" + files[j];
+        int stat = ExitCode(std::system(cmd.c_str()));
+        if (stat != 0 && !(exact && stat == 22)) err = true;
+    }
+
+    return true;
+} /* end of HttpBatch */
+
+/**
+* @brief   : HttpMatch - get the files in an HTTP(S) directory index that match the accept patterns
+* @param[I]: fopt (FTP options)
+* @param[I]: url (the remote directory)
+* @param[I]: patterns (accept patterns of the files)
+* @param[O]: files (matched file names in the order of the index)
+* @return  : true:ok, false:the directory index is not available
+* @note    : patterns without wildcards are taken as the file names, so that the index is not needed
+**/
+bool FtpUtil::HttpMatch(const ftpopt_t *fopt, const string &url, const std::vector<string> &patterns,
+    std::vector<string> &files)
+{
+    files.clear();
+    if (IsExactNames(patterns))
+    {
+        files = patterns;
+        return true;
+    }
+
+    std::vector<string> names;
+    if (!RemoteList(fopt, url, names)) return false;
+
+    StringUtil str;
+    for (const string &name : names)
+    {
+        for (const string &pat : patterns)
+        {
+            if (!str.WildMatch(pat.c_str(), name.c_str())) continue;
+            files.push_back(name);
+            break;
+        }
+    }
+
+    return true;
+} /* end of HttpMatch */
+
+/**
+* @brief   : CurlCmd - get the head of a 'curl' command under the options of the job
+* @param[I]: fopt (FTP options)
+* @param[I]: n (number of the concurrent transfers, which share the bandwidth budget)
+* @param[O]: none
+* @return  : the command without the URLs
+* @note    : HTTP/2 is asked for, the login is read from '.netrc' if any, and the session cookies (i.e., of the
+*            Earthdata login of CDDIS, which the HTTPS requests are redirected to) are kept for the run
+**/
+string FtpUtil::CurlCmd(const ftpopt_t *fopt, int n)
+{
+    /* the progress meter of '--parallel' is not turned off by '-s' alone */
+    string cmd = string(fopt->curlFull) + (fopt->printInfoWget ? "" : " -s --no-progress-meter") +
+        " -f -L --http2 --netrc-optional" + CookieOpt(_cookieFile);
+
+    /* '--limit-rate' of 'curl' is per transfer */
+    if (fopt->bwRate > 0) cmd += " --limit-rate " + to_string(BwLimit(fopt, n)) + "k";
+
+    return cmd;
+} /* end of CurlCmd */
+
+/**
+* @brief   : FetchCmd - get the command that downloads the matched files of a remote directory, or one remote file
+* @param[I]: fopt (FTP options)
+* @param[I]: url (the remote directory, or the remote file if 'accept' is empty)
+* @param[I]: cutDirs (the option '--cut-dirs=N ' of 'wget')
+* @param[I]: accept (accept patterns of the files separated by ',', "" for the remote file 'url')
+* @param[O]: none
+* @return  : the command for 'std::system' ("" if no file in the directory index matches), the files are
+*            downloaded into the current directory
+* @note    : FTP(S): 'wget', which matches the accept patterns itself; HTTP(S): 'curl' over HTTP/2, the files
+*            matched in the directory index are requested by one command ('wget' if there is no index)
+**/
+string FtpUtil::FetchCmd(const ftpopt_t *fopt, const string &url, const string &cutDirs, const string &accept)
+{
+    string wgetCmd = string(fopt->wgetFull) + " " + fopt->qr + " -nH" + (accept.empty() ? "" : " -A " + accept) +
+        cutDirs + url;
+    if (url.compare(0, 4, "http") != 0) return wgetCmd;
+    if (accept.empty()) return CurlCmd(fopt, 1) + " -O " + url;
+
+    std::vector<string> patterns, files;
+    size_t ipos = 0;
+    while (ipos <= accept.size())
+    {
+        size_t jpos = accept.find(',', ipos);
+        if (jpos == string::npos) jpos = accept.size();
+        if (jpos > ipos) patterns.push_back(accept.substr(ipos, jpos - ipos));
+        ipos = jpos + 1;
+    }
+    if (!HttpMatch(fopt, url, patterns, files)) return wgetCmd;
+
+    /* one command per MAXBATCH files to keep the command line short */
+    string cmd;
+    for (size_t i = 0; i < files.size(); i += MAXBATCH)
+    {
+#ifdef _WIN32   /* for Windows */
+        if (!cmd.empty()) cmd += " & ";
+#else           /* for Linux or Mac */
+        if (!cmd.empty()) cmd += " ; ";
+#endif
+        /* the files of one command are transferred in parallel and share the bandwidth */
+        size_t n = std::min(files.size() - i, (size_t)MAXBATCH);
+        cmd += CurlCmd(fopt, (int)n) + (n > 1 ? " --parallel" : "") + " --remote-name-all";
+        for (size_t j = i; j < i + n; j++) cmd += " " + url + "/" + files[j];
+    }
+
+    return cmd;
+} /* end of FetchCmd */
+
+/**
+* @brief   : RemoteStat - get the size, modification time and ETag of a remote file
+* @param[I]: fopt (FTP options)
+* @param[I]: url (the remote directory)
+* @param[I]: file (local file name, the remote file may have an additional '.Z' or '.gz')
+* @param[O]: ent (catalog entry of the remote file)
+* @return  : true:ok, false:the remote file is not found or the server is not reachable
+* @note    : FTP(S): the directory listing of 'wget' is parsed; HTTP(S): the response headers of 'curl' are parsed
+**/
+bool FtpUtil::RemoteStat(const ftpopt_t *fopt, const string &url, const string &file, catent_t &ent)
+{
+    ent.name = file;
+    ent.remote = "-";
+    ent.size = -1;
+    ent.mtime = "-";
+    ent.etag = "-";
+
+    if (url.compare(0, 4, "http") != 0)
+    {
+        std::vector<catent_t> ents;
+        if (!FtpListing(fopt, url, ents)) return false;
+        for (const catent_t &e : ents)
+        {
+            if (e.name != file && e.name.compare(0, file.size() + 1, file + ".") != 0) continue;
+            ent.remote = e.name;
+            ent.size = e.size;
+            ent.mtime = e.mtime;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /* the name of the response has the process ID, as the processes may share the directory */
+    StringUtil str;
+    string statFile = str.TmpName(".good_stat");
+    string cmd = string(fopt->curlFull) + " -s -I -L --http2 --netrc-optional" + CookieOpt(_cookieFile) + " -m 30 " +
+        url + "/" + file + " > " + statFile + " 2>&1";
+    std::system(cmd.c_str());
+
+    bool stat = false;
+    ifstream inFile(statFile.c_str());
+    if (inFile.is_open())
+    {
+        string line;
+        while (getline(inFile, line))
+        {
+            istringstream iss(line);
+            std::vector<string> fld;
+            string f;
+            while (iss >> f) fld.push_back(f);
+            if (fld.empty()) continue;
+
+            /* the last response (after redirection) is taken */
+            if (fld[0].compare(0, 5, "HTTP/") == 0)
+            {
+                stat = fld.size() > 1 && fld[1] == "200";
+                ent.size = -1;
+                ent.mtime = ent.etag = "-";
+            }
+            else if (strcasecmp(fld[0].c_str(), "Content-Length:") == 0 && fld.size() > 1)
+                ent.size = atoll(fld[1].c_str());
+            else if (strcasecmp(fld[0].c_str(), "ETag:") == 0 && fld.size() > 1) ent.etag = fld[1];
+            else if (strcasecmp(fld[0].c_str(), "Last-Modified:") == 0 && fld.size() > 1)
+            {
+                ent.mtime = fld[1];
+                for (size_t i = 2; i < fld.size(); i++) ent.mtime += "_" + fld[i];
+            }
+        }
+        inFile.close();
+    }
+    if (stat) ent.remote = file;
+    remove(statFile.c_str());
+
+    return stat;
+} /* end of RemoteStat */
+
+/**
+* @brief   : FtpListing - get the entries of the listing of an FTP(S) directory
+* @param[I]: fopt (FTP options)
+* @param[I]: url (the remote directory)
+* @param[O]: ents (entries of the regular files with their name, size and modification time)
+* @return  : true:ok, false:the remote directory cannot be listed
+* @note    : the listing of a directory is fetched once per run, 'RemoteStat' and 'RemoteList' share it
+**/
+bool FtpUtil::FtpListing(const ftpopt_t *fopt, const string &url, std::vector<catent_t> &ents)
+{
+    auto it = _listings.find(url);
+    if (it != _listings.end())
+    {
+        ents = it->second;
 
+        return true;
+    }
+    ents.clear();
 
-/* function definition -------------------------------------------------------*/
+    /* the names of the response and the listing have the process ID, as the processes may share the directory */
+    StringUtil str;
+    string statFile = str.TmpName(".good_stat"), listDir = str.TmpName(".good_list");
+    string listFile = listDir + FILEPATHSEP + ".listing";
+    string cmd = string(fopt->wgetFull) + " -q --spider -nd --no-remove-listing -P " + listDir + " -t 1 -T 30 " +
+        url + "/ > " + statFile + " 2>&1";
+    std::system(cmd.c_str());
+    remove(statFile.c_str());
+
+    ifstream inFile(listFile.c_str());
+    if (!inFile.is_open())
+    {
+        RemoveDir(listDir);
+
+        return false;
+    }
+
+    std::unordered_set<string> nameSet;
+    string line;
+    while (getline(inFile, line))
+    {
+        /* -rw-r--r--  1  owner  group  size  month  day  time/year  name */
+        istringstream iss(line);
+        std::vector<string> fld;
+        string f;
+        while (iss >> f) fld.push_back(f);
+        if (fld.size() < 9 || fld[0][0] != '-' || !nameSet.insert(fld[8]).second) continue;
+
+        catent_t ent;
+        ent.name = ent.remote = fld[8];
+        ent.size = atoll(fld[4].c_str());
+        ent.mtime = ListDate(fld[5], fld[6], fld[7]);
+        ent.etag = "-";
+        ents.push_back(ent);
+    }
+    inFile.close();
+    remove(listFile.c_str());
+    RemoveDir(listDir);
+    _listings[url] = ents;
+
+    return true;
+} /* end of FtpListing */
 
 /**
-* @brief   : init - Get FTP archive for CDDIS, IGN, or WHU
-* @param[I]: none
-* @param[O]: none
-* @return  : none
-* @note    :
+* @brief   : RemoteList - get the file names in a remote directory
+* @param[I]: fopt (FTP options)
+* @param[I]: url (the remote directory)
+* @param[O]: names (file names)
+* @return  : true:ok, false:the remote directory cannot be listed
+* @note    : FTP(S): the directory listing of 'wget' is parsed; HTTP(S): the links of the directory index
 **/
-void FtpUtil::init()
+bool FtpUtil::RemoteList(const ftpopt_t *fopt, const string &url, std::vector<string> &names)
 {
-    /* FTP archive for CDDIS */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily");                /* IGS daily observation (30s) files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/hourly");               /* IGS hourly observation (30s) files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/highrate");             /* IGS high-rate observation (1s) files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily");                /* MGEX daily observation (30s) files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/hourly");               /* MGEX hourly observation (30s) files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/highrate");             /* MGEX high-rate observation (1s) files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily");                /* broadcast ephemeris files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products");                  /* IGS SP3 files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products");                  /* IGS CLK files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products");                  /* IGS EOP files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products");                  /* IGS weekly SINEX files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/mgex");             /* MGEX SP3 files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/mgex");             /* MGEX CLK files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/bias");             /* MGEX DCB files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/ionex");            /* global ionosphere map (GIM) files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/ionex");            /* Rate of TEC index (ROTI) files */
-    _ftpArchive.CDDIS.push_back("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/products/troposphere/zpd");  /* IGS final tropospheric product files */
+    names.clear();
+    if (url.compare(0, 4, "http") != 0)
+    {
+        std::vector<catent_t> ents;
+        if (!FtpListing(fopt, url, ents)) return false;
+        for (const catent_t &e : ents) names.push_back(e.name);
 
-    /* FTP archive for IGN */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/data");                                         /* IGS daily observation (30s) files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/data/hourly");                                  /* IGS hourly observation (30s) files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/data/highrate");                                /* IGS high-rate observation (1s) files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/data");                                         /* MGEX daily observation (30s) files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/data/hourly");                                  /* MGEX hourly observation (30s) files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/data/highrate");                                /* MGEX high-rate observation (1s) files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/data");                                         /* broadcast ephemeris files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products");                                     /* IGS SP3 files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products");                                     /* IGS CLK files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products");                                     /* IGS EOP files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products");                                     /* IGS weekly SINEX files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products/mgex");                                /* MGEX SP3 files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products/mgex");                                /* MGEX CLK files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products/mgex/dcb");                            /* MGEX DCB files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products/ionosphere");                          /* global ionosphere map (GIM) files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products/ionosphere");                          /* Rate of TEC index (ROTI) files */
-    _ftpArchive.IGN.push_back("ftp://igs.ign.fr/pub/igs/products/troposphere");                         /* IGS final tropospheric product files */
+        return true;
+    }
 
-    /* FTP archive for WHU */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/data/daily");                               /* IGS daily observation (30s) files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/data/hourly");                              /* IGS hourly observation (30s) files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/data");                                     /* IGS high-rate observation (1s) files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/data/daily");                               /* MGEX daily observation (30s) files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/data/hourly");                              /* MGEX hourly observation (30s) files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/data");                                     /* MGEX high-rate observation (1s) files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/data/daily");                               /* broadcast ephemeris files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products");                                 /* IGS SP3 files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products");                                 /* IGS CLK files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products");                                 /* IGS EOP files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products");                                 /* IGS weekly SINEX files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products/mgex");                            /* MGEX SP3 files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products/mgex");                            /* MGEX CLK files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products/mgex/dcb");                        /* MGEX DCB files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products/ionex");                           /* global ionosphere map (GIM) files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products/ionex");                           /* Rate of TEC index (ROTI) files */
-    _ftpArchive.WHU.push_back("ftp://igs.gnsswhu.cn/pub/gps/products/troposphere/new");                 /* IGS final tropospheric product files */
-} /* end of init */
+    /* the name of the index has the process ID, as the processes may share the directory */
+    StringUtil str;
+    string listFile = str.TmpName(".good_index");
+    string cmd = string(fopt->curlFull) + " -s -f -L --http2 --netrc-optional" + CookieOpt(_cookieFile) + " -o " +
+        listFile + " " + url + "/";
+    remove(listFile.c_str());
+    if (std::system(cmd.c_str()) != 0)
+    {
+        remove(listFile.c_str());
+
+        return false;
+    }
+
+    ifstream inFile(listFile.c_str());
+    if (!inFile.is_open()) return false;
+
+    std::unordered_set<string> nameSet;
+    string line;
+    while (getline(inFile, line))
+    {
+        size_t pos = 0;
+        while ((pos = line.find("href=\"", pos)) != string::npos)
+        {
+            pos += 6;
+            size_t end = line.find('"', pos);
+            if (end == string::npos) break;
+            string name = line.substr(pos, end - pos);
+            pos = end;
+            if (name.empty() || name.find('/') != string::npos || name.find('?') != string::npos) continue;
+            if (nameSet.insert(name).second) names.push_back(name);
+        }
+    }
+    inFile.close();
+    remove(listFile.c_str());
+
+    return true;
+} /* end of RemoteList */
+
+/**
+* @brief   : IsUpToDate - whether the local file exists and is the same version as the remote one
+* @param[I]: fopt (FTP options)
+* @param[I]: url (the remote directory)
+* @param[I]: file (local file name in the current directory)
+* @param[O]: ent (catalog entry of the remote file to be recorded by 'UpdateCatalog', empty name if not needed)
+* @return  : true:up to date (no downloading), false:need downloading
+* @note    : the remote file is checked only if 'refresh' is on, otherwise it is the same as the existence check.
+*            A local file without a catalog entry is kept (and its entry seeded) if it is not older than the remote
+*            one. A changed local file is moved to '*.stale' and restored by 'UpdateCatalog' if the downloading fails
+**/
+bool FtpUtil::IsUpToDate(const ftpopt_t *fopt, const string &url, const string &file, catent_t &ent)
+{
+    ent.name = "";
+    string landed = LandedFile(file);
+    bool exist = !landed.empty();
+    if (!fopt->refresh) return exist || TakeShared(file) == 1;
+
+    if (!RemoteStat(fopt, url, file, ent))
+    {
+        ent.name = "";
+
+        return exist || TakeShared(file) == 1;
+    }
+    if (!exist)
+    {
+        /* the version in the store is taken only if it is the same as the remote one */
+        CatalogUtil storeCat;
+        catent_t stored;
+        bool same = _storeOn && storeCat.Load(_store.RefDir()) && storeCat.Find(file, stored) &&
+            storeCat.IsSame(stored, ent);
+        if (same && TakeShared(file) == 1)
+        {
+            UpdateCatalog(file, ent);
+
+            return true;
+        }
+        _lock.Lock(LockFile(file), true);
+
+        return false;
+    }
+
+    CatalogUtil cat;
+    catent_t old;
+    cat.Load("", _shardTag);
+    if (cat.Find(file, old))
+    {
+        if (cat.IsSame(old, ent)) return true;
+    }
+    else if (IsLocalCurrent(landed, file, ent))
+    {
+        /* the file was downloaded before the catalog was kept, its entry is seeded from the remote one */
+        cat.Update(ent);
+        cat.Save();
+
+        return true;
+    }
+
+    cout << "*** INFO(FtpUtil::IsUpToDate): " << file << " has changed upstream and will be downloaded again" << endl;
+    _lock.Lock(LockFile(file), true);
+    string staleFile = landed + ".stale";
+    remove(staleFile.c_str());
+    rename(landed.c_str(), staleFile.c_str());
+
+    return false;
+} /* end of IsUpToDate */
+
+/**
+* @brief   : UpdateCatalog - record the downloaded file in the freshness catalog
+* @param[I]: file (local file name in the current directory)
+* @param[I]: ent (catalog entry from 'IsUpToDate')
+* @param[O]: none
+* @return  : none
+* @note    : if the downloading failed, the previous version ('*.stale') is restored
+**/
+void FtpUtil::UpdateCatalog(const string &file, const catent_t &ent)
+{
+    /* the previous version is '*.stale' or '*.zst.stale', as it was kept */
+    string staleFile = file + ".stale", zstStale = file + ".zst.stale";
+    if (!LandedFile(file).empty())
+    {
+        if (access(staleFile.c_str(), 0) == 0) remove(staleFile.c_str());
+        if (access(zstStale.c_str(), 0) == 0) remove(zstStale.c_str());
+        if (ent.name.empty()) return;
+        if (ent.size > 0) _plan.Record(_planKind, 1, ent.size);
+
+        CatalogUtil cat;
+        cat.Load("", _shardTag);
+        cat.Update(ent);
+        cat.Save();
+
+        /* the store keeps the remote version of its latest content as well, its catalog is shared by the processes */
+        if (_storeOn)
+        {
+            cat.Load(_store.RefDir());
+            cat.Update(ent);
+            cat.Save();
+        }
+    }
+    else if (access(staleFile.c_str(), 0) == 0)
+    {
+        rename(staleFile.c_str(), file.c_str());
+        cout << "*** INFO(FtpUtil::UpdateCatalog): the previous version of " << file << " is kept" << endl;
+    }
+    else if (access(zstStale.c_str(), 0) == 0)
+    {
+        rename(zstStale.c_str(), (file + ".zst").c_str());
+        cout << "*** INFO(FtpUtil::UpdateCatalog): the previous version of " << file << " is kept" << endl;
+    }
+} /* end of UpdateCatalog */
 
 /**
 * @brief   : GetDailyObsIgs - download IGS RINEX daily observation (30s) files (short name "d") according to 'site.list' file
@@ -132,6 +2906,8 @@ void FtpUtil::init()
 **/
 void FtpUtil::GetDailyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBS);
+
     /* creation of sub-directory ('daily') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -166,28 +2942,16 @@ void FtpUtil::GetDailyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sDoy = str.doy2str(doy);
 
     /* FTP archive: CDDIS, IGN, or WHU */
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
-    if (strlen(fopt->obsOpt) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+    string gzipFull = fopt->gzipFull;
+    if (IsAllSites(fopt, fopt->obsOpt))  /* the option of 'all' is selected */
     {
         /* download all the IGS observation files */
-        string url, cutDirs = " --cut-dirs=7 ";
-        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBSD] + "/" +
-            sYyyy + "/" + sDoy + "/" + sYy + "d";
-        else if (strcmp(ftpName.c_str(), "IGN") == 0)
-        {
-            url = _ftpArchive.IGN[IDX_OBSD] + "/" + sYyyy + "/" + sDoy;
-            cutDirs = " --cut-dirs=5 ";
-        }
-        else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_OBSD] + "/" +
-            sYyyy + "/" + sDoy + "/" + sYy + "d";
-        else url = _ftpArchive.CDDIS[IDX_OBSD] + "/" + sYyyy + "/" + sDoy + "/" + sYy + "d";
+        string url = ArcUrl(fopt, IDX_OBSD, ts), cutDirs = CutDirs(url);
 
         /* it is OK for '*.Z' or '*.gz' format */
         string dFile = "*" + sDoy + "0." + sYy + "d";
         string dxFile = dFile + ".*";
-        string cmd = wgetFull + " " + qr + " -nH -A " + dxFile + cutDirs + url;
+        string cmd = FetchCmd(fopt, url, cutDirs, dxFile);
         std::system(cmd.c_str());
 
         /* get the file list */
@@ -200,22 +2964,16 @@ void FtpUtil::GetDailyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             if (access(dFiles[i].c_str(), 0) == 0)
             {
                 /* extract it */
-                cmd = gzipFull + " -d -f " + dFiles[i];
-                std::system(cmd.c_str());
+                UnzipObs(fopt, dFiles[i], "");
 
                 str.StrMid(sitName, dFiles[i].c_str(), 0, 4);
                 string site = sitName;
                 str.ToLower(site);
                 dFile = site + sDoy + "0." + sYy + "d";
                 if (access(dFile.c_str(), 0) == -1) continue;
-                string oFile = site + sDoy + "0." + sYy + "o";
+                string oFile = ObsName(fopt, site + sDoy + "0." + sYy + "o");
                 /* convert from 'd' file to 'o' file */
-#ifdef _WIN32  /* for Windows */
-                cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                std::system(cmd.c_str());
+                CrxToObs(fopt, dFile, oFile);
 
                 /* delete 'd' file */
 #ifdef _WIN32   /* for Windows */
@@ -224,89 +2982,84 @@ void FtpUtil::GetDailyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 cmd = "rm -rf " + dFile;
 #endif
                 std::system(cmd.c_str());
+                NotifyFile(fopt, oFile);
             }
         }
     }
     else  /* the option of full path of site list file is selected */
     {
-        /* download the IGS observation file site-by-site */
-        if (access(fopt->obsOpt, 0) == 0)
+        /* download the IGS observation files of all the sites in one FTP session */
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, fopt->obsOpt, sitNames))
         {
-            ifstream sitLst(fopt->obsOpt);
-            if (!sitLst.is_open())
+            std::vector<string> getSites, dxFiles, waitFiles;
+            for (string sitName : sitNames)
             {
-                cerr << "*** ERROR(FtpUtil::GetDailyObsIgs): open site.list = " << fopt->obsOpt << 
-                    " file failed, please check it" << endl;
+                str.ToLower(sitName);
+                string oFile = ObsName(fopt, sitName + sDoy + "0." + sYy + "o");
+                string dFile = sitName + sDoy + "0." + sYy + "d";
+                int got = 1;
+                if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                else if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1 &&
+                    (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+                else if (got == 0)
+                {
+                    /* it is OK for '*.Z' or '*.gz' format */
+                    getSites.push_back(sitName);
+                    dxFiles.push_back(dFile + ".*");
+                }
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetDailyObsIgs): IGS daily observation file " << oFile << 
+                        " or " << dFile << " has existed!" << endl;
+                    NotifyFile(fopt, oFile);
+                }
+            }
 
-                return;
+            if (dxFiles.size() > 0)
+            {
+                string url = ArcUrl(fopt, IDX_OBSD, ts), cutDirs = CutDirs(url);
+                FetchBatch(fopt, url, cutDirs, dxFiles);
             }
 
-            string sitName;
-            while (getline(sitLst, sitName))
+            for (string sitName : getSites)
             {
-                str.ToLower(sitName);
-                string oFile = sitName + sDoy + "0." + sYy + "o";
+                string oFile = ObsName(fopt, sitName + sDoy + "0." + sYy + "o");
                 string dFile = sitName + sDoy + "0." + sYy + "d";
-                if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1)
+                string dgzFile = dFile + ".gz", dzFile = dFile + ".Z";
+                string cmd;
+                if (access(dgzFile.c_str(), 0) == 0)
                 {
-                    string url, cutDirs = " --cut-dirs=7 ";
-                    if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBSD] + "/" +
-                        sYyyy + "/" + sDoy + "/" + sYy + "d";
-                    else if (strcmp(ftpName.c_str(), "IGN") == 0)
-                    {
-                        url = _ftpArchive.IGN[IDX_OBSD] + "/" + sYyyy + "/" + sDoy;
-                        cutDirs = " --cut-dirs=5 ";
-                    }
-                    else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_OBSD] + "/" +
-                        sYyyy + "/" + sDoy + "/" + sYy + "d";
-                    else url = _ftpArchive.CDDIS[IDX_OBSD] + "/" + sYyyy + "/" + sDoy + "/" + sYy + "d";
-
-                    /* it is OK for '*.Z' or '*.gz' format */
-                    string dxFile = dFile + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + dxFile + cutDirs + url;
-                    std::system(cmd.c_str());
-
-                    string dgzFile = dFile + ".gz", dzFile = dFile + ".Z";
-                    if (access(dgzFile.c_str(), 0) == 0)
-                    {
-                        /* extract '*.gz' */
-                        cmd = gzipFull + " -d -f " + dgzFile;
-                        std::system(cmd.c_str());
-                    }
-                    else if (access(dzFile.c_str(), 0) == 0)
-                    {
-                        /* extract '*.Z' */
-                        cmd = gzipFull + " -d -f " + dzFile;
-                        std::system(cmd.c_str());
-                    }
-                    if (access(dFile.c_str(), 0) == -1)
-                    {
-                        cout << "*** WARNING(FtpUtil::GetDailyObsIgs): failed to download IGS daily observation file " << oFile << endl;
+                    /* extract '*.gz' */
+                    UnzipObs(fopt, dgzFile, "");
+                }
+                else if (access(dzFile.c_str(), 0) == 0)
+                {
+                    /* extract '*.Z' */
+                    UnzipObs(fopt, dzFile, "");
+                }
+                if (access(dFile.c_str(), 0) == -1)
+                {
+                    cout << "*** WARNING(FtpUtil::GetDailyObsIgs): failed to download IGS daily observation file " << oFile << endl;
+                    NotifyFile(fopt, oFile);
 
-                        continue;
-                    }
+                    continue;
+                }
 
-#ifdef _WIN32  /* for Windows */
-                    cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                    cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                    std::system(cmd.c_str());
+                CrxToObs(fopt, dFile, oFile);
 
-                    if (access(oFile.c_str(), 0) == 0)
-                    {
-                        cout << "*** INFO(FtpUtil::GetDailyObsIgs): successfully download IGS daily observation file " << oFile << endl;
+                if (access(oFile.c_str(), 0) == 0)
+                {
+                    cout << "*** INFO(FtpUtil::GetDailyObsIgs): successfully download IGS daily observation file " << oFile << endl;
+                    NotifyFile(fopt, oFile);
 
-                        /* delete dFile */
-                        remove(dFile.c_str());
-                    }
+                    /* delete dFile */
+                    remove(dFile.c_str());
                 }
-                else cout << "*** INFO(FtpUtil::GetDailyObsIgs): IGS daily observation file " << oFile << 
-                    " or " << dFile << " has existed!" << endl;
             }
 
-            /* close 'site.list' */
-            sitLst.close();
+            /* the files that another GOOD process is downloading */
+            WaitShared(fopt, waitFiles);
         }
     }
 } /* end of GetDailyObsIgs */
@@ -322,6 +3075,8 @@ void FtpUtil::GetDailyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetHourlyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBSH);
+
     /* creation of sub-directory ('hourly') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -349,10 +3104,8 @@ void FtpUtil::GetHourlyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt
     string sDoy = str.doy2str(doy);
 
     /* FTP archive: CDDIS, IGN, or WHU */
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
-    if (strlen(fopt->obsOpt) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+    string gzipFull = fopt->gzipFull;
+    if (IsAllSites(fopt, fopt->obsOpt))  /* the option of 'all' is selected */
     {
         /* download all the IGS observation files */
         for (int i = 0; i < fopt->hhObs.size(); i++)
@@ -380,17 +3133,7 @@ void FtpUtil::GetHourlyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt
             chdir(sHhDir.c_str());
 #endif
 
-            string url, cutDirs = " --cut-dirs=7 ";
-            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBSH] + "/" +
-                sYyyy + "/" + sDoy + "/" + sHh;
-            else if (strcmp(ftpName.c_str(), "IGN") == 0)
-            {
-                url = _ftpArchive.IGN[IDX_OBSH] + "/" + sYyyy + "/" + sDoy;
-                cutDirs = " --cut-dirs=6 ";
-            }
-            else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_OBSH] + "/" +
-                sYyyy + "/" + sDoy + "/" + sHh;
-            else url = _ftpArchive.CDDIS[IDX_OBSH] + "/" + sYyyy + "/" + sDoy + "/" + sHh;
+            string url = ArcUrl(fopt, IDX_OBSH, ts, sHh), cutDirs = CutDirs(url);
 
             /* 'a' = 97, 'b' = 98, ... */
             int ii = fopt->hhObs[i] + 97;
@@ -400,7 +3143,7 @@ void FtpUtil::GetHourlyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt
             /* it is OK for '*.Z' or '*.gz' format */
             string dFile = "*" + sDoy + sch + "." + sYy + "d";
             string dxFile = dFile + ".*";
-            string cmd = wgetFull + " " + qr + " -nH -A " + dxFile + cutDirs + url;
+            string cmd = FetchCmd(fopt, url, cutDirs, dxFile);
             std::system(cmd.c_str());
 
             /* get the file list */
@@ -413,22 +3156,16 @@ void FtpUtil::GetHourlyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt
                 if (access(dFiles[i].c_str(), 0) == 0)
                 {
                     /* extract it */
-                    cmd = gzipFull + " -d -f " + dFiles[i];
-                    std::system(cmd.c_str());
+                    UnzipObs(fopt, dFiles[i], "");
 
                     str.StrMid(sitName, dFiles[i].c_str(), 0, 4);
                     string site = sitName;
                     str.ToLower(site);
                     dFile = site + sDoy + sch + "." + sYy + "d";
                     if (access(dFile.c_str(), 0) == -1) continue;
-                    string oFile = site + sDoy + sch + "." + sYy + "o";
+                    string oFile = ObsName(fopt, site + sDoy + sch + "." + sYy + "o");
                     /* convert from 'd' file to 'o' file */
-#ifdef _WIN32  /* for Windows */
-                    cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                    cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                    std::system(cmd.c_str());
+                    CrxToObs(fopt, dFile, oFile);
 
                     /* delete 'd' file */
 #ifdef _WIN32   /* for Windows */
@@ -437,121 +3174,117 @@ void FtpUtil::GetHourlyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt
                     cmd = "rm -rf " + dFile;
 #endif
                     std::system(cmd.c_str());
+                    NotifyFile(fopt, oFile);
                 }
             }
         }
     }
     else  /* the option of full path of site list file is selected */
     {
-        /* download the IGS observation file site-by-site */
-        if (access(fopt->obsOpt, 0) == 0)
+        /* download the IGS observation files of all the sites in one session per hour */
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, fopt->obsOpt, sitNames))
         {
-            ifstream sitLst(fopt->obsOpt);
-            if (!sitLst.is_open())
-            {
-                cerr << "*** ERROR(FtpUtil::GetHourlyObsIgs): open site.list = " << fopt->obsOpt << 
-                    " file failed, please check it" << endl;
-
-                return;
-            }
-
-            string sitName;
-            while (getline(sitLst, sitName))
+            for (size_t i = 0; i < fopt->hhObs.size(); i++)
             {
-                for (int i = 0; i < fopt->hhObs.size(); i++)
+                string sHh = str.hh2str(fopt->hhObs[i]);
+                char tmpDir[MAXSTRPATH] = { '\0' };
+                char sep = (char)FILEPATHSEP;
+                sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
+                string sHhDir = tmpDir;
+                if (access(sHhDir.c_str(), 0) == -1)
                 {
-                    string sHh = str.hh2str(fopt->hhObs[i]);
-                    char tmpDir[MAXSTRPATH] = { '\0' };
-                    char sep = (char)FILEPATHSEP;
-                    sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
-                    string sHhDir = tmpDir;
-                    if (access(sHhDir.c_str(), 0) == -1)
-                    {
-                        /* If the directory does not exist, creat it */
+                    /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                        string cmd = "mkdir " + sHhDir;
+                    string cmd = "mkdir " + sHhDir;
 #else           /* for Linux or Mac */
-                        string cmd = "mkdir -p " + sHhDir;
+                    string cmd = "mkdir -p " + sHhDir;
 #endif
-                        std::system(cmd.c_str());
-                    }
+                    std::system(cmd.c_str());
+                }
 
-                    /* change directory */
+                /* change directory */
 #ifdef _WIN32   /* for Windows */
-                    _chdir(sHhDir.c_str());
+                _chdir(sHhDir.c_str());
 #else           /* for Linux or Mac */
-                    chdir(sHhDir.c_str());
+                chdir(sHhDir.c_str());
 #endif
 
-                    /* 'a' = 97, 'b' = 98, ... */
-                    int ii = fopt->hhObs[i] + 97;
-                    char ch = ii;
-                    string sch;
-                    sch.push_back(ch);
+                /* 'a' = 97, 'b' = 98, ... */
+                int ii = fopt->hhObs[i] + 97;
+                char ch = ii;
+                string sch;
+                sch.push_back(ch);
+
+                std::vector<string> getSites, pats, waitFiles;
+                for (string sitName : sitNames)
+                {
                     str.ToLower(sitName);
-                    string oFile = sitName + sDoy + sch + "." + sYy + "o";
+                    string oFile = ObsName(fopt, sitName + sDoy + sch + "." + sYy + "o");
                     string dFile = sitName + sDoy + sch + "." + sYy + "d";
-                    if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1)
+                    int got = 1;
+                    if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                    else if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1 &&
+                        (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+                    else if (got == 0)
                     {
-                        string url, cutDirs = " --cut-dirs=7 ";
-                        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBSH] + "/" +
-                            sYyyy + "/" + sDoy + "/" + sHh;
-                        else if (strcmp(ftpName.c_str(), "IGN") == 0)
-                        {
-                            url = _ftpArchive.IGN[IDX_OBSH] + "/" + sYyyy + "/" + sDoy;
-                            cutDirs = " --cut-dirs=6 ";
-                        }
-                        else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_OBSH] + "/" +
-                            sYyyy + "/" + sDoy + "/" + sHh;
-                        else url = _ftpArchive.CDDIS[IDX_OBSH] + "/" + sYyyy + "/" + sDoy + "/" + sHh;
-
                         /* it is OK for '*.Z' or '*.gz' format */
-                        string dxFile = dFile + ".*";
-                        string cmd = wgetFull + " " + qr + " -nH -A " + dxFile + cutDirs + url;
-                        std::system(cmd.c_str());
+                        getSites.push_back(sitName);
+                        pats.push_back(dFile + ".*");
+                    }
+                    else
+                    {
+                        cout << "*** INFO(FtpUtil::GetHourlyObsIgs): IGS hourly observation file " << oFile <<
+                            " or " << dFile << " has existed!" << endl;
+                        NotifyFile(fopt, oFile);
+                    }
+                }
 
-                        string dgzFile = dFile + ".gz", dzFile = dFile + ".Z";
-                        if (access(dgzFile.c_str(), 0) == 0)
-                        {
-                            /* extract '*.gz' */
-                            cmd = gzipFull + " -d -f " + dgzFile;
-                            std::system(cmd.c_str());
-                        }
-                        else if (access(dzFile.c_str(), 0) == 0)
-                        {
-                            /* extract '*.Z' */
-                            cmd = gzipFull + " -d -f " + dzFile;
-                            std::system(cmd.c_str());
-                        }
-                        if (access(dFile.c_str(), 0) == -1)
-                        {
-                            cout << "*** WARNING(FtpUtil::GetHourlyObsIgs): failed to download IGS Hourly observation file " << oFile << endl;
+                if (pats.size() > 0)
+                {
+                    string url = ArcUrl(fopt, IDX_OBSH, ts, sHh), cutDirs = CutDirs(url);
+                    FetchBatch(fopt, url, cutDirs, pats);
+                }
 
-                            continue;
-                        }
+                for (string sitName : getSites)
+                {
+                    string oFile = ObsName(fopt, sitName + sDoy + sch + "." + sYy + "o");
+                    string dFile = sitName + sDoy + sch + "." + sYy + "d";
+                    string dgzFile = dFile + ".gz", dzFile = dFile + ".Z";
+                    string cmd;
+                    if (access(dgzFile.c_str(), 0) == 0)
+                    {
+                        /* extract '*.gz' */
+                        UnzipObs(fopt, dgzFile, "");
+                    }
+                    else if (access(dzFile.c_str(), 0) == 0)
+                    {
+                        /* extract '*.Z' */
+                        UnzipObs(fopt, dzFile, "");
+                    }
+                    if (access(dFile.c_str(), 0) == -1)
+                    {
+                        cout << "*** WARNING(FtpUtil::GetHourlyObsIgs): failed to download IGS hourly observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
-#ifdef _WIN32  /* for Windows */
-                        cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                        cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                        std::system(cmd.c_str());
+                        continue;
+                    }
 
-                        if (access(oFile.c_str(), 0) == 0)
-                        {
-                            cout << "*** INFO(FtpUtil::GetHourlyObsIgs): successfully download IGS hourly observation file " << oFile << endl;
+                    CrxToObs(fopt, dFile, oFile);
 
-                            /* delete dFile */
-                            remove(dFile.c_str());
-                        }
+                    if (access(oFile.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetHourlyObsIgs): successfully download IGS hourly observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
+
+                        /* delete dFile */
+                        remove(dFile.c_str());
                     }
-                    else cout << "*** INFO(FtpUtil::GetHourlyObsIgs): IGS hourly observation file " <<
-                        oFile << " or " << dFile << " has existed!" << endl;
                 }
-            }
 
-            /* close 'site.list' */
-            sitLst.close();
+                /* the files that another GOOD process is downloading */
+                WaitShared(fopt, waitFiles);
+            }
         }
     }
 } /* end of GetHourlyObsIgs */
@@ -567,6 +3300,8 @@ void FtpUtil::GetHourlyObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt
 **/
 void FtpUtil::GetHrObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBSH);
+
     /* creation of sub-directory ('highrate') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -594,10 +3329,8 @@ void FtpUtil::GetHrObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sDoy = str.doy2str(doy);
 
     /* FTP archive: CDDIS, IGN, or WHU */
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
-    if (strlen(fopt->obsOpt) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+    string gzipFull = fopt->gzipFull;
+    if (IsAllSites(fopt, fopt->obsOpt))  /* the option of 'all' is selected */
     {
         /* download all the IGS observation files */
         for (int i = 0; i < fopt->hhObs.size(); i++)
@@ -625,15 +3358,7 @@ void FtpUtil::GetHrObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             chdir(sHhDir.c_str());
 #endif
 
-            string url, cutDirs = " --cut-dirs=8 ";
-            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBSHR] + "/" +
-                sYyyy + "/" + sDoy + "/" + sYy + "d" + "/" + sHh;
-            else if (strcmp(ftpName.c_str(), "IGN") == 0)
-            {
-                url = _ftpArchive.IGN[IDX_OBSHR] + "/" + sYyyy + "/" + sDoy;
-                cutDirs = " --cut-dirs=6 ";
-            }
-            else url = _ftpArchive.CDDIS[IDX_OBSHR] + "/" + sYyyy + "/" + sDoy + "/" + sYy + "d" + "/" + sHh;
+            string url = ArcUrl(fopt, IDX_OBSHR, ts, sHh), cutDirs = CutDirs(url);
 
             /* 'a' = 97, 'b' = 98, ... */
             int ii = fopt->hhObs[i] + 97;
@@ -643,12 +3368,16 @@ void FtpUtil::GetHrObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             /* it is OK for '*.Z' or '*.gz' format */
             string dFile = "*" + sDoy + sch + "*." + sYy + "d";
             string dxFile = dFile + ".*";
-            string cmd = wgetFull + " " + qr + " -nH -A " + dxFile + cutDirs + url;
+            if (_rangeTe.mjd != 0) dxFile = QuarterPatterns(ts, fopt->hhObs[i], "*" + sDoy + sch, "." + sYy + "d.*");
+            string cmd = FetchCmd(fopt, url, cutDirs, dxFile);
             std::system(cmd.c_str());
 
+            int qmask = Quarters(ts, ch - 'a');  /* 15-minute files in the time range requested */
             std::vector<string> minuStr = { "00", "15", "30", "45" };
             for (int i = 0; i < minuStr.size(); i++)
             {
+                if ((qmask >> i & 1) == 0) continue;
+
                 /* get the file list */
                 string suffix = minuStr[i] + "." + sYy + "d";
                 vector<string> dFiles;
@@ -659,22 +3388,16 @@ void FtpUtil::GetHrObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                     if (access(dFiles[j].c_str(), 0) == 0)
                     {
                         /* extract it */
-                        cmd = gzipFull + " -d -f " + dFiles[j];
-                        std::system(cmd.c_str());
+                        UnzipObs(fopt, dFiles[j], "");
 
                         str.StrMid(sitName, dFiles[j].c_str(), 0, 4);
                         string site = sitName;
                         str.ToLower(site);
                         dFile = site + sDoy + sch + minuStr[i] + "." + sYy + "d";
                         if (access(dFile.c_str(), 0) == -1) continue;
-                        string oFile = site + sDoy + sch + minuStr[i] + "." + sYy + "o";
+                        string oFile = ObsName(fopt, site + sDoy + sch + minuStr[i] + "." + sYy + "o");
                         /* convert from 'd' file to 'o' file */
-#ifdef _WIN32  /* for Windows */
-                        cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                        cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                        std::system(cmd.c_str());
+                        CrxToObs(fopt, dFile, oFile);
 
                         /* delete 'd' file */
 #ifdef _WIN32   /* for Windows */
@@ -683,6 +3406,7 @@ void FtpUtil::GetHrObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                         cmd = "rm -rf " + dFile;
 #endif
                         std::system(cmd.c_str());
+                        NotifyFile(fopt, oFile);
                     }
                 }
             }
@@ -690,118 +3414,119 @@ void FtpUtil::GetHrObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     }
     else  /* the option of full path of site list file is selected */
     {
-        /* download the IGS observation file site-by-site */
-        if (access(fopt->obsOpt, 0) == 0)
+        /* download the IGS observation files of all the sites in one session per hour */
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, fopt->obsOpt, sitNames))
         {
-            ifstream sitLst(fopt->obsOpt);
-            if (!sitLst.is_open())
-            {
-                cerr << "*** ERROR(FtpUtil::GetHrObsIgs): open site.list = " << fopt->obsOpt << 
-                    " file failed, please check it" << endl;
-
-                return;
-            }
-
-            string sitName;
-            while (getline(sitLst, sitName))
+            for (size_t i = 0; i < fopt->hhObs.size(); i++)
             {
-                for (int i = 0; i < fopt->hhObs.size(); i++)
-                {
-                    string sHh = str.hh2str(fopt->hhObs[i]);
-                    char tmpDir[MAXSTRPATH] = { '\0' };
-                    char sep = (char)FILEPATHSEP;
-                    sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
-                    string sHhDir = tmpDir;
-                    if (access(sHhDir.c_str(), 0) == -1)
-                    {
-                        /* If the directory does not exist, creat it */
+                string sHh = str.hh2str(fopt->hhObs[i]);
+                char tmpDir[MAXSTRPATH] = { '\0' };
+                char sep = (char)FILEPATHSEP;
+                sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
+                string sHhDir = tmpDir;
+                if (access(sHhDir.c_str(), 0) == -1)
+                {
+                    /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                        string cmd = "mkdir " + sHhDir;
+                    string cmd = "mkdir " + sHhDir;
 #else           /* for Linux or Mac */
-                        string cmd = "mkdir -p " + sHhDir;
+                    string cmd = "mkdir -p " + sHhDir;
 #endif
-                        std::system(cmd.c_str());
-                    }
+                    std::system(cmd.c_str());
+                }
 
-                    /* change directory */
+                /* change directory */
 #ifdef _WIN32   /* for Windows */
-                    _chdir(sHhDir.c_str());
+                _chdir(sHhDir.c_str());
 #else           /* for Linux or Mac */
-                    chdir(sHhDir.c_str());
+                chdir(sHhDir.c_str());
 #endif
 
-                    /* 'a' = 97, 'b' = 98, ... */
-                    int ii = fopt->hhObs[i] + 97;
-                    char ch = ii;
-                    string sch;
-                    sch.push_back(ch);
+                /* 'a' = 97, 'b' = 98, ... */
+                int ii = fopt->hhObs[i] + 97;
+                char ch = ii;
+                string sch;
+                sch.push_back(ch);
 
-                    std::vector<string> minuStr = { "00", "15", "30", "45" };
-                    for (int i = 0; i < minuStr.size(); i++)
+                int qmask = Quarters(ts, ch - 'a');  /* 15-minute files in the time range requested */
+                std::vector<string> minuStr = { "00", "15", "30", "45" };
+                std::vector<string> getSites, getMinus, pats, waitFiles;
+                for (string sitName : sitNames)
+                {
+                    for (size_t k = 0; k < minuStr.size(); k++)
                     {
+                        if ((qmask >> k & 1) == 0) continue;
+
                         str.ToLower(sitName);
-                        string oFile = sitName + sDoy + sch + minuStr[i] + "." + sYy + "o";
-                        string dFile = sitName + sDoy + sch + minuStr[i] + "." + sYy + "d";
-                        if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1)
+                        string oFile = ObsName(fopt, sitName + sDoy + sch + minuStr[k] + "." + sYy + "o");
+                        string dFile = sitName + sDoy + sch + minuStr[k] + "." + sYy + "d";
+                        int got = 1;
+                        if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                        else if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1 &&
+                            (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+                        else if (got == 0)
                         {
-                            string url, cutDirs = " --cut-dirs=8 ";
-                            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBSHR] + "/" +
-                                sYyyy + "/" + sDoy + "/" + sYy + "d" + "/" + sHh;
-                            else if (strcmp(ftpName.c_str(), "IGN") == 0)
-                            {
-                                url = _ftpArchive.IGN[IDX_OBSHR] + "/" + sYyyy + "/" + sDoy;
-                                cutDirs = " --cut-dirs=6 ";
-                            }
-                            else url = _ftpArchive.CDDIS[IDX_OBSHR] + "/" + sYyyy + "/" + sDoy + "/" + sYy + "d" + "/" + sHh;
-
                             /* it is OK for '*.Z' or '*.gz' format */
-                            string dxFile = dFile + ".*";
-                            string cmd = wgetFull + " " + qr + " -nH -A " + dxFile + cutDirs + url;
-                            std::system(cmd.c_str());
+                            getSites.push_back(sitName);
+                            getMinus.push_back(minuStr[k]);
+                            pats.push_back(dFile + ".*");
+                        }
+                        else
+                        {
+                            cout << "*** INFO(FtpUtil::GetHrObsIgs): IGS high-rate observation file " << oFile <<
+                                " or " << dFile << " has existed!" << endl;
+                            NotifyFile(fopt, oFile);
+                        }
+                    }
+                }
 
-                            string dgzFile = dFile + ".gz", dzFile = dFile + ".Z";
-                            if (access(dgzFile.c_str(), 0) == 0)
-                            {
-                                /* extract '*.gz' */
-                                cmd = gzipFull + " -d -f " + dgzFile;
-                                std::system(cmd.c_str());
-                            }
-                            else if (access(dzFile.c_str(), 0) == 0)
-                            {
-                                /* extract '*.Z' */
-                                cmd = gzipFull + " -d -f " + dzFile;
-                                std::system(cmd.c_str());
-                            }
-                            if (access(dFile.c_str(), 0) == -1)
-                            {
-                                cout << "*** WARNING(FtpUtil::GetHrObsIgs): failed to download IGS high-rate observation file " << oFile << endl;
+                if (pats.size() > 0)
+                {
+                    string url = ArcUrl(fopt, IDX_OBSHR, ts, sHh), cutDirs = CutDirs(url);
+                    FetchBatch(fopt, url, cutDirs, pats);
+                }
 
-                                continue;
-                            }
+                for (size_t k = 0; k < getSites.size(); k++)
+                {
+                    string sitName = getSites[k];
+                    string oFile = ObsName(fopt, sitName + sDoy + sch + getMinus[k] + "." + sYy + "o");
+                    string dFile = sitName + sDoy + sch + getMinus[k] + "." + sYy + "d";
+                    string dgzFile = dFile + ".gz", dzFile = dFile + ".Z";
+                    string cmd;
+                    if (access(dgzFile.c_str(), 0) == 0)
+                    {
+                        /* extract '*.gz' */
+                        UnzipObs(fopt, dgzFile, "");
+                    }
+                    else if (access(dzFile.c_str(), 0) == 0)
+                    {
+                        /* extract '*.Z' */
+                        UnzipObs(fopt, dzFile, "");
+                    }
+                    if (access(dFile.c_str(), 0) == -1)
+                    {
+                        cout << "*** WARNING(FtpUtil::GetHrObsIgs): failed to download IGS high-rate observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
-#ifdef _WIN32  /* for Windows */
-                            cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                            cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                            std::system(cmd.c_str());
+                        continue;
+                    }
 
-                            if (access(oFile.c_str(), 0) == 0)
-                            {
-                                cout << "*** INFO(FtpUtil::GetHrObsIgs): successfully download IGS high-rate observation file " << oFile << endl;
+                    CrxToObs(fopt, dFile, oFile);
 
-                                /* delete dFile */
-                                remove(dFile.c_str());
-                            }
-                        }
-                        else cout << "*** INFO(FtpUtil::GetHrObsIgs): IGS high-rate observation file " <<
-                            oFile << " or " << dFile << " has existed!" << endl;
+                    if (access(oFile.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetHrObsIgs): successfully download IGS high-rate observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
+
+                        /* delete dFile */
+                        remove(dFile.c_str());
                     }
                 }
-            }
 
-            /* close 'site.list' */
-            sitLst.close();
+                /* the files that another GOOD process is downloading */
+                WaitShared(fopt, waitFiles);
+            }
         }
     }
 } /* end of GetHrObsIgs */
@@ -817,6 +3542,8 @@ void FtpUtil::GetHrObsIgs(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetDailyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBS);
+
     /* creation of sub-directory ('daily') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -851,28 +3578,16 @@ void FtpUtil::GetDailyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt
     string sDoy = str.doy2str(doy);
 
     /* FTP archive: CDDIS, IGN, or WHU */
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
-    if (strlen(fopt->obmOpt) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+    string gzipFull = fopt->gzipFull;
+    if (IsAllSites(fopt, fopt->obmOpt))  /* the option of 'all' is selected */
     {
         /* download all the MGEX observation files */
-        string url, cutDirs = " --cut-dirs=7 ";
-        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBMD] + "/" + 
-            sYyyy + "/" + sDoy + "/" + sYy + "d";
-        else if (strcmp(ftpName.c_str(), "IGN") == 0)
-        {
-            url = _ftpArchive.IGN[IDX_OBMD] + "/" + sYyyy + "/" + sDoy;
-            cutDirs = " --cut-dirs=5 ";
-        }
-        else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_OBMD] + "/" + 
-            sYyyy + "/" + sDoy + "/" + sYy + "d";
-        else url = _ftpArchive.CDDIS[IDX_OBMD] + "/" + sYyyy + "/" + sDoy + "/" + sYy + "d";
+        string url = ArcUrl(fopt, IDX_OBMD, ts), cutDirs = CutDirs(url);
 
         /* it is OK for '*.Z' or '*.gz' format */
         string crxFile = "*_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx";
         string crxxFile = crxFile + ".*";
-        string cmd = wgetFull + " " + qr + " -nH -A " + crxxFile + cutDirs + url;
+        string cmd = FetchCmd(fopt, url, cutDirs, crxxFile);
         std::system(cmd.c_str());
 
         /* get the file list */
@@ -885,8 +3600,7 @@ void FtpUtil::GetDailyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt
             if (access(crxFiles[i].c_str(), 0) == 0)
             {
                 /* extract it */
-                cmd = gzipFull + " -d -f " + crxFiles[i];
-                std::system(cmd.c_str());
+                UnzipObs(fopt, crxFiles[i], "");
 
                 str.StrMid(sitName, crxFiles[i].c_str(), 0, 4);
                 string site = sitName;
@@ -894,14 +3608,9 @@ void FtpUtil::GetDailyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt
                 str.StrMid(sitName, crxFiles[i].c_str(), 0, (int)crxFiles[i].find_last_of('.'));
                 crxFile = sitName;
                 if (access(crxFile.c_str(), 0) == -1) continue;
-                string oFile = site + sDoy + "0." + sYy + "o";
+                string oFile = ObsName(fopt, site + sDoy + "0." + sYy + "o");
                 /* convert from 'd' file to 'o' file */
-#ifdef _WIN32  /* for Windows */
-                cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                std::system(cmd.c_str());
+                CrxToObs(fopt, crxFile, oFile);
 
                 /* delete 'd' file */
 #ifdef _WIN32   /* for Windows */
@@ -910,99 +3619,97 @@ void FtpUtil::GetDailyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt
                 cmd = "rm -rf " + crxFile;
 #endif
                 std::system(cmd.c_str());
+                NotifyFile(fopt, oFile);
             }
         }
     }
     else  /* the option of full path of site list file is selected */
     {
-        /* download the MGEX observation file site-by-site */
-        if (access(fopt->obmOpt, 0) == 0)
+        /* download the MGEX observation files of all the sites in one FTP session */
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, fopt->obmOpt, sitNames))
         {
-            ifstream sitLst(fopt->obmOpt);
-            if (!sitLst.is_open())
-            {
-                cerr << "*** ERROR(FtpUtil::GetDailyObsMgex): open site.list = " << fopt->obmOpt << " file failed, please check it" << endl;
-
-                return;
-            }
-
-            string sitName;
-            while (getline(sitLst, sitName))
+            std::vector<string> getSites, crxxFiles, waitFiles;
+            for (string sitName : sitNames)
             {
                 str.ToLower(sitName);
-                string oFile = sitName + sDoy + "0." + sYy + "o";
+                string oFile = ObsName(fopt, sitName + sDoy + "0." + sYy + "o");
                 string dFile = sitName + sDoy + "0." + sYy + "d";
-                if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1)
+                int got = 1;
+                if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                else if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1 &&
+                    (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+                else if (got == 0)
                 {
-                    string url, cutDirs = " --cut-dirs=7 ";
-                    if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBMD] + "/" + 
-                        sYyyy + "/" + sDoy + "/" + sYy + "d";
-                    else if (strcmp(ftpName.c_str(), "IGN") == 0)
-                    {
-                        url = _ftpArchive.IGN[IDX_OBMD] + "/" + sYyyy + "/" + sDoy;
-                        cutDirs = " --cut-dirs=5 ";
-                    }
-                    else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_OBMD] + "/" + 
-                        sYyyy + "/" + sDoy + "/" + sYy + "d";
-                    else url = _ftpArchive.CDDIS[IDX_OBMD] + "/" + sYyyy + "/" + sDoy + "/" + sYy + "d";
-
                     /* it is OK for '*.Z' or '*.gz' format */
+                    getSites.push_back(sitName);
                     str.ToUpper(sitName);
-                    string crxFile = sitName + "*_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx";
-                    string crxxFile = crxFile + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + crxxFile + cutDirs + url;
-                    std::system(cmd.c_str());
+                    crxxFiles.push_back(sitName + "*_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx.*");
+                }
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetDailyObsMgex): MGEX daily observation file " << oFile << 
+                        " or " << dFile << " has existed!" << endl;
+                    NotifyFile(fopt, oFile);
+                }
+            }
 
-                    /* extract '*.gz' */
-                    string crxgzFile = crxFile + ".gz";
-                    cmd = gzipFull + " -d -f " + crxgzFile;
-                    std::system(cmd.c_str());
-                    string changeFileName;
+            if (crxxFiles.size() > 0)
+            {
+                string url = ArcUrl(fopt, IDX_OBMD, ts), cutDirs = CutDirs(url);
+                FetchBatch(fopt, url, cutDirs, crxxFiles);
+            }
+
+            for (string sitName : getSites)
+            {
+                string oFile = ObsName(fopt, sitName + sDoy + "0." + sYy + "o");
+                string dFile = sitName + sDoy + "0." + sYy + "d";
+                str.ToUpper(sitName);
+                string crxFile = sitName + "*_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx";
+
+                /* extract '*.gz' */
+                string crxgzFile = crxFile + ".gz";
+                UnzipObs(fopt, crxgzFile, dFile);
+                string cmd;
+                string changeFileName;
 #ifdef _WIN32  /* for Windows */
-                    changeFileName = "rename";
+                changeFileName = "rename";
 #else          /* for Linux or Mac */
-                    changeFileName = "mv";
+                changeFileName = "mv";
 #endif
+                cmd = changeFileName + " " + crxFile + " " + dFile;
+                std::system(cmd.c_str());
+                if (access(dFile.c_str(), 0) == -1)
+                {
+                    /* extract '*.Z' */
+                    string crxzFile = crxFile + ".Z";
+                    UnzipObs(fopt, crxzFile, dFile);
+
                     cmd = changeFileName + " " + crxFile + " " + dFile;
                     std::system(cmd.c_str());
                     if (access(dFile.c_str(), 0) == -1)
                     {
-                        /* extract '*.Z' */
-                        string crxzFile = crxFile + ".Z";
-                        cmd = gzipFull + " -d -f " + crxzFile;
-                        std::system(cmd.c_str());
-
-                        cmd = changeFileName + " " + crxFile + " " + dFile;
-                        std::system(cmd.c_str());
-                        if (access(dFile.c_str(), 0) == -1)
-                        {
-                            cout << "*** WARNING(FtpUtil::GetDailyObsMgex): failed to download MGEX daily observation file " << oFile << endl;
+                        cout << "*** WARNING(FtpUtil::GetDailyObsMgex): failed to download MGEX daily observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
-                            continue;
-                        }
+                        continue;
                     }
+                }
 
-#ifdef _WIN32  /* for Windows */
-                    cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                    cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                    std::system(cmd.c_str());
+                CrxToObs(fopt, dFile, oFile);
 
-                    if (access(oFile.c_str(), 0) == 0)
-                    {
-                        cout << "*** INFO(FtpUtil::GetDailyObsMgex): successfully download MGEX daily observation file " << oFile << endl;
+                if (access(oFile.c_str(), 0) == 0)
+                {
+                    cout << "*** INFO(FtpUtil::GetDailyObsMgex): successfully download MGEX daily observation file " << oFile << endl;
+                    NotifyFile(fopt, oFile);
 
-                        /* delete dFile */
-                        remove(dFile.c_str());
-                    }
+                    /* delete dFile */
+                    remove(dFile.c_str());
                 }
-                else cout << "*** INFO(FtpUtil::GetDailyObsMgex): MGEX daily observation file " << oFile << 
-                    " or " << dFile << " has existed!" << endl;
             }
 
-            /* close 'site.list' */
-            sitLst.close();
+            /* the files that another GOOD process is downloading */
+            WaitShared(fopt, waitFiles);
         }
     }
 } /* end of GetDailyObsMgex */
@@ -1018,6 +3725,8 @@ void FtpUtil::GetDailyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt
 **/
 void FtpUtil::GetHourlyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBSH);
+
     /* creation of sub-directory ('hourly') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -1045,10 +3754,8 @@ void FtpUtil::GetHourlyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fop
     string sDoy = str.doy2str(doy);
 
     /* FTP archive: CDDIS, IGN, or WHU */
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
-    if (strlen(fopt->obmOpt) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+    string gzipFull = fopt->gzipFull;
+    if (IsAllSites(fopt, fopt->obmOpt))  /* the option of 'all' is selected */
     {
         /* download all the MGEX observation files */
         for (int i = 0; i < fopt->hhObm.size(); i++)
@@ -1076,22 +3783,12 @@ void FtpUtil::GetHourlyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fop
             chdir(sHhDir.c_str());
 #endif
 
-            string url, cutDirs = " --cut-dirs=7 ";
-            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBMH] + "/" +
-                sYyyy + "/" + sDoy + "/" + sHh;
-            else if (strcmp(ftpName.c_str(), "IGN") == 0)
-            {
-                url = _ftpArchive.IGN[IDX_OBMH] + "/" + sYyyy + "/" + sDoy;
-                cutDirs = " --cut-dirs=6 ";
-            }
-            else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_OBMH] + "/" +
-                sYyyy + "/" + sDoy + "/" + sHh;
-            else url = _ftpArchive.CDDIS[IDX_OBMH] + "/" + sYyyy + "/" + sDoy + "/" + sHh;
+            string url = ArcUrl(fopt, IDX_OBMH, ts, sHh), cutDirs = CutDirs(url);
 
             /* it is OK for '*.Z' or '*.gz' format */
             string crxFile = "*_R_" + sYyyy + sDoy + sHh + "00_01H_30S_MO.crx";
             string crxxFile = crxFile + ".*";
-            string cmd = wgetFull + " " + qr + " -nH -A " + crxxFile + cutDirs + url;
+            string cmd = FetchCmd(fopt, url, cutDirs, crxxFile);
             std::system(cmd.c_str());
 
             /* 'a' = 97, 'b' = 98, ... */
@@ -1110,8 +3807,7 @@ void FtpUtil::GetHourlyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fop
                 if (access(crxFiles[i].c_str(), 0) == 0)
                 {
                     /* extract it */
-                    cmd = gzipFull + " -d -f " + crxFiles[i];
-                    std::system(cmd.c_str());
+                    UnzipObs(fopt, crxFiles[i], "");
 
                     str.StrMid(sitName, crxFiles[i].c_str(), 0, 4);
                     string site = sitName;
@@ -1119,14 +3815,9 @@ void FtpUtil::GetHourlyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fop
                     str.StrMid(sitName, crxFiles[i].c_str(), 0, (int)crxFiles[i].find_last_of('.'));
                     crxFile = sitName;
                     if (access(crxFile.c_str(), 0) == -1) continue;
-                    string oFile = site + sDoy + sch + "." + sYy + "o";
+                    string oFile = ObsName(fopt, site + sDoy + sch + "." + sYy + "o");
                     /* convert from 'd' file to 'o' file */
-#ifdef _WIN32  /* for Windows */
-                    cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                    cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                    std::system(cmd.c_str());
+                    CrxToObs(fopt, crxFile, oFile);
 
                     /* delete 'd' file */
 #ifdef _WIN32   /* for Windows */
@@ -1135,129 +3826,130 @@ void FtpUtil::GetHourlyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fop
                     cmd = "rm -rf " + crxFile;
 #endif
                     std::system(cmd.c_str());
+                    NotifyFile(fopt, oFile);
                 }
             }
         }
     }
     else  /* the option of full path of site list file is selected */
     {
-        /* download the MGEX observation file site-by-site */
-        if (access(fopt->obmOpt, 0) == 0)
+        /* download the MGEX observation files of all the sites in one session per hour */
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, fopt->obmOpt, sitNames))
         {
-            ifstream sitLst(fopt->obmOpt);
-            if (!sitLst.is_open())
+            for (size_t i = 0; i < fopt->hhObm.size(); i++)
             {
-                cerr << "*** ERROR(FtpUtil::GetHourlyObsMgex): open site.list = " << fopt->obmOpt << " file failed, please check it" << endl;
-
-                return;
-            }
-
-            string sitName;
-            while (getline(sitLst, sitName))
-            {
-                for (int i = 0; i < fopt->hhObm.size(); i++)
+                string sHh = str.hh2str(fopt->hhObm[i]);
+                char tmpDir[MAXSTRPATH] = { '\0' };
+                char sep = (char)FILEPATHSEP;
+                sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
+                string sHhDir = tmpDir;
+                if (access(sHhDir.c_str(), 0) == -1)
                 {
-                    string sHh = str.hh2str(fopt->hhObm[i]);
-                    char tmpDir[MAXSTRPATH] = { '\0' };
-                    char sep = (char)FILEPATHSEP;
-                    sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
-                    string sHhDir = tmpDir;
-                    if (access(sHhDir.c_str(), 0) == -1)
-                    {
-                        /* If the directory does not exist, creat it */
+                    /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                        string cmd = "mkdir " + sHhDir;
+                    string cmd = "mkdir " + sHhDir;
 #else           /* for Linux or Mac */
-                        string cmd = "mkdir -p " + sHhDir;
+                    string cmd = "mkdir -p " + sHhDir;
 #endif
-                        std::system(cmd.c_str());
-                    }
+                    std::system(cmd.c_str());
+                }
 
-                    /* change directory */
+                /* change directory */
 #ifdef _WIN32   /* for Windows */
-                    _chdir(sHhDir.c_str());
+                _chdir(sHhDir.c_str());
 #else           /* for Linux or Mac */
-                    chdir(sHhDir.c_str());
+                chdir(sHhDir.c_str());
 #endif
 
-                    /* 'a' = 97, 'b' = 98, ... */
-                    int ii = fopt->hhObm[i] + 97;
-                    char ch = ii;
-                    string sch;
-                    sch.push_back(ch);
+                /* 'a' = 97, 'b' = 98, ... */
+                int ii = fopt->hhObm[i] + 97;
+                char ch = ii;
+                string sch;
+                sch.push_back(ch);
+
+                std::vector<string> getSites, pats, waitFiles;
+                for (string sitName : sitNames)
+                {
                     str.ToLower(sitName);
-                    string oFile = sitName + sDoy + sch + "." + sYy + "o";
+                    string oFile = ObsName(fopt, sitName + sDoy + sch + "." + sYy + "o");
                     string dFile = sitName + sDoy + sch + "." + sYy + "d";
-                    if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1)
+                    int got = 1;
+                    if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                    else if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1 &&
+                        (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+                    else if (got == 0)
                     {
-                        string url, cutDirs = " --cut-dirs=7 ";
-                        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBMH] + "/" +
-                            sYyyy + "/" + sDoy + "/" + sHh;
-                        else if (strcmp(ftpName.c_str(), "IGN") == 0)
-                        {
-                            url = _ftpArchive.IGN[IDX_OBMH] + "/" + sYyyy + "/" + sDoy;
-                            cutDirs = " --cut-dirs=6 ";
-                        }
-                        else url = _ftpArchive.CDDIS[IDX_OBMH] + "/" + sYyyy + "/" + sDoy + "/" + sHh;
-
                         /* it is OK for '*.Z' or '*.gz' format */
+                        getSites.push_back(sitName);
                         str.ToUpper(sitName);
-                        string crxFile = sitName + "*_R_" + sYyyy + sDoy + sHh + "00_01H_30S_MO.crx";
-                        string crxxFile = crxFile + ".*";
-                        string cmd = wgetFull + " " + qr + " -nH -A " + crxxFile + cutDirs + url;
-                        std::system(cmd.c_str());
+                        pats.push_back(sitName + "*_R_" + sYyyy + sDoy + sHh + "00_01H_30S_MO.crx.*");
+                    }
+                    else
+                    {
+                        cout << "*** INFO(FtpUtil::GetHourlyObsMgex): MGEX hourly observation file " << oFile <<
+                            " or " << dFile << " has existed!" << endl;
+                        NotifyFile(fopt, oFile);
+                    }
+                }
 
-                        /* extract '*.gz' */
-                        string crxgzFile = crxFile + ".gz";
-                        cmd = gzipFull + " -d -f " + crxgzFile;
-                        std::system(cmd.c_str());
-                        string changeFileName;
+                if (pats.size() > 0)
+                {
+                    string url = ArcUrl(fopt, IDX_OBMH, ts, sHh), cutDirs = CutDirs(url);
+                    FetchBatch(fopt, url, cutDirs, pats);
+                }
+
+                for (string sitName : getSites)
+                {
+                    string oFile = ObsName(fopt, sitName + sDoy + sch + "." + sYy + "o");
+                    string dFile = sitName + sDoy + sch + "." + sYy + "d";
+                    str.ToUpper(sitName);
+                    string crxFile = sitName + "*_R_" + sYyyy + sDoy + sHh + "00_01H_30S_MO.crx";
+
+                    /* extract '*.gz' */
+                    string crxgzFile = crxFile + ".gz";
+                    UnzipObs(fopt, crxgzFile, dFile);
+                    string cmd;
+                    string changeFileName;
 #ifdef _WIN32  /* for Windows */
-                        changeFileName = "rename";
+                    changeFileName = "rename";
 #else          /* for Linux or Mac */
-                        changeFileName = "mv";
+                    changeFileName = "mv";
 #endif
+                    cmd = changeFileName + " " + crxFile + " " + dFile;
+                    std::system(cmd.c_str());
+                    if (access(dFile.c_str(), 0) == -1)
+                    {
+                        /* extract '*.Z' */
+                        string crxzFile = crxFile + ".Z";
+                        UnzipObs(fopt, crxzFile, dFile);
+
                         cmd = changeFileName + " " + crxFile + " " + dFile;
                         std::system(cmd.c_str());
                         if (access(dFile.c_str(), 0) == -1)
                         {
-                            /* extract '*.Z' */
-                            string crxzFile = crxFile + ".Z";
-                            cmd = gzipFull + " -d -f " + crxzFile;
-                            std::system(cmd.c_str());
+                            cout << "*** WARNING(FtpUtil::GetHourlyObsMgex): failed to download MGEX hourly observation file " << oFile << endl;
+                            NotifyFile(fopt, oFile);
 
-                            cmd = changeFileName + " " + crxFile + " " + dFile;
-                            std::system(cmd.c_str());
-                            if (access(dFile.c_str(), 0) == -1)
-                            {
-                                cout << "*** WARNING(FtpUtil::GetDailyObsMgex): failed to download MGEX daily observation file " << oFile << endl;
-
-                                continue;
-                            }
+                            continue;
                         }
+                    }
 
-#ifdef _WIN32  /* for Windows */
-                        cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                        cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                        std::system(cmd.c_str());
+                    CrxToObs(fopt, dFile, oFile);
 
-                        if (access(oFile.c_str(), 0) == 0)
-                        {
-                            cout << "*** INFO(FtpUtil::GetHourlyObsMgex): successfully download MGEX hourly observation file " << oFile << endl;
+                    if (access(oFile.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetHourlyObsMgex): successfully download MGEX hourly observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
-                            /* delete dFile */
-                            remove(dFile.c_str());
-                        }
+                        /* delete dFile */
+                        remove(dFile.c_str());
                     }
-                    else cout << "*** INFO(FtpUtil::GetHourlyObsMgex): MGEX hourly observation file " <<
-                        oFile << " or " << dFile << " has existed!" << endl;
                 }
-            }
 
-            /* close 'site.list' */
-            sitLst.close();
+                /* the files that another GOOD process is downloading */
+                WaitShared(fopt, waitFiles);
+            }
         }
     }
 } /* end of GetHourlyObsMgex */
@@ -1273,6 +3965,8 @@ void FtpUtil::GetHourlyObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fop
 **/
 void FtpUtil::GetHrObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBSH);
+
     /* creation of sub-directory ('highrate') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -1300,10 +3994,8 @@ void FtpUtil::GetHrObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sDoy = str.doy2str(doy);
 
     /* FTP archive: CDDIS, IGN, or WHU */
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
-    if (strlen(fopt->obmOpt) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+    string gzipFull = fopt->gzipFull;
+    if (IsAllSites(fopt, fopt->obmOpt))  /* the option of 'all' is selected */
     {
         /* download all the MGEX observation files */
         for (int i = 0; i < fopt->hhObm.size(); i++)
@@ -1331,20 +4023,14 @@ void FtpUtil::GetHrObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             chdir(sHhDir.c_str());
 #endif
 
-            string url, cutDirs = " --cut-dirs=8 ";
-            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBMHR] + "/" +
-                sYyyy + "/" + sDoy + "/" + sYy + "d" + "/" + sHh;
-            else if (strcmp(ftpName.c_str(), "IGN") == 0)
-            {
-                url = _ftpArchive.IGN[IDX_OBMHR] + "/" + sYyyy + "/" + sDoy;
-                cutDirs = " --cut-dirs=6 ";
-            }
-            else url = _ftpArchive.CDDIS[IDX_OBMHR] + "/" + sYyyy + "/" + sDoy + "/" + sYy + "d" + "/" + sHh;
+            string url = ArcUrl(fopt, IDX_OBMHR, ts, sHh), cutDirs = CutDirs(url);
 
             /* it is OK for '*.Z' or '*.gz' format */
             string crxFile = "*_R_*_15M_01S_MO.crx";
             string crxxFile = crxFile + ".*";
-            string cmd = wgetFull + " " + qr + " -nH -A " + crxxFile + cutDirs + url;
+            if (_rangeTe.mjd != 0) crxxFile = QuarterPatterns(ts, fopt->hhObm[i], "*_R_" + sYyyy + sDoy + sHh,
+                "_15M_01S_MO.crx.*");
+            string cmd = FetchCmd(fopt, url, cutDirs, crxxFile);
             std::system(cmd.c_str());
 
             /* 'a' = 97, 'b' = 98, ... */
@@ -1353,9 +4039,12 @@ void FtpUtil::GetHrObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             string sch;
             sch.push_back(ch);
 
+            int qmask = Quarters(ts, ch - 'a');  /* 15-minute files in the time range requested */
             std::vector<string> minuStr = { "00", "15", "30", "45" };
             for (int i = 0; i < minuStr.size(); i++)
             {
+                if ((qmask >> i & 1) == 0) continue;
+
                 /* get the file list */
                 string suffix = minuStr[i] + "_15M_01S_MO.crx";
                 vector<string> crxFiles;
@@ -1366,8 +4055,7 @@ void FtpUtil::GetHrObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                     if (access(crxFiles[j].c_str(), 0) == 0)
                     {
                         /* extract it */
-                        cmd = gzipFull + " -d -f " + crxFiles[j];
-                        std::system(cmd.c_str());
+                        UnzipObs(fopt, crxFiles[j], "");
 
                         str.StrMid(sitName, crxFiles[j].c_str(), 0, 4);
                         string site = sitName;
@@ -1375,14 +4063,9 @@ void FtpUtil::GetHrObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                         str.StrMid(sitName, crxFiles[j].c_str(), 0, (int)crxFiles[j].find_last_of('.'));
                         crxFile = sitName;
                         if (access(crxFile.c_str(), 0) == -1) continue;
-                        string oFile = site + sDoy + sch + minuStr[i] +  "." + sYy + "o";
+                        string oFile = ObsName(fopt, site + sDoy + sch + minuStr[i] +  "." + sYy + "o");
                         /* convert from 'd' file to 'o' file */
-#ifdef _WIN32  /* for Windows */
-                        cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                        cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                        std::system(cmd.c_str());
+                        CrxToObs(fopt, crxFile, oFile);
 
                         /* delete 'd' file */
 #ifdef _WIN32   /* for Windows */
@@ -1391,6 +4074,7 @@ void FtpUtil::GetHrObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                         cmd = "rm -rf " + crxFile;
 #endif
                         std::system(cmd.c_str());
+                        NotifyFile(fopt, oFile);
                     }
                 }
             }
@@ -1398,129 +4082,132 @@ void FtpUtil::GetHrObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     }
     else  /* the option of full path of site list file is selected */
     {
-        /* download the MGEX observation file site-by-site */
-        if (access(fopt->obmOpt, 0) == 0)
+        /* download the MGEX observation files of all the sites in one session per hour */
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, fopt->obmOpt, sitNames))
         {
-            ifstream sitLst(fopt->obmOpt);
-            if (!sitLst.is_open())
+            for (size_t i = 0; i < fopt->hhObm.size(); i++)
             {
-                cerr << "*** ERROR(FtpUtil::GetHrObsMgex): open site.list = " << fopt->obmOpt << " file failed, please check it" << endl;
-
-                return;
-            }
-
-            string sitName;
-            while (getline(sitLst, sitName))
-            {
-                for (int i = 0; i < fopt->hhObm.size(); i++)
+                string sHh = str.hh2str(fopt->hhObm[i]);
+                char tmpDir[MAXSTRPATH] = { '\0' };
+                char sep = (char)FILEPATHSEP;
+                sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
+                string sHhDir = tmpDir;
+                if (access(sHhDir.c_str(), 0) == -1)
                 {
-                    string sHh = str.hh2str(fopt->hhObm[i]);
-                    char tmpDir[MAXSTRPATH] = { '\0' };
-                    char sep = (char)FILEPATHSEP;
-                    sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
-                    string sHhDir = tmpDir;
-                    if (access(sHhDir.c_str(), 0) == -1)
-                    {
-                        /* If the directory does not exist, creat it */
+                    /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                        string cmd = "mkdir " + sHhDir;
+                    string cmd = "mkdir " + sHhDir;
 #else           /* for Linux or Mac */
-                        string cmd = "mkdir -p " + sHhDir;
+                    string cmd = "mkdir -p " + sHhDir;
 #endif
-                        std::system(cmd.c_str());
-                    }
+                    std::system(cmd.c_str());
+                }
 
-                    /* change directory */
+                /* change directory */
 #ifdef _WIN32   /* for Windows */
-                    _chdir(sHhDir.c_str());
+                _chdir(sHhDir.c_str());
 #else           /* for Linux or Mac */
-                    chdir(sHhDir.c_str());
+                chdir(sHhDir.c_str());
 #endif
 
-                    /* 'a' = 97, 'b' = 98, ... */
-                    int ii = fopt->hhObm[i] + 97;
-                    char ch = ii;
-                    string sch;
-                    sch.push_back(ch);
+                /* 'a' = 97, 'b' = 98, ... */
+                int ii = fopt->hhObm[i] + 97;
+                char ch = ii;
+                string sch;
+                sch.push_back(ch);
 
-                    std::vector<string> minuStr = { "00", "15", "30", "45" };
-                    for (int i = 0; i < minuStr.size(); i++)
+                int qmask = Quarters(ts, ch - 'a');  /* 15-minute files in the time range requested */
+                std::vector<string> minuStr = { "00", "15", "30", "45" };
+                std::vector<string> getSites, getMinus, pats, waitFiles;
+                for (string sitName : sitNames)
+                {
+                    for (size_t k = 0; k < minuStr.size(); k++)
                     {
+                        if ((qmask >> k & 1) == 0) continue;
+
                         str.ToLower(sitName);
-                        string oFile = sitName + sDoy + sch + minuStr[i] + "." + sYy + "o";
-                        string dFile = sitName + sDoy + sch + minuStr[i] + "." + sYy + "d";
-                        if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1)
+                        string oFile = ObsName(fopt, sitName + sDoy + sch + minuStr[k] + "." + sYy + "o");
+                        string dFile = sitName + sDoy + sch + minuStr[k] + "." + sYy + "d";
+                        int got = 1;
+                        if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                        else if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1 &&
+                            (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+                        else if (got == 0)
                         {
-                            string url, cutDirs = " --cut-dirs=8 ";
-                            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBMHR] + "/" +
-                                sYyyy + "/" + sDoy + "/" + sYy + "d" + "/" + sHh;
-                            else if (strcmp(ftpName.c_str(), "IGN") == 0)
-                            {
-                                url = _ftpArchive.IGN[IDX_OBMHR] + "/" + sYyyy + "/" + sDoy;
-                                cutDirs = " --cut-dirs=6 ";
-                            }
-                            else url = _ftpArchive.CDDIS[IDX_OBMHR] + "/" + sYyyy + "/" + sDoy + "/" + 
-                                sYy + "d" + "/" + sHh;
-
                             /* it is OK for '*.Z' or '*.gz' format */
+                            getSites.push_back(sitName);
+                            getMinus.push_back(minuStr[k]);
                             str.ToUpper(sitName);
-                            string crxFile = sitName + "*_R_" + sYyyy + sDoy + sHh + minuStr[i] + "_15M_01S_MO.crx";
-                            string crxxFile = crxFile + ".*";
-                            string cmd = wgetFull + " " + qr + " -nH -A " + crxxFile + cutDirs + url;
-                            std::system(cmd.c_str());
+                            pats.push_back(sitName + "*_R_" + sYyyy + sDoy + sHh + minuStr[k] + "_15M_01S_MO.crx.*");
+                        }
+                        else
+                        {
+                            cout << "*** INFO(FtpUtil::GetHrObsMgex): MGEX high-rate observation file " << oFile <<
+                                " or " << dFile << " has existed!" << endl;
+                            NotifyFile(fopt, oFile);
+                        }
+                    }
+                }
 
-                            /* extract '*.gz' */
-                            string crxgzFile = crxFile + ".gz";
-                            cmd = gzipFull + " -d -f " + crxgzFile;
-                            std::system(cmd.c_str());
-                            string changeFileName;
-#ifdef _WIN32  /* for Windows */
-                            changeFileName = "rename";
-#else          /* for Linux or Mac */
-                            changeFileName = "mv";
-#endif
-                            cmd = changeFileName + " " + crxFile + " " + dFile;
-                            std::system(cmd.c_str());
-                            if (access(dFile.c_str(), 0) == -1)
-                            {
-                                /* extract '*.Z' */
-                                string crxzFile = crxFile + ".Z";
-                                cmd = gzipFull + " -d -f " + crxzFile;
-                                std::system(cmd.c_str());
-
-                                cmd = changeFileName + " " + crxFile + " " + dFile;
-                                std::system(cmd.c_str());
-                                if (access(dFile.c_str(), 0) == -1)
-                                {
-                                    cout << "*** WARNING(FtpUtil::GetDailyObsMgex): failed to download MGEX daily observation file " << oFile << endl;
-
-                                    continue;
-                                }
-                            }
+                if (pats.size() > 0)
+                {
+                    string url = ArcUrl(fopt, IDX_OBMHR, ts, sHh), cutDirs = CutDirs(url);
+                    FetchBatch(fopt, url, cutDirs, pats);
+                }
+
+                for (size_t k = 0; k < getSites.size(); k++)
+                {
+                    string sitName = getSites[k];
+                    string oFile = ObsName(fopt, sitName + sDoy + sch + getMinus[k] + "." + sYy + "o");
+                    string dFile = sitName + sDoy + sch + getMinus[k] + "." + sYy + "d";
+                    str.ToUpper(sitName);
+                    string crxFile = sitName + "*_R_" + sYyyy + sDoy + sHh + getMinus[k] + "_15M_01S_MO.crx";
 
+                    /* extract '*.gz' */
+                    string crxgzFile = crxFile + ".gz";
+                    UnzipObs(fopt, crxgzFile, dFile);
+                    string cmd;
+                    string changeFileName;
 #ifdef _WIN32  /* for Windows */
-                            cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
+                    changeFileName = "rename";
 #else          /* for Linux or Mac */
-                            cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
+                    changeFileName = "mv";
 #endif
-                            std::system(cmd.c_str());
+                    cmd = changeFileName + " " + crxFile + " " + dFile;
+                    std::system(cmd.c_str());
+                    if (access(dFile.c_str(), 0) == -1)
+                    {
+                        /* extract '*.Z' */
+                        string crxzFile = crxFile + ".Z";
+                        UnzipObs(fopt, crxzFile, dFile);
 
-                            if (access(oFile.c_str(), 0) == 0)
-                            {
-                                cout << "*** INFO(FtpUtil::GetHrObsMgex): successfully download MGEX high-rate observation file " << oFile << endl;
+                        cmd = changeFileName + " " + crxFile + " " + dFile;
+                        std::system(cmd.c_str());
+                        if (access(dFile.c_str(), 0) == -1)
+                        {
+                            cout << "*** WARNING(FtpUtil::GetHrObsMgex): failed to download MGEX high-rate observation file " << oFile << endl;
+                            NotifyFile(fopt, oFile);
 
-                                /* delete dFile */
-                                remove(dFile.c_str());
-                            }
+                            continue;
                         }
-                        else cout << "*** INFO(FtpUtil::GetHrObsMgex): MGEX high-rate observation file " << 
-                            oFile << " or " << dFile << " has existed!" << endl;
+                    }
+
+                    CrxToObs(fopt, dFile, oFile);
+
+                    if (access(oFile.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetHrObsMgex): successfully download MGEX high-rate observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
+
+                        /* delete dFile */
+                        remove(dFile.c_str());
                     }
                 }
-            }
 
-            /* close 'site.list' */
-            sitLst.close();
+                /* the files that another GOOD process is downloading */
+                WaitShared(fopt, waitFiles);
+            }
         }
     }
 } /* end of GetHrObsMgex */
@@ -1536,6 +4223,8 @@ void FtpUtil::GetHrObsMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetDailyObsCut(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBS);
+
     /* creation of sub-directory ('daily') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -1569,65 +4258,70 @@ void FtpUtil::GetDailyObsCut(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
+    string gzipFull = fopt->gzipFull;
     string url = "http://saegnss2.curtin.edu/ldc/rinex3/daily/" + sYyyy + "/" + sDoy;
     string cutDirs = " --cut-dirs=5 ";
-    /* download the Curtin University of Technology (CUT) observation file site-by-site */
-    if (access(fopt->obcOpt, 0) == 0)
+    /* download the Curtin University of Technology (CUT) observation files of all the sites in one batch */
+    std::vector<string> sitNames;
+    if (GetSiteList(fopt, fopt->obcOpt, sitNames))
     {
-        ifstream sitLst(fopt->obcOpt);
-        if (!sitLst.is_open())
-        {
-            cerr << "*** ERROR(FtpUtil::GetDailyObsCut): open site.list = " << fopt->obcOpt << " file failed, please check it" << endl;
-
-            return;
-        }
-
-        string sitName;
-        while (getline(sitLst, sitName))
+        std::vector<string> getSites, crxgzFiles, waitFiles;
+        for (string sitName : sitNames)
         {
             str.ToLower(sitName);
-            string oFile = sitName + sDoy + "0." + sYy + "o";
-            if (access(oFile.c_str(), 0) == -1)
+            string oFile = ObsName(fopt, sitName + sDoy + "0." + sYy + "o");
+            int got = 1;
+            if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+            else if (access(oFile.c_str(), 0) == -1 && (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+            else if (got == 0)
             {
-                /* it is OK for '*.gz' format */
+                /* it is OK for '*.gz' format, the names are exact so that no directory index is needed */
+                getSites.push_back(sitName);
                 str.ToUpper(sitName);
-                string crxFile = sitName + "00AUS_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx";
-                string crxgzFile = crxFile + ".gz";
-                string cmd = wgetFull + " " + qr + " -nH " + cutDirs + url + "/" + crxgzFile;
-                std::system(cmd.c_str());
+                crxgzFiles.push_back(sitName + "00AUS_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx.gz");
+            }
+            else
+            {
+                cout << "*** INFO(FtpUtil::GetDailyObsCut): CUT daily observation file " << oFile <<
+                    " has existed!" << endl;
+                NotifyFile(fopt, oFile);
+            }
+        }
 
-                /* extract '*.gz' */
-                cmd = gzipFull + " -d -f " + crxgzFile;
-                std::system(cmd.c_str());
-                if (access(crxFile.c_str(), 0) == -1)
-                {
-                    cout << "*** WARNING(FtpUtil::GetDailyObsCut): failed to download CUT daily observation file " << oFile << endl;
+        FetchBatch(fopt, url, cutDirs, crxgzFiles);
 
-                    continue;
-                }
+        for (string sitName : getSites)
+        {
+            string oFile = ObsName(fopt, sitName + sDoy + "0." + sYy + "o");
+            str.ToUpper(sitName);
+            string crxFile = sitName + "00AUS_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx";
 
-#ifdef _WIN32  /* for Windows */
-                cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                std::system(cmd.c_str());
+            /* extract '*.gz' */
+            string crxgzFile = crxFile + ".gz";
+            UnzipObs(fopt, crxgzFile, "");
+            string cmd;
+            if (access(crxFile.c_str(), 0) == -1)
+            {
+                cout << "*** WARNING(FtpUtil::GetDailyObsCut): failed to download CUT daily observation file " << oFile << endl;
+                NotifyFile(fopt, oFile);
 
-                if (access(oFile.c_str(), 0) == 0)
-                {
-                    cout << "*** INFO(FtpUtil::GetDailyObsCut): successfully download CUT daily observation file " << oFile << endl;
+                continue;
+            }
 
-                    /* delete crxFile */
-                    remove(crxFile.c_str());
-                }
+            CrxToObs(fopt, crxFile, oFile);
+
+            if (access(oFile.c_str(), 0) == 0)
+            {
+                cout << "*** INFO(FtpUtil::GetDailyObsCut): successfully download CUT daily observation file " << oFile << endl;
+                NotifyFile(fopt, oFile);
+
+                /* delete crxFile */
+                remove(crxFile.c_str());
             }
-            else cout << "*** INFO(FtpUtil::GetDailyObsCut): CUT daily observation file " << oFile <<
-                " has existed!" << endl;
         }
 
-        /* close 'site.list' */
-        sitLst.close();
+        /* the files that another GOOD process is downloading */
+        WaitShared(fopt, waitFiles);
     }
 } /* end of GetDailyObsCut */
 
@@ -1642,6 +4336,8 @@ void FtpUtil::GetDailyObsCut(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetDailyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBS);
+
     /* creation of sub-directory ('daily') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -1675,15 +4371,15 @@ void FtpUtil::GetDailyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
+    string gzipFull = fopt->gzipFull;
     string url = "ftp://ftp.data.gnss.ga.gov.au/daily/" + sYyyy + "/" + sDoy;
     string cutDirs = " --cut-dirs=3 ";
-    if (strlen(fopt->obgOpt) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+    if (IsAllSites(fopt, fopt->obgOpt))  /* the option of 'all' is selected */
     {
         /* it is OK for '*.gz' format */
         string crxFile = "*_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx";
         string crxgzFile = crxFile + ".gz";
-        string cmd = wgetFull + " " + qr + " -nH -A " + crxgzFile + cutDirs + url;
+        string cmd = FetchCmd(fopt, url, cutDirs, crxgzFile);
         std::system(cmd.c_str());
 
         /* get the file list */
@@ -1696,8 +4392,7 @@ void FtpUtil::GetDailyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             if (access(crxFiles[i].c_str(), 0) == 0)
             {
                 /* extract it */
-                cmd = gzipFull + " -d -f " + crxFiles[i];
-                std::system(cmd.c_str());
+                UnzipObs(fopt, crxFiles[i], "");
 
                 str.StrMid(sitName, crxFiles[i].c_str(), 0, 4);
                 string site = sitName;
@@ -1705,14 +4400,9 @@ void FtpUtil::GetDailyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 str.StrMid(sitName, crxFiles[i].c_str(), 0, (int)crxFiles[i].find_last_of('.'));
                 crxFile = sitName;
                 if (access(crxFile.c_str(), 0) == -1) continue;
-                string oFile = site + sDoy + "0." + sYy + "o";
+                string oFile = ObsName(fopt, site + sDoy + "0." + sYy + "o");
                 /* convert from 'crx' file to 'o' file */
-#ifdef _WIN32  /* for Windows */
-                cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                std::system(cmd.c_str());
+                CrxToObs(fopt, crxFile, oFile);
 
                 /* delete crxFile */
 #ifdef _WIN32   /* for Windows */
@@ -1721,76 +4411,82 @@ void FtpUtil::GetDailyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 cmd = "rm -rf " + crxFile;
 #endif
                 std::system(cmd.c_str());
+                NotifyFile(fopt, oFile);
             }
         }
     }
     else  /* the option of full path of site list file is selected */
     {
-        /* download the GA observation file site-by-site */
-        if (access(fopt->obgOpt, 0) == 0)
+        /* download the GA observation files of all the sites in one FTP session */
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, fopt->obgOpt, sitNames))
         {
-            ifstream sitLst(fopt->obgOpt);
-            if (!sitLst.is_open())
-            {
-                cerr << "*** ERROR(FtpUtil::GetDailyObsGa): open site.list = " << fopt->obgOpt << " file failed, please check it" << endl;
-
-                return;
-            }
-
-            string sitName;
-            while (getline(sitLst, sitName))
+            std::vector<string> getSites, crxgzFiles, waitFiles;
+            for (string sitName : sitNames)
             {
                 str.ToLower(sitName);
-                string oFile = sitName + sDoy + "0." + sYy + "o";
-                string dFile = sitName + sDoy + "0." + sYy + "d";
-                if (access(oFile.c_str(), 0) == -1)
+                string oFile = ObsName(fopt, sitName + sDoy + "0." + sYy + "o");
+                int got = 1;
+                if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                else if (access(oFile.c_str(), 0) == -1 && (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+                else if (got == 0)
                 {
                     /* it is OK for '*.gz' format */
+                    getSites.push_back(sitName);
                     str.ToUpper(sitName);
-                    string crxFile = sitName + "*_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx";
-                    string crxgzFile = crxFile + ".gz";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + crxgzFile + cutDirs + url;
-                    std::system(cmd.c_str());
+                    crxgzFiles.push_back(sitName + "*_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx.gz");
+                }
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetDailyObsGa): GA daily observation file " << oFile <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, oFile);
+                }
+            }
 
-                    /* extract '*.gz' */
-                    cmd = gzipFull + " -d -f " + crxgzFile;
-                    std::system(cmd.c_str());
-                    string changeFileName;
-#ifdef _WIN32  /* for Windows */
-                    changeFileName = "rename";
-#else          /* for Linux or Mac */
-                    changeFileName = "mv";
-#endif
-                    cmd = changeFileName + " " + crxFile + " " + dFile;
-                    std::system(cmd.c_str());
-                    if (access(dFile.c_str(), 0) == -1)
-                    {
-                        cout << "*** WARNING(FtpUtil::GetDailyObsGa): failed to download GA daily observation file " << oFile << endl;
+            FetchBatch(fopt, url, cutDirs, crxgzFiles);
 
-                        continue;
-                    }
+            for (string sitName : getSites)
+            {
+                string oFile = ObsName(fopt, sitName + sDoy + "0." + sYy + "o");
+                string dFile = sitName + sDoy + "0." + sYy + "d";
+                str.ToUpper(sitName);
+                string crxFile = sitName + "*_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx";
 
+                /* extract '*.gz' */
+                string crxgzFile = crxFile + ".gz";
+                UnzipObs(fopt, crxgzFile, dFile);
+                string cmd;
+                string changeFileName;
 #ifdef _WIN32  /* for Windows */
-                    cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
+                changeFileName = "rename";
 #else          /* for Linux or Mac */
-                    cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
+                changeFileName = "mv";
 #endif
-                    std::system(cmd.c_str());
+                cmd = changeFileName + " " + crxFile + " " + dFile;
+                std::system(cmd.c_str());
+                if (access(dFile.c_str(), 0) == -1)
+                {
+                    cout << "*** WARNING(FtpUtil::GetDailyObsGa): failed to download GA daily observation file " << oFile << endl;
+                    NotifyFile(fopt, oFile);
 
-                    if (access(oFile.c_str(), 0) == 0)
-                    {
-                        cout << "*** INFO(FtpUtil::GetDailyObsGa): successfully download GA daily observation file " << oFile << endl;
+                    continue;
+                }
 
-                        /* delete dFile */
-                        remove(dFile.c_str());
-                    }
+                CrxToObs(fopt, dFile, oFile);
+
+                if (access(oFile.c_str(), 0) == 0)
+                {
+                    cout << "*** INFO(FtpUtil::GetDailyObsGa): successfully download GA daily observation file " << oFile << endl;
+                    NotifyFile(fopt, oFile);
+
+                    /* delete dFile */
+                    remove(dFile.c_str());
                 }
-                else cout << "*** INFO(FtpUtil::GetDailyObsGa): GA daily observation file " << oFile <<
-                    " has existed!" << endl;
             }
 
-            /* close 'site.list' */
-            sitLst.close();
+            /* the files that another GOOD process is downloading */
+            WaitShared(fopt, waitFiles);
         }
     }
 } /* end of GetDailyObsGa */
@@ -1806,6 +4502,8 @@ void FtpUtil::GetDailyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetHourlyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBSH);
+
     /* creation of sub-directory ('hourly') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -1832,10 +4530,10 @@ void FtpUtil::GetHourlyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
+    string gzipFull = fopt->gzipFull;
     string url0 = "ftp://ftp.data.gnss.ga.gov.au/hourly/" + sYyyy + "/" + sDoy;
     string cutDirs = " --cut-dirs=4 ";
-    if (strlen(fopt->obgOpt) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+    if (IsAllSites(fopt, fopt->obgOpt))  /* the option of 'all' is selected */
     {
         /* download all the GA observation files */
         for (int i = 0; i < fopt->hhObg.size(); i++)
@@ -1867,7 +4565,7 @@ void FtpUtil::GetHourlyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             /* it is OK for '*.gz' format */
             string crxFile = "*_R_" + sYyyy + sDoy + sHh + "00_01H_30S_MO.crx";
             string crxgzFile = crxFile + ".gz";
-            string cmd = wgetFull + " " + qr + " -nH -A " + crxgzFile + cutDirs + url;
+            string cmd = FetchCmd(fopt, url, cutDirs, crxgzFile);
             std::system(cmd.c_str());
 
             /* 'a' = 97, 'b' = 98, ... */
@@ -1886,8 +4584,7 @@ void FtpUtil::GetHourlyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 if (access(crxFiles[i].c_str(), 0) == 0)
                 {
                     /* extract it */
-                    cmd = gzipFull + "  -d -f " + crxFiles[i];
-                    std::system(cmd.c_str());
+                    UnzipObs(fopt, crxFiles[i], "");
 
                     str.StrMid(sitName, crxFiles[i].c_str(), 0, 4);
                     string site = sitName;
@@ -1895,14 +4592,9 @@ void FtpUtil::GetHourlyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                     str.StrMid(sitName, crxFiles[i].c_str(), 0, (int)crxFiles[i].find_last_of('.'));
                     crxFile = sitName;
                     if (access(crxFile.c_str(), 0) == -1) continue;
-                    string oFile = site + sDoy + sch + "." + sYy + "o";
+                    string oFile = ObsName(fopt, site + sDoy + sch + "." + sYy + "o");
                     /* convert from 'd' file to 'o' file */
-#ifdef _WIN32  /* for Windows */
-                    cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                    cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                    std::system(cmd.c_str());
+                    CrxToObs(fopt, crxFile, oFile);
 
                     /* delete 'd' file */
 #ifdef _WIN32   /* for Windows */
@@ -1911,113 +4603,124 @@ void FtpUtil::GetHourlyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                     cmd = "rm -rf " + crxFile;
 #endif
                     std::system(cmd.c_str());
+                    NotifyFile(fopt, oFile);
                 }
             }
         }
     }
     else  /* the option of full path of site list file is selected */
     {
-        /* download the GA observation file site-by-site */
-        if (access(fopt->obgOpt, 0) == 0)
+        /* download the GA observation files of all the sites in one session per hour */
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, fopt->obgOpt, sitNames))
         {
-            ifstream sitLst(fopt->obgOpt);
-            if (!sitLst.is_open())
-            {
-                cerr << "*** ERROR(FtpUtil::GetHourlyObsGa): open site.list = " << fopt->obgOpt << " file failed, please check it" << endl;
-
-                return;
-            }
-
-            string sitName;
-            while (getline(sitLst, sitName))
+            for (size_t i = 0; i < fopt->hhObg.size(); i++)
             {
-                for (int i = 0; i < fopt->hhObg.size(); i++)
+                string sHh = str.hh2str(fopt->hhObg[i]);
+                char tmpDir[MAXSTRPATH] = { '\0' };
+                char sep = (char)FILEPATHSEP;
+                sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
+                string sHhDir = tmpDir;
+                if (access(sHhDir.c_str(), 0) == -1)
                 {
-                    string sHh = str.hh2str(fopt->hhObg[i]);
-                    char tmpDir[MAXSTRPATH] = { '\0' };
-                    char sep = (char)FILEPATHSEP;
-                    sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
-                    string sHhDir = tmpDir;
-                    if (access(sHhDir.c_str(), 0) == -1)
-                    {
-                        /* If the directory does not exist, creat it */
+                    /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                        string cmd = "mkdir " + sHhDir;
+                    string cmd = "mkdir " + sHhDir;
 #else           /* for Linux or Mac */
-                        string cmd = "mkdir -p " + sHhDir;
+                    string cmd = "mkdir -p " + sHhDir;
 #endif
-                        std::system(cmd.c_str());
-                    }
+                    std::system(cmd.c_str());
+                }
 
-                    /* change directory */
+                /* change directory */
 #ifdef _WIN32   /* for Windows */
-                    _chdir(sHhDir.c_str());
+                _chdir(sHhDir.c_str());
 #else           /* for Linux or Mac */
-                    chdir(sHhDir.c_str());
+                chdir(sHhDir.c_str());
 #endif
 
-                    /* 'a' = 97, 'b' = 98, ... */
-                    int ii = fopt->hhObg[i] + 97;
-                    char ch = ii;
-                    string sch;
-                    sch.push_back(ch);
+                /* 'a' = 97, 'b' = 98, ... */
+                int ii = fopt->hhObg[i] + 97;
+                char ch = ii;
+                string sch;
+                sch.push_back(ch);
+
+                std::vector<string> getSites, pats, waitFiles;
+                for (string sitName : sitNames)
+                {
                     str.ToLower(sitName);
-                    string oFile = sitName + sDoy + sch + "." + sYy + "o";
+                    string oFile = ObsName(fopt, sitName + sDoy + sch + "." + sYy + "o");
                     string dFile = sitName + sDoy + sch + "." + sYy + "d";
-                    if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1)
+                    int got = 1;
+                    if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                    else if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1 &&
+                        (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+                    else if (got == 0)
                     {
-                        string url = url0 + "/" + sHh;
                         /* it is OK for '*.gz' format */
+                        getSites.push_back(sitName);
                         str.ToUpper(sitName);
-                        string crxFile = sitName + "*_R_" + sYyyy + sDoy + sHh + "00_01H_30S_MO.crx";
-                        string crxxFile = crxFile + ".*";
-                        string cmd = wgetFull + " " + qr + " -nH -A " + crxxFile + cutDirs + url;
-                        std::system(cmd.c_str());
-
-                        /* extract '*.gz' */
-                        string crxgzFile = crxFile + ".gz";
-                        cmd = gzipFull + " -d -f " + crxgzFile;
-                        std::system(cmd.c_str());
-                        string changeFileName;
-#ifdef _WIN32  /* for Windows */
-                        changeFileName = "rename";
-#else          /* for Linux or Mac */
-                        changeFileName = "mv";
-#endif
-                        cmd = changeFileName + " " + crxFile + " " + dFile;
-                        std::system(cmd.c_str());
-                        if (access(dFile.c_str(), 0) == -1)
-                        {
-                            cout << "*** WARNING(FtpUtil::GetDailyObsGa): failed to download GA daily observation file " << oFile << endl;
+                        pats.push_back(sitName + "*_R_" + sYyyy + sDoy + sHh + "00_01H_30S_MO.crx.gz");
+                    }
+                    else
+                    {
+                        cout << "*** INFO(FtpUtil::GetHourlyObsGa): GA hourly observation file " << oFile <<
+                            " or " << dFile << " has existed!" << endl;
+                        NotifyFile(fopt, oFile);
+                    }
+                }
 
-                            continue;
-                        }
+                if (pats.size() > 0)
+                {
+                    string url = url0 + "/" + sHh;
+                    FetchBatch(fopt, url, cutDirs, pats);
+                }
+
+                for (string sitName : getSites)
+                {
+                    string oFile = ObsName(fopt, sitName + sDoy + sch + "." + sYy + "o");
+                    string dFile = sitName + sDoy + sch + "." + sYy + "d";
+                    str.ToUpper(sitName);
+                    string crxFile = sitName + "*_R_" + sYyyy + sDoy + sHh + "00_01H_30S_MO.crx";
 
+                    /* extract '*.gz' */
+                    string crxgzFile = crxFile + ".gz";
+                    UnzipObs(fopt, crxgzFile, dFile);
+                    string cmd;
+                    string changeFileName;
 #ifdef _WIN32  /* for Windows */
-                        cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
+                    changeFileName = "rename";
 #else          /* for Linux or Mac */
-                        cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
+                    changeFileName = "mv";
 #endif
-                        std::system(cmd.c_str());
+                    cmd = changeFileName + " " + crxFile + " " + dFile;
+                    std::system(cmd.c_str());
+                    if (access(dFile.c_str(), 0) == -1)
+                    {
+                        cout << "*** WARNING(FtpUtil::GetHourlyObsGa): failed to download GA hourly observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
-                        if (access(oFile.c_str(), 0) == 0)
-                        {
-                            cout << "*** INFO(FtpUtil::GetHourlyObsGa): successfully download GA hourly observation file " << oFile << endl;
+                        continue;
+                    }
 
-                            /* delete dFile */
-                            remove(dFile.c_str());
-                        }
+                    CrxToObs(fopt, dFile, oFile);
+
+                    if (access(oFile.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetHourlyObsGa): successfully download GA hourly observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
+
+                        /* delete dFile */
+                        remove(dFile.c_str());
                     }
-                    else cout << "*** INFO(FtpUtil::GetHourlyObsGa): GA hourly observation file " <<
-                        oFile << " or " << dFile << " has existed!" << endl;
                 }
-            }
 
-            /* close 'site.list' */
-            sitLst.close();
+                /* the files that another GOOD process is downloading */
+                WaitShared(fopt, waitFiles);
+            }
         }
     }
-} /* end of GetHourlyObsMgex */
+} /* end of GetHourlyObsGa */
 
 /**
 * @brief   : GetHrObsGa - download Geoscience Australia (GA) RINEX high-rate observation (1s) files (long name "crx") according to 'site.list' file
@@ -2030,6 +4733,8 @@ void FtpUtil::GetHourlyObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetHrObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBSH);
+
     /* creation of sub-directory ('highrate') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -2056,10 +4761,10 @@ void FtpUtil::GetHrObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
+    string gzipFull = fopt->gzipFull;
     string url0 = "ftp://ftp.data.gnss.ga.gov.au/highrate/" + sYyyy + "/" + sDoy;
     string cutDirs = " --cut-dirs=4 ";
-    if (strlen(fopt->obgOpt) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+    if (IsAllSites(fopt, fopt->obgOpt))  /* the option of 'all' is selected */
     {
         /* download all the MGEX observation files */
         for (int i = 0; i < fopt->hhObg.size(); i++)
@@ -2091,7 +4796,9 @@ void FtpUtil::GetHrObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             /* it is OK for '*.gz' format */
             string crxFile = "*_15M_01S_MO.crx";
             string crxgzFile = crxFile + ".gz";
-            string cmd = wgetFull + " " + qr + " -nH -A " + crxgzFile + cutDirs + url;
+            if (_rangeTe.mjd != 0) crxgzFile = QuarterPatterns(ts, fopt->hhObg[i], "*_" + sYyyy + sDoy + sHh,
+                "_15M_01S_MO.crx.gz");
+            string cmd = FetchCmd(fopt, url, cutDirs, crxgzFile);
             std::system(cmd.c_str());
 
             /* 'a' = 97, 'b' = 98, ... */
@@ -2100,9 +4807,12 @@ void FtpUtil::GetHrObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             string sch;
             sch.push_back(ch);
 
+            int qmask = Quarters(ts, ch - 'a');  /* 15-minute files in the time range requested */
             std::vector<string> minuStr = { "00", "15", "30", "45" };
             for (int i = 0; i < minuStr.size(); i++)
             {
+                if ((qmask >> i & 1) == 0) continue;
+
                 /* get the file list */
                 string suffix = minuStr[i] + "_15M_01S_MO.crx";
                 vector<string> crxFiles;
@@ -2113,8 +4823,7 @@ void FtpUtil::GetHrObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                     if (access(crxFiles[j].c_str(), 0) == 0)
                     {
                         /* extract it */
-                        cmd = gzipFull + " -d -f " + crxFiles[j];
-                        std::system(cmd.c_str());
+                        UnzipObs(fopt, crxFiles[j], "");
 
                         str.StrMid(sitName, crxFiles[j].c_str(), 0, 4);
                         string site = sitName;
@@ -2122,14 +4831,9 @@ void FtpUtil::GetHrObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                         str.StrMid(sitName, crxFiles[j].c_str(), 0, (int)crxFiles[j].find_last_of('.'));
                         crxFile = sitName;
                         if (access(crxFile.c_str(), 0) == -1) continue;
-                        string oFile = site + sDoy + sch + minuStr[i] + "." + sYy + "o";
+                        string oFile = ObsName(fopt, site + sDoy + sch + minuStr[i] + "." + sYy + "o");
                         /* convert from 'crx' file to 'o' file */
-#ifdef _WIN32  /* for Windows */
-                        cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                        cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                        std::system(cmd.c_str());
+                        CrxToObs(fopt, crxFile, oFile);
 
                         /* delete 'crx' file */
 #ifdef _WIN32   /* for Windows */
@@ -2138,6 +4842,7 @@ void FtpUtil::GetHrObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                         cmd = "rm -rf " + crxFile;
 #endif
                         std::system(cmd.c_str());
+                        NotifyFile(fopt, oFile);
                     }
                 }
             }
@@ -2145,108 +4850,123 @@ void FtpUtil::GetHrObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     }
     else  /* the option of full path of site list file is selected */
     {
-        /* download the GA observation file site-by-site */
-        if (access(fopt->obgOpt, 0) == 0)
+        /* download the GA observation files of all the sites in one session per hour */
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, fopt->obgOpt, sitNames))
         {
-            ifstream sitLst(fopt->obgOpt);
-            if (!sitLst.is_open())
-            {
-                cerr << "*** ERROR(FtpUtil::GetHrObsGa): open site.list = " << fopt->obgOpt << " file failed, please check it" << endl;
-
-                return;
-            }
-
-            string sitName;
-            while (getline(sitLst, sitName))
+            for (size_t i = 0; i < fopt->hhObg.size(); i++)
             {
-                for (int i = 0; i < fopt->hhObg.size(); i++)
+                string sHh = str.hh2str(fopt->hhObg[i]);
+                char tmpDir[MAXSTRPATH] = { '\0' };
+                char sep = (char)FILEPATHSEP;
+                sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
+                string sHhDir = tmpDir;
+                if (access(sHhDir.c_str(), 0) == -1)
                 {
-                    string sHh = str.hh2str(fopt->hhObg[i]);
-                    char tmpDir[MAXSTRPATH] = { '\0' };
-                    char sep = (char)FILEPATHSEP;
-                    sprintf(tmpDir, "%s%c%s", subDir.c_str(), sep, sHh.c_str());
-                    string sHhDir = tmpDir;
-                    if (access(sHhDir.c_str(), 0) == -1)
-                    {
-                        /* If the directory does not exist, creat it */
+                    /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                        string cmd = "mkdir " + sHhDir;
+                    string cmd = "mkdir " + sHhDir;
 #else           /* for Linux or Mac */
-                        string cmd = "mkdir -p " + sHhDir;
+                    string cmd = "mkdir -p " + sHhDir;
 #endif
-                        std::system(cmd.c_str());
-                    }
+                    std::system(cmd.c_str());
+                }
 
-                    /* change directory */
+                /* change directory */
 #ifdef _WIN32   /* for Windows */
-                    _chdir(sHhDir.c_str());
+                _chdir(sHhDir.c_str());
 #else           /* for Linux or Mac */
-                    chdir(sHhDir.c_str());
+                chdir(sHhDir.c_str());
 #endif
 
-                    /* 'a' = 97, 'b' = 98, ... */
-                    int ii = fopt->hhObg[i] + 97;
-                    char ch = ii;
-                    string sch;
-                    sch.push_back(ch);
+                /* 'a' = 97, 'b' = 98, ... */
+                int ii = fopt->hhObg[i] + 97;
+                char ch = ii;
+                string sch;
+                sch.push_back(ch);
 
-                    string url = url0 + "/" + sHh;
-                    std::vector<string> minuStr = { "00", "15", "30", "45" };
-                    for (int i = 0; i < minuStr.size(); i++)
+                int qmask = Quarters(ts, ch - 'a');  /* 15-minute files in the time range requested */
+                std::vector<string> minuStr = { "00", "15", "30", "45" };
+                std::vector<string> getSites, getMinus, pats, waitFiles;
+                for (string sitName : sitNames)
+                {
+                    for (size_t k = 0; k < minuStr.size(); k++)
                     {
+                        if ((qmask >> k & 1) == 0) continue;
+
                         str.ToLower(sitName);
-                        string oFile = sitName + sDoy + sch + minuStr[i] + "." + sYy + "o";
-                        string dFile = sitName + sDoy + sch + minuStr[i] + "." + sYy + "d";
-                        if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1)
+                        string oFile = ObsName(fopt, sitName + sDoy + sch + minuStr[k] + "." + sYy + "o");
+                        string dFile = sitName + sDoy + sch + minuStr[k] + "." + sYy + "d";
+                        int got = 1;
+                        if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                        else if (access(oFile.c_str(), 0) == -1 && access(dFile.c_str(), 0) == -1 &&
+                            (got = TakeShared(oFile, false)) < 0) waitFiles.push_back(oFile);
+                        else if (got == 0)
                         {
                             /* it is OK for '*.gz' format */
+                            getSites.push_back(sitName);
+                            getMinus.push_back(minuStr[k]);
                             str.ToUpper(sitName);
-                            string crxFile = sitName + "*" + sYyyy + sDoy + sHh + minuStr[i] + "_15M_01S_MO.crx";
-                            string crxgzFile = crxFile + ".gz";
-                            string cmd = wgetFull + " " + qr + " -nH -A " + crxgzFile + cutDirs + url;
-                            std::system(cmd.c_str());
+                            pats.push_back(sitName + "*" + sYyyy + sDoy + sHh + minuStr[k] + "_15M_01S_MO.crx.gz");
+                        }
+                        else
+                        {
+                            cout << "*** INFO(FtpUtil::GetHrObsGa): GA high-rate observation file " << oFile <<
+                                " or " << dFile << " has existed!" << endl;
+                            NotifyFile(fopt, oFile);
+                        }
+                    }
+                }
 
-                            /* extract '*.gz' */
-                            cmd = gzipFull + " -d -f " + crxgzFile;
-                            std::system(cmd.c_str());
-                            string changeFileName;
-#ifdef _WIN32  /* for Windows */
-                            changeFileName = "rename";
-#else          /* for Linux or Mac */
-                            changeFileName = "mv";
-#endif
-                            cmd = changeFileName + " " + crxFile + " " + dFile;
-                            std::system(cmd.c_str());
-                            if (access(dFile.c_str(), 0) == -1)
-                            {
-                                cout << "*** WARNING(FtpUtil::GetDailyObsGa): failed to download GA daily observation file " << oFile << endl;
+                if (pats.size() > 0)
+                {
+                    string url = url0 + "/" + sHh;
+                    FetchBatch(fopt, url, cutDirs, pats);
+                }
 
-                                continue;
-                            }
+                for (size_t k = 0; k < getSites.size(); k++)
+                {
+                    string sitName = getSites[k];
+                    string oFile = ObsName(fopt, sitName + sDoy + sch + getMinus[k] + "." + sYy + "o");
+                    string dFile = sitName + sDoy + sch + getMinus[k] + "." + sYy + "d";
+                    str.ToUpper(sitName);
+                    string crxFile = sitName + "*" + sYyyy + sDoy + sHh + getMinus[k] + "_15M_01S_MO.crx";
 
+                    /* extract '*.gz' */
+                    string crxgzFile = crxFile + ".gz";
+                    UnzipObs(fopt, crxgzFile, dFile);
+                    string cmd;
+                    string changeFileName;
 #ifdef _WIN32  /* for Windows */
-                            cmd = crx2rnxFull + " " + dFile + " -f - > " + oFile;
+                    changeFileName = "rename";
 #else          /* for Linux or Mac */
-                            cmd = "cat " + dFile + " | " + crx2rnxFull + " -f - > " + oFile;
+                    changeFileName = "mv";
 #endif
-                            std::system(cmd.c_str());
+                    cmd = changeFileName + " " + crxFile + " " + dFile;
+                    std::system(cmd.c_str());
+                    if (access(dFile.c_str(), 0) == -1)
+                    {
+                        cout << "*** WARNING(FtpUtil::GetHrObsGa): failed to download GA high-rate observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
-                            if (access(oFile.c_str(), 0) == 0)
-                            {
-                                cout << "*** INFO(FtpUtil::GetHrObsGa): successfully download GA high-rate observation file " << oFile << endl;
+                        continue;
+                    }
 
-                                /* delete dFile */
-                                remove(dFile.c_str());
-                            }
-                        }
-                        else cout << "*** INFO(FtpUtil::GetHrObsGa): GA high-rate observation file " <<
-                            oFile << " or " << dFile << " has existed!" << endl;
+                    CrxToObs(fopt, dFile, oFile);
+
+                    if (access(oFile.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetHrObsGa): successfully download GA high-rate observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
+
+                        /* delete dFile */
+                        remove(dFile.c_str());
                     }
                 }
-            }
 
-            /* close 'site.list' */
-            sitLst.close();
+                /* the files that another GOOD process is downloading */
+                WaitShared(fopt, waitFiles);
+            }
         }
     }
 } /* end of GetHrObsGa */
@@ -2262,6 +4982,8 @@ void FtpUtil::GetHrObsGa(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::Get30sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBS);
+
     /* creation of sub-directory ('daily') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -2295,67 +5017,57 @@ void FtpUtil::Get30sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
+    string gzipFull = fopt->gzipFull;
     string url0 = "ftp://ftp.geodetic.gov.hk/rinex3/" + sYyyy + "/" + sDoy;
     string cutDirs = " --cut-dirs=5 ";
     /* download the Hong Kong CORS observation file site-by-site */
-    if (access(fopt->obhOpt, 0) == 0)
+    std::vector<string> sitNames;
+    if (GetSiteList(fopt, fopt->obhOpt, sitNames))
     {
-        ifstream sitLst(fopt->obhOpt);
-        if (!sitLst.is_open())
-        {
-            cerr << "*** ERROR(FtpUtil::Get30sObsHk): open site.list = " << fopt->obhOpt << " file failed, please check it" << endl;
-
-            return;
-        }
-
-        string sitName;
-        while (getline(sitLst, sitName))
+        for (string sitName : sitNames)
         {
             str.ToLower(sitName);
-            string oFile = sitName + sDoy + "0." + sYy + "o";
+            string oFile = ObsName(fopt, sitName + sDoy + "0." + sYy + "o");
             string url = url0 + "/" + sitName + "/30s";
-            if (access(oFile.c_str(), 0) == -1)
+            if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+            else if (access(oFile.c_str(), 0) == -1 && !TakeShared(oFile))
             {
                 /* it is OK for '*.gz' format */
                 str.ToUpper(sitName);
                 string crxFile = sitName + "00HKG_R_" + sYyyy + sDoy + "0000_01D_30S_MO.crx";
                 string crxgzFile = crxFile + ".gz";
                 str.ToLower(sitName);
-                string cmd = wgetFull + " " + qr + " -nH " + cutDirs + url + "/" + crxgzFile;
+                string cmd = FetchCmd(fopt, url + "/" + crxgzFile, cutDirs, "");
                 std::system(cmd.c_str());
 
                 /* extract '*.gz' */
-                cmd = gzipFull + " -d -f " + crxgzFile;
-                std::system(cmd.c_str());
+                UnzipObs(fopt, crxgzFile, "");
                 if (access(crxFile.c_str(), 0) == -1)
                 {
                     cout << "*** WARNING(FtpUtil::Get30sObsHk): failed to download HK CORS 30s observation file " << oFile << endl;
+                    NotifyFile(fopt, oFile);
 
                     continue;
                 }
 
-#ifdef _WIN32  /* for Windows */
-                cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                std::system(cmd.c_str());
+                CrxToObs(fopt, crxFile, oFile);
 
                 if (access(oFile.c_str(), 0) == 0)
                 {
                     cout << "*** INFO(FtpUtil::Get30sObsHk): successfully download HK CORS 30s observation file " << oFile << endl;
+                    NotifyFile(fopt, oFile);
 
                     /* delete crxFile */
                     remove(crxFile.c_str());
                 }
             }
-            else cout << "*** INFO(FtpUtil::Get30sObsHk): HK CORS 30s observation file " << oFile <<
-                " has existed!" << endl;
+            else
+            {
+                cout << "*** INFO(FtpUtil::Get30sObsHk): HK CORS 30s observation file " << oFile <<
+                    " has existed!" << endl;
+                NotifyFile(fopt, oFile);
+            }
         }
-
-        /* close 'site.list' */
-        sitLst.close();
     }
 } /* end of Get30sObsHk */
 
@@ -2370,6 +5082,8 @@ void FtpUtil::Get30sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::Get5sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBSH);
+
     /* creation of sub-directory ('daily') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -2403,22 +5117,14 @@ void FtpUtil::Get5sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
+    string gzipFull = fopt->gzipFull;
     string url0 = "ftp://ftp.geodetic.gov.hk/rinex3/" + sYyyy + "/" + sDoy;
     string cutDirs = " --cut-dirs=5 ";
     /* download the Hong Kong CORS observation file site-by-site */
-    if (access(fopt->obhOpt, 0) == 0)
+    std::vector<string> sitNames;
+    if (GetSiteList(fopt, fopt->obhOpt, sitNames))
     {
-        ifstream sitLst(fopt->obhOpt);
-        if (!sitLst.is_open())
-        {
-            cerr << "*** ERROR(FtpUtil::Get5sObsHk): open site.list = " << fopt->obhOpt << " file failed, please check it" << endl;
-
-            return;
-        }
-
-        string sitName;
-        while (getline(sitLst, sitName))
+        for (string sitName : sitNames)
         {
             for (int i = 0; i < fopt->hhObh.size(); i++)
             {
@@ -2451,50 +5157,48 @@ void FtpUtil::Get5sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 string sch;
                 sch.push_back(ch);
                 str.ToLower(sitName);
-                string oFile = sitName + sDoy + sch + "." + sYy + "o";
+                string oFile = ObsName(fopt, sitName + sDoy + sch + "." + sYy + "o");
                 string url = url0 + "/" + sitName + "/5s";
-                if (access(oFile.c_str(), 0) == -1)
+                if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                else if (access(oFile.c_str(), 0) == -1 && !TakeShared(oFile))
                 {
                     /* it is OK for '*.gz' format */
                     str.ToUpper(sitName);
                     string crxFile = sitName + "00HKG_R_" + sYyyy + sDoy + sHh + "00_01H_05S_MO.crx";
                     string crxgzFile = crxFile + ".gz";
                     str.ToLower(sitName);
-                    string cmd = wgetFull + " " + qr + " -nH " + cutDirs + url + "/" + crxgzFile;
+                    string cmd = FetchCmd(fopt, url + "/" + crxgzFile, cutDirs, "");
                     std::system(cmd.c_str());
 
                     /* extract '*.gz' */
-                    cmd = gzipFull + " -d -f " + crxgzFile;
-                    std::system(cmd.c_str());
+                    UnzipObs(fopt, crxgzFile, "");
                     if (access(crxFile.c_str(), 0) == -1)
                     {
                         cout << "*** WARNING(FtpUtil::Get5sObsHk): failed to download HK CORS 5s observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
                         continue;
                     }
 
-#ifdef _WIN32  /* for Windows */
-                    cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                    cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                    std::system(cmd.c_str());
+                    CrxToObs(fopt, crxFile, oFile);
 
                     if (access(oFile.c_str(), 0) == 0)
                     {
                         cout << "*** INFO(FtpUtil::Get5sObsHk): successfully download HK CORS 5s observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
                         /* delete crxFile */
                         remove(crxFile.c_str());
                     }
                 }
-                else cout << "*** INFO(FtpUtil::Get5sObsHk): HK CORS 5s observation file " << oFile <<
-                    " has existed!" << endl;
+                else
+                {
+                    cout << "*** INFO(FtpUtil::Get5sObsHk): HK CORS 5s observation file " << oFile <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, oFile);
+                }
             }
         }
-
-        /* close 'site.list' */
-        sitLst.close();
     }
 } /* end of Get5sObsHk */
 
@@ -2509,6 +5213,8 @@ void FtpUtil::Get5sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::Get1sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_OBSH);
+
     /* creation of sub-directory ('daily') */
     char tmpDir[MAXSTRPATH] = { '\0' };
     char sep = (char)FILEPATHSEP;
@@ -2542,22 +5248,14 @@ void FtpUtil::Get1sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, crx2rnxFull = fopt->crx2rnxFull, qr = fopt->qr;
+    string gzipFull = fopt->gzipFull;
     string url0 = "ftp://ftp.geodetic.gov.hk/rinex3/" + sYyyy + "/" + sDoy;
     string cutDirs = " --cut-dirs=5 ";
     /* download the Hong Kong CORS observation file site-by-site */
-    if (access(fopt->obhOpt, 0) == 0)
+    std::vector<string> sitNames;
+    if (GetSiteList(fopt, fopt->obhOpt, sitNames))
     {
-        ifstream sitLst(fopt->obhOpt);
-        if (!sitLst.is_open())
-        {
-            cerr << "*** ERROR(FtpUtil::Get1sObsHk): open site.list = " << fopt->obhOpt << " file failed, please check it" << endl;
-
-            return;
-        }
-
-        string sitName;
-        while (getline(sitLst, sitName))
+        for (string sitName : sitNames)
         {
             for (int i = 0; i < fopt->hhObh.size(); i++)
             {
@@ -2590,50 +5288,48 @@ void FtpUtil::Get1sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 string sch;
                 sch.push_back(ch);
                 str.ToLower(sitName);
-                string oFile = sitName + sDoy + sch + "." + sYy + "o";
+                string oFile = ObsName(fopt, sitName + sDoy + sch + "." + sYy + "o");
                 string url = url0 + "/" + sitName + "/1s";
-                if (access(oFile.c_str(), 0) == -1)
+                if (IsKnownMissing(fopt, oFile)) NotifyFile(fopt, oFile);
+                else if (access(oFile.c_str(), 0) == -1 && !TakeShared(oFile))
                 {
                     /* it is OK for '*.gz' format */
                     str.ToUpper(sitName);
                     string crxFile = sitName + "00HKG_R_" + sYyyy + sDoy + sHh + "00_01H_01S_MO.crx";
                     string crxgzFile = crxFile + ".gz";
                     str.ToLower(sitName);
-                    string cmd = wgetFull + " " + qr + " -nH " + cutDirs + url + "/" + crxgzFile;
+                    string cmd = FetchCmd(fopt, url + "/" + crxgzFile, cutDirs, "");
                     std::system(cmd.c_str());
 
                     /* extract '*.gz' */
-                    cmd = gzipFull + " -d -f " + crxgzFile;
-                    std::system(cmd.c_str());
+                    UnzipObs(fopt, crxgzFile, "");
                     if (access(crxFile.c_str(), 0) == -1)
                     {
                         cout << "*** WARNING(FtpUtil::Get1sObsHk): failed to download HK CORS 1s observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
                         continue;
                     }
 
-#ifdef _WIN32  /* for Windows */
-                    cmd = crx2rnxFull + " " + crxFile + " -f - > " + oFile;
-#else          /* for Linux or Mac */
-                    cmd = "cat " + crxFile + " | " + crx2rnxFull + " -f - > " + oFile;
-#endif
-                    std::system(cmd.c_str());
+                    CrxToObs(fopt, crxFile, oFile);
 
                     if (access(oFile.c_str(), 0) == 0)
                     {
                         cout << "*** INFO(FtpUtil::Get1sObsHk): successfully download HK CORS 1s observation file " << oFile << endl;
+                        NotifyFile(fopt, oFile);
 
                         /* delete crxFile */
                         remove(crxFile.c_str());
                     }
                 }
-                else cout << "*** INFO(FtpUtil::Get1sObsHk): HK CORS 1s observation file " << oFile <<
-                    " has existed!" << endl;
+                else
+                {
+                    cout << "*** INFO(FtpUtil::Get1sObsHk): HK CORS 1s observation file " << oFile <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, oFile);
+                }
             }
         }
-
-        /* close 'site.list' */
-        sitLst.close();
     }
 } /* end of Get1sObsHk */
 
@@ -2648,6 +5344,8 @@ void FtpUtil::Get1sObsHk(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, fopt->navTyp == NAV_DAILY ? MISS_OBS : (fopt->navTyp == NAV_HOURLY ? MISS_OBSH : MISS_ULTRA));
+
     /* compute day of year */
     TimeUtil tu;
     int yyyy, doy;
@@ -2658,13 +5356,9 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
-    string nTyp(fopt->navTyp);
-    str.ToLower(nTyp);
     string nOpt(fopt->navOpt);
     str.ToLower(nOpt);
-    if (strcmp(nTyp.c_str(), "daily") == 0)
+    if (fopt->navTyp == NAV_DAILY)
     {
         /* creation of sub-directory ('daily') */
         char tmpDir[MAXSTRPATH] = { '\0' };
@@ -2705,29 +5399,20 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
         else if (strcmp(nOpt.c_str(), "mixed") == 0)
         {
             /* multi-GNSS broadcast ephemeris file */
-            if (strcmp(ftpName.c_str(), "IGN") == 0) navFile = "BRDC00IGN_R_" + sYyyy + sDoy + "0000_01D_MN.rnx";
+            if (fopt->ftpArc == ARC_IGN) navFile = "BRDC00IGN_R_" + sYyyy + sDoy + "0000_01D_MN.rnx";
             else navFile = "BRDC00IGS_R_" + sYyyy + sDoy + "0000_01D_MN.rnx";
             nav0File = "brdm" + sDoy + "0." + sYy + "p";
         }
 
-        if (access(navFile.c_str(), 0) == -1 && access(nav0File.c_str(), 0) == -1)
+        if (IsKnownMissing(fopt, navFile)) NotifyFile(fopt, navFile);
+        else if (access(navFile.c_str(), 0) == -1 && access(nav0File.c_str(), 0) == -1 && !TakeShared(nav0File))
         {
-            string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
-            string url, cutDirs = " --cut-dirs=6 ";
-            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_NAV] + "/" +
-                sYyyy + "/brdc";
-            else if (strcmp(ftpName.c_str(), "IGN") == 0)
-            {
-                url = _ftpArchive.IGN[IDX_NAV] + "/" + sYyyy + "/" + sDoy;
-                cutDirs = " --cut-dirs=5 ";
-            }
-            else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_NAV] + "/" +
-                sYyyy + "/brdc";
-            else url = _ftpArchive.CDDIS[IDX_NAV] + "/" + sYyyy + "/brdc";
+            string gzipFull = fopt->gzipFull;
+            string url = ArcUrl(fopt, IDX_NAV, ts), cutDirs = CutDirs(url);
 
             /* it is OK for '*.Z' or '*.gz' format */
             string navxFile = navFile + ".*";
-            string cmd = wgetFull + " " + qr + " -nH -A " + navxFile + cutDirs + url;
+            string cmd = FetchCmd(fopt, url, cutDirs, navxFile);
             std::system(cmd.c_str());
 
             string navgzFile = navFile + ".gz", navzFile = navFile + ".Z";
@@ -2743,8 +5428,12 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 cmd = gzipFull + " -d -f " + navzFile;
                 std::system(cmd.c_str());
             }
-            if (access(navFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetNav): failed to download broadcast ephemeris file " <<
-                nav0File << endl;
+            if (access(navFile.c_str(), 0) == -1)
+            {
+                cout << "*** INFO(FtpUtil::GetNav): failed to download broadcast ephemeris file " <<
+                    nav0File << endl;
+                NotifyFile(fopt, nav0File);
+            }
 
             if (strcmp(nOpt.c_str(), "mixed") == 0)
             {
@@ -2758,12 +5447,20 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 std::system(cmd.c_str());
             }
 
-            if (access(nav0File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetNav): successfully download broadcast ephemeris file " << nav0File << endl;
+            if (access(nav0File.c_str(), 0) == 0)
+            {
+                cout << "*** INFO(FtpUtil::GetNav): successfully download broadcast ephemeris file " << nav0File << endl;
+                NotifyFile(fopt, nav0File);
+            }
+        }
+        else
+        {
+            cout << "*** INFO(FtpUtil::GetNav): broadcast ephemeris file " << nav0File << " or " <<
+                navFile << " has existed!" << endl;
+            NotifyFile(fopt, nav0File);
         }
-        else cout << "*** INFO(FtpUtil::GetNav): broadcast ephemeris file " << nav0File << " or " <<
-            navFile << " has existed!" << endl;
     }
-    else if (strcmp(nTyp.c_str(), "hourly") == 0)
+    else if (fopt->navTyp == NAV_HOURLY)
     {
         /* creation of sub-directory ('hourly') */
         char tmpDir[MAXSTRPATH] = { '\0' };
@@ -2782,21 +5479,13 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
         }
 
         string sitFile = fopt->obsOpt;
-        if (fopt->getObs) sitFile = fopt->obsOpt;
-        else if (fopt->getObm) sitFile = fopt->obmOpt;
+        if (fopt->get[GET_OBS]) sitFile = fopt->obsOpt;
+        else if (fopt->get[GET_OBM]) sitFile = fopt->obmOpt;
         /* download the broadcast ephemeris file site-by-site */
-        if (access(sitFile.c_str(), 0) == 0)
+        std::vector<string> sitNames;
+        if (GetSiteList(fopt, sitFile.c_str(), sitNames))
         {
-            ifstream sitLst(sitFile.c_str());
-            if (!sitLst.is_open())
-            {
-                cerr << "*** ERROR(FtpUtil::GetHourlyObsMgex): open site.list = " << sitFile << " file failed, please check it" << endl;
-
-                return;
-            }
-
-            string sitName;
-            while (getline(sitLst, sitName))
+            for (string sitName : sitNames)
             {
                 for (int i = 0; i < fopt->hhNav.size(); i++)
                 {
@@ -2940,20 +5629,19 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                     
                     for (int i = 0; i < navFiles.size(); i++)
                     {
-                        string url, cutDirs = " --cut-dirs=7 ";
-                        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_OBMH] + "/" +
-                            sYyyy + "/" + sDoy + "/" + sHh;
-                        else if (strcmp(ftpName.c_str(), "IGN") == 0)
+                        if (IsKnownMissing(fopt, nav0Files[i]))
                         {
-                            url = _ftpArchive.IGN[IDX_OBMH] + "/" + sYyyy + "/" + sDoy;
-                            cutDirs = " --cut-dirs=6 ";
+                            NotifyFile(fopt, nav0Files[i]);
+
+                            continue;
                         }
-                        else url = _ftpArchive.CDDIS[IDX_OBMH] + "/" + sYyyy + "/" + sDoy + "/" + sHh;
+
+                        string url = ArcUrl(fopt, IDX_OBMH, ts, sHh), cutDirs = CutDirs(url);
 
                         /* it is OK for '*.Z' or '*.gz' format */
-                        string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
+                        string gzipFull = fopt->gzipFull;
                         string navxFile = navFiles[i] + ".*";
-                        string cmd = wgetFull + " " + qr + " -nH -A " + navxFile + cutDirs + url;
+                        string cmd = FetchCmd(fopt, url, cutDirs, navxFile);
                         std::system(cmd.c_str());
 
                         /* extract '*.gz' */
@@ -2981,11 +5669,13 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                             {
                                 cout << "*** WARNING(FtpUtil::GetNav): failed to download hourly broadcast ephemeris file " << 
                                     navFiles[i] << endl;
+                                NotifyFile(fopt, nav0Files[i]);
                             }
                             else
                             {
                                 cout << "*** INFO(FtpUtil::GetNav): successfully download hourly broadcast ephemeris file " <<
                                     navFiles[i] << endl;
+                                NotifyFile(fopt, nav0Files[i]);
 
                                 continue;
                             }
@@ -2994,18 +5684,16 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                         {
                             cout << "*** INFO(FtpUtil::GetNav): successfully download hourly broadcast ephemeris file " <<
                                 navFiles[i] << endl;
+                            NotifyFile(fopt, nav0Files[i]);
 
                             continue;
                         }
                     }
                 }
             }
-
-            /* close 'site.list' */
-            sitLst.close();
         }
     }
-    else if (strcmp(nTyp.c_str(), "RTNAV") == 0)
+    else if (fopt->navTyp == NAV_RTNAV)
     {
         /* creation of sub-directory ('daily') */
         char tmpDir[MAXSTRPATH] = { '\0' };
@@ -3031,15 +5719,17 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 #endif
 
         string navFile = "brdm" + sDoy + "z." + sYy + "p";
-        if (access(navFile.c_str(), 0) == -1)
+        string url = "ftp://ftp.lrz.de/transfer/steigenb/brdm";
+        catent_t ent;
+        if (IsKnownMissing(fopt, navFile)) NotifyFile(fopt, navFile);
+        else if (!IsUpToDate(fopt, url, navFile, ent))
         {
             /* download brdmDDDz.YYp.Z file */
-            string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
-            string url = "ftp://ftp.lrz.de/transfer/steigenb/brdm";
+            string gzipFull = fopt->gzipFull;
 
             /* it is OK for '*.Z' or '*.gz' format */
             string navxFile = navFile + ".*";
-            string cmd = wgetFull + " " + qr + " -nH -A " + navxFile + " --cut-dirs=3 " + url;
+            string cmd = FetchCmd(fopt, url, " --cut-dirs=3 ", navxFile);
             std::system(cmd.c_str());
 
             string navgzFile = navFile + ".gz", navzFile = navFile + ".Z";
@@ -3056,13 +5746,26 @@ void FtpUtil::GetNav(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 std::system(cmd.c_str());
             }
 
-            if (access(navFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetNav): failed to download real-time broadcast ephemeris file " <<
-                navFile << endl;
-            else if (access(navFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetNav): successfully download real-time broadcast ephemeris file " <<
-                navFile << endl;
+            if (access(navFile.c_str(), 0) == -1)
+            {
+                cout << "*** INFO(FtpUtil::GetNav): failed to download real-time broadcast ephemeris file " <<
+                    navFile << endl;
+                NotifyFile(fopt, navFile);
+            }
+            else if (access(navFile.c_str(), 0) == 0)
+            {
+                cout << "*** INFO(FtpUtil::GetNav): successfully download real-time broadcast ephemeris file " <<
+                    navFile << endl;
+                NotifyFile(fopt, navFile);
+            }
+            UpdateCatalog(navFile, ent);
+        }
+        else
+        {
+            cout << "*** INFO(FtpUtil::GetNav): real-time broadcast ephemeris file " << navFile <<
+                " has existed!" << endl;
+            NotifyFile(fopt, navFile);
         }
-        else cout << "*** INFO(FtpUtil::GetNav): real-time broadcast ephemeris file " << navFile <<
-            " has existed!" << endl;
     }
 } /* end of GetNav */
 
@@ -3098,41 +5801,28 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
     string sDoy = str.doy2str(doy);
 
     string ac(fopt->orbClkOpt);
-    str.ToLower(ac);
-    std::vector<string> acIGS = { "igs", "igr", "igu", "cod", "esa", "gfz", "gfu", "grg", "jpl" };
-    bool isIGS = false;
-    for (int i = 0; i < acIGS.size(); i++)
-    {
-        if (strcmp(ac.c_str(), acIGS[i].c_str()) == 0) isIGS = true;
-    }
-    std::vector<string> acMGEX = { "com", "gbm", "grm", "wum", "wuu" };
-    bool isMGEX = false;
-    for (int i = 0; i < acMGEX.size(); i++)
-    {
-        if (strcmp(ac.c_str(), acMGEX[i].c_str()) == 0) isMGEX = true;
-    }
+    int acId = fopt->orbClkAc;
+    bool isIGS = acId >= 0 && acId < NAC && !IsMgexAc(acId);
+    bool isMGEX = acId >= 0 && acId < NAC && IsMgexAc(acId);
+    SetMissClass(ts, acId == AC_IGR ? MISS_RAPID : (UltraStep(acId) < 24 ? MISS_ULTRA : MISS_FINAL));
 
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
+    string gzipFull = fopt->gzipFull;
     if (isIGS)  /* IGS products */
     {
-        if (strcmp(ac.c_str(), "igu") == 0)
+        if (acId == AC_IGU)
         {
-            string url, cutDirs = " --cut-dirs=4 ";
-            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_SP3] + "/" + sWwww;
-            else if (strcmp(ftpName.c_str(), "IGN") == 0) url = _ftpArchive.IGN[IDX_SP3] + "/" + sWwww;
-            else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_SP3] + "/" + sWwww;
-            else url = _ftpArchive.CDDIS[IDX_SP3] + "/" + sWwww;
+            string url = ArcUrl(fopt, IDX_SP3, ts), cutDirs = CutDirs(url);
             for (int i = 0; i < fopt->hhOrbClk.size(); i++)
             {
                 string sHh = str.hh2str(fopt->hhOrbClk[i]);
                 string sp3File = ac + sWwww + sDow + "_" + sHh + ".sp3";
-                if (access(sp3File.c_str(), 0) == -1)
+                catent_t ent;
+                if (IsKnownMissing(fopt, sp3File)) NotifyFile(fopt, sp3File);
+                else if (!IsUpToDate(fopt, url, sp3File, ent))
                 {
                     /* it is OK for '*.Z' or '*.gz' format */
                     string sp3xFile = sp3File + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + sp3xFile + cutDirs + url;
+                    string cmd = FetchCmd(fopt, url, cutDirs, sp3xFile);
                     std::system(cmd.c_str());
 
                     string sp3gzFile = sp3File + ".gz", sp3zFile = sp3File + ".Z";
@@ -3149,10 +5839,19 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         std::system(cmd.c_str());
                     }
 
-                    if (access(sp3File.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetOrbClk): failed to download IGS ultra-rapid orbit file " <<
-                        sp3File << endl;
-                    else if (access(sp3File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetOrbClk): successfully download IGS ultra-rapid orbit file " <<
-                        sp3File << endl;
+                    if (access(sp3File.c_str(), 0) == -1)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): failed to download IGS ultra-rapid orbit file " <<
+                            sp3File << endl;
+                        NotifyFile(fopt, sp3File);
+                    }
+                    else if (access(sp3File.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): successfully download IGS ultra-rapid orbit file " <<
+                            sp3File << endl;
+                        NotifyFile(fopt, sp3File);
+                    }
+                    UpdateCatalog(sp3File, ent);
 
                     /* delete some temporary directories */
                     string tmpDir = "repro3";
@@ -3166,11 +5865,15 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         std::system(cmd.c_str());
                     }
                 }
-                else cout << "*** INFO(FtpUtil::GetOrbClk): IGS ultra-rapid orbit file " << sp3File <<
-                    " has existed!" << endl;
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetOrbClk): IGS ultra-rapid orbit file " << sp3File <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, sp3File);
+                }
             }
         }
-        else if (strcmp(ac.c_str(), "gfu") == 0)
+        else if (acId == AC_GFU)
         {
             string url = "ftp://ftp.gfz-potsdam.de/pub/GNSS/products/ultra/w" + sWwww;
             string cutDirs = " --cut-dirs=5 ";
@@ -3178,11 +5881,13 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
             {
                 string sHh = str.hh2str(fopt->hhOrbClk[i]);
                 string sp3File = ac + sWwww + sDow + "_" + sHh + ".sp3";
-                if (access(sp3File.c_str(), 0) == -1)
+                catent_t ent;
+                if (IsKnownMissing(fopt, sp3File)) NotifyFile(fopt, sp3File);
+                else if (!IsUpToDate(fopt, url, sp3File, ent))
                 {
                     /* it is OK for '*.Z' or '*.gz' format */
                     string sp3xFile = sp3File + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + sp3xFile + cutDirs + url;
+                    string cmd = FetchCmd(fopt, url, cutDirs, sp3xFile);
                     std::system(cmd.c_str());
 
                     string sp3gzFile = sp3File + ".gz", sp3zFile = sp3File + ".Z";
@@ -3199,24 +5904,37 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         std::system(cmd.c_str());
                     }
 
-                    if (access(sp3File.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetOrbClk): failed to download GFZ ultra-rapid orbit file " <<
-                        sp3File << endl;
-                    else if (access(sp3File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetOrbClk): successfully download GFZ ultra-rapid orbit file " <<
-                        sp3File << endl;
+                    if (access(sp3File.c_str(), 0) == -1)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): failed to download GFZ ultra-rapid orbit file " <<
+                            sp3File << endl;
+                        NotifyFile(fopt, sp3File);
+                    }
+                    else if (access(sp3File.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): successfully download GFZ ultra-rapid orbit file " <<
+                            sp3File << endl;
+                        NotifyFile(fopt, sp3File);
+                    }
+                    UpdateCatalog(sp3File, ent);
+                }
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetOrbClk): GFZ ultra-rapid orbit file " << sp3File <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, sp3File);
                 }
-                else cout << "*** INFO(FtpUtil::GetOrbClk): GFZ ultra-rapid orbit file " << sp3File <<
-                    " has existed!" << endl;
             }
         }
         else
         {
             string sp3File, clkFile;
-            if (strcmp(ac.c_str(), "cod") == 0)
+            if (acId == AC_COD)
             {
                 sp3File = ac + sWwww + sDow + ".eph";
                 clkFile = ac + sWwww + sDow + ".clk_05s";
             }
-            else if (strcmp(ac.c_str(), "igs") == 0)
+            else if (acId == AC_IGS)
             {
                 sp3File = ac + sWwww + sDow + ".sp3";
                 clkFile = ac + sWwww + sDow + ".clk_30s";
@@ -3227,18 +5945,15 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                 clkFile = ac + sWwww + sDow + ".clk";
             }
 
-            string url, cutDirs = " --cut-dirs=4 ";
-            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_SP3] + "/" + sWwww;
-            else if (strcmp(ftpName.c_str(), "IGN") == 0) url = _ftpArchive.IGN[IDX_SP3] + "/" + sWwww;
-            else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_SP3] + "/" + sWwww;
-            else url = _ftpArchive.CDDIS[IDX_SP3] + "/" + sWwww;
+            string url = ArcUrl(fopt, IDX_SP3, ts), cutDirs = CutDirs(url);
             if (mode == 1)       /* SP3 file downloaded */
             {
-                if (access(sp3File.c_str(), 0) == -1)
+                if (IsKnownMissing(fopt, sp3File)) NotifyFile(fopt, sp3File);
+                else if (access(sp3File.c_str(), 0) == -1 && !TakeShared(sp3File))
                 {
                     /* it is OK for '*.Z' or '*.gz' format */
                     string sp3xFile = sp3File + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + sp3xFile + cutDirs + url;
+                    string cmd = FetchCmd(fopt, url, cutDirs, sp3xFile);
                     std::system(cmd.c_str());
 
                     string sp3gzFile = sp3File + ".gz", sp3zFile = sp3File + ".Z";
@@ -3255,10 +5970,18 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         std::system(cmd.c_str());
                     }
 
-                    if (access(sp3File.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetOrbClk): failed to download IGS precise orbit file " <<
-                        sp3File << endl;
-                    else if (access(sp3File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetOrbClk): successfully download IGS precise orbit file " <<
-                        sp3File << endl;
+                    if (access(sp3File.c_str(), 0) == -1)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): failed to download IGS precise orbit file " <<
+                            sp3File << endl;
+                        NotifyFile(fopt, sp3File);
+                    }
+                    else if (access(sp3File.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): successfully download IGS precise orbit file " <<
+                            sp3File << endl;
+                        NotifyFile(fopt, sp3File);
+                    }
 
                     /* delete some temporary directories */
                     string tmpDir = "repro3";
@@ -3272,16 +5995,21 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         std::system(cmd.c_str());
                     }
                 }
-                else cout << "*** INFO(FtpUtil::GetOrbClk): IGS precise orbit file " << sp3File <<
-                    " has existed!" << endl;
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetOrbClk): IGS precise orbit file " << sp3File <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, sp3File);
+                }
             }
             else if (mode == 2)  /* CLK file downloaded */
             {
-                if (access(clkFile.c_str(), 0) == -1)
+                if (IsKnownMissing(fopt, clkFile)) NotifyFile(fopt, clkFile);
+                else if (access(clkFile.c_str(), 0) == -1 && !TakeShared(clkFile))
                 {
                     /* it is OK for '*.Z' or '*.gz' format */
                     string clkxFile = clkFile + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + clkxFile + cutDirs + url;
+                    string cmd = FetchCmd(fopt, url, cutDirs, clkxFile);
                     std::system(cmd.c_str());
 
                     string clkgzFile = clkFile + ".gz", clkzFile = clkFile + ".Z";
@@ -3298,10 +6026,18 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         std::system(cmd.c_str());
                     }
 
-                    if (access(clkFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetOrbClk): failed to download IGS precise clock file " <<
-                        clkFile << endl;
-                    else if (access(clkFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetOrbClk): successfully download IGS precise clock file " <<
-                        clkFile << endl;
+                    if (access(clkFile.c_str(), 0) == -1)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): failed to download IGS precise clock file " <<
+                            clkFile << endl;
+                        NotifyFile(fopt, clkFile);
+                    }
+                    else if (access(clkFile.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): successfully download IGS precise clock file " <<
+                            clkFile << endl;
+                        NotifyFile(fopt, clkFile);
+                    }
 
                     /* delete some temporary directories */
                     string tmpDir = "repro3";
@@ -3315,29 +6051,31 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         std::system(cmd.c_str());
                     }
                 }
-                else cout << "*** INFO(FtpUtil::GetOrbClk): IGS precise clock file " << clkFile <<
-                    " has existed!" << endl;
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetOrbClk): IGS precise clock file " << clkFile <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, clkFile);
+                }
             }
         }
     }
     else if (isMGEX)  /* MGEX products */
     {
-        string url, cutDirs = " --cut-dirs=5 ";
-        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_SP3M] + "/" + sWwww;
-        else if (strcmp(ftpName.c_str(), "IGN") == 0) url = _ftpArchive.IGN[IDX_SP3M] + "/" + sWwww;
-        else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_SP3M] + "/" + sWwww;
-        else url = _ftpArchive.CDDIS[IDX_SP3M] + "/" + sWwww;
-        if (strcmp(ac.c_str(), "wuu") == 0)
+        string url = ArcUrl(fopt, IDX_SP3M, ts), cutDirs = CutDirs(url);
+        if (acId == AC_WUU)
         {
             for (int i = 0; i < fopt->hhOrbClk.size(); i++)
             {
                 string sHh = str.hh2str(fopt->hhOrbClk[i]);
                 string sp3File = "WUM0MGXULA_" + sYyyy + sDoy + sHh + "00_01D_05M_ORB.SP3";
-                if (access(sp3File.c_str(), 0) == -1)
+                catent_t ent;
+                if (IsKnownMissing(fopt, sp3File)) NotifyFile(fopt, sp3File);
+                else if (!IsUpToDate(fopt, url, sp3File, ent))
                 {
                     /* it is OK for '*.Z' or '*.gz' format */
                     string sp3xFile = sp3File + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + sp3xFile + cutDirs + url;
+                    string cmd = FetchCmd(fopt, url, cutDirs, sp3xFile);
                     std::system(cmd.c_str());
 
                     string sp3gzFile = sp3File + ".gz", sp3zFile = sp3File + ".Z";
@@ -3354,40 +6092,53 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         std::system(cmd.c_str());
                     }
 
-                    if (access(sp3File.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetOrbClk): failed to download WHU multi-GNSS ultra-rapid orbit file " <<
-                        sp3File << endl;
-                    else if (access(sp3File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetOrbClk): successfully download WHU multi-GNSS ultra-rapid orbit file " <<
-                        sp3File << endl;
+                    if (access(sp3File.c_str(), 0) == -1)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): failed to download WHU multi-GNSS ultra-rapid orbit file " <<
+                            sp3File << endl;
+                        NotifyFile(fopt, sp3File);
+                    }
+                    else if (access(sp3File.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): successfully download WHU multi-GNSS ultra-rapid orbit file " <<
+                            sp3File << endl;
+                        NotifyFile(fopt, sp3File);
+                    }
+                    UpdateCatalog(sp3File, ent);
+                }
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetOrbClk): WHU multi-GNSS ultra-rapid orbit file " << sp3File <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, sp3File);
                 }
-                else cout << "*** INFO(FtpUtil::GetOrbClk): WHU multi-GNSS ultra-rapid orbit file " << sp3File <<
-                    " has existed!" << endl;
             }
         }
         else
         {
             string sp3File, clkFile, sp30File, clk0File;
-            if (strcmp(ac.c_str(), "com") == 0)
+            if (acId == AC_COM)
             {
                 sp3File = "COD0MGXFIN_" + sYyyy + sDoy + "0000_01D_" + "*_ORB.SP3";
                 clkFile = "COD0MGXFIN_" + sYyyy + sDoy + "0000_01D_" + "*_CLK.CLK";
                 sp30File = "com" + sWwww + sDow + ".sp3";
                 clk0File = "com" + sWwww + sDow + ".clk";
             }
-            else if (strcmp(ac.c_str(), "gbm") == 0)
+            else if (acId == AC_GBM)
             {
                 sp3File = "GFZ0MGXRAP_" + sYyyy + sDoy + "0000_01D_" + "*_ORB.SP3";
                 clkFile = "GFZ0MGXRAP_" + sYyyy + sDoy + "0000_01D_" + "*_CLK.CLK";
                 sp30File = "gbm" + sWwww + sDow + ".sp3";
                 clk0File = "gbm" + sWwww + sDow + ".clk";
             }
-            else if (strcmp(ac.c_str(), "grm") == 0)
+            else if (acId == AC_GRM)
             {
                 sp3File = "GRG0MGXFIN_" + sYyyy + sDoy + "0000_01D_" + "*_ORB.SP3";
                 clkFile = "GRG0MGXFIN_" + sYyyy + sDoy + "0000_01D_" + "*_CLK.CLK";
                 sp30File = "grm" + sWwww + sDow + ".sp3";
                 clk0File = "grm" + sWwww + sDow + ".clk";
             }
-            else if (strcmp(ac.c_str(), "wum") == 0)
+            else if (acId == AC_WUM)
             {
                 sp3File = "WUM0MGXFIN_" + sYyyy + sDoy + "0000_01D_" + "*_ORB.SP3";
                 clkFile = "WUM0MGXFIN_" + sYyyy + sDoy + "0000_01D_" + "*_CLK.CLK";
@@ -3397,11 +6148,12 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
 
             if (mode == 1)       /* SP3 file downloaded */
             {
-                if (access(sp30File.c_str(), 0) == -1)
+                if (IsKnownMissing(fopt, sp30File)) NotifyFile(fopt, sp30File);
+                else if (access(sp30File.c_str(), 0) == -1 && !TakeShared(sp30File))
                 {
                     /* it is OK for '*.Z' or '*.gz' format */
                     string sp3xFile = sp3File + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + sp3xFile + cutDirs + url;
+                    string cmd = FetchCmd(fopt, url, cutDirs, sp3xFile);
                     std::system(cmd.c_str());
 
                     /* extract '*.gz' */
@@ -3426,22 +6178,35 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         cmd = changeFileName + " " + sp3File + " " + sp30File;
                         std::system(cmd.c_str());
 
-                        if (access(sp30File.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetOrbClk): failed to download MGEX precise orbit file " <<
-                            sp30File << endl;
+                        if (access(sp30File.c_str(), 0) == -1)
+                        {
+                            cout << "*** INFO(FtpUtil::GetOrbClk): failed to download MGEX precise orbit file " <<
+                                sp30File << endl;
+                            NotifyFile(fopt, sp30File);
+                        }
                     }
 
-                    if (access(sp30File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetOrbClk): successfully download MGEX precise orbit file " << sp30File << endl;
+                    if (access(sp30File.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): successfully download MGEX precise orbit file " << sp30File << endl;
+                        NotifyFile(fopt, sp30File);
+                    }
+                }
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetOrbClk): MGEX precise orbit file " << sp30File <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, sp30File);
                 }
-                else cout << "*** INFO(FtpUtil::GetOrbClk): MGEX precise orbit file " << sp30File <<
-                    " has existed!" << endl;
             }
             else if (mode == 2)  /* CLK file downloaded */
             {
-                if (access(clk0File.c_str(), 0) == -1)
+                if (IsKnownMissing(fopt, clk0File)) NotifyFile(fopt, clk0File);
+                else if (access(clk0File.c_str(), 0) == -1 && !TakeShared(clk0File))
                 {
                     /* it is OK for '*.Z' or '*.gz' format */
                     string clkxFile = clkFile + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + clkxFile + cutDirs + url;
+                    string cmd = FetchCmd(fopt, url, cutDirs, clkxFile);
                     std::system(cmd.c_str());
 
                     /* extract '*.gz' */
@@ -3466,15 +6231,27 @@ void FtpUtil::GetOrbClk(gtime_t ts, const char dir[], int mode, const ftpopt_t *
                         cmd = changeFileName + " " + clkFile + " " + clk0File;
                         std::system(cmd.c_str());
 
-                        if (access(clkFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetOrbClk): failed to download MGEX precise clock file " <<
-                            clk0File << endl;
+                        if (access(clkFile.c_str(), 0) == -1)
+                        {
+                            cout << "*** INFO(FtpUtil::GetOrbClk): failed to download MGEX precise clock file " <<
+                                clk0File << endl;
+                            NotifyFile(fopt, clk0File);
+                        }
                     }
 
-                    if (access(clk0File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetOrbClk): successfully download MGEX precise clock file " <<
-                        clk0File << endl;
+                    if (access(clk0File.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetOrbClk): successfully download MGEX precise clock file " <<
+                            clk0File << endl;
+                        NotifyFile(fopt, clk0File);
+                    }
+                }
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetOrbClk): MGEX precise clock file " << clk0File <<
+                        " has existed!" << endl;
+                    NotifyFile(fopt, clk0File);
                 }
-                else cout << "*** INFO(FtpUtil::GetOrbClk): MGEX precise clock file " << clk0File <<
-                    " has existed!" << endl;
             }
         }
     }
@@ -3507,37 +6284,28 @@ void FtpUtil::GetEop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sDow(to_string(dow));
 
     string ac(fopt->eopOpt);
-    str.ToLower(ac);
-    std::vector<string> acIGS = { "igs", "igr", "igu", "cod", "esa", "gfz", "gfu", "grg", "jpl" };;
-    bool isIGS = false;
-    for (int i = 0; i < acIGS.size(); i++)
-    {
-        if (strcmp(ac.c_str(), acIGS[i].c_str()) == 0) isIGS = true;
-    }
+    int acId = fopt->eopAc;
+    bool isIGS = acId >= 0 && acId < NAC && !IsMgexAc(acId);
+    SetMissClass(ts, acId == AC_IGR ? MISS_RAPID : (UltraStep(acId) < 24 ? MISS_ULTRA : MISS_FINAL));
 
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
     if (isIGS)  /* IGS products */
     {
-        string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
-        if (strcmp(ac.c_str(), "igu") == 0)
+        string gzipFull = fopt->gzipFull;
+        if (acId == AC_IGU)
         {
+            string url = ArcUrl(fopt, IDX_EOP, ts), cutDirs = CutDirs(url);
             for (int i = 0; i < fopt->hhEop.size(); i++)
             {
                 string sHh = str.hh2str(fopt->hhEop[i]);
                 string eopFile = ac + sWwww + sDow + "_" + sHh + ".erp";
-                if (access(eopFile.c_str(), 0) == -1)
+                catent_t ent;
+                if (IsKnownMissing(fopt, eopFile)) NotifyFile(fopt, eopFile);
+                else if (!IsUpToDate(fopt, url, eopFile, ent))
                 {
                     /* download the EOP file */
-                    string url, cutDirs = " --cut-dirs=4 ";
-                    if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_EOP] + "/" + sWwww;
-                    else if (strcmp(ftpName.c_str(), "IGN") == 0) url = _ftpArchive.IGN[IDX_EOP] + "/" + sWwww;
-                    else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_EOP] + "/" + sWwww;
-                    else url = _ftpArchive.CDDIS[IDX_EOP] + "/" + sWwww;
-
                     /* it is OK for '*.Z' or '*.gz' format */
                     string eopxFile = eopFile + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + eopxFile + cutDirs + url;
+                    string cmd = FetchCmd(fopt, url, cutDirs, eopxFile);
                     std::system(cmd.c_str());
 
                     string eopgzFile = eopFile + ".gz", eopzFile = eopFile + ".Z";
@@ -3554,10 +6322,19 @@ void FtpUtil::GetEop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                         std::system(cmd.c_str());
                     }
 
-                    if (access(eopFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetEop): failed to download IGU EOP file " <<
-                        eopFile << endl;
-                    else if (access(eopFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetEop): successfully download IGU EOP file " <<
-                        eopFile << endl;
+                    if (access(eopFile.c_str(), 0) == -1)
+                    {
+                        cout << "*** INFO(FtpUtil::GetEop): failed to download IGU EOP file " <<
+                            eopFile << endl;
+                        NotifyFile(fopt, eopFile);
+                    }
+                    else if (access(eopFile.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetEop): successfully download IGU EOP file " <<
+                            eopFile << endl;
+                        NotifyFile(fopt, eopFile);
+                    }
+                    UpdateCatalog(eopFile, ent);
 
                     /* delete some temporary directories */
                     string tmpDir = "repro3";
@@ -3571,10 +6348,14 @@ void FtpUtil::GetEop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                         std::system(cmd.c_str());
                     }
                 }
-                else cout << "*** INFO(FtpUtil::GetEop): IGU EOP file " << eopFile << " has existed!" << endl;
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetEop): IGU EOP file " << eopFile << " has existed!" << endl;
+                    NotifyFile(fopt, eopFile);
+                }
             }
         }
-        else if (strcmp(ac.c_str(), "gfu") == 0)
+        else if (acId == AC_GFU)
         {
             string url = "ftp://ftp.gfz-potsdam.de/pub/GNSS/products/ultra/w" + sWwww;
             string cutDirs = " --cut-dirs=5 ";
@@ -3582,11 +6363,13 @@ void FtpUtil::GetEop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             {
                 string sHh = str.hh2str(fopt->hhEop[i]);
                 string eopFile = ac + sWwww + sDow + "_" + sHh + ".erp";
-                if (access(eopFile.c_str(), 0) == -1)
+                catent_t ent;
+                if (IsKnownMissing(fopt, eopFile)) NotifyFile(fopt, eopFile);
+                else if (!IsUpToDate(fopt, url, eopFile, ent))
                 {
                     /* it is OK for '*.Z' or '*.gz' format */
                     string eopxFile = eopFile + ".*";
-                    string cmd = wgetFull + " " + qr + " -nH -A " + eopxFile + cutDirs + url;
+                    string cmd = FetchCmd(fopt, url, cutDirs, eopxFile);
                     std::system(cmd.c_str());
 
                     string eopgzFile = eopFile + ".gz", eopzFile = eopFile + ".Z";
@@ -3603,31 +6386,41 @@ void FtpUtil::GetEop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                         std::system(cmd.c_str());
                     }
 
-                    if (access(eopFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetEop): failed to download GFU EOP file " <<
-                        eopFile << endl;
-                    else if (access(eopFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetEop): successfully download GFU EOP file " <<
-                        eopFile << endl;
+                    if (access(eopFile.c_str(), 0) == -1)
+                    {
+                        cout << "*** INFO(FtpUtil::GetEop): failed to download GFU EOP file " <<
+                            eopFile << endl;
+                        NotifyFile(fopt, eopFile);
+                    }
+                    else if (access(eopFile.c_str(), 0) == 0)
+                    {
+                        cout << "*** INFO(FtpUtil::GetEop): successfully download GFU EOP file " <<
+                            eopFile << endl;
+                        NotifyFile(fopt, eopFile);
+                    }
+                    UpdateCatalog(eopFile, ent);
+                }
+                else
+                {
+                    cout << "*** INFO(FtpUtil::GetEop): GFU EOP file " << eopFile << " has existed!" << endl;
+                    NotifyFile(fopt, eopFile);
                 }
-                else cout << "*** INFO(FtpUtil::GetEop): GFU EOP file " << eopFile << " has existed!" << endl;
             }
         }
         else
         {
             string eopFile;
-            if (strcmp(ac.c_str(), "igr") == 0) eopFile = ac + sWwww + sDow + ".erp";
+            if (acId == AC_IGR) eopFile = ac + sWwww + sDow + ".erp";
             else eopFile = ac + sWwww + "7.erp";
-            if (access(eopFile.c_str(), 0) == -1)
+            if (IsKnownMissing(fopt, eopFile)) NotifyFile(fopt, eopFile);
+            else if (access(eopFile.c_str(), 0) == -1 && !TakeShared(eopFile))
             {
                 /* download the EOP file */
-                string url, cutDirs = " --cut-dirs=4 ";
-                if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_EOP] + "/" + sWwww;
-                else if (strcmp(ftpName.c_str(), "IGN") == 0) url = _ftpArchive.IGN[IDX_EOP] + "/" + sWwww;
-                else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_EOP] + "/" + sWwww;
-                else url = _ftpArchive.CDDIS[IDX_EOP] + "/" + sWwww;
+                string url = ArcUrl(fopt, IDX_EOP, ts), cutDirs = CutDirs(url);
 
                 /* it is OK for '*.Z' or '*.gz' format */
                 string eopxFile = eopFile + ".*";
-                string cmd = wgetFull + " " + qr + " -nH -A " + eopxFile + cutDirs + url;
+                string cmd = FetchCmd(fopt, url, cutDirs, eopxFile);
                 std::system(cmd.c_str());
 
                 string eopgzFile = eopFile + ".gz", eopzFile = eopFile + ".Z";
@@ -3644,10 +6437,18 @@ void FtpUtil::GetEop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                     std::system(cmd.c_str());
                 }
 
-                if (access(eopFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetEop): failed to download IGS EOP file " <<
-                    eopFile << endl;
-                else if (access(eopFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetEop): successfully download IGS EOP file " <<
-                    eopFile << endl;
+                if (access(eopFile.c_str(), 0) == -1)
+                {
+                    cout << "*** INFO(FtpUtil::GetEop): failed to download IGS EOP file " <<
+                        eopFile << endl;
+                    NotifyFile(fopt, eopFile);
+                }
+                else if (access(eopFile.c_str(), 0) == 0)
+                {
+                    cout << "*** INFO(FtpUtil::GetEop): successfully download IGS EOP file " <<
+                        eopFile << endl;
+                    NotifyFile(fopt, eopFile);
+                }
 
                 /* delete some temporary directories */
                 string tmpDir = "repro3";
@@ -3661,7 +6462,11 @@ void FtpUtil::GetEop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                     std::system(cmd.c_str());
                 }
             }
-            else cout << "*** INFO(FtpUtil::GetEop): IGS EOP file " << eopFile << " has existed!" << endl;
+            else
+            {
+                cout << "*** INFO(FtpUtil::GetEop): IGS EOP file " << eopFile << " has existed!" << endl;
+                NotifyFile(fopt, eopFile);
+            }
         }
     }
 } /* end of GetOrbClkEop */
@@ -3677,6 +6482,8 @@ void FtpUtil::GetEop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetSnx(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_FINAL);
+
     /* change directory */
 #ifdef _WIN32   /* for Windows */
     _chdir(dir);
@@ -3692,22 +6499,17 @@ void FtpUtil::GetSnx(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sWwww = str.wwww2str(wwww);
     string sDow(to_string(dow));
 
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
     string snx0File = "igs" + sWwww + ".snx";
-    if (access(snx0File.c_str(), 0) == -1)
-    {
-        string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;        
-        string url, cutDirs = " --cut-dirs=4 ";
-        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_SNX] + "/" + sWwww;
-        else if (strcmp(ftpName.c_str(), "IGN") == 0) url = _ftpArchive.IGN[IDX_SNX] + "/" + sWwww;
-        else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_SNX] + "/" + sWwww;
-        else url = _ftpArchive.CDDIS[IDX_SNX] + "/" + sWwww;
+    if (IsKnownMissing(fopt, snx0File)) NotifyFile(fopt, snx0File);
+    else if (access(snx0File.c_str(), 0) == -1 && !TakeShared(snx0File))
+    {
+        string gzipFull = fopt->gzipFull;
+        string url = ArcUrl(fopt, IDX_SNX, ts), cutDirs = CutDirs(url);
         
         /* it is OK for '*.Z' or '*.gz' format */
         string snxFile = "igs*P" + sWwww + ".snx";
         string snxxFile = snxFile + ".*";
-        string cmd = wgetFull + " " + qr + " -nH -A " + snxxFile + cutDirs + url;
+        string cmd = FetchCmd(fopt, url, cutDirs, snxxFile);
         std::system(cmd.c_str());
 
         /* extract '*.Z' */
@@ -3731,23 +6533,23 @@ void FtpUtil::GetSnx(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 
             cmd = changeFileName + " " + snxFile + " " + snx0File;
             std::system(cmd.c_str());
-            if (access(snx0File.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetSnx): failed to download IGS weekly SINEX file " <<
-                snx0File << endl;
+            if (access(snx0File.c_str(), 0) == -1)
+            {
+                cout << "*** INFO(FtpUtil::GetSnx): failed to download IGS weekly SINEX file " <<
+                    snx0File << endl;
+                NotifyFile(fopt, snx0File);
+            }
         }
 
         /* If the weekly SINEX file does not exist,  we use the daily SINEX file instead */
         if (access(snx0File.c_str(), 0) == -1)
         {
-            string url, cutDirs = " --cut-dirs=4 ";
-            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_SNX] + "/" + sWwww;
-            else if (strcmp(ftpName.c_str(), "IGN") == 0) url = _ftpArchive.IGN[IDX_SNX] + "/" + sWwww;
-            else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_SNX] + "/" + sWwww;
-            else url = _ftpArchive.CDDIS[IDX_SNX] + "/" + sWwww;
+            string url = ArcUrl(fopt, IDX_SNX, ts), cutDirs = CutDirs(url);
             
             /* it is OK for '*.Z' or '*.gz' format */
             string snxFile = "igs*P" + sWwww + sDow + ".snx";
             string snxxFile = snxFile + ".*";
-            string cmd = wgetFull + " " + qr + " -nH -A " + snxxFile + cutDirs + url;
+            string cmd = FetchCmd(fopt, url, cutDirs, snxxFile);
             std::system(cmd.c_str());
 
             /* extract '*.Z' */
@@ -3771,13 +6573,21 @@ void FtpUtil::GetSnx(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 
                 cmd = changeFileName + " " + snxFile + " " + snx0File;
                 std::system(cmd.c_str());
-                if (access(snx0File.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetSnx): failed to download IGS weekly SINEX file " <<
-                    snx0File << endl;
+                if (access(snx0File.c_str(), 0) == -1)
+                {
+                    cout << "*** INFO(FtpUtil::GetSnx): failed to download IGS weekly SINEX file " <<
+                        snx0File << endl;
+                    NotifyFile(fopt, snx0File);
+                }
             }
         }
 
-        if (access(snx0File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetSnx): successfully download IGS weekly SINEX file " << 
-            snx0File << endl;
+        if (access(snx0File.c_str(), 0) == 0)
+        {
+            cout << "*** INFO(FtpUtil::GetSnx): successfully download IGS weekly SINEX file " << 
+                snx0File << endl;
+            NotifyFile(fopt, snx0File);
+        }
 
         /* delete some temporary directories */
         string tmpDir = "repro3";
@@ -3791,7 +6601,11 @@ void FtpUtil::GetSnx(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
     }
-    else cout << "*** INFO(FtpUtil::GetSnx): IGS weekly SINEX file " << snx0File << " has existed!" << endl;
+    else
+    {
+        cout << "*** INFO(FtpUtil::GetSnx): IGS weekly SINEX file " << snx0File << " has existed!" << endl;
+        NotifyFile(fopt, snx0File);
+    }
 } /* end of GetSnx */
 
 /**
@@ -3805,6 +6619,8 @@ void FtpUtil::GetSnx(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetDcbMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_FINAL);
+
     /* change directory */
 #ifdef _WIN32   /* for Windows */
     _chdir(dir);
@@ -3821,29 +6637,16 @@ void FtpUtil::GetDcbMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYyyy = str.yyyy2str(yyyy);
     string sDoy = str.doy2str(doy);
 
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
     string dcbFile = "CAS0MGXRAP_" + sYyyy + sDoy + "0000_01D_01D_DCB.BSX";
-    if (access(dcbFile.c_str(), 0) == -1)
+    if (IsKnownMissing(fopt, dcbFile)) NotifyFile(fopt, dcbFile);
+    else if (access(dcbFile.c_str(), 0) == -1 && !TakeShared(dcbFile))
     {
-        string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
-        string url, cutDirs = " --cut-dirs=5 ";
-        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_DCBM] + "/" + sYyyy;
-        else if (strcmp(ftpName.c_str(), "IGN") == 0)
-        {
-            url = _ftpArchive.IGN[IDX_DCBM] + "/" + sYyyy;
-            cutDirs = " --cut-dirs=6 ";
-        }
-        else if (strcmp(ftpName.c_str(), "WHU") == 0)
-        {
-            url = _ftpArchive.WHU[IDX_DCBM] + "/" + sYyyy;
-            cutDirs = " --cut-dirs=6 ";
-        }
-        else url = _ftpArchive.CDDIS[IDX_DCBM] + "/" + sYyyy;
+        string gzipFull = fopt->gzipFull;
+        string url = ArcUrl(fopt, IDX_DCBM, ts), cutDirs = CutDirs(url);
 
         /* it is OK for '*.Z' or '*.gz' format */
         string dcbxFile = dcbFile + ".*";
-        string cmd = wgetFull + " " + qr + " -nH -A " + dcbxFile + cutDirs + url;
+        string cmd = FetchCmd(fopt, url, cutDirs, dcbxFile);
         std::system(cmd.c_str());
 
         string dcbgzFile = dcbFile + ".gz", dcbzFile = dcbFile + ".Z";
@@ -3860,12 +6663,24 @@ void FtpUtil::GetDcbMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
 
-        if (access(dcbFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetDcbMgex): failed to download multi-GNSS DCB file " <<
-            dcbFile << endl;
-        else if (access(dcbFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetDcbMgex): successfully download multi-GNSS DCB file " <<
-            dcbFile << endl;
+        if (access(dcbFile.c_str(), 0) == -1)
+        {
+            cout << "*** INFO(FtpUtil::GetDcbMgex): failed to download multi-GNSS DCB file " <<
+                dcbFile << endl;
+            NotifyFile(fopt, dcbFile);
+        }
+        else if (access(dcbFile.c_str(), 0) == 0)
+        {
+            cout << "*** INFO(FtpUtil::GetDcbMgex): successfully download multi-GNSS DCB file " <<
+                dcbFile << endl;
+            NotifyFile(fopt, dcbFile);
+        }
+    }
+    else
+    {
+        cout << "*** INFO(FtpUtil::GetDcbMgex): multi-GNSS DCB file " << dcbFile << " has existed!" << endl;
+        NotifyFile(fopt, dcbFile);
     }
-    else cout << "*** INFO(FtpUtil::GetDcbMgex): multi-GNSS DCB file " << dcbFile << " has existed!" << endl;
 } /* end of GetDcbMgex */
 
 /**
@@ -3880,6 +6695,8 @@ void FtpUtil::GetDcbMgex(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetDcbCode(gtime_t ts, const char dir[], const char dType[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_FINAL);
+
     /* change directory */
 #ifdef _WIN32   /* for Windows */
     _chdir(dir);
@@ -3919,15 +6736,16 @@ void FtpUtil::GetDcbCode(gtime_t ts, const char dir[], const char dType[], const
         dcb0File = "P2C2" + sYy + sMm + ".DCB";
     }
     
-    if (access(dcbFile.c_str(), 0) == -1 && access(dcb0File.c_str(), 0) == -1)
+    if (IsKnownMissing(fopt, dcbFile)) NotifyFile(fopt, dcbFile);
+    else if (access(dcbFile.c_str(), 0) == -1 && access(dcb0File.c_str(), 0) == -1 && !TakeShared(dcbFile))
     {
         /* download DCB file */
-        string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
+        string gzipFull = fopt->gzipFull;
         string url = "ftp://ftp.aiub.unibe.ch/CODE/" + sYyyy;
 
         /* it is OK for '*.Z' or '*.gz' format */
         string dcbxFile = dcbFile + ".*";
-        string cmd = wgetFull + " " + qr + " -nH -A " + dcbxFile + " --cut-dirs=2 " + url;
+        string cmd = FetchCmd(fopt, url, " --cut-dirs=2 ", dcbxFile);
         std::system(cmd.c_str());
 
         string dcbgzFile = dcbFile + ".gz", dcbzFile = dcbFile + ".Z";
@@ -3944,8 +6762,12 @@ void FtpUtil::GetDcbCode(gtime_t ts, const char dir[], const char dType[], const
             std::system(cmd.c_str());
         }
 
-        if (access(dcbFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetDcbCode): failed to download CODE DCB file " <<
-            dcbFile << endl;
+        if (access(dcbFile.c_str(), 0) == -1)
+        {
+            cout << "*** INFO(FtpUtil::GetDcbCode): failed to download CODE DCB file " <<
+                dcbFile << endl;
+            NotifyFile(fopt, dcbFile);
+        }
 
         if (strcmp(type.c_str(), "P2C2") == 0)
         {
@@ -3959,10 +6781,18 @@ void FtpUtil::GetDcbCode(gtime_t ts, const char dir[], const char dType[], const
             std::system(cmd.c_str());
         }
 
-        if (access(dcb0File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetDcbCode): successfully download CODE DCB file " << dcb0File << endl;
+        if (access(dcb0File.c_str(), 0) == 0)
+        {
+            cout << "*** INFO(FtpUtil::GetDcbCode): successfully download CODE DCB file " << dcb0File << endl;
+            NotifyFile(fopt, dcb0File);
+        }
+    }
+    else
+    {
+        cout << "*** INFO(FtpUtil::GetDcbCode): CODE DCB file " << dcb0File << " or " << dcbFile <<
+            " has existed!" << endl;
+        NotifyFile(fopt, dcb0File);
     }
-    else cout << "*** INFO(FtpUtil::GetDcbCode): CODE DCB file " << dcb0File << " or " << dcbFile <<
-        " has existed!" << endl;
 } /* end of GetDcbCode */
 
 /**
@@ -3976,6 +6806,8 @@ void FtpUtil::GetDcbCode(gtime_t ts, const char dir[], const char dType[], const
 **/
 void FtpUtil::GetIono(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_FINAL);
+
     /* change directory */
 #ifdef _WIN32   /* for Windows */
     _chdir(dir);
@@ -3993,26 +6825,18 @@ void FtpUtil::GetIono(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
     string ac(fopt->ionOpt);
     str.ToLower(ac);
     string ionFile = ac + "g" + sDoy + "0." + sYy + "i";
-    if (access(ionFile.c_str(), 0) == -1)
-    {
-        string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
-        string url, cutDirs = " --cut-dirs=6 ";
-        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_ION] + "/" + 
-            sYyyy + "/" + sDoy;
-        else if (strcmp(ftpName.c_str(), "IGN") == 0) url = _ftpArchive.IGN[IDX_ION] + "/" + 
-            sYyyy + "/" + sDoy;
-        else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_ION] + "/" + 
-            sYyyy + "/" + sDoy;
-        else url = _ftpArchive.CDDIS[IDX_ION] + "/" + sYyyy + "/" + sDoy;
+    if (IsKnownMissing(fopt, ionFile)) NotifyFile(fopt, ionFile);
+    else if (access(ionFile.c_str(), 0) == -1 && !TakeShared(ionFile))
+    {
+        string gzipFull = fopt->gzipFull;
+        string url = ArcUrl(fopt, IDX_ION, ts), cutDirs = CutDirs(url);
 
         /* it is OK for '*.Z' or '*.gz' format */
         string ionxFile = ionFile + ".*";
-        string cmd = wgetFull + " " + qr + " -nH -A " + ionxFile + cutDirs + url;
+        string cmd = FetchCmd(fopt, url, cutDirs, ionxFile);
         std::system(cmd.c_str());
 
         string iongzFile = ionFile + ".gz", ionzFile = ionFile + ".Z";
@@ -4029,10 +6853,18 @@ void FtpUtil::GetIono(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
 
-        if (access(ionFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetIono): failed to download GIM file " <<
-            ionFile << endl;
-        else if (access(ionFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetIono): successfully download GIM file " <<
-            ionFile << endl;
+        if (access(ionFile.c_str(), 0) == -1)
+        {
+            cout << "*** INFO(FtpUtil::GetIono): failed to download GIM file " <<
+                ionFile << endl;
+            NotifyFile(fopt, ionFile);
+        }
+        else if (access(ionFile.c_str(), 0) == 0)
+        {
+            cout << "*** INFO(FtpUtil::GetIono): successfully download GIM file " <<
+                ionFile << endl;
+            NotifyFile(fopt, ionFile);
+        }
 
         /* delete some temporary directories */
         string tmpDir = "topex";
@@ -4046,7 +6878,11 @@ void FtpUtil::GetIono(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
     }
-    else cout << "*** INFO(FtpUtil::GetIono): GIM file " << ionFile << " has existed!" << endl;
+    else
+    {
+        cout << "*** INFO(FtpUtil::GetIono): GIM file " << ionFile << " has existed!" << endl;
+        NotifyFile(fopt, ionFile);
+    }
 } /* end of GetIono */
 
 /**
@@ -4060,6 +6896,8 @@ void FtpUtil::GetIono(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetRoti(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_FINAL);
+
     /* change directory */
 #ifdef _WIN32   /* for Windows */
     _chdir(dir);
@@ -4077,24 +6915,16 @@ void FtpUtil::GetRoti(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sYy = str.yy2str(yy);
     string sDoy = str.doy2str(doy);
 
-    string ftpName = fopt->ftpFrom;
-    str.ToUpper(ftpName);
     string rotFile = "roti" + sDoy + "0." + sYy + "f";
-    if (access(rotFile.c_str(), 0) == -1)
-    {
-        string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
-        string url, cutDirs = " --cut-dirs=6 ";
-        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_ROTI] + "/" +
-            sYyyy + "/" + sDoy;
-        else if (strcmp(ftpName.c_str(), "IGN") == 0) url = _ftpArchive.IGN[IDX_ROTI] + "/" +
-            sYyyy + "/" + sDoy;
-        else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_ROTI] + "/" +
-            sYyyy + "/" + sDoy;
-        else url = _ftpArchive.CDDIS[IDX_ROTI] + "/" + sYyyy + "/" + sDoy;
+    if (IsKnownMissing(fopt, rotFile)) NotifyFile(fopt, rotFile);
+    else if (access(rotFile.c_str(), 0) == -1 && !TakeShared(rotFile))
+    {
+        string gzipFull = fopt->gzipFull;
+        string url = ArcUrl(fopt, IDX_ROTI, ts), cutDirs = CutDirs(url);
 
         /* it is OK for '*.Z' or '*.gz' format */
         string rotxFile = rotFile + ".*";
-        string cmd = wgetFull + " " + qr + " -nH -A " + rotxFile + cutDirs + url;
+        string cmd = FetchCmd(fopt, url, cutDirs, rotxFile);
         std::system(cmd.c_str());
 
         string rotgzFile = rotFile + ".gz", rotzFile = rotFile + ".Z";
@@ -4111,10 +6941,18 @@ void FtpUtil::GetRoti(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
 
-        if (access(rotFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetRoti): failed to download ROTI file " <<
-            rotFile << endl;
-        else if (access(rotFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetRoti): successfully download ROTI file " <<
-            rotFile << endl;
+        if (access(rotFile.c_str(), 0) == -1)
+        {
+            cout << "*** INFO(FtpUtil::GetRoti): failed to download ROTI file " <<
+                rotFile << endl;
+            NotifyFile(fopt, rotFile);
+        }
+        else if (access(rotFile.c_str(), 0) == 0)
+        {
+            cout << "*** INFO(FtpUtil::GetRoti): successfully download ROTI file " <<
+                rotFile << endl;
+            NotifyFile(fopt, rotFile);
+        }
 
         /* delete some temporary directories */
         string tmpDir = "topex";
@@ -4128,7 +6966,11 @@ void FtpUtil::GetRoti(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
     }
-    else cout << "*** INFO(FtpUtil::GetRoti): ROTI file " << rotFile << " has existed!" << endl;
+    else
+    {
+        cout << "*** INFO(FtpUtil::GetRoti): ROTI file " << rotFile << " has existed!" << endl;
+        NotifyFile(fopt, rotFile);
+    }
 } /* end of GetRoti */
 
 /**
@@ -4142,6 +6984,8 @@ void FtpUtil::GetRoti(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetTrop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_TRP);
+
     /* change directory */
 #ifdef _WIN32   /* for Windows */
     _chdir(dir);
@@ -4164,34 +7008,22 @@ void FtpUtil::GetTrop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
     string sDow(to_string(dow));
 
     string ac(fopt->trpOpt);
-    str.ToLower(ac);
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
-    if (strcmp(ac.c_str(), "igs") == 0)
+    int acId = fopt->trpAc;
+    string gzipFull = fopt->gzipFull;
+    if (acId == AC_IGS)
     {
-        string ftpName = fopt->ftpFrom;
-        str.ToUpper(ftpName);
         string sitFile = fopt->obsOpt;
-        if (fopt->getObs) sitFile = fopt->obsOpt;
-        else if (fopt->getObm) sitFile = fopt->obmOpt;
-        if (strlen(sitFile.c_str()) < 9)  /* the option of 'all' is selected; the length of "site.list" is nine */
+        if (fopt->get[GET_OBS]) sitFile = fopt->obsOpt;
+        else if (fopt->get[GET_OBM]) sitFile = fopt->obmOpt;
+        if (IsAllSites(fopt, sitFile))  /* the option of 'all' is selected */
         {
             /* download all the IGS ZPD files */
-            string url, cutDirs = " --cut-dirs=7 ";
-            if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_ZTD] + "/" +
-                sYyyy + "/" + sDoy;
-            else if (strcmp(ftpName.c_str(), "IGN") == 0)
-            {
-                url = _ftpArchive.IGN[IDX_ZTD] + "/" + sYyyy + "/" + sDoy;
-                cutDirs = " --cut-dirs=6 ";
-            }
-            else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_ZTD] + "/" +
-                sYyyy + "/" + sDoy;
-            else url = _ftpArchive.CDDIS[IDX_ZTD] + "/" + sYyyy + "/" + sDoy;
+            string url = ArcUrl(fopt, IDX_ZTD, ts), cutDirs = CutDirs(url);
 
             /* it is OK for '*.Z' or '*.gz' format */
             string zpdFile = "*" + sDoy + "0." + sYy + "zpd";
             string zpdxFile = zpdFile + ".*";
-            string cmd = wgetFull + " " + qr + " -nH -A " + zpdxFile + cutDirs + url;
+            string cmd = FetchCmd(fopt, url, cutDirs, zpdxFile);
             std::system(cmd.c_str());
 
             /* get the file list */
@@ -4211,37 +7043,21 @@ void FtpUtil::GetTrop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
         else  /* the option of full path of site list file is selected */
         {
             /* download the IGS ZPD file site-by-site */
-            if (access(sitFile.c_str(), 0) == 0)
+            std::vector<string> sitNames;
+            if (GetSiteList(fopt, sitFile.c_str(), sitNames))
             {
-                ifstream sitLst(sitFile.c_str());
-                if (!sitLst.is_open())
-                {
-                    cerr << "*** ERROR(FtpUtil::GetTrop): open site.list = " << sitFile << " file failed, please check it" << endl;
-
-                    return;
-                }
-
-                string sitName;
-                while (getline(sitLst, sitName))
+                for (string sitName : sitNames)
                 {
                     str.ToLower(sitName);
                     string zpdFile = sitName + sDoy + "0." + sYy + "zpd";
-                    if (access(zpdFile.c_str(), 0) == -1)
+                    if (IsKnownMissing(fopt, zpdFile)) NotifyFile(fopt, zpdFile);
+                    else if (access(zpdFile.c_str(), 0) == -1 && !TakeShared(zpdFile))
                     {
-                        string url, cutDirs = " --cut-dirs=7 ";
-                        if (strcmp(ftpName.c_str(), "CDDIS") == 0) url = _ftpArchive.CDDIS[IDX_ZTD] + "/" +
-                            sYyyy + "/" + sDoy;
-                        else if (strcmp(ftpName.c_str(), "IGN") == 0)
-                        {
-                            url = _ftpArchive.IGN[IDX_ZTD] + "/" + sYyyy + "/" + sDoy;
-                            cutDirs = " --cut-dirs=6 ";
-                        }
-                        else if (strcmp(ftpName.c_str(), "WHU") == 0) url = _ftpArchive.WHU[IDX_ZTD] + "/" +
-                            sYyyy + "/" + sDoy;
+                        string url = ArcUrl(fopt, IDX_ZTD, ts), cutDirs = CutDirs(url);
                         
                         /* it is OK for '*.Z' or '*.gz' format */
                         string zpdxFile = zpdFile + ".*";
-                        string cmd = wgetFull + " " + qr + " -nH -A " + zpdxFile + cutDirs + url;
+                        string cmd = FetchCmd(fopt, url, cutDirs, zpdxFile);
                         std::system(cmd.c_str());
 
                         string zpdgzFile = zpdFile + ".gz", zpdzFile = zpdFile + ".Z";
@@ -4258,31 +7074,41 @@ void FtpUtil::GetTrop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                             std::system(cmd.c_str());
                         }
 
-                        if (access(zpdFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetTrop): failed to download IGS tropospheric product file " <<
-                            zpdFile << endl;
-                        else if (access(zpdFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetTrop): successfully download IGS tropospheric product file " <<
-                            zpdFile << endl;
+                        if (access(zpdFile.c_str(), 0) == -1)
+                        {
+                            cout << "*** INFO(FtpUtil::GetTrop): failed to download IGS tropospheric product file " <<
+                                zpdFile << endl;
+                            NotifyFile(fopt, zpdFile);
+                        }
+                        else if (access(zpdFile.c_str(), 0) == 0)
+                        {
+                            cout << "*** INFO(FtpUtil::GetTrop): successfully download IGS tropospheric product file " <<
+                                zpdFile << endl;
+                            NotifyFile(fopt, zpdFile);
+                        }
+                    }
+                    else
+                    {
+                        cout << "*** INFO(FtpUtil::GetTrop): IGS tropospheric product file " << zpdFile << 
+                            " has existed!" << endl;
+                        NotifyFile(fopt, zpdFile);
                     }
-                    else cout << "*** INFO(FtpUtil::GetTrop): IGS tropospheric product file " << zpdFile << 
-                        " has existed!" << endl;
                 }
-
-                /* close 'site.list' */
-                sitLst.close();
             }
         }
     }
-    else if (strcmp(ac.c_str(), "cod") == 0)
+    else if (acId == AC_COD)
     {
         string trpFile = "COD" + sWwww + sDow + ".TRO";
-        if (access(trpFile.c_str(), 0) == -1)
+        if (IsKnownMissing(fopt, trpFile)) NotifyFile(fopt, trpFile);
+        else if (access(trpFile.c_str(), 0) == -1 && !TakeShared(trpFile))
         {
             string url = "ftp://ftp.aiub.unibe.ch/CODE/" + sYyyy;
             string cutDirs = " --cut-dirs=2 ";
 
             /* it is OK for '*.Z' or '*.gz' format */
             string trpxFile = trpFile + ".*";
-            string cmd = wgetFull + " " + qr + " -nH -A " + trpxFile + cutDirs + url;
+            string cmd = FetchCmd(fopt, url, cutDirs, trpxFile);
             std::system(cmd.c_str());
 
             string trpgzFile = trpFile + ".gz", trpzFile = trpFile + ".Z";
@@ -4299,13 +7125,25 @@ void FtpUtil::GetTrop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
                 std::system(cmd.c_str());
             }
 
-            if (access(trpFile.c_str(), 0) == -1) cout << "*** INFO(FtpUtil::GetTrop): failed to download CODE tropospheric product file " <<
-                trpFile << endl;
-            else if (access(trpFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetTrop): successfully download CODE tropospheric product file " <<
-                trpFile << endl;
+            if (access(trpFile.c_str(), 0) == -1)
+            {
+                cout << "*** INFO(FtpUtil::GetTrop): failed to download CODE tropospheric product file " <<
+                    trpFile << endl;
+                NotifyFile(fopt, trpFile);
+            }
+            else if (access(trpFile.c_str(), 0) == 0)
+            {
+                cout << "*** INFO(FtpUtil::GetTrop): successfully download CODE tropospheric product file " <<
+                    trpFile << endl;
+                NotifyFile(fopt, trpFile);
+            }
+        }
+        else
+        {
+            cout << "*** INFO(FtpUtil::GetTrop): CODE tropospheric product file " << trpFile <<
+                " has existed!" << endl;
+            NotifyFile(fopt, trpFile);
         }
-        else cout << "*** INFO(FtpUtil::GetTrop): CODE tropospheric product file " << trpFile <<
-            " has existed!" << endl;
     }
 } /* end of GetTrop */
 
@@ -4321,6 +7159,8 @@ void FtpUtil::GetTrop(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetRtOrbClkCNT(gtime_t ts, const char dir[], int mode, const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_RT);
+
     /* change directory */
 #ifdef _WIN32   /* for Windows */
     _chdir(dir);
@@ -4336,24 +7176,33 @@ void FtpUtil::GetRtOrbClkCNT(gtime_t ts, const char dir[], int mode, const ftpop
     string sWwww = str.wwww2str(wwww);
     string sDow(to_string(dow));
 
-    string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
+    string gzipFull = fopt->gzipFull;
     if (mode == 1)       /* SP3 file downloaded */
     {
         string sp3File = "cnt" + sWwww + sDow + ".sp3";
-        if (access(sp3File.c_str(), 0) == -1)
+        if (IsKnownMissing(fopt, sp3File)) NotifyFile(fopt, sp3File);
+        else if (access(sp3File.c_str(), 0) == -1 && !TakeShared(sp3File))
         {
             string sp3gzFile = sp3File + ".gz";
             string url = "http://www.ppp-wizard.net/products/REAL_TIME/" + sp3gzFile;
-            string cmd = wgetFull + " " + qr + " -nH --cut-dirs=2 " + url;
+            string cmd = FetchCmd(fopt, url, " --cut-dirs=2 ", "");
             std::system(cmd.c_str());
 
             /* extract '*.gz' */
             cmd = gzipFull + " -d -f " + sp3gzFile;
             std::system(cmd.c_str());
-            if (access(sp3File.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): successfully download CNES real-time precise orbit file " << 
-                sp3File << endl;
-            else cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): failed to download CNES real-time precise orbit file " <<
-                sp3File << endl;
+            if (access(sp3File.c_str(), 0) == 0)
+            {
+                cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): successfully download CNES real-time precise orbit file " << 
+                    sp3File << endl;
+                NotifyFile(fopt, sp3File);
+            }
+            else
+            {
+                cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): failed to download CNES real-time precise orbit file " <<
+                    sp3File << endl;
+                NotifyFile(fopt, sp3File);
+            }
 
             /* delete some temporary directories */
             std::vector<string> tmpDir = { "FORMAT_BIAIS_OFFI1", "FORMATBIAS_OFF_v1" };
@@ -4370,26 +7219,39 @@ void FtpUtil::GetRtOrbClkCNT(gtime_t ts, const char dir[], int mode, const ftpop
                 }
             }
         }
-        else cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): CNES real-time precise orbit file " << sp3File << 
-            " has existed!" << endl;
+        else
+        {
+            cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): CNES real-time precise orbit file " << sp3File << 
+                " has existed!" << endl;
+            NotifyFile(fopt, sp3File);
+        }
     }
     else if (mode == 2)  /* CLK file downloaded */
     {
         string clkFile = "cnt" + sWwww + sDow + ".clk";
-        if (access(clkFile.c_str(), 0) == -1)
+        if (IsKnownMissing(fopt, clkFile)) NotifyFile(fopt, clkFile);
+        else if (access(clkFile.c_str(), 0) == -1 && !TakeShared(clkFile))
         {
             string clkgzFile = clkFile + ".gz";
             string url = "http://www.ppp-wizard.net/products/REAL_TIME/" + clkgzFile;
-            string cmd = wgetFull + " " + qr + " -nH --cut-dirs=2 " + url;
+            string cmd = FetchCmd(fopt, url, " --cut-dirs=2 ", "");
             std::system(cmd.c_str());
 
             /* extract '*.gz' */
             cmd = gzipFull + " -d -f " + clkgzFile;
             std::system(cmd.c_str());
-            if (access(clkFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): successfully download CNES real-time precise clock file " <<
-                clkFile << endl;
-            else cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): failed to download CNES real-time precise clock file " <<
-                clkFile << endl;
+            if (access(clkFile.c_str(), 0) == 0)
+            {
+                cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): successfully download CNES real-time precise clock file " <<
+                    clkFile << endl;
+                NotifyFile(fopt, clkFile);
+            }
+            else
+            {
+                cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): failed to download CNES real-time precise clock file " <<
+                    clkFile << endl;
+                NotifyFile(fopt, clkFile);
+            }
 
             /* delete some temporary directories */
             std::vector<string> tmpDir = { "FORMAT_BIAIS_OFFI1", "FORMATBIAS_OFF_v1" };
@@ -4406,8 +7268,12 @@ void FtpUtil::GetRtOrbClkCNT(gtime_t ts, const char dir[], int mode, const ftpop
                 }
             }
         }
-        else cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): CNES real-time precise clock file " << clkFile << 
-            " has existed!" << endl;
+        else
+        {
+            cout << "*** INFO(FtpUtil::GetRtOrbClkCNT): CNES real-time precise clock file " << clkFile << 
+                " has existed!" << endl;
+            NotifyFile(fopt, clkFile);
+        }
     }
 } /* end of GetRtOrbClkCNT */
 
@@ -4422,6 +7288,8 @@ void FtpUtil::GetRtOrbClkCNT(gtime_t ts, const char dir[], int mode, const ftpop
 **/
 void FtpUtil::GetRtBiasCNT(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_RT);
+
     /* change directory */
 #ifdef _WIN32   /* for Windows */
     _chdir(dir);
@@ -4439,25 +7307,34 @@ void FtpUtil::GetRtBiasCNT(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 
     /* code and phase bias file downloaded */
     string biaFile = "cnt" + sWwww + sDow + ".bia";
-    if (access(biaFile.c_str(), 0) == -1)
+    if (IsKnownMissing(fopt, biaFile)) NotifyFile(fopt, biaFile);
+    else if (access(biaFile.c_str(), 0) == -1 && !TakeShared(biaFile))
     {
-        string wgetFull = fopt->wgetFull, gzipFull = fopt->gzipFull, qr = fopt->qr;
+        string gzipFull = fopt->gzipFull;
         string biagzFile = biaFile + ".gz";
         string url = "http://www.ppp-wizard.net/products/REAL_TIME/" + biagzFile;
         string cutDirs = " --cut-dirs=2 ";
 
         /* it is OK for '*.Z' or '*.gz' format */
         string biaxFile = biaFile + ".*";
-        string cmd = wgetFull + " " + qr + " -nH --cut-dirs=2 " + url;
+        string cmd = FetchCmd(fopt, url, " --cut-dirs=2 ", "");
         std::system(cmd.c_str());
 
         /* extract '*.gz' */
         cmd = gzipFull + " -d -f " + biagzFile;
         std::system(cmd.c_str());
-        if (access(biaFile.c_str(), 0) == 0) cout << "*** INFO(GetRtBiasCNT): successfully download CNES real-time code and phase bias file " << 
-            biaFile << endl;
-        else cout << "*** INFO(FtpUtil::GetRtBiasCNT): failed to download CNES real-time code and phase bias file " <<
-            biaFile << endl;
+        if (access(biaFile.c_str(), 0) == 0)
+        {
+            cout << "*** INFO(GetRtBiasCNT): successfully download CNES real-time code and phase bias file " << 
+                biaFile << endl;
+            NotifyFile(fopt, biaFile);
+        }
+        else
+        {
+            cout << "*** INFO(FtpUtil::GetRtBiasCNT): failed to download CNES real-time code and phase bias file " <<
+                biaFile << endl;
+            NotifyFile(fopt, biaFile);
+        }
 
         /* delete some temporary directories */
         std::vector<string> tmpDir = { "FORMAT_BIAIS_OFFI1", "FORMATBIAS_OFF_v1" };
@@ -4474,8 +7351,12 @@ void FtpUtil::GetRtBiasCNT(gtime_t ts, const char dir[], const ftpopt_t *fopt)
             }
         }
     }
-    else cout << "*** INFO(FtpUtil::GetRtBiasCNT): CNES real-time code and phase bias file " << biaFile <<
-        " has existed!" << endl;
+    else
+    {
+        cout << "*** INFO(FtpUtil::GetRtBiasCNT): CNES real-time code and phase bias file " << biaFile <<
+            " has existed!" << endl;
+        NotifyFile(fopt, biaFile);
+    }
 } /* end of GetRtBiasCNT */
 
 /**
@@ -4489,6 +7370,8 @@ void FtpUtil::GetRtBiasCNT(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 **/
 void FtpUtil::GetAntexIGS(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 {
+    SetMissClass(ts, MISS_STATIC);
+
     /* change directory */
 #ifdef _WIN32   /* for Windows */
     _chdir(dir);
@@ -4497,32 +7380,70 @@ void FtpUtil::GetAntexIGS(gtime_t ts, const char dir[], const ftpopt_t *fopt)
 #endif
 
     string atxFile("igs14.atx");
-    if (access(atxFile.c_str(), 0) == -1)
+    string url = "https://files.igs.org/pub/station/general";
+    catent_t ent;
+    if (IsKnownMissing(fopt, atxFile)) NotifyFile(fopt, atxFile);
+    else if (!IsUpToDate(fopt, url, atxFile, ent))
     {
-        string wgetFull = fopt->wgetFull, qr = fopt->qr;
-        string url = "https://files.igs.org/pub/station/general/" + atxFile;
-        string cmd = wgetFull + " " + qr + " -nH --cut-dirs=3 " + url;
+        string cmd = FetchCmd(fopt, url + "/" + atxFile, " --cut-dirs=3 ", "");
         std::system(cmd.c_str());
 
-        if (access(atxFile.c_str(), 0) == 0) cout << "*** INFO(FtpUtil::GetAntexIGS): successfully download IGS ANTEX file " << atxFile << endl;
+        if (access(atxFile.c_str(), 0) == 0)
+        {
+            cout << "*** INFO(FtpUtil::GetAntexIGS): successfully download IGS ANTEX file " << atxFile << endl;
+            NotifyFile(fopt, atxFile);
+            UpdateCatalog(atxFile, ent);
+        }
+        else
+        {
+            cout << "*** WARNING(FtpUtil::GetAntexIGS): failed to download IGS ANTEX file " << atxFile << endl;
+            NotifyFile(fopt, atxFile);
+
+            /* the failure is recorded above, then the previous version is restored if it was kept */
+            if (access((atxFile + ".stale").c_str(), 0) == 0 || access((atxFile + ".zst.stale").c_str(), 0) == 0)
+                UpdateCatalog(atxFile, ent);
+        }
+    }
+    else
+    {
+        cout << "*** INFO(FtpUtil::GetAntexIGS): IGS ANTEX file " << atxFile << " has existed!" << endl;
+        NotifyFile(fopt, atxFile);
     }
-    else cout << "*** INFO(FtpUtil::GetAntexIGS): IGS ANTEX file " << atxFile << " has existed!" << endl;
 } /* end of GetAntexIGS */
 
 /**
-* @brief     : FtpDownload - GNSS data downloading via FTP
-* @param[I]  : popt (processing options)
+* @brief     : FtpInit - the settings of FTP archive and third-party softwares before downloading
 * @param[I/O]: fopt (FTP options)
 * @return    : none
-* @note      :
+* @note      : it is called once before 'FtpGet'
 **/
-void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
+void FtpUtil::FtpInit(ftpopt_t *fopt)
 {
     /* Get FTP archive for CDDIS, IGN, or WHU */
     init();
+    SetProtocol(fopt);
 
-    /* setting of the third-party softwares (.i.e, wget, gzip, crx2rnx etc.) */
+    /* the learned concurrency of the hosts is kept in the home directory between runs */
+#ifdef _WIN32   /* for Windows */
+    const char *home = getenv("USERPROFILE");
+#else           /* for Linux or Mac */
+    const char *home = getenv("HOME");
+#endif
+    _rate.Load(home != nullptr ? home : "");
+    _plan.Load(home != nullptr ? home : "");
+    _bucket.Open(home != nullptr ? home : "");
+
+    /* the session cookies of 'curl' are kept by each downloader in a file of its own, removed at the end of the run;
+       the path is absolute as the jobs change the current directory */
     StringUtil str;
+    if (_cookieFile.empty())
+        _cookieFile = str.TmpName((home != nullptr ? string(home) + (char)FILEPATHSEP : string()) + ".good_cookies");
+
+    /* a shard keeps its own catalogs and inventories, 'FtpMerge' takes them in after all the shards have finished */
+    _plan.Shard(fopt->shardIdx, fopt->shardCnt);
+    _shardTag = fopt->shardCnt > 1 ? to_string(fopt->shardIdx) + "of" + to_string(fopt->shardCnt) : "";
+
+    /* setting of the third-party softwares (.i.e, wget, gzip, crx2rnx etc.) */
     if (fopt->isPath3party)  /* the path of third-party softwares is NOT set in the environmental variable */
     {
         char cmdTmp[MAXCHARS] = { '\0' };
@@ -4532,33 +7453,82 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
         sprintf(cmdTmp, "%s%c%s", fopt->dir3party, sep, "wget");
         str.TrimSpace(cmdTmp);
         str.CutFilePathSep(cmdTmp);
-        strcpy(fopt->wgetFull, cmdTmp);
+        fopt->wgetFull = str.Intern(cmdTmp);
+
+        /* for curl */
+        sprintf(cmdTmp, "%s%c%s", fopt->dir3party, sep, "curl");
+        str.TrimSpace(cmdTmp);
+        str.CutFilePathSep(cmdTmp);
+        fopt->curlFull = str.Intern(cmdTmp);
 
         /* for gzip */
         sprintf(cmdTmp, "%s%c%s", fopt->dir3party, sep, "gzip");
         str.TrimSpace(cmdTmp);
         str.CutFilePathSep(cmdTmp);
-        strcpy(fopt->gzipFull, cmdTmp);
+        fopt->gzipFull = str.Intern(cmdTmp);
 
         /* for crx2rnx */
         sprintf(cmdTmp, "%s%c%s", fopt->dir3party, sep, "crx2rnx");
         str.TrimSpace(cmdTmp);
         str.CutFilePathSep(cmdTmp);
-        strcpy(fopt->crx2rnxFull, cmdTmp);
+        fopt->crx2rnxFull = str.Intern(cmdTmp);
+
+        /* for zstd */
+        sprintf(cmdTmp, "%s%c%s", fopt->dir3party, sep, "zstd");
+        str.TrimSpace(cmdTmp);
+        str.CutFilePathSep(cmdTmp);
+        fopt->zstdFull = str.Intern(cmdTmp);
     }
     else  /* the path of third-party softwares is set in the environmental variable */
     {
-        str.SetStr(fopt->wgetFull, "wget", 5);
-        str.SetStr(fopt->gzipFull, "gzip", 5);
-        str.SetStr(fopt->crx2rnxFull, "crx2rnx", 8);
+        fopt->wgetFull = "wget";
+        fopt->curlFull = "curl";
+        fopt->gzipFull = "gzip";
+        fopt->crx2rnxFull = "crx2rnx";
+        fopt->zstdFull = "zstd";
     }
+    _zstd.SetTool(fopt->zstdFull);
 
     /* "-qr" (printInfoWget == false, not print information of 'wget') or "r" (printInfoWget == true, print information of 'wget') in 'wget' command line */
-    if (fopt->printInfoWget) str.SetStr(fopt->qr, "-r", 3);
-    else str.SetStr(fopt->qr, "-qr", 4);
+    if (fopt->printInfoWget) fopt->qr = "-r";
+    else fopt->qr = "-qr";
+} /* end of FtpInit */
+
+/**
+* @brief   : FtpGet - download one kind of product for one day
+* @param[I]: popt (processing options of the day)
+* @param[I]: fopt (FTP options)
+* @param[I]: get (product, GET_???)
+* @param[O]: none
+* @return  : none
+* @note    : 'FtpInit' must be called first
+**/
+void FtpUtil::FtpGet(const prcopt_t *popt, const ftpopt_t *fopt, int get)
+{
+    if (get < 0 || get >= NGET || !fopt->get[get]) return;
+
+    /* a lock left by a product that did not report all of its files is not kept for the next one */
+    _lock.UnlockAll();
+    _getStart = time(nullptr);
+    _landed.clear();
+    _requeue = false;
+
+    /* all the products go through the content-addressed store, which is the cache shared by the projects and users */
+    _storeOn = popt->storeDir[0] != '\0';
+    if (_storeOn && _store.Root() != popt->storeDir) _storeOn = _store.Open(popt->storeDir);
+
+    /* the products re-read most by the processing are kept as seekable zstd (the observations by 'CrxToObs') */
+    _zstdOn = fopt->zstdSeek && (get == GET_ORBCLK || get == GET_ION || get == GET_RTORBCLK);
+
+    ftpopt_t jopt;
+    JobOpt(popt, fopt, get, jopt);
+    if (!ShardJob(popt, get, jopt)) return;
+    fopt = &jopt;
+    _planKind = PlanKind(fopt, get);
+    if (_storeOn) _store.Scope(StoreScope(fopt, get));
 
     /* IGS observation (short name 'd') downloaded */
-    if (fopt->getObs)
+    if (get == GET_OBS)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->obsDir, 0) == -1)
@@ -4572,13 +7542,17 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
 
-        if (strcmp(fopt->obsTyp, "daily") == 0) GetDailyObsIgs(popt->ts, popt->obsDir, fopt);
-        else if (strcmp(fopt->obsTyp, "hourly") == 0) GetHourlyObsIgs(popt->ts, popt->obsDir, fopt);
-        else if (strcmp(fopt->obsTyp, "highrate") == 0) GetHrObsIgs(popt->ts, popt->obsDir, fopt);
+        if (fopt->obsTyp == OBS_DAILY) GetDailyObsIgs(popt->ts, popt->obsDir, fopt);
+        else if (fopt->obsTyp == OBS_HOURLY) GetHourlyObsIgs(popt->ts, popt->obsDir, fopt);
+        else if (fopt->obsTyp == OBS_HIGHRATE) GetHrObsIgs(popt->ts, popt->obsDir, fopt);
+
+        /* one daily file per site instead of up to 24 or 96 files */
+        if (fopt->spliceObs && fopt->obsTyp != OBS_DAILY) SpliceObs(fopt, popt->ts, string(popt->obsDir) + (char)FILEPATHSEP +
+            (fopt->obsTyp == OBS_HOURLY ? "hourly" : "highrate"));
     }
 
     /* MGEX observation (long name 'crx') downloaded */
-    if (fopt->getObm)
+    if (get == GET_OBM)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->obmDir, 0) == -1)
@@ -4592,13 +7566,17 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
 
-        if (strcmp(fopt->obmTyp, "daily") == 0) GetDailyObsMgex(popt->ts, popt->obmDir, fopt);
-        else if (strcmp(fopt->obmTyp, "hourly") == 0) GetHourlyObsMgex(popt->ts, popt->obmDir, fopt);
-        else if (strcmp(fopt->obmTyp, "highrate") == 0) GetHrObsMgex(popt->ts, popt->obmDir, fopt);
+        if (fopt->obmTyp == OBS_DAILY) GetDailyObsMgex(popt->ts, popt->obmDir, fopt);
+        else if (fopt->obmTyp == OBS_HOURLY) GetHourlyObsMgex(popt->ts, popt->obmDir, fopt);
+        else if (fopt->obmTyp == OBS_HIGHRATE) GetHrObsMgex(popt->ts, popt->obmDir, fopt);
+
+        /* one daily file per site instead of up to 24 or 96 files */
+        if (fopt->spliceObs && fopt->obmTyp != OBS_DAILY) SpliceObs(fopt, popt->ts, string(popt->obmDir) + (char)FILEPATHSEP +
+            (fopt->obmTyp == OBS_HOURLY ? "hourly" : "highrate"));
     }
 
     /* Curtin University of Technology (CUT) observation (long name 'crx') downloaded */
-    if (fopt->getObc)
+    if (get == GET_OBC)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->obcDir, 0) == -1)
@@ -4612,11 +7590,11 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
 
-        if (strcmp(fopt->obcTyp, "daily") == 0) GetDailyObsCut(popt->ts, popt->obcDir, fopt);
+        if (fopt->obcTyp == OBS_DAILY) GetDailyObsCut(popt->ts, popt->obcDir, fopt);
     }
 
     /* Geoscience Australia (GA) observation (long name 'crx') downloaded */
-    if (fopt->getObg)
+    if (get == GET_OBG)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->obgDir, 0) == -1)
@@ -4630,13 +7608,17 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
 
-        if (strcmp(fopt->obgTyp, "daily") == 0) GetDailyObsGa(popt->ts, popt->obgDir, fopt);
-        else if (strcmp(fopt->obgTyp, "hourly") == 0) GetHourlyObsGa(popt->ts, popt->obgDir, fopt);
-        else if (strcmp(fopt->obgTyp, "highrate") == 0) GetHrObsGa(popt->ts, popt->obgDir, fopt);
+        if (fopt->obgTyp == OBS_DAILY) GetDailyObsGa(popt->ts, popt->obgDir, fopt);
+        else if (fopt->obgTyp == OBS_HOURLY) GetHourlyObsGa(popt->ts, popt->obgDir, fopt);
+        else if (fopt->obgTyp == OBS_HIGHRATE) GetHrObsGa(popt->ts, popt->obgDir, fopt);
+
+        /* one daily file per site instead of up to 24 or 96 files */
+        if (fopt->spliceObs && fopt->obgTyp != OBS_DAILY) SpliceObs(fopt, popt->ts, string(popt->obgDir) + (char)FILEPATHSEP +
+            (fopt->obgTyp == OBS_HOURLY ? "hourly" : "highrate"));
     }
 
     /* Hong Kong CORS observation (long name 'crx') downloaded */
-    if (fopt->getObh)
+    if (get == GET_OBH)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->obhDir, 0) == -1)
@@ -4650,16 +7632,16 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
             std::system(cmd.c_str());
         }
 
-        if (strcmp(fopt->obhTyp, "30s") == 0 || strcmp(fopt->obhTyp, "30 s") == 0)
+        if (fopt->obhTyp == OBS_30S)
             Get30sObsHk(popt->ts, popt->obhDir, fopt);
-        else if (strcmp(fopt->obhTyp, "5s") == 0 || strcmp(fopt->obhTyp, "05s") == 0)
+        else if (fopt->obhTyp == OBS_5S)
             Get5sObsHk(popt->ts, popt->obhDir, fopt);
-        else if (strcmp(fopt->obhTyp, "1s") == 0 || strcmp(fopt->obhTyp, "01s") == 0)
+        else if (fopt->obhTyp == OBS_1S)
             Get1sObsHk(popt->ts, popt->obhDir, fopt);
     }
 
     /* broadcast ephemeris downloaded */
-    if (fopt->getNav)
+    if (get == GET_NAV)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->navDir, 0) == -1)
@@ -4677,7 +7659,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
 
     /* precise orbit and clock product downloaded for the current day */
-    if (fopt->getOrbClk)
+    if (get == GET_ORBCLK)
     {
         /* If the directory 'sp3' does not exist, creat it */
         if (access(popt->sp3Dir, 0) == -1)
@@ -4692,7 +7674,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
         }
         GetOrbClk(popt->ts, popt->sp3Dir, 1, fopt);  /* sp3 */
 
-        if (strcmp(fopt->orbClkOpt, "igu") != 0 && strcmp(fopt->orbClkOpt, "gfu") != 0 && strcmp(fopt->orbClkOpt, "wuu") != 0)
+        if (UltraStep(fopt->orbClkAc) >= 24)
         {
             /* If the directory 'clk' does not exist, creat it */
             if (access(popt->clkDir, 0) == -1)
@@ -4709,8 +7691,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
             GetOrbClk(popt->ts, popt->clkDir, 2, fopt);  /* clk */
         }
 
-        if (fopt->minusAdd1day && (strcmp(fopt->orbClkOpt, "igu") != 0 && strcmp(fopt->orbClkOpt, "gfu") != 0 &&
-            strcmp(fopt->orbClkOpt, "wuu") != 0))
+        if (fopt->minusAdd1day && UltraStep(fopt->orbClkAc) >= 24)
         {
             TimeUtil tu;
             gtime_t tt;
@@ -4727,7 +7708,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
     
     /* EOP file downloaded */
-    if (fopt->getEop)
+    if (get == GET_EOP)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->eopDir, 0) == -1)
@@ -4745,7 +7726,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
 
     /* IGS SINEX file downloaded */
-    if (fopt->getSnx)
+    if (get == GET_SNX)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->snxDir, 0) == -1)
@@ -4763,7 +7744,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
 
     /* MGEX and/or CODE DCB files downloaded */
-    if (fopt->getDcb)
+    if (get == GET_DCB)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->dcbDir, 0) == -1)
@@ -4784,7 +7765,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
 
     /* global ionosphere map (GIM) downloaded */
-    if (fopt->getIon)
+    if (get == GET_ION)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->ionDir, 0) == -1)
@@ -4802,7 +7783,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
 
     /* Rate of TEC index (ROTI) file downloaded */
-    if (fopt->getRoti)
+    if (get == GET_ROTI)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->ionDir, 0) == -1)
@@ -4820,7 +7801,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
 
     /* final tropospheric product downloaded */
-    if (fopt->getTrp)
+    if (get == GET_TRP)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->ztdDir, 0) == -1)
@@ -4838,7 +7819,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
 
     /* real-time precise orbit and clock products from CNES offline files downloaded */
-    if (fopt->getRtOrbClk)
+    if (get == GET_RTORBCLK)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->sp3Dir, 0) == -1)
@@ -4885,7 +7866,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
 
     /* real-time code and phase bias products from CNES offline files downloaded */
-    if (fopt->getRtBias)
+    if (get == GET_RTBIAS)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->biaDir, 0) == -1)
@@ -4903,7 +7884,7 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
     }
 
     /* IGS ANTEX file downloaded */
-    if (fopt->getAtx)
+    if (get == GET_ATX)
     {
         /* If the directory does not exist, creat it */
         if (access(popt->tblDir, 0) == -1)
@@ -4919,4 +7900,144 @@ void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
 
         GetAntexIGS(popt->ts, popt->tblDir, fopt);
     }
-} /* end of FtpDownload */
\ No newline at end of file
+
+    /* the files landed by the product are validated all at once, so that they are checked in parallel */
+    ValidateFiles(fopt);
+
+    if (fopt->inventory) _invent.Save();
+    _miss.Save();
+    _plan.Save();
+} /* end of FtpGet */
+
+/**
+* @brief     : FtpDownload - GNSS data downloading via FTP
+* @param[I]  : popt (processing options)
+* @param[I/O]: fopt (FTP options)
+* @return    : none
+* @note      : the products of the day are downloaded in the order of GET_???
+**/
+void FtpUtil::FtpDownload(const prcopt_t *popt, ftpopt_t *fopt)
+{
+    FtpInit(fopt);
+    for (int get = 0; get < NGET; get++)
+    {
+        /* the quarantined files are downloaded again at once */
+        do FtpGet(popt, fopt, get);
+        while (_requeue);
+    }
+} /* end of FtpDownload */
+
+/**
+* @brief     : FtpPlan - print and cost the download plan of the days without downloading
+* @param[I]  : days (processing options of each day)
+* @param[I/O]: fopt (FTP options)
+* @return    : none
+* @note      : the plan counts the jobs, the files requested and the ones already present, estimates the
+*              bytes by the size history ('.good_sizes' in the home directory) and projects the runtime by
+*              the learned concurrency and throughput of the hosts
+**/
+void FtpUtil::FtpPlan(const std::vector<prcopt_t> &days, ftpopt_t *fopt)
+{
+    FtpInit(fopt);
+    _plan.Clear();
+    for (const prcopt_t &day : days)
+    {
+        for (int get = 0; get < NGET; get++)
+        {
+            if (!fopt->get[get]) continue;
+
+            ftpopt_t jopt;
+            JobOpt(&day, fopt, get, jopt);
+            if (ShardJob(&day, get, jopt)) PlanGet(&day, &jopt, get);
+        }
+    }
+    _plan.Report(_rate);
+} /* end of FtpPlan */
+
+/**
+* @brief   : MergeDir - merge the catalogs and inventories of the shards in a directory
+* @param[I]: dir (the directory)
+* @param[I]: recursive (whether the sub-directories are merged as well)
+* @param[O]: merged (the directories merged so far, the ones in it are skipped)
+* @return  : number of the shard files merged
+* @note    : the network listings of the shards ('.good_sites_igs2021032_of4') are removed
+**/
+int FtpUtil::MergeDir(const string &dir, bool recursive, std::unordered_set<string> &merged)
+{
+    if (dir.empty() || access(dir.c_str(), 0) == -1 || !merged.insert(dir).second) return 0;
+
+    CatalogUtil cat;
+    InventUtil inv;
+    int nCat = cat.Merge(dir), nInv = inv.Merge(dir);
+    if (nCat < 0 || nInv < 0) cerr << "*** ERROR(FtpUtil::MergeDir): merge the shards of " << dir << " FAILED!" << endl;
+    int n = (nCat > 0 ? nCat : 0) + (nInv > 0 ? nInv : 0);
+
+    /* the network listings resolved for the shards are listed again by the next run */
+    StringUtil str;
+    std::vector<string> names;
+    str.ListDir(dir, names);
+    for (const string &name : names)
+    {
+        if (str.WildMatch(".good_sites_*_of*", name.c_str())) remove((dir + (char)FILEPATHSEP + name).c_str());
+    }
+    if (!recursive) return n;
+
+    std::vector<string> subDirs;
+    str.ListSubDirs(dir, subDirs);
+    for (const string &subDir : subDirs) n += MergeDir(dir + (char)FILEPATHSEP + subDir, true, merged);
+
+    return n;
+} /* end of MergeDir */
+
+/**
+* @brief   : FtpMerge - merge the catalogs and inventories of the shards into the ones of the directories
+* @param[I]: days (processing options of each day)
+* @param[I]: fopt (FTP options)
+* @param[O]: none
+* @return  : none
+* @note    : it is run once after all the shards ('shard' = 1 i/K) have finished, with the same configure
+*            file; the day directories are searched with their sub-directories (i.e., 'daily' and the hours)
+**/
+void FtpUtil::FtpMerge(const std::vector<prcopt_t> &days, const ftpopt_t *fopt)
+{
+    std::unordered_set<string> merged;
+    int n = 0;
+    for (const prcopt_t &day : days)
+    {
+        /* the directories of the days, and the ones shared by the days of the other products */
+        const char *dayDirs[] = { day.obsDir, day.obmDir, day.obcDir, day.obgDir, day.obhDir, day.navDir, day.ztdDir };
+        int dayGets[] = { GET_OBS, GET_OBM, GET_OBC, GET_OBG, GET_OBH, GET_NAV, GET_TRP };
+        for (int i = 0; i < 7; i++)
+        {
+            if (fopt->get[dayGets[i]]) n += MergeDir(dayDirs[i], true, merged);
+        }
+        const char *dirs[] = { day.sp3Dir, day.clkDir, day.eopDir, day.snxDir, day.dcbDir, day.biaDir, day.ionDir, day.tblDir };
+        for (const char *dir : dirs) n += MergeDir(dir, false, merged);
+    }
+    cout << "*** INFO(FtpUtil::FtpMerge): " << n << " catalogs and inventories of the shards are merged, " <<
+        merged.size() << " directories searched" << endl;
+} /* end of FtpMerge */
+
+/**
+* @brief   : IsRequeued - whether the last product is to be downloaded again
+* @param[I]: none
+* @param[O]: none
+* @return  : true:files of the product were quarantined by the validation, false:done
+* @note    :
+**/
+bool FtpUtil::IsRequeued()
+{
+    return _requeue;
+} /* end of IsRequeued */
+
+/**
+* @brief   : FailedFiles - get the number of files that failed to be downloaded
+* @param[I]: none
+* @param[O]: none
+* @return  : the files reported as failed (after the retries of the validation) by this downloader
+* @note    : the files known missing by the negative cache are counted as failed too
+**/
+int FtpUtil::FailedFiles()
+{
+    return _nFailed;
+} /* end of FailedFiles */
\ No newline at end of file
@@ -7,13 +7,36 @@ class FtpUtil
 {
 private:
 
-    struct ftpArchive_t
-    {
-        std::vector<string> CDDIS;  /* CDDIS FTP */
-        std::vector<string> IGN;    /* IGN FTP */
-        std::vector<string> WHU;    /* WHU FTP */
-    };
-    ftpArchive_t _ftpArchive;
+    std::vector<string> _ftpArchive[NARC];  /* FTP archives of CDDIS, IGN, and WHU (indexed by ARC_???) */
+    std::vector<string> _httpsArchive[NARC];/* HTTPS trees of the FTP archives (empty: FTP only) */
+    CacheUtil _miss;                        /* negative cache of the current directory */
+    gtime_t _missTs;                        /* start time of the product day for the negative cache */
+    int _missCls;                           /* latency class of the product for the negative cache (-1: not used) */
+    gtime_t _rangeTs;                       /* start of the time range requested of the current product */
+    gtime_t _rangeTe;                       /* end (exclusive) of the time range requested (mjd 0: whole days) */
+    RateUtil _rate;                         /* learned download concurrency of the hosts */
+    BucketUtil _bucket;                     /* bandwidth budgets shared by the processes */
+    StoreUtil _store;                       /* content-addressed store of the products shared by the projects */
+    bool _storeOn;                          /* whether the current product goes through the store */
+    LockUtil _lock;                         /* locks of the products being downloaded by this process */
+    ZstdUtil _zstd;                         /* seekable zstd compression of the kept files */
+    bool _zstdOn;                           /* whether the current product is kept as seekable zstd */
+    IndexUtil _index;                       /* epoch index of the RINEX observation files */
+    time_t _getStart;                       /* start time of the current product */
+    std::vector<landed_t> _landed;          /* files of the current product that are not validated yet */
+    std::unordered_map<string, int> _badCount;  /* times each file (full path) has been quarantined */
+    bool _requeue;                          /* whether the current product is to be downloaded again */
+    int _nFailed;                           /* files reported as failed since the construction */
+    InventUtil _invent;                     /* inventory of the observation files of the current directory */
+    std::unordered_map<string, std::vector<string> > _netSites;  /* sites of the networks listed in this run (i.e., 'igs2021032') */
+    PlanUtil _plan;                         /* size history of the product files and the dry-run plan */
+    string _planKind;                       /* kind of the files of the current product for the size history */
+    string _shardTag;                       /* shard of this process for its catalogs and inventories, i.e., '2of4' ("" if not sharded) */
+    std::unordered_map<string, std::vector<catent_t> > _listings;  /* FTP(S) directory listings fetched in this run (indexed by URL) */
+    string _jobQr;                          /* 'qr' of 'wget' with the rate limit of the last job, which its options point to */
+    string _cookieFile;                     /* session cookies of the HTTPS logins of 'curl' in this run ("" before 'FtpInit') */
+
+    friend class FtpUtilTest;               /* white-box tests of the private routines (test/test_*.cpp) */
 
 private:
 
@@ -26,6 +49,556 @@ private:
     **/
     void init();
 
+    /**
+    * @brief   : SetProtocol - select the protocol (FTP or HTTPS) of the FTP archive in use
+    * @param[I]: fopt (FTP options)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the HTTPS tree is used only if the archive has one; if 'ftpRoot' is set (i.e., a mirror or a
+    *            local stand-in like 'https://localhost:8443'), it replaces the scheme and host of the HTTPS tree
+    **/
+    void SetProtocol(const ftpopt_t *fopt);
+
+    /**
+    * @brief   : ArcUrl - get the remote directory of a product of the FTP archive in use
+    * @param[I]: fopt (FTP options)
+    * @param[I]: idx (index of the product, IDX_???)
+    * @param[I]: ts (the day of the product)
+    * @param[I]: sHh (the hour of the sub-daily observation files, i.e., '05', "" for the others)
+    * @param[O]: none
+    * @return  : the URL of the directory, i.e., 'ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily/2021/032/21d'
+    * @note    : the tree of the archive is taken from '_ftpArchive' and the directories under it from the
+    *            layout of the archive
+    **/
+    string ArcUrl(const ftpopt_t *fopt, int idx, gtime_t ts, const string &sHh = "");
+
+    /**
+    * @brief   : IsAllSites - whether the observation files in the whole directory are downloaded
+    * @param[I]: fopt (FTP options)
+    * @param[I]: sitOpt (all; the full path of 'site.list')
+    * @param[O]: none
+    * @return  : true:'all' is selected, false:site-by-site
+    * @note    : the in-memory site list (fopt->sites) takes precedence over 'sitOpt'
+    **/
+    bool IsAllSites(const ftpopt_t *fopt, const string &sitOpt);
+
+    /**
+    * @brief   : GetSiteList - get the site names from the in-memory site list or 'site.list' file
+    * @param[I]: fopt (FTP options)
+    * @param[I]: sitFile (the full path of 'site.list')
+    * @param[O]: sites (site names without duplicates)
+    * @return  : true:ok, false:error or 'site.list' is not found
+    * @note    : besides the site names, the list may select the sites by wildcard patterns, networks, bounding
+    *            boxes and exclusions (see 'SiteUtil::Parse'), which are resolved against the remote listings of
+    *            the networks and the positions in the inventory of the current directory
+    **/
+    bool GetSiteList(const ftpopt_t *fopt, const string &sitFile, std::vector<string> &sites);
+
+    /**
+    * @brief   : NetworkSites - get the sites of a network on the day of the current product
+    * @param[I]: fopt (FTP options)
+    * @param[I]: net (network, i.e., 'igs', 'mgex' or 'euref')
+    * @param[O]: sites (site names in lower case)
+    * @return  : true:ok, false:the remote directory cannot be listed
+    * @note    : the sites are those of the daily observation files in the remote directory of the network; the
+    *            listing is taken once per run and cached in the directory ('.good_sites_igs2021032'), a dry run
+    *            ('plan') uses the cached listing only. The shards of a run take the sites from one listing
+    *            ('.good_sites_igs2021032_of4') kept until 'FtpMerge'. The EUREF sites are listed at BKG, but they
+    *            are downloaded from the archive of 'ftpDownloading' like any other site, so '@euref' is a filter
+    *            of the sites only
+    **/
+    bool NetworkSites(const ftpopt_t *fopt, const string &net, std::vector<string> &sites);
+
+    /**
+    * @brief   : StationSinex - get the IGS station SINEX with the positions of the stations
+    * @param[I]: fopt (FTP options)
+    * @param[O]: file (local file name of the station SINEX)
+    * @return  : true:ok, false:not available
+    * @note    : the SINEX of the current and the former IGS stations is taken once a week and cached in the
+    *            directory ('.good_sites_snx'), a dry run ('plan') uses the cached one only
+    **/
+    bool StationSinex(const ftpopt_t *fopt, string &file);
+
+    /**
+    * @brief   : Quarters - get the 15-minute files of an hour that overlap the time range requested
+    * @param[I]: ts (start time of the day)
+    * @param[I]: hh (hour)
+    * @param[O]: none
+    * @return  : bit mask of the 15-minute files (bit 0: 'hh:00', ..., bit 3: 'hh:45'), 0xF without time range
+    * @note    : an hourly file is needed if the mask is not zero
+    **/
+    int Quarters(gtime_t ts, int hh);
+
+    /**
+    * @brief   : QuarterPatterns - get the accept patterns of the 15-minute files of an hour in the time range requested
+    * @param[I]: ts (start time of the day)
+    * @param[I]: hh (hour)
+    * @param[I]: head (part of the pattern before the minutes, i.e., '*032o')
+    * @param[I]: tail (part of the pattern after the minutes, i.e., '.21d.*')
+    * @param[O]: none
+    * @return  : the patterns separated by ',' for the option '-A' of 'wget'
+    * @note    :
+    **/
+    string QuarterPatterns(gtime_t ts, int hh, const string &head, const string &tail);
+
+    /**
+    * @brief   : JobOpt - get the FTP options of one job (one product for one day)
+    * @param[I]: popt (processing options of the day)
+    * @param[I]: fopt (FTP options)
+    * @param[I]: get (product, GET_???)
+    * @param[O]: jopt (FTP options of the job)
+    * @return  : none
+    * @note    : the bandwidth budget, the conversion filter and the hours in the time range are set
+    **/
+    void JobOpt(const prcopt_t *popt, const ftpopt_t *fopt, int get, ftpopt_t &jopt);
+
+    /**
+    * @brief   : BwLimit - get the rate limit of one transfer under the bandwidth budget of the job
+    * @param[I]: fopt (FTP options of the job, see 'JobOpt')
+    * @param[I]: n (number of the concurrent transfers of the process)
+    * @param[O]: none
+    * @return  : the limit in KB/s (0: unlimited)
+    * @note    : the budget is split over the shards and the concurrent transfers, so the processes of one
+    *            sharded run never exceed it together; the shared bucket ('BucketUtil') paces the batches of
+    *            all the processes on top of it
+    **/
+    int BwLimit(const ftpopt_t *fopt, int n);
+
+    /**
+    * @brief   : StoreScope - get the scope of the product names of a product in the store
+    * @param[I]: fopt (FTP options of the job, see 'JobOpt')
+    * @param[I]: get (product, GET_???)
+    * @param[O]: none
+    * @return  : the scope, i.e., 'orbclk' or 'obs/gdc.cddis.eosdis.nasa.gov/1a2b3c4d'
+    * @note    : the observation files of the sources share their names, and the settings of the conversion
+    *            (decimation, system and code filters, compact or zstd form) change their content but not their
+    *            names, so they are scoped by the host and the hash of the settings
+    **/
+    string StoreScope(const ftpopt_t *fopt, int get);
+
+    /**
+    * @brief     : ShardJob - keep the part of one job (one product for one day) of the shard of this process
+    * @param[I]  : popt (processing options of the day)
+    * @param[I]  : get (product, GET_???)
+    * @param[I/O]: jopt (FTP options of the job, see 'JobOpt'; the sites of the shard are set as the in-memory site list)
+    * @return    : true:the job (or some of its sites) is downloaded by this process, false:by the other shards
+    * @note      : the sites of an observation product are spread over the shards (see 'PlanUtil::IsMine'); the
+    *              other products, and the observation products whose sites are unknown (i.e., 'all' of GA),
+    *              go to one shard per day as a whole
+    **/
+    bool ShardJob(const prcopt_t *popt, int get, ftpopt_t &jopt);
+
+    /**
+    * @brief   : MergeDir - merge the catalogs and inventories of the shards in a directory
+    * @param[I]: dir (the directory)
+    * @param[I]: recursive (whether the sub-directories are merged as well)
+    * @param[O]: merged (the directories merged so far, the ones in it are skipped)
+    * @return  : number of the shard files merged
+    * @note    : the network listings of the shards ('.good_sites_igs2021032_of4') are removed
+    **/
+    int MergeDir(const string &dir, bool recursive, std::unordered_set<string> &merged);
+
+    /**
+    * @brief   : PlanKind - get the kind of the files of a product for the size history
+    * @param[I]: fopt (FTP options)
+    * @param[I]: get (product, GET_???)
+    * @param[O]: none
+    * @return  : the kind, i.e., 'obs.daily', 'obm.highrate', 'nav.daily' or 'orbclk'
+    * @note    :
+    **/
+    string PlanKind(const ftpopt_t *fopt, int get);
+
+    /**
+    * @brief   : PlanHost - get the host from which a product is downloaded
+    * @param[I]: fopt (FTP options)
+    * @param[I]: get (product, GET_???)
+    * @param[O]: none
+    * @return  : the host name, i.e., 'gdc.cddis.eosdis.nasa.gov'
+    * @note    :
+    **/
+    string PlanHost(const ftpopt_t *fopt, int get);
+
+    /**
+    * @brief   : PlanGet - expand one job (one product for one day) into the planned requests
+    * @param[I]: popt (processing options of the day)
+    * @param[I]: fopt (FTP options of the job, see 'JobOpt')
+    * @param[I]: get (product, GET_???)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the observation files are expanded site by site and hour by hour (15 minutes for the high-rate
+    *            files) with their local names, the other products into their local names by 'PlanFiles'.
+    *            Nothing is downloaded, the sites of 'all' are taken from the cached network listing only
+    **/
+    void PlanGet(const prcopt_t *popt, const ftpopt_t *fopt, int get);
+
+    /**
+    * @brief   : PlanFiles - get the local files of a product (other than the observations) for one day
+    * @param[I]: popt (processing options of the day)
+    * @param[I]: fopt (FTP options of the job, see 'JobOpt')
+    * @param[I]: get (product, GET_???)
+    * @param[O]: paths (full paths of the files, in the directories where the downloading lands them)
+    * @return  : true:ok, false:the files depend on a site list of 'all', which is not known before downloading
+    * @note    : the names follow those the getters (i.e., 'GetOrbClk') report by 'NotifyFile'
+    **/
+    bool PlanFiles(const prcopt_t *popt, const ftpopt_t *fopt, int get, std::vector<string> &paths);
+
+    /**
+    * @brief   : NotifyFile - report one downloaded (or failed) file to the completion callback
+    * @param[I]: fopt (FTP options)
+    * @param[I]: file (file name in the current directory)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the file is regarded as landed if it exists; with 'validate' a file changed in this run is held
+    *            (with its lock) until 'ValidateFiles'
+    **/
+    void NotifyFile(const ftpopt_t *fopt, const string &file);
+
+    /**
+    * @brief   : ReportFile - put one landed file into the store, release its lock and report it to the callback
+    * @param[I]: fopt (FTP options)
+    * @param[I]: file (file name in the current directory)
+    * @param[I]: landed (name under which it is kept, "" if it failed)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void ReportFile(const ftpopt_t *fopt, const string &file, const string &landed);
+
+    /**
+    * @brief   : LockFile - get the lock file of a product
+    * @param[I]: file (local file name)
+    * @param[O]: none
+    * @return  : full path of the lock file
+    * @note    : the lock is taken in the store if it is used, otherwise in the current directory
+    **/
+    string LockFile(const string &file);
+
+    /**
+    * @brief   : LandedFile - get the name under which a product is kept in the current directory
+    * @param[I]: file (local file name)
+    * @param[O]: none
+    * @return  : 'file', or its seekable zstd version 'file.zst', "" if neither exists
+    * @note    : a 'file.zst' whose recompression failed is kept as 'file' without '.zst', which is taken as well
+    **/
+    string LandedFile(const string &file);
+
+    /**
+    * @brief   : Recompress - recompress a downloaded product to seekable zstd
+    * @param[I]: fopt (FTP options)
+    * @param[I]: file (local file name)
+    * @param[O]: none
+    * @return  : the name under which the product is kept, 'file' itself if the recompression failed
+    * @note    : the original file is removed after the recompression
+    **/
+    string Recompress(const ftpopt_t *fopt, const string &file);
+
+    /**
+    * @brief   : TakeShared - take a product from the shared cache, or claim it for downloading
+    * @param[I]: file (local file name)
+    * @param[I]: wait (true:wait for the process downloading the product, false:return at once)
+    * @param[O]: none
+    * @return  : 1:taken (no downloading), 0:to be downloaded by this process, -1:held by another process
+    * @note    : with 0 the lock of the product is held until 'NotifyFile', so the concurrent GOOD processes
+    *            never download (or extract) the same file at the same time; -1 is returned only if 'wait' is false
+    **/
+    int TakeShared(const string &file, bool wait = true);
+
+    /**
+    * @brief   : WaitShared - wait for the products being downloaded by the other GOOD processes
+    * @param[I]: fopt (FTP options)
+    * @param[I]: files (local file names, for which 'TakeShared' returned -1)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the locks of this process are released first, so that two processes never wait for each other
+    **/
+    void WaitShared(const ftpopt_t *fopt, const std::vector<string> &files);
+
+    /**
+    * @brief   : ObsName - get the local name of an observation file as it is kept on disk
+    * @param[I]: fopt (FTP options)
+    * @param[I]: oFile (RINEX observation file name, i.e., 'abmf0320.21o')
+    * @param[O]: none
+    * @return  : 'oFile' itself, the compact RINEX + gzip name (i.e., 'abmf0320.21d.gz') if 'keepCompact' is on,
+    *            or the seekable zstd name (i.e., 'abmf0320.21o.zst') if 'zstdSeek' is on
+    * @note    : 'keepCompact' takes precedence, the compact RINEX can only be decoded from its start
+    **/
+    string ObsName(const ftpopt_t *fopt, const string &oFile);
+
+    /**
+    * @brief   : UnzipObs - extract a downloaded observation archive into its compact RINEX file
+    * @param[I]: fopt (FTP options)
+    * @param[I]: zFile (archive '*.gz' or '*.Z', it may contain wildcards)
+    * @param[I]: crxFile (compact RINEX file name given to 'CrxToObs', "" for the archive name without its suffix)
+    * @param[O]: none
+    * @return  : none
+    * @note    : with 'keepCompact' a gzip archive is kept as 'crxFile.gz', so that 'CrxToObs' keeps its original
+    *            bytes instead of compressing the compact RINEX again; an archive that can not be extracted is removed
+    **/
+    void UnzipObs(const ftpopt_t *fopt, const string &zFile, const string &crxFile);
+
+    /**
+    * @brief   : CrxToObs - convert a downloaded compact RINEX file into the observation file kept on disk
+    * @param[I]: fopt (FTP options)
+    * @param[I]: crxFile (compact RINEX (Hatanaka) file, it may contain wildcards)
+    * @param[I]: oFile (observation file from 'ObsName')
+    * @param[O]: none
+    * @return  : none
+    * @note    : with 'keepCompact' the gzip archive kept by 'UnzipObs' is taken as it is (a '.Z' archive is gzipped
+    *            again), which is about 8-10 times smaller than RINEX; with 'zstdSeek' the RINEX is recompressed to
+    *            seekable zstd
+    **/
+    void CrxToObs(const ftpopt_t *fopt, const string &crxFile, const string &oFile);
+
+    /**
+    * @brief   : DecodeCmd - get the command line that writes the RINEX of an observation file to the standard output
+    * @param[I]: fopt (FTP options)
+    * @param[I]: file (RINEX, compact RINEX ('*.yyd', '*.crx'), optionally compressed by gzip ('*.gz', '*.Z') or zstd ('*.zst'))
+    * @param[O]: none
+    * @return  : the command line
+    * @note    :
+    **/
+    string DecodeCmd(const ftpopt_t *fopt, const string &file);
+
+    /**
+    * @brief   : ReadCmd - stream the standard output of a command line by line
+    * @param[I]: cmd (command line)
+    * @param[I]: onLine (callback of each line)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the command stops as soon as 'onLine' returns false
+    **/
+    bool ReadCmd(const string &cmd, const linecb_t &onLine);
+
+    /**
+    * @brief   : SpliceSite - splice the hourly or high-rate observation files of one site into one daily file
+    * @param[I]: fopt (FTP options)
+    * @param[I]: frags (observation files of the site in time order)
+    * @param[I]: outFile (daily observation file, i.e., 'abmf0320.21o', 'abmf0320.21o.zst' or 'abmf0320.21o.gz')
+    * @param[O]: none
+    * @return  : true:ok, false:error (nothing is written)
+    * @note    : the files are streamed once: the header of the first one is kept, the headers of the others and
+    *            the epochs not after the last one written are dropped
+    **/
+    bool SpliceSite(const ftpopt_t *fopt, const std::vector<string> &frags, const string &outFile);
+
+    /**
+    * @brief   : SpliceObs - splice the hourly or high-rate observation files of the day into daily files
+    * @param[I]: fopt (FTP options)
+    * @param[I]: ts (start time)
+    * @param[I]: dir (the 'hourly' or 'highrate' directory)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the sites are spliced in parallel, the daily file (i.e., 'hourly/abmf0320.21o') is written only if
+    *            it is missing or older than one of the files in 'hourly/HH/'
+    **/
+    void SpliceObs(const ftpopt_t *fopt, gtime_t ts, const string &dir);
+
+    /**
+    * @brief   : ValidateFiles - validate the files held by 'NotifyFile'
+    * @param[I]: fopt (FTP options)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the files are checked in parallel by the invariants of their formats; an invalid file is moved
+    *            into 'quarantine/' of its directory and the product is re-queued, until 'validRetry' is used up
+    **/
+    void ValidateFiles(const ftpopt_t *fopt);
+
+    /**
+    * @brief   : AddInventory - add or replace the inventory entry of an observation file
+    * @param[I]: fopt (FTP options)
+    * @param[I]: file (observation file, i.e., 'abmf0320.21o', 'abmf0320.21o.zst' or 'abmf0320.21d.gz')
+    * @param[O]: none
+    * @return  : none
+    * @note    : only the header is decoded, the inventory of the directory of the file is saved by 'FtpGet'
+    **/
+    void AddInventory(const ftpopt_t *fopt, const string &file);
+
+    /**
+    * @brief   : RemoteStat - get the size, modification time and ETag of a remote file
+    * @param[I]: fopt (FTP options)
+    * @param[I]: url (the remote directory)
+    * @param[I]: file (local file name, the remote file may have an additional '.Z' or '.gz')
+    * @param[O]: ent (catalog entry of the remote file)
+    * @return  : true:ok, false:the remote file is not found or the server is not reachable
+    * @note    : FTP(S): the directory listing of 'wget' is parsed; HTTP(S): the response headers of 'curl' are parsed
+    **/
+    bool RemoteStat(const ftpopt_t *fopt, const string &url, const string &file, catent_t &ent);
+
+    /**
+    * @brief   : FtpListing - get the entries of the listing of an FTP(S) directory
+    * @param[I]: fopt (FTP options)
+    * @param[I]: url (the remote directory)
+    * @param[O]: ents (entries of the regular files with their name, size and modification time)
+    * @return  : true:ok, false:the remote directory cannot be listed
+    * @note    : the listing of a directory is fetched once per run, 'RemoteStat' and 'RemoteList' share it
+    **/
+    bool FtpListing(const ftpopt_t *fopt, const string &url, std::vector<catent_t> &ents);
+
+    /**
+    * @brief   : RemoteList - get the file names in a remote directory
+    * @param[I]: fopt (FTP options)
+    * @param[I]: url (the remote directory)
+    * @param[O]: names (file names)
+    * @return  : true:ok, false:the remote directory cannot be listed
+    * @note    : FTP(S): the directory listing of 'wget' is parsed; HTTP(S): the links of the directory index
+    **/
+    bool RemoteList(const ftpopt_t *fopt, const string &url, std::vector<string> &names);
+
+    /**
+    * @brief   : IsUpToDate - whether the local file exists and is the same version as the remote one
+    * @param[I]: fopt (FTP options)
+    * @param[I]: url (the remote directory)
+    * @param[I]: file (local file name in the current directory)
+    * @param[O]: ent (catalog entry of the remote file to be recorded by 'UpdateCatalog', empty name if not needed)
+    * @return  : true:up to date (no downloading), false:need downloading
+    * @note    : the remote file is checked only if 'refresh' is on, otherwise it is the same as the existence check.
+    *            A changed local file is moved to '*.stale' and restored by 'UpdateCatalog' if the downloading fails
+    **/
+    bool IsUpToDate(const ftpopt_t *fopt, const string &url, const string &file, catent_t &ent);
+
+    /**
+    * @brief   : UpdateCatalog - record the downloaded file in the freshness catalog
+    * @param[I]: file (local file name in the current directory)
+    * @param[I]: ent (catalog entry from 'IsUpToDate')
+    * @param[O]: none
+    * @return  : none
+    * @note    : if the downloading failed, the previous version ('*.stale') is restored
+    **/
+    void UpdateCatalog(const string &file, const catent_t &ent);
+
+    /**
+    * @brief   : SetMissClass - set the product epoch and latency class for the negative cache
+    * @param[I]: ts (start time of the product day)
+    * @param[I]: cls (latency class, MISS_???; -1: the negative cache is not used)
+    * @param[O]: none
+    * @return  : none
+    * @note    : it is called at the beginning of each product downloading
+    **/
+    void SetMissClass(gtime_t ts, int cls);
+
+    /**
+    * @brief   : LoadMissing - load the negative cache of the current directory if it is not loaded yet
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : none
+    * @note    : the negative cache of the previous directory is saved first
+    **/
+    void LoadMissing();
+
+    /**
+    * @brief   : IsKnownMissing - whether the file is known to be not yet available on the archive
+    * @param[I]: fopt (FTP options)
+    * @param[I]: file (local file name in the current directory)
+    * @param[O]: none
+    * @return  : true:skip the downloading, false:go on downloading
+    * @note    : the file is skipped until the expiry time in the negative cache
+    **/
+    bool IsKnownMissing(const ftpopt_t *fopt, const string &file);
+
+    /**
+    * @brief   : UpdateMissing - update the negative cache according to the result of downloading
+    * @param[I]: file (local file name in the current directory)
+    * @param[I]: ok (true:the file is available, false:the file is missing)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the expiry time is the later one of the normal publishing time of the product and now plus
+    *            the retry interval, which is doubled after each failed request (up to MAXRETRY hours). The cache
+    *            is saved by 'FtpGet' once the product is done
+    **/
+    void UpdateMissing(const string &file, bool ok);
+
+    /**
+    * @brief   : FetchBatch - download many files under the same remote directory in one batch
+    * @param[I]: fopt (FTP options)
+    * @param[I]: url (the remote directory)
+    * @param[I]: cutDirs (the option '--cut-dirs=N ' of 'wget')
+    * @param[I]: patterns (accept patterns of the files, i.e., 'ABMF*_R_20210320000_01D_30S_MO.crx.*')
+    * @param[O]: none
+    * @return  : none
+    * @note    : the batch runs with the concurrency learned for the host, then its aggregate throughput and
+    *            errors are reported back to adjust the concurrency for the next batch (see 'RateUtil::Report')
+    **/
+    void FetchBatch(const ftpopt_t *fopt, const string &url, const string &cutDirs,
+        const std::vector<string> &patterns);
+
+    /**
+    * @brief   : BatchBytes - get the total size of the local files matching the accept patterns
+    * @param[I]: patterns (accept patterns of the files)
+    * @param[O]: files (number of the files)
+    * @return  : the total size in bytes
+    * @note    :
+    **/
+    long long BatchBytes(const std::vector<string> &patterns, int &files);
+
+    /**
+    * @brief   : WgetBatch - download many files under the same remote directory by concurrent FTP sessions
+    * @param[I]: fopt (FTP options)
+    * @param[I]: url (the remote directory)
+    * @param[I]: cutDirs (the option '--cut-dirs=N ' of 'wget')
+    * @param[I]: patterns (accept patterns of the files)
+    * @param[I]: conc (number of concurrent sessions)
+    * @param[O]: used (number of sessions used)
+    * @param[O]: err (true if a session met network failures or error replies of the server)
+    * @return  : none
+    * @note    : the patterns are dealt to the sessions and joined into one accept list per session, so that one
+    *            login and one directory listing serve many files (MGET-style); the list is split every MAXBATCH
+    *            patterns to keep the command line short. With more than one session, each session works in its
+    *            own part directory so that the '.listing' files of 'wget' do not clash
+    **/
+    void WgetBatch(const ftpopt_t *fopt, const string &url, const string &cutDirs,
+        const std::vector<string> &patterns, int conc, int &used, bool &err);
+
+    /**
+    * @brief   : HttpBatch - download many files under the same remote directory over HTTP/2
+    * @param[I]: fopt (FTP options)
+    * @param[I]: url (the remote directory)
+    * @param[I]: patterns (accept patterns of the files)
+    * @param[I]: conc (number of concurrent streams)
+    * @param[O]: used (number of streams used)
+    * @param[O]: err (true if 'curl' failed on a listed file, i.e., refused, throttled, or timed out)
+    * @return  : true:ok, false:the directory index is not available ('wget' is used instead)
+    * @note    : the directory index is matched against the patterns, then all the matched files are requested
+    *            by one 'curl --parallel' command, which multiplexes them over one TLS connection per host
+    **/
+    bool HttpBatch(const ftpopt_t *fopt, const string &url, const std::vector<string> &patterns,
+        int conc, int &used, bool &err);
+
+    /**
+    * @brief   : HttpMatch - get the files in an HTTP(S) directory index that match the accept patterns
+    * @param[I]: fopt (FTP options)
+    * @param[I]: url (the remote directory)
+    * @param[I]: patterns (accept patterns of the files)
+    * @param[O]: files (matched file names in the order of the index)
+    * @return  : true:ok, false:the directory index is not available
+    * @note    : patterns without wildcards are taken as the file names, so that the index is not needed
+    **/
+    bool HttpMatch(const ftpopt_t *fopt, const string &url, const std::vector<string> &patterns,
+        std::vector<string> &files);
+
+    /**
+    * @brief   : CurlCmd - get the head of a 'curl' command under the options of the job
+    * @param[I]: fopt (FTP options)
+    * @param[I]: n (number of the concurrent transfers, which share the bandwidth budget)
+    * @param[O]: none
+    * @return  : the command without the URLs
+    * @note    : HTTP/2 is asked for, the login is read from '.netrc' if any
+    **/
+    string CurlCmd(const ftpopt_t *fopt, int n);
+
+    /**
+    * @brief   : FetchCmd - get the command that downloads the matched files of a remote directory, or one remote file
+    * @param[I]: fopt (FTP options)
+    * @param[I]: url (the remote directory, or the remote file if 'accept' is empty)
+    * @param[I]: cutDirs (the option '--cut-dirs=N ' of 'wget')
+    * @param[I]: accept (accept patterns of the files separated by ',', "" for the remote file 'url')
+    * @param[O]: none
+    * @return  : the command for 'std::system' ("" if no file in the directory index matches), the files are
+    *            downloaded into the current directory
+    * @note    : FTP(S): 'wget', which matches the accept patterns itself; HTTP(S): 'curl' over HTTP/2, the files
+    *            matched in the directory index are requested by one command ('wget' if there is no index)
+    **/
+    string FetchCmd(const ftpopt_t *fopt, const string &url, const string &cutDirs, const string &accept);
+
     /**
     * @brief   : GetDailyObsIgs - download IGS RINEX daily observation (30s) files (short name "d") according to 'site.list' file
     * @param[I]: ts (start time)
@@ -306,19 +879,139 @@ private:
 public:
     FtpUtil()
 	{
-
+		_nFailed = 0;
 	}
 	~FtpUtil()
 	{
-
+		if (!_cookieFile.empty()) remove(_cookieFile.c_str());
 	}
 
+    /**
+    * @brief     : FtpInit - the settings of FTP archive and third-party softwares before downloading
+    * @param[I/O]: fopt (FTP options)
+    * @return    : none
+    * @note      : it is called once before 'FtpGet'
+    **/
+    void FtpInit(ftpopt_t *fopt);
+
+    /**
+    * @brief   : FtpGet - download one kind of product for one day
+    * @param[I]: popt (processing options of the day)
+    * @param[I]: fopt (FTP options)
+    * @param[I]: get (product, GET_???)
+    * @param[O]: none
+    * @return  : none
+    * @note    : 'FtpInit' must be called first
+    **/
+    void FtpGet(const prcopt_t *popt, const ftpopt_t *fopt, int get);
+
     /**
     * @brief     : FtpDownload - GNSS data downloading via FTP
     * @param[I]  : popt (processing options)
     * @param[I/O]: fopt (FTP options)
     * @return    : none
-    * @note      :
+    * @note      : the products of the day are downloaded in the order of GET_???
     **/
     void FtpDownload(const prcopt_t *popt, ftpopt_t *fopt);
+
+    /**
+    * @brief     : FtpPlan - print and cost the download plan of the days without downloading
+    * @param[I]  : days (processing options of each day)
+    * @param[I/O]: fopt (FTP options)
+    * @return    : none
+    * @note      : the plan counts the jobs, the files requested and the ones already present, estimates the
+    *              bytes by the size history ('.good_sizes' in the home directory) and projects the runtime by
+    *              the learned concurrency and throughput of the hosts
+    **/
+    void FtpPlan(const std::vector<prcopt_t> &days, ftpopt_t *fopt);
+
+    /**
+    * @brief   : FtpMerge - merge the catalogs and inventories of the shards into the ones of the directories
+    * @param[I]: days (processing options of each day)
+    * @param[I]: fopt (FTP options)
+    * @param[O]: none
+    * @return  : none
+    * @note    : it is run once after all the shards ('shard' = 1 i/K) have finished, with the same configure
+    *            file; the day directories are searched with their sub-directories (i.e., 'daily' and the hours)
+    **/
+    void FtpMerge(const std::vector<prcopt_t> &days, const ftpopt_t *fopt);
+
+    /**
+    * @brief   : IsRequeued - whether the last product is to be downloaded again
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:files of the product were quarantined by the validation, false:done
+    * @note    :
+    **/
+    bool IsRequeued();
+
+    /**
+    * @brief   : FailedFiles - get the number of files that failed to be downloaded
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : the files reported as failed (after the retries of the validation) by this downloader
+    * @note    : the files known missing by the negative cache are counted as failed too
+    **/
+    int FailedFiles();
+
+    /**
+    * @brief   : ReadObs - stream the RINEX of an observation file line by line, which is decoded on demand
+    * @param[I]: fopt (FTP options, after 'FtpInit')
+    * @param[I]: file (observation file, i.e., 'abmf0320.21d.gz' kept by 'keepCompact', 'abmf0320.21o.zst' kept by
+    *                  'zstdSeek', or 'abmf0320.21o')
+    * @param[I]: onLine (callback of each line)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : nothing is written to disk, the decoding stops as soon as 'onLine' returns false
+    **/
+    bool ReadObs(const ftpopt_t *fopt, const string &file, const linecb_t &onLine);
+
+    /**
+    * @brief   : ReadObs - stream the header and the epochs in a time window of an observation file line by line
+    * @param[I]: fopt (FTP options, after 'FtpInit')
+    * @param[I]: file (observation file, i.e., 'abmf0320.21o.zst' kept by 'zstdSeek', or 'abmf0320.21o')
+    * @param[I]: ts, te (time window [ts, te) in the time system of the file)
+    * @param[I]: onLine (callback of each line)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the epoch index ('abmf0320.21o.idx') gives the range of the window, so only the range is read
+    *            (seekable zstd: only its frames are decoded); a missing or stale index is built first
+    **/
+    bool ReadObs(const ftpopt_t *fopt, const string &file, gtime_t ts, gtime_t te, const linecb_t &onLine);
+
+    /**
+    * @brief   : FindArc - find the FTP archive by its name
+    * @param[I]: name (FTP archive name, i.e., CDDIS, IGN, or WHU, case-insensitive)
+    * @param[O]: none
+    * @return  : FTP archive (ARC_???), -1 if not found
+    * @note    :
+    **/
+    int FindArc(const char *name);
+
+    /**
+    * @brief   : FindAc - find the analysis center of precise products by its name
+    * @param[I]: name (three-char name of analysis center, case-insensitive)
+    * @param[O]: none
+    * @return  : analysis center (AC_???), -1 if not found
+    * @note    :
+    **/
+    int FindAc(const char *name);
+
+    /**
+    * @brief   : IsMgexAc - whether the analysis center provides MGEX products
+    * @param[I]: ac (analysis center, AC_???)
+    * @param[O]: none
+    * @return  : true:MGEX products, false:IGS products
+    * @note    :
+    **/
+    bool IsMgexAc(int ac);
+
+    /**
+    * @brief   : UltraStep - get the step of the ultra-rapid products of the analysis center
+    * @param[I]: ac (analysis center, AC_???)
+    * @param[O]: none
+    * @return  : step in hours (6 for igu, 3 for gfu, 1 for wuu), 24 for final/rapid products
+    * @note    :
+    **/
+    int UltraStep(int ac);
 };
\ No newline at end of file
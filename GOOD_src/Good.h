@@ -11,7 +11,20 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <vector>
+#include <unordered_map>
+#include <functional>
+#include <bitset>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
+#include <algorithm>
+#include <queue>
+#include <ctime>
+#include <chrono>
+#include <thread>
+#include <sys/stat.h>
 #ifdef _WIN32  /* for Windows */
 #include <string>
 #include <winsock2.h>
@@ -22,6 +35,8 @@
 #include <string.h>
 #include <math.h>
 #include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
 #include <pthread.h>
 #endif
 
@@ -42,85 +57,280 @@ using namespace std;
 #endif
 
 /* type definitions ----------------------------------------------------------*/
+typedef std::function<void(const char *file, bool ok)> goodcb_t;  /* completion callback of one file (full path; true:landed, false:failed) */
+typedef std::function<bool(const char *line)> linecb_t;           /* reader callback of one decoded line (without line end; false:stop reading) */
+
 struct gtime_t
 {                                 /* time struct */
     int mjd;                      /* modified Julian date (MJD) */
     double sod;                   /* seconds of the day */
 };
 
+struct catent_t
+{                                 /* freshness catalog entry of one downloaded file */
+    string name;                  /* local file name (after extraction) */
+    string remote;                /* remote file name (i.e., with '.Z' or '.gz') */
+    long long size;               /* remote file size in bytes (-1: unknown) */
+    string mtime;                 /* remote modification time of HTTP(S), the date of an FTP listing ('-': unknown) */
+    string etag;                  /* remote ETag for HTTP(S) ('-': unknown) */
+};
+
+struct missent_t
+{                                 /* negative cache entry of one file that is not available on the archive */
+    string name;                  /* local file name */
+    gtime_t expire;               /* the file is not requested again before this time (UTC) */
+    int count;                    /* number of failed requests */
+};
+
+struct hostrate_t
+{                                 /* learned download concurrency of one host */
+    string host;                  /* host name of the archive */
+    int conc;                     /* number of concurrent sessions (FTP) or streams (HTTP/2) */
+    double rate;                  /* aggregate throughput (bytes/s) measured at the last adjustment, 0: unknown */
+};
+
+struct zstframe_t
+{                                 /* one independent frame of a seekable zstd file */
+    long long cOff;               /* offset of the compressed frame in the file */
+    long long cSize;              /* compressed size in bytes */
+    long long dOff;               /* offset of the decompressed data of the frame */
+    long long dSize;              /* decompressed size in bytes */
+};
+
+struct epochidx_t
+{                                 /* one epoch of the epoch index of a RINEX observation file */
+    gtime_t time;                 /* epoch time (time system of the file) */
+    long long off;                /* offset of the epoch record in the RINEX */
+    int nsat;                     /* number of satellites of the epoch */
+    int flag;                     /* epoch flag (0: ok, 1: power failure, 6: cycle slip records) */
+};
+
+struct invent_t
+{                                 /* inventory entry of one observation file, taken from its header */
+    string name;                  /* local file name */
+    string site;                  /* site name (the first 4 characters of the file name in lower case) */
+    string marker;                /* MARKER NAME */
+    string number;                /* MARKER NUMBER */
+    string receiver;              /* receiver type of 'REC # / TYPE / VERS' */
+    string firmware;              /* receiver firmware version of 'REC # / TYPE / VERS' */
+    string antenna;               /* antenna type and radome of 'ANT # / TYPE' */
+    double pos[3];                /* APPROX POSITION XYZ (m, 0: unknown) */
+    double height;                /* antenna height of 'ANTENNA: DELTA H/E/N' (m) */
+    double version;               /* RINEX version */
+    double interval;              /* INTERVAL (s, 0: not in the header) */
+    string first;                 /* TIME OF FIRST OBS, i.e., '2021-02-01 00:00:00' */
+    string systems;               /* GNSS systems, i.e., 'GRE' (RINEX 2: the system of the file, 'M' for mixed) */
+    string types;                 /* observation types, i.e., 'G:C1C L1C C2W L2W;R:C1C L1C' (RINEX 2: 'C1 L1 L2 P2') */
+};
+
+struct sitesel_t
+{                                 /* one selector of the site list */
+    bool exclude;                 /* whether the sites selected are removed (a line starting with '-') */
+    int type;                     /* type of the selector (SEL_??? in SiteUtil.cpp) */
+    string text;                  /* site name, wildcard pattern (lower case) or network (i.e., 'igs') */
+    double box[4];                /* latitude range and longitude range (deg) of a bounding box */
+};
+
+struct sizehist_t
+{                                 /* size history of one kind of product files */
+    string kind;                  /* kind of the files, i.e., 'obs.daily' */
+    long long files;              /* number of the files downloaded */
+    long long bytes;              /* total remote bytes of the files */
+};
+
+struct plansum_t
+{                                 /* planned requests of one kind of product files from one host */
+    string kind;                  /* kind of the files, i.e., 'obs.daily' */
+    string host;                  /* host name of the archive */
+    long long jobs;               /* jobs (one product for one day, of the observation one site for one day) */
+    long long files;              /* files requested by the jobs */
+    long long present;            /* files already present locally, which are not downloaded */
+    long long bytes;              /* estimated bytes of the files to be downloaded */
+    long long guessed;            /* files to be downloaded whose size is the nominal one (no history) */
+    int unlisted;                 /* days whose sites are unknown ('all' without a cached network listing) */
+};
+
+struct landed_t
+{                                 /* one landed file that is not validated yet */
+    string dir;                   /* directory of the file */
+    string file;                  /* local file name */
+    string landed;                /* name under which it is kept, i.e., 'file' or 'file.zst' */
+};
+
+enum
+{                                 /* FTP archives */
+    ARC_CDDIS = 0,                /* CDDIS */
+    ARC_IGN,                      /* IGN */
+    ARC_WHU,                      /* WHU */
+    NARC                          /* number of FTP archives */
+};
+
+enum
+{                                 /* protocols of the FTP archives */
+    PROTO_FTP = 0,                /* FTP or FTPS ('wget') */
+    PROTO_HTTPS                   /* HTTPS with HTTP/2 multiplexing ('curl') */
+};
+
+enum
+{                                 /* analysis centers of precise products */
+    AC_IGS = 0,                   /* IGS final */
+    AC_IGR,                       /* IGS rapid */
+    AC_IGU,                       /* IGS ultra-rapid */
+    AC_COD,                       /* CODE */
+    AC_ESA,                       /* ESA */
+    AC_GFZ,                       /* GFZ */
+    AC_GFU,                       /* GFZ ultra-rapid */
+    AC_GRG,                       /* CNES/CLS */
+    AC_JPL,                       /* JPL */
+    AC_COM,                       /* CODE MGEX */
+    AC_GBM,                       /* GFZ MGEX */
+    AC_GRM,                       /* CNES/CLS MGEX */
+    AC_WUM,                       /* WHU MGEX */
+    AC_WUU,                       /* WHU MGEX ultra-rapid */
+    NAC                           /* number of analysis centers */
+};
+
+enum
+{                                 /* types of observation files */
+    OBS_DAILY = 0,                /* daily (30s) */
+    OBS_HOURLY,                   /* hourly (30s) */
+    OBS_HIGHRATE,                 /* high-rate (1s) */
+    OBS_30S,                      /* daily 30s (Hong Kong CORS) */
+    OBS_5S,                       /* 5s (Hong Kong CORS) */
+    OBS_1S                        /* 1s (Hong Kong CORS) */
+};
+
+enum
+{                                 /* types of broadcast ephemeris files */
+    NAV_DAILY = 0,                /* daily */
+    NAV_HOURLY,                   /* hourly (site-specific) */
+    NAV_RTNAV                     /* real-time */
+};
+
+enum
+{                                 /* products to be downloaded, index of ftpopt_t::get */
+    GET_OBS = 0,                  /* IGS observation (RINEX version 2.xx, short name 'd') */
+    GET_OBM,                      /* MGEX observation (RINEX version 3.xx, long name 'crx') */
+    GET_OBC,                      /* Curtin University of Technology (CUT) observation (RINEX version 3.xx, long name 'crx') */
+    GET_OBG,                      /* Geoscience Australia (GA) observation (RINEX version 3.xx, long name 'crx') */
+    GET_OBH,                      /* Hong Kong CORS observation (RINEX version 3.xx, long name 'crx') */
+    GET_NAV,                      /* broadcast ephemeris */
+    GET_ORBCLK,                   /* precise orbit and clock */
+    GET_EOP,                      /* earth rotation parameter */
+    GET_SNX,                      /* IGS weekly SINEX */
+    GET_DCB,                      /* CODE and/or MGEX differential code bias (DCB) */
+    GET_ION,                      /* global ionosphere map (GIM) */
+    GET_ROTI,                     /* rate of TEC index (ROTI) */
+    GET_TRP,                      /* CODE and/or IGS tropospheric product */
+    GET_RTORBCLK,                 /* real-time precise orbit and clock products from CNES offline files */
+    GET_RTBIAS,                   /* real-time code and phase bias products from CNES offline files */
+    GET_ATX,                      /* ANTEX format antenna phase center correction */
+    NGET                          /* number of products */
+};
+
+/* all the strings in ftpopt_t and prcopt_t are interned by StringUtil::Intern, so that the
+   options are cheap to copy and the strings stay valid for the lifetime of the program */
 struct ftpopt_t
 {                                 /* the type of GNSS data downloading */
     bool ftpDownloading;          /* the master switch for data downloading, 0:off  1:on, only for data downloading */
-    char ftpFrom[MAXCHARS];       /* FTP archive: CDDIS, IGN, or WHU */
-    bool getObs;                  /* (0:off  1:on) IGS observation (RINEX version 2.xx, short name 'd') */
-    char obsTyp[MAXCHARS];        /* 'daily', 'hourly', or 'highrate' */
-    char obsOpt[MAXCHARS];        /* all; the full path of 'site.list' */
+    const char *ftpFrom;          /* FTP archive: CDDIS, IGN, or WHU */
+    int ftpArc;                   /* FTP archive (ARC_???) resolved from 'ftpFrom' */
+    int ftpProto;                 /* protocol of the FTP archive (PROTO_???) */
+    const char *ftpRoot;          /* (optional) root URL replacing the host of the HTTPS archive, i.e., a mirror or a local stand-in */
+    std::bitset<NGET> get;        /* (0:off  1:on) switches of the products to be downloaded (GET_???) */
+    int obsTyp;                   /* OBS_DAILY, OBS_HOURLY, or OBS_HIGHRATE */
+    const char *obsOpt;           /* all; the full path of 'site.list' */
     std::vector<int> hhObs;       /* hours array (0: 00:00, 1: 1:00, 2: 2:00, 3: 3:00, ...) */
-    bool getObm;                  /* (0:off  1:on) MGEX observation (RINEX version 3.xx, long name 'crx') */
-    char obmTyp[MAXCHARS];        /* 'daily', 'hourly', or 'highrate' */
-    char obmOpt[MAXCHARS];        /* all; the full path of 'site.list' */
+    int obmTyp;                   /* OBS_DAILY, OBS_HOURLY, or OBS_HIGHRATE */
+    const char *obmOpt;           /* all; the full path of 'site.list' */
     std::vector<int> hhObm;       /* hours array (0: 00:00, 1: 1:00, 2: 2:00, 3: 3:00, ...) */
-    bool getObc;                  /* (0:off  1:on) Curtin University of Technology (CUT) observation (RINEX version 3.xx, long name 'crx') */
-    char obcTyp[MAXCHARS];        /* 'daily' */
-    char obcOpt[MAXCHARS];        /* all; the full path of 'site.list' */
-    bool getObg;                  /* (0:off  1:on) Geoscience Australia (GA) observation (RINEX version 3.xx, long name 'crx') */
-    char obgTyp[MAXCHARS];        /* 'daily', 'hourly', or 'highrate' */
-    char obgOpt[MAXCHARS];        /* all; the full path of 'site.list' */
+    int obcTyp;                   /* OBS_DAILY */
+    const char *obcOpt;           /* all; the full path of 'site.list' */
+    int obgTyp;                   /* OBS_DAILY, OBS_HOURLY, or OBS_HIGHRATE */
+    const char *obgOpt;           /* all; the full path of 'site.list' */
     std::vector<int> hhObg;       /* hours array (0: 00:00, 1: 1:00, 2: 2:00, 3: 3:00, ...) */
-    bool getObh;                  /* (0:off  1:on) Hong Kong CORS observation (RINEX version 3.xx, long name 'crx') */
-    char obhTyp[MAXCHARS];        /* 'daily' */
-    char obhOpt[MAXCHARS];        /* all; the full path of 'site.list' */
+    int obhTyp;                   /* OBS_30S, OBS_5S, or OBS_1S */
+    const char *obhOpt;           /* all; the full path of 'site.list' */
     std::vector<int> hhObh;       /* hours array (0: 00:00, 1: 1:00, 2: 2:00, 3: 3:00, ...) */
-    bool getNav;                  /* (0:off  1:on) broadcast ephemeris */
-    char navTyp[MAXCHARS];        /* 'daily' or 'hourly' */
-    char navOpt[MAXCHARS];        /* 'gps', 'glo', 'bds', 'gal', 'qzs', 'irn', 'mixed' or 'all' */
+    int navTyp;                   /* NAV_DAILY, NAV_HOURLY, or NAV_RTNAV */
+    const char *navOpt;           /* 'gps', 'glo', 'bds', 'gal', 'qzs', 'irn', 'mixed' or 'all' */
     std::vector<int> hhNav;       /* hours array (0: 00:00, 1: 1:00, 2: 2:00, 3: 3:00, ...) */
-    bool getOrbClk;               /* (0:off  1:on) precise orbit and clock */
-    char orbClkOpt[MAXCHARS];     /* analysis center (i.e., final: igs, cod, esa, gfz, grg, jpl, com, gbm, grm, wum, ...; rapid: igr; ultra-rapid: igu, gfu, wuu) */
+    int orbClkAc;                 /* analysis center (AC_???) resolved from 'orbClkOpt' */
+    const char *orbClkOpt;        /* analysis center (i.e., final: igs, cod, esa, gfz, grg, jpl, com, gbm, grm, wum, ...; rapid: igr; ultra-rapid: igu, gfu, wuu) */
     std::vector<int> hhOrbClk;    /* hours array (0: 00:00, 6: 6:00, 12: 12:00, 18: 18:00 for igu; 0: 00:00, 3: 3:00, 6: 6:00, ... for gfu; 0: 00:00, 1: 1:00, 2: 2:00, ... for wuu) */
-    bool getEop;                  /* (0:off  1:on) earth rotation parameter */
-    char eopOpt[MAXCHARS];        /* analysis center (i.e., final: igs, cod, esa, gfz, grg, jpl, ...; ultra: igu, gfu) */
+    int eopAc;                    /* analysis center (AC_???) resolved from 'eopOpt' */
+    const char *eopOpt;           /* analysis center (i.e., final: igs, cod, esa, gfz, grg, jpl, ...; ultra: igu, gfu) */
     std::vector<int> hhEop;       /* hours array (0: 00:00, 6: 6:00, 12: 12:00, 18: 18:00 for igu; 0: 00:00, 3: 3:00, 6: 6:00, ... for gfu) */
-    bool getSnx;                  /* (0:off  1:on) IGS weekly SINEX */
-    bool getDcb;                  /* (0:off  1:on) CODE and/or MGEX differential code bias (DCB) */
-    bool getIon;                  /* (0:off  1:on) global ionosphere map (GIM) */
-    char ionOpt[10];              /* analysis center (i.e., igs, cod, cas, ...) */
-    bool getRoti;                 /* (0:off  1:on) rate of TEC index (ROTI) */
-    bool getTrp;                  /* (0:off  1:on) CODE and/or IGS tropospheric product */
-    char trpOpt[10];              /* analysis center (i.e., igs, cod, ...). If 'igs' is set, it will choose the 3rd of 'getObs' for site-specific tropospheric product */
-    bool getRtOrbClk;             /* (0:off  1:on) real-time precise orbit and clock products from CNES offline files */
-    bool getRtBias;               /* (0:off  1:on) real-time code and phase bias products from CNES offline files */
-    bool getAtx;                  /* (0:off  1:on) ANTEX format antenna phase center correction */
-    char dir3party[MAXSTRPATH];   /* (optional) the directory where third-party softwares (i.e., 'wget', 'gzip', 'crx2rnx' etc) are stored. This option is not needed if you have set the path or environment variable for them */
+    const char *ionOpt;           /* analysis center (i.e., igs, cod, cas, ...) */
+    int trpAc;                    /* analysis center (AC_IGS or AC_COD) resolved from 'trpOpt' */
+    const char *trpOpt;           /* analysis center (i.e., igs, cod, ...). If 'igs' is set, it will choose the 3rd of 'getObs' for site-specific tropospheric product */
+    const char *dir3party;        /* (optional) the directory where third-party softwares (i.e., 'wget', 'gzip', 'crx2rnx' etc) are stored. This option is not needed if you have set the path or environment variable for them */
     bool isPath3party;            /* if true: the path need be set for third-party softwares */
-    char wgetFull[MAXCHARS];      /* if isPath3party == true, set the full path where 'wget' is */
-    char gzipFull[MAXCHARS];      /* if isPath3party == true, set the full path where 'gzip' is */
-    char crx2rnxFull[MAXCHARS];   /* if isPath3party == true, set the full path where 'crx2rnx' is */
+    const char *wgetFull;         /* if isPath3party == true, set the full path where 'wget' is */
+    const char *curlFull;         /* if isPath3party == true, set the full path where 'curl' is */
+    const char *gzipFull;         /* if isPath3party == true, set the full path where 'gzip' is */
+    const char *crx2rnxFull;      /* if isPath3party == true, set the full path where 'crx2rnx' is */
+    const char *zstdFull;         /* if isPath3party == true, set the full path where 'zstd' is */
     bool minusAdd1day;            /* (0:off  1:on) the day before and after the current day for precise satellite orbit and clock products downloading */
     bool printInfoWget;           /* (0:off  1 : on) print the information generated by 'wget' */
-    char qr[MAXCHARS];            /* "-qr" (printInfoWget == false) or "r" (printInfoWget == true) in 'wget' command line */
+    bool refresh;                 /* (0:off  1:on) re-download the mutable products (i.e., ultra-rapid, real-time broadcast ephemeris, ANTEX) changed upstream */
+    bool negCache;                /* (0:off  1:on) skip the files that are known to be not yet available on the archive */
+    bool keepCompact;             /* (0:off  1:on) keep the observation files in compact RINEX + gzip ('*.yyd.gz') instead of RINEX '*.yyo' */
+    bool zstdSeek;                /* (0:off  1:on) keep the orbit/clock, GIM and RINEX observation files as seekable zstd ('*.zst') */
+    int zstdFrame;                /* maximum decompressed size (KB) of one zstd frame */
+    int zstdLevel;                /* compression level of zstd (1-19) */
+    bool epochIndex;              /* (0:off  1:on) write the epoch index ('*.yyo.idx') next to each RINEX observation file */
+    bool spliceObs;               /* (0:off  1:on) splice the hourly and high-rate observation files into one daily file per site */
+    int spliceThreads;            /* number of sites spliced in parallel (0: number of CPU cores) */
+    int decimate;                 /* decimation interval (s) of the observations at conversion (0: off) */
+    const char *decSys;           /* GNSS systems kept at conversion, i.e., "GE" ("": all) */
+    const char *fltSys[NGET];     /* GNSS systems kept at conversion of each observation product, they replace 'decSys' ("": not set) */
+    const char *fltCodes[NGET];   /* observation codes kept at conversion of each observation product, i.e., "C1C,L1C,C2W,L2W" ("": all) */
+    const char *decCodes;         /* observation codes kept at conversion of the current job, set by 'FtpUtil::FtpGet' */
+    bool validate;                /* (0:off  1:on) validate the downloaded files, the invalid ones are quarantined and downloaded again */
+    int validRetry;               /* maximum times a file is downloaded again after it is quarantined */
+    int validThreads;             /* number of files validated in parallel (0: number of CPU cores) */
+    bool inventory;               /* (0:off  1:on) keep an inventory of the observation files ('inventory.csv'), taken from their headers */
+    bool plan;                    /* (0:off  1:on) dry run, the download plan is expanded and costed but nothing is downloaded */
+    int shardIdx;                 /* this process downloads the shard 'shardIdx' (1 to 'shardCnt') of the jobs */
+    int shardCnt;                 /* number of shards the jobs are partitioned into (1: no sharding) */
+    bool merge;                   /* (0:off  1:on) merge the catalogs and inventories of the shards, nothing is downloaded */
+    bool prioSched;               /* (0:off  1:on) download the products of all the days by priority classes instead of day by day */
+    int prio[NGET];               /* priority class of the products (0: highest) */
+    int deadline[NGET];           /* deadline hint of the products (minutes after the start of downloading, 0: none) */
+    int bwInter;                  /* bandwidth budget (KB/s, 0: unlimited) of the interactive/real-time jobs */
+    int bwBack;                   /* bandwidth budget (KB/s, 0: unlimited) of the backfill jobs */
+    int bwAge;                    /* a job is backfill if its day is more than 'bwAge' days before now */
+    int bwRate;                   /* bandwidth budget (KB/s, 0: unlimited) of the current job, set by 'FtpUtil::FtpGet' */
+    bool bwIsBack;                /* whether the current job is backfill, its budget is shared with the backfill jobs of all the processes */
+    const char *qr;               /* "-qr" (printInfoWget == false) or "r" (printInfoWget == true) in 'wget' command line */
+    std::vector<string> sites;    /* in-memory site list, it takes precedence over 'all' or 'site.list' of observation downloading if not empty */
+    goodcb_t onFile;              /* (optional) callback invoked each time a file is downloaded or failed */
 };
 
 struct prcopt_t
 {                                 /* processing options type */
     /* processing directory */
-    char obsDir[MAXSTRPATH];      /* the directory of IGS RINEX format observation files (short name "d" files) */
-    char obmDir[MAXSTRPATH];      /* the directory of MGEX RINEX format observation files (long name "crx" files) */
-    char obcDir[MAXSTRPATH];      /* the directory of Curtin University of Technology (CUT) RINEX format observation files (long name "crx" files) */
-    char obgDir[MAXSTRPATH];      /* the directory of Geoscience Australia (GA) RINEX format observation files (long name "crx" files) */
-    char obhDir[MAXSTRPATH];      /* the directory of Hong Kong CORS RINEX format observation files (long name "crx" files) */
-    char navDir[MAXSTRPATH];      /* the directory of RINEX format broadcast ephemeris files */
-    char sp3Dir[MAXSTRPATH];      /* the directory of SP3 format precise ephemeris files */
-    char clkDir[MAXSTRPATH];      /* the directory of RINEX format precise clock files */
-    char eopDir[MAXSTRPATH];      /* the directory of earth rotation parameter files */
-    char snxDir[MAXSTRPATH];      /* the directory of SINEX format IGS weekly solution files */
-    char dcbDir[MAXSTRPATH];      /* the directory of CODE and/or MGEX differential code bias (DCB) files */
-    char biaDir[MAXSTRPATH];      /* the directory of CNES real-time phase bias files */
-    char ionDir[MAXSTRPATH];      /* the directory of CODE and/or IGS global ionosphere map (GIM) files */
-    char ztdDir[MAXSTRPATH];      /* the directory of CODE and/or IGS tropospheric product files */
-    char tblDir[MAXSTRPATH];      /* the directory of table files for processing */
+    const char *obsDir;           /* the directory of IGS RINEX format observation files (short name "d" files) */
+    const char *obmDir;           /* the directory of MGEX RINEX format observation files (long name "crx" files) */
+    const char *obcDir;           /* the directory of Curtin University of Technology (CUT) RINEX format observation files (long name "crx" files) */
+    const char *obgDir;           /* the directory of Geoscience Australia (GA) RINEX format observation files (long name "crx" files) */
+    const char *obhDir;           /* the directory of Hong Kong CORS RINEX format observation files (long name "crx" files) */
+    const char *navDir;           /* the directory of RINEX format broadcast ephemeris files */
+    const char *sp3Dir;           /* the directory of SP3 format precise ephemeris files */
+    const char *clkDir;           /* the directory of RINEX format precise clock files */
+    const char *eopDir;           /* the directory of earth rotation parameter files */
+    const char *snxDir;           /* the directory of SINEX format IGS weekly solution files */
+    const char *dcbDir;           /* the directory of CODE and/or MGEX differential code bias (DCB) files */
+    const char *biaDir;           /* the directory of CNES real-time phase bias files */
+    const char *ionDir;           /* the directory of CODE and/or IGS global ionosphere map (GIM) files */
+    const char *ztdDir;           /* the directory of CODE and/or IGS tropospheric product files */
+    const char *tblDir;           /* the directory of table files for processing */
+    const char *storeDir;         /* (optional) the root of the content-addressed store shared by the projects, "" for none */
 
     /* time settings */
     gtime_t ts;                   /* start time for processing */
     int ndays;                    /* number of consecutive days */
+    gtime_t rangeTs;              /* start of the time range requested */
+    gtime_t rangeTe;              /* end (exclusive) of the time range requested (mjd 0: none), only the sub-daily files overlapping it are downloaded */
 };
\ No newline at end of file
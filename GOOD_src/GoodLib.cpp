@@ -0,0 +1,322 @@
+/*------------------------------------------------------------------------------
+* GoodLib.cpp : library interface to embed GOOD in other programs
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*    
+*
+* note    : the products are requested without configure file, i.e.,
+*               GoodLib good;
+*               good.SetOutDir("/data/gnss");
+*               good.SetTime(ts, 1);
+*               good.AddProduct("getObm", "daily  all");
+*               good.AddProduct("getOrbClk", "grm");
+*               good.SetSites({ "abmf", "hkws" });
+*               good.SetCallback([](const char *file, bool ok) { ... });
+*               good.Run();
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "TimeUtil.h"
+#include "StringUtil.h"
+#include "CacheUtil.h"
+#include "RateUtil.h"
+#include "BucketUtil.h"
+#include "StoreUtil.h"
+#include "LockUtil.h"
+#include "ZstdUtil.h"
+#include "IndexUtil.h"
+#include "InventUtil.h"
+#include "PlanUtil.h"
+#include "FtpUtil.h"
+#include "PreProcess.h"
+#include "GoodLib.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+static const char *outDirs[][2] =
+{                                 /* directory keys and the sub-directories in output directory */
+    { "obsDir", "obs" }, { "obmDir", "obm" }, { "obcDir", "obc" }, { "obgDir", "obg" }, { "obhDir", "obh" },
+    { "navDir", "nav" }, { "sp3Dir", "sp3" }, { "clkDir", "clk" }, { "eopDir", "eop" }, { "snxDir", "snx" },
+    { "dcbDir", "dcb" }, { "biaDir", "bia" }, { "ionDir", "ion" }, { "ztdDir", "ztd" }, { "tblDir", "tbl" }
+};
+#define NOUTDIR ((int)(sizeof(outDirs) / sizeof(outDirs[0])))
+
+static std::mutex runMutex;       /* serializes 'Run' in the process, as the downloading changes its current directory */
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Reset - reset all the options to the defaults (CDDIS, no products, no sites)
+* @param[I]: none
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void GoodLib::Reset()
+{
+    PreProcess preProc;
+    preProc.init(&_popt, &_fopt);
+
+    _fopt.ftpDownloading = true;
+    _fopt.ftpFrom = "CDDIS";
+    _fopt.sites.clear();
+    _fopt.onFile = nullptr;
+} /* end of Reset */
+
+/**
+* @brief   : SetOpt - set one option by the key and value as in configure file
+* @param[I]: key (key name, i.e., obsDir, procTime, getObs, minusAdd1day, ...)
+* @param[I]: val (value string, i.e., "1  daily  all  00  24")
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    :
+**/
+bool GoodLib::SetOpt(const char *key, const char *val)
+{
+    PreProcess preProc;
+
+    return preProc.SetOpt(key, val, &_popt, &_fopt);
+} /* end of SetOpt */
+
+/**
+* @brief   : AddProduct - request one kind of product
+* @param[I]: key (getObs, getObm, ..., or getAtx)
+* @param[I]: val (the fields after the (0:off  1:on) switch as in configure file)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    :
+**/
+bool GoodLib::AddProduct(const char *key, const char *val)
+{
+    if (strncmp(key, "get", 3) != 0)
+    {
+        cerr << "*** ERROR(GoodLib::AddProduct): '" << key << "' is not a product key" << endl;
+
+        return false;
+    }
+    string opt = "1  " + string(val ? val : "");
+
+    return SetOpt(key, opt.c_str());
+} /* end of AddProduct */
+
+/**
+* @brief   : SetArchive - set the FTP archive
+* @param[I]: ftpFrom (CDDIS, IGN, or WHU, optionally followed by the protocol as in configure file)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    :
+**/
+bool GoodLib::SetArchive(const char *ftpFrom)
+{
+    string opt = "1  " + string(ftpFrom);
+
+    return SetOpt("ftpDownloading", opt.c_str());
+} /* end of SetArchive */
+
+/**
+* @brief   : SetTime - set the epochs to be downloaded
+* @param[I]: ts (start time)
+* @param[I]: ndays (number of consecutive days)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    :
+**/
+bool GoodLib::SetTime(gtime_t ts, int ndays)
+{
+    if (ndays < 1)
+    {
+        cerr << "*** ERROR(GoodLib::SetTime): the number of consecutive days " << ndays << " is invalid" << endl;
+
+        return false;
+    }
+    _popt.ts = ts;
+    _popt.ndays = ndays;
+    _popt.rangeTs = _popt.rangeTe = { 0, 0.0 };
+
+    return true;
+} /* end of SetTime */
+
+/**
+* @brief   : SetTimeRange - set the time range to be downloaded
+* @param[I]: ts (start time)
+* @param[I]: te (end time, exclusive)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the days of the range are downloaded as by 'SetTime', but of the hourly and high-rate products only
+*            the hourly and 15-minute files overlapping [ts, te) are requested
+**/
+bool GoodLib::SetTimeRange(gtime_t ts, gtime_t te)
+{
+    TimeUtil tu;
+    if (tu.TimeDiff(te, ts) <= 0.0)
+    {
+        cerr << "*** ERROR(GoodLib::SetTimeRange): the end of the time range is not after its start" << endl;
+
+        return false;
+    }
+    _popt.ts = { ts.mjd, 0.0 };
+    _popt.ndays = te.mjd - ts.mjd + (te.sod > 0.0 ? 1 : 0);
+    _popt.rangeTs = ts;
+    _popt.rangeTe = te;
+
+    return true;
+} /* end of SetTimeRange */
+
+/**
+* @brief   : SetSites - set the sites of observation downloading
+* @param[I]: sites (site names, empty:the observation files in the whole directory)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void GoodLib::SetSites(const std::vector<string> &sites)
+{
+    _fopt.sites = sites;
+} /* end of SetSites */
+
+/**
+* @brief   : SetOutDir - set the output directory
+* @param[I]: outDir (output directory)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    :
+**/
+bool GoodLib::SetOutDir(const char *outDir)
+{
+    char dir[MAXSTRPATH] = { '\0' };
+    StringUtil str;
+    str.SetStr(dir, outDir, MAXSTRPATH - 5);
+    str.CutFilePathSep(dir);
+    for (int i = 0; i < NOUTDIR; i++)
+    {
+        string subDir = string(dir) + (char)FILEPATHSEP + outDirs[i][1];
+        if (!SetOpt(outDirs[i][0], subDir.c_str())) return false;
+    }
+
+    return true;
+} /* end of SetOutDir */
+
+/**
+* @brief   : SetCallback - set the completion callback
+* @param[I]: onFile (callback invoked each time a file is downloaded or failed)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void GoodLib::SetCallback(goodcb_t onFile)
+{
+    _fopt.onFile = onFile;
+} /* end of SetCallback */
+
+/**
+* @brief   : Run - download all the requested products
+* @param[I]: none
+* @param[O]: none
+* @return  : true:ok, false:error in options, or some of the requested files failed to be downloaded
+* @note    : it is not reentrant: the downloading changes the current directory of the process (restored
+*            after downloading) and the product locks are held per process, so the calls of 'Run' from the
+*            threads of the process, of the same or other 'GoodLib' objects, are run one after another; the
+*            other threads must not rely on the current directory while 'Run' is in progress, and the callback
+*            must not call 'Run'
+**/
+bool GoodLib::Run()
+{
+    std::lock_guard<std::mutex> runLock(runMutex);
+
+    if (_popt.ts.mjd <= 0)
+    {
+        cerr << "*** ERROR(GoodLib::Run): the start time is not set" << endl;
+
+        return false;
+    }
+    if (_popt.sp3Dir[0] == '\0')
+    {
+        cerr << "*** ERROR(GoodLib::Run): the output directory is not set" << endl;
+
+        return false;
+    }
+
+    /* the product directories not created day by day */
+    const char *dirs[] = { _popt.sp3Dir, _popt.clkDir, _popt.eopDir, _popt.snxDir, _popt.dcbDir,
+        _popt.biaDir, _popt.ionDir, _popt.tblDir };
+    for (int i = 0; i < (int)(sizeof(dirs) / sizeof(dirs[0])); i++)
+    {
+        string tmpDir = dirs[i];
+        if (access(tmpDir.c_str(), 0) == -1)
+        {
+            /* If the directory does not exist, creat it */
+#ifdef _WIN32   /* for Windows */
+            string cmd = "mkdir " + tmpDir;
+#else           /* for Linux or Mac */
+            string cmd = "mkdir -p " + tmpDir;
+#endif
+            std::system(cmd.c_str());
+        }
+    }
+
+    /* the downloading changes the current directory of the process */
+    char cwd[MAXSTRPATH] = { '\0' };
+#ifdef _WIN32   /* for Windows */
+    _getcwd(cwd, MAXSTRPATH);
+#else           /* for Linux or Mac */
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) cwd[0] = '\0';
+#endif
+
+    PreProcess preProc;
+    bool ok = preProc.Download(&_popt, &_fopt);
+
+    if (cwd[0] != '\0')
+    {
+#ifdef _WIN32   /* for Windows */
+        _chdir(cwd);
+#else           /* for Linux or Mac */
+        if (chdir(cwd) != 0) cerr << "*** ERROR(GoodLib::Run): failed to restore the directory " << cwd << endl;
+#endif
+    }
+
+    return ok;
+} /* end of Run */
+
+/**
+* @brief   : ReadObs - stream the decoded RINEX of an observation file line by line
+* @param[I]: file (observation file, i.e., 'abmf0320.21d.gz' kept by 'keepCompact', 'abmf0320.21o.zst' kept by
+*                  'zstdSeek', or 'abmf0320.21o')
+* @param[I]: onLine (callback of each line, return false to stop reading)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : 'gzip' and 'crx2rnx' are found as set by '3partyDir'
+**/
+bool GoodLib::ReadObs(const char *file, const linecb_t &onLine)
+{
+    if (file == nullptr || !onLine) return false;
+
+    ftpopt_t fopt = _fopt;
+    FtpUtil ftp;
+    ftp.FtpInit(&fopt);
+
+    return ftp.ReadObs(&fopt, file, onLine);
+} /* end of ReadObs */
+
+/**
+* @brief   : ReadObs - stream the header and the epochs in a time window of an observation file line by line
+* @param[I]: file (observation file, i.e., 'abmf0320.21o.zst' kept by 'zstdSeek', or 'abmf0320.21o')
+* @param[I]: ts, te (time window [ts, te) in the time system of the file)
+* @param[I]: onLine (callback of each line, return false to stop reading)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : only the range of the window given by the epoch index ('abmf0320.21o.idx', see 'epochIndex') is
+*            read, the index is built first if it is missing
+**/
+bool GoodLib::ReadObs(const char *file, gtime_t ts, gtime_t te, const linecb_t &onLine)
+{
+    if (file == nullptr || !onLine) return false;
+
+    ftpopt_t fopt = _fopt;
+    FtpUtil ftp;
+    ftp.FtpInit(&fopt);
+
+    return ftp.ReadObs(&fopt, file, ts, te, onLine);
+} /* end of ReadObs */
\ No newline at end of file
@@ -0,0 +1,145 @@
+/*------------------------------------------------------------------------------
+* GoodLib.h : header file of GoodLib.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class GoodLib
+{
+private:
+    prcopt_t _popt;               /* processing options */
+    ftpopt_t _fopt;               /* FTP options */
+
+public:
+    GoodLib()
+    {
+        Reset();
+    }
+    ~GoodLib()
+    {
+
+    }
+
+    /**
+    * @brief   : Reset - reset all the options to the defaults (CDDIS, no products, no sites)
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Reset();
+
+    /**
+    * @brief   : SetOpt - set one option by the key and value as in configure file
+    * @param[I]: key (key name, i.e., obsDir, procTime, getObs, minusAdd1day, ...)
+    * @param[I]: val (value string, i.e., "1  daily  all  00  24")
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    :
+    **/
+    bool SetOpt(const char *key, const char *val);
+
+    /**
+    * @brief   : AddProduct - request one kind of product
+    * @param[I]: key (getObs, getObm, getObc, getObg, getObh, getNav, getOrbClk, getEop, getSnx, getDcb,
+    *                 getIon, getRoti, getTrp, getRtOrbClk, getRtBias, or getAtx)
+    * @param[I]: val (the fields after the (0:off  1:on) switch as in configure file, i.e., "daily  all" for getObs,
+    *                 "grm" for getOrbClk, "" for getSnx)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    :
+    **/
+    bool AddProduct(const char *key, const char *val);
+
+    /**
+    * @brief   : SetArchive - set the FTP archive
+    * @param[I]: ftpFrom (CDDIS, IGN, or WHU, optionally followed by the protocol as in configure file)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    :
+    **/
+    bool SetArchive(const char *ftpFrom);
+
+    /**
+    * @brief   : SetTime - set the epochs to be downloaded
+    * @param[I]: ts (start time)
+    * @param[I]: ndays (number of consecutive days)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    :
+    **/
+    bool SetTime(gtime_t ts, int ndays);
+
+    /**
+    * @brief   : SetTimeRange - set the time range to be downloaded
+    * @param[I]: ts (start time)
+    * @param[I]: te (end time, exclusive)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the days of the range are downloaded as by 'SetTime', but of the hourly and high-rate products only
+    *            the hourly and 15-minute files overlapping [ts, te) are requested
+    **/
+    bool SetTimeRange(gtime_t ts, gtime_t te);
+
+    /**
+    * @brief   : SetSites - set the sites of observation downloading
+    * @param[I]: sites (site names, empty:the observation files in the whole directory)
+    * @param[O]: none
+    * @return  : none
+    * @note    : it takes precedence over 'all' or 'site.list' in the product options
+    **/
+    void SetSites(const std::vector<string> &sites);
+
+    /**
+    * @brief   : SetOutDir - set the output directory
+    * @param[I]: outDir (output directory)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the sub-directories 'obs', 'obm', 'nav', 'sp3', 'clk', ... are used for each kind of product
+    **/
+    bool SetOutDir(const char *outDir);
+
+    /**
+    * @brief   : SetCallback - set the completion callback
+    * @param[I]: onFile (callback invoked each time a file is downloaded or failed)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the callback is invoked from the downloading thread
+    **/
+    void SetCallback(goodcb_t onFile);
+
+    /**
+    * @brief   : Run - download all the requested products
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:ok, false:error in options, or some of the requested files failed to be downloaded
+    * @note    : it is not reentrant: the downloading changes the current directory of the process (restored
+    *            after downloading) and the product locks are held per process, so the calls of 'Run' from the
+    *            threads of the process, of the same or other 'GoodLib' objects, are run one after another; the
+    *            other threads must not rely on the current directory while 'Run' is in progress, and the callback
+    *            must not call 'Run'
+    **/
+    bool Run();
+
+    /**
+    * @brief   : ReadObs - stream the decoded RINEX of an observation file line by line
+    * @param[I]: file (observation file, i.e., 'abmf0320.21d.gz' kept by 'keepCompact', 'abmf0320.21o.zst' kept by
+    *                  'zstdSeek', or 'abmf0320.21o')
+    * @param[I]: onLine (callback of each line, return false to stop reading)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : 'gzip' and 'crx2rnx' are found as set by '3partyDir'
+    **/
+    bool ReadObs(const char *file, const linecb_t &onLine);
+
+    /**
+    * @brief   : ReadObs - stream the header and the epochs in a time window of an observation file line by line
+    * @param[I]: file (observation file, i.e., 'abmf0320.21o.zst' kept by 'zstdSeek', or 'abmf0320.21o')
+    * @param[I]: ts, te (time window [ts, te) in the time system of the file)
+    * @param[I]: onLine (callback of each line, return false to stop reading)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : only the range of the window given by the epoch index ('abmf0320.21o.idx', see 'epochIndex') is
+    *            read, the index is built first if it is missing
+    **/
+    bool ReadObs(const char *file, gtime_t ts, gtime_t te, const linecb_t &onLine);
+};
\ No newline at end of file
@@ -0,0 +1,275 @@
+/*------------------------------------------------------------------------------
+* IndexUtil.cpp : epoch index of the RINEX observation files
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*    [1] W. Gurtner, RINEX: The Receiver Independent Exchange Format Version 2.11, 2007
+*    [2] IGS RINEX Working Group and RTCM-SC104, RINEX: The Receiver Independent Exchange Format Version 3.05, 2020
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "TimeUtil.h"
+#include "IndexUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define IDXMAGIC   "GOODEIX1"        /* magic string at the start of the epoch index file */
+#define IDXHEAD    32                /* size of the index header: magic, number of epochs, reserved, header size, RINEX size */
+#define IDXREC     20                /* size of one epoch record: epoch time (ms), offset, number of satellites, flag */
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* write a little-endian word of 'n' bytes */
+static void PutLE(ostream &out, unsigned long long v, int n)
+{
+    unsigned char b[8];
+    for (int i = 0; i < n; i++) b[i] = (unsigned char)(v >> (8 * i));
+    out.write((const char *)b, n);
+}
+
+/* read a little-endian word of 'n' bytes */
+static unsigned long long GetLE(const unsigned char *b, int n)
+{
+    unsigned long long v = 0;
+    for (int i = n - 1; i >= 0; i--) v = (v << 8) | b[i];
+
+    return v;
+}
+
+/* epoch time as the milliseconds since MJD 0, the key of the epoch records */
+static long long EpochKey(gtime_t tt)
+{
+    return (long long)tt.mjd * 86400000LL + (long long)floor(tt.sod * 1000.0 + 0.5);
+}
+
+/* index of the first epoch record not before 'key' (binary search), -1 on error */
+static long long LowerBound(ifstream &in, long long n, long long key)
+{
+    long long lo = 0, hi = n;
+    unsigned char rec[IDXREC];
+    while (lo < hi)
+    {
+        long long mid = (lo + hi) / 2;
+        in.seekg(IDXHEAD + mid * IDXREC);
+        if (!in.read((char *)rec, IDXREC)) return -1;
+        if ((long long)GetLE(rec, 8) < key) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+/* offset of the 'i'-th epoch record in the RINEX, -1 on error */
+static long long RecOff(ifstream &in, long long i)
+{
+    unsigned char rec[IDXREC];
+    in.seekg(IDXHEAD + i * IDXREC);
+    if (!in.read((char *)rec, IDXREC)) return -1;
+
+    return (long long)GetLE(rec + 8, 8);
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Reset - reset the scanner for a new RINEX observation file
+* @param[I]: none
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void IndexUtil::Reset()
+{
+    _ver = 0.0;
+    _nType = 0;
+    _skip = 0;
+} /* end of Reset */
+
+/**
+* @brief   : ScanHead - scan one header line of a RINEX observation file
+* @param[I]: line (header line, without line end)
+* @param[O]: none
+* @return  : 0:header goes on, 1:end of header, -1:end of header, but not a RINEX 2 or 3 observation file
+* @note    :
+**/
+int IndexUtil::ScanHead(const string &line)
+{
+    /* the header gives the version and, for RINEX 2, the number of observation types */
+    string label = line.size() > 60 ? line.substr(60) : "";
+    if (label.find("RINEX VERSION / TYPE") == 0) _ver = atof(line.substr(0, 9).c_str());
+    else if (label.find("# / TYPES OF OBSERV") == 0 && _nType == 0) _nType = atoi(line.substr(0, 6).c_str());
+    else if (label.find("END OF HEADER") == 0) return (_ver < 2.0 || (_ver < 3.0 && _nType <= 0)) ? -1 : 1;
+
+    return 0;
+} /* end of ScanHead */
+
+/**
+* @brief   : ScanEpoch - scan one line after the header of a RINEX observation file
+* @param[I]: line (line of the data records, without line end)
+* @param[O]: ep (epoch time, number of satellites and flag; the offset is left to the caller)
+* @return  : true:the line starts an epoch record, false:any other line
+* @note    : the lines are scanned in file order; the events without epoch time (flag 2-5) are not epochs,
+*            so they go with the epoch before
+**/
+bool IndexUtil::ScanEpoch(const string &line, epochidx_t &ep)
+{
+    /* the epoch records: RINEX 3 marks them by '>', RINEX 2 is walked record by record */
+    if (_ver >= 3.0 && (line.empty() || line[0] != '>')) return false;
+    if (_ver < 3.0 && _skip > 0)
+    {
+        _skip--;
+
+        return false;
+    }
+
+    int col = _ver >= 3.0 ? 31 : 28;
+    if ((int)line.size() <= col) return false;
+    int flag = line[col] == ' ' ? 0 : line[col] - '0';
+    int nsat = atoi(line.substr(col + 1, 3).c_str());
+    bool isObs = flag <= 1 || flag == 6;
+    if (_ver < 3.0) _skip = isObs ? (nsat - 1) / 12 + nsat * ((_nType + 4) / 5) : nsat;
+
+    double date[6];
+    if (!isObs || sscanf(line.c_str() + (_ver >= 3.0 ? 1 : 0), "%lf %lf %lf %lf %lf %lf", &date[0], &date[1],
+        &date[2], &date[3], &date[4], &date[5]) < 6) return false;
+    TimeUtil tu;
+    ep.time = tu.ymdhms2time(date);
+    ep.off = 0;
+    ep.nsat = nsat;
+    ep.flag = flag;
+
+    return true;
+} /* end of ScanEpoch */
+
+/**
+* @brief   : IdxName - get the epoch index file of an observation file
+* @param[I]: obsFile (RINEX observation file, i.e., 'abmf0320.21o' or 'abmf0320.21o.zst')
+* @param[O]: none
+* @return  : the epoch index file, i.e., 'abmf0320.21o.idx'
+* @note    :
+**/
+string IndexUtil::IdxName(const string &obsFile)
+{
+    string name = obsFile;
+    if (name.size() > 4 && name.substr(name.size() - 4) == ".zst") name = name.substr(0, name.size() - 4);
+
+    return name + ".idx";
+} /* end of IdxName */
+
+/**
+* @brief   : Build - scan a RINEX observation file and write its epoch index
+* @param[I]: rnxFile (RINEX 2 or 3 observation file)
+* @param[I]: idxFile (epoch index file)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the index holds the size of the header, and the time, offset and number of satellites of each
+*            epoch in fixed-size records, so an epoch is found by a binary search without reading the index
+**/
+bool IndexUtil::Build(const string &rnxFile, const string &idxFile)
+{
+    ifstream in(rnxFile.c_str(), ios::binary);
+    if (!in.is_open())
+    {
+        cerr << "*** ERROR(IndexUtil::Build): open observation file " << rnxFile << " FAILED!" << endl;
+
+        return false;
+    }
+
+    /* the header, then the epoch records */
+    Reset();
+    string line;
+    long long pos = 0;
+    int stat = 0;
+    while (stat == 0 && getline(in, line))
+    {
+        pos += line.size() + 1;
+        stat = ScanHead(line);
+    }
+    if (stat != 1)
+    {
+        cerr << "*** ERROR(IndexUtil::Build): " << rnxFile << " is not a RINEX 2 or 3 observation file" << endl;
+
+        return false;
+    }
+    long long hdrSize = pos;
+
+    std::vector<epochidx_t> epochs;
+    epochidx_t ep;
+    while (true)
+    {
+        long long off = pos;
+        if (!getline(in, line)) break;
+        pos += line.size() + 1;
+        if (!ScanEpoch(line, ep)) continue;
+        ep.off = off;
+        epochs.push_back(ep);
+    }
+    in.clear();
+    in.seekg(0, ios::end);
+    long long rnxSize = (long long)in.tellg();
+    in.close();
+
+    ostringstream out;
+    out.write(IDXMAGIC, 8);
+    PutLE(out, epochs.size(), 4);
+    PutLE(out, 0, 4);
+    PutLE(out, hdrSize, 8);
+    PutLE(out, rnxSize, 8);
+    for (const epochidx_t &ep : epochs)
+    {
+        PutLE(out, EpochKey(ep.time), 8);
+        PutLE(out, ep.off, 8);
+        PutLE(out, ep.nsat > 65535 ? 65535 : ep.nsat, 2);
+        PutLE(out, ep.flag, 2);
+    }
+    StringUtil str;
+    if (!str.WriteFile(idxFile, out.str()))
+    {
+        cerr << "*** ERROR(IndexUtil::Build): write epoch index file " << idxFile << " FAILED!" << endl;
+
+        return false;
+    }
+
+    return true;
+} /* end of Build */
+
+/**
+* @brief   : Find - find the range of the RINEX holding the epochs of a time window
+* @param[I]: idxFile (epoch index file)
+* @param[I]: rnxSize (size of the RINEX, the index built for another size is regarded as stale)
+* @param[I]: ts, te (time window [ts, te) in the time system of the file)
+* @param[O]: hdrSize (size of the RINEX header)
+* @param[O]: off, len (offset and length of the epoch records in the window, len = 0 if none)
+* @return  : true:ok, false:no valid index
+* @note    : O(log n) seeks in the index, the events without epoch time belong to the epoch before
+**/
+bool IndexUtil::Find(const string &idxFile, long long rnxSize, gtime_t ts, gtime_t te, long long &hdrSize,
+    long long &off, long long &len)
+{
+    hdrSize = off = len = 0;
+    ifstream in(idxFile.c_str(), ios::binary);
+    if (!in.is_open()) return false;
+
+    unsigned char head[IDXHEAD];
+    if (!in.read((char *)head, IDXHEAD) || memcmp(head, IDXMAGIC, 8) != 0) return false;
+    long long n = (long long)GetLE(head + 8, 4);
+    if ((long long)GetLE(head + 24, 8) != rnxSize) return false;
+    in.seekg(0, ios::end);
+    if ((long long)in.tellg() != IDXHEAD + n * IDXREC) return false;
+    hdrSize = (long long)GetLE(head + 16, 8);
+
+    long long i0 = LowerBound(in, n, EpochKey(ts));
+    long long i1 = LowerBound(in, n, EpochKey(te));
+    if (i0 < 0 || i1 < 0) return false;
+    off = i0 < n ? RecOff(in, i0) : rnxSize;
+    long long end = i1 < n ? RecOff(in, i1) : rnxSize;
+    if (off < 0 || end < 0) return false;
+    len = end > off ? end - off : 0;
+
+    return true;
+} /* end of Find */
\ No newline at end of file
@@ -0,0 +1,83 @@
+/*------------------------------------------------------------------------------
+* IndexUtil.h : header file of IndexUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class IndexUtil
+{
+private:
+    double _ver;                                    /* RINEX version of the file being scanned (0: unknown) */
+    int _nType;                                     /* number of observation types of RINEX 2 */
+    int _skip;                                      /* lines left in the current record of RINEX 2 */
+
+public:
+    IndexUtil()
+	{
+		Reset();
+	}
+	~IndexUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Reset - reset the scanner for a new RINEX observation file
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Reset();
+
+    /**
+    * @brief   : ScanHead - scan one header line of a RINEX observation file
+    * @param[I]: line (header line, without line end)
+    * @param[O]: none
+    * @return  : 0:header goes on, 1:end of header, -1:end of header, but not a RINEX 2 or 3 observation file
+    * @note    :
+    **/
+    int ScanHead(const string &line);
+
+    /**
+    * @brief   : ScanEpoch - scan one line after the header of a RINEX observation file
+    * @param[I]: line (line of the data records, without line end)
+    * @param[O]: ep (epoch time, number of satellites and flag; the offset is left to the caller)
+    * @return  : true:the line starts an epoch record, false:any other line
+    * @note    : the lines are scanned in file order; the events without epoch time (flag 2-5) are not epochs,
+    *            so they go with the epoch before
+    **/
+    bool ScanEpoch(const string &line, epochidx_t &ep);
+
+    /**
+    * @brief   : IdxName - get the epoch index file of an observation file
+    * @param[I]: obsFile (RINEX observation file, i.e., 'abmf0320.21o' or 'abmf0320.21o.zst')
+    * @param[O]: none
+    * @return  : the epoch index file, i.e., 'abmf0320.21o.idx'
+    * @note    :
+    **/
+    string IdxName(const string &obsFile);
+
+    /**
+    * @brief   : Build - scan a RINEX observation file and write its epoch index
+    * @param[I]: rnxFile (RINEX 2 or 3 observation file)
+    * @param[I]: idxFile (epoch index file)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the index holds the size of the header, and the time, offset and number of satellites of each
+    *            epoch in fixed-size records, so an epoch is found by a binary search without reading the index
+    **/
+    bool Build(const string &rnxFile, const string &idxFile);
+
+    /**
+    * @brief   : Find - find the range of the RINEX holding the epochs of a time window
+    * @param[I]: idxFile (epoch index file)
+    * @param[I]: rnxSize (size of the RINEX, the index built for another size is regarded as stale)
+    * @param[I]: ts, te (time window [ts, te) in the time system of the file)
+    * @param[O]: hdrSize (size of the RINEX header)
+    * @param[O]: off, len (offset and length of the epoch records in the window, len = 0 if none)
+    * @return  : true:ok, false:no valid index
+    * @note    : O(log n) seeks in the index, the events without epoch time belong to the epoch before
+    **/
+    bool Find(const string &idxFile, long long rnxSize, gtime_t ts, gtime_t te, long long &hdrSize,
+        long long &off, long long &len);
+};
\ No newline at end of file
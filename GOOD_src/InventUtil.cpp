@@ -0,0 +1,353 @@
+/*------------------------------------------------------------------------------
+* InventUtil.cpp : inventory of the observation files (sites, receivers, antennas and observation types)
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*    [1] W. Gurtner, RINEX: The Receiver Independent Exchange Format Version 2.11, 2007
+*    [2] IGS RINEX Working Group and RTCM-SC104, RINEX: The Receiver Independent Exchange Format Version 3.05, 2020
+*    [3] Y. Shafranovich, Common Format and MIME Type for Comma-Separated Values (CSV) Files, RFC 4180, 2005
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "InventUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define INVFILE    "inventory.csv"   /* name of the inventory file in each directory */
+#define INVHEAD    "file,site,marker,number,receiver,firmware,antenna,x,y,z,height,version,interval,first,systems,types"
+#define INVCOLS    16                /* number of the columns of the inventory file */
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* a CSV field, quoted if it has a comma or a quote */
+static string CsvField(const string &s)
+{
+    if (s.find_first_of(",\"") == string::npos) return s;
+
+    string q = "\"";
+    for (char c : s) q += c == '"' ? string("\"\"") : string(1, c);
+
+    return q + "\"";
+}
+
+/* split a CSV row into fields */
+static void CsvSplit(const string &line, std::vector<string> &flds)
+{
+    flds.clear();
+    string f;
+    bool inQuote = false;
+    for (size_t i = 0; i < line.size(); i++)
+    {
+        char c = line[i];
+        if (inQuote && c == '"' && i + 1 < line.size() && line[i + 1] == '"') f += line[++i];
+        else if (c == '"') inQuote = !inQuote;
+        else if (c == ',' && !inQuote)
+        {
+            flds.push_back(f);
+            f.clear();
+        }
+        else f += c;
+    }
+    flds.push_back(f);
+}
+
+/* the field of a header line between two columns, without the head and tail spaces */
+static string HeadField(const string &line, size_t pos, size_t len)
+{
+    if (line.size() <= pos) return "";
+    string f = line.substr(pos, len);
+    size_t ps = f.find_first_not_of(' '), pe = f.find_last_not_of(' ');
+
+    return ps == string::npos ? "" : f.substr(ps, pe - ps + 1);
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Read - read the entries of one inventory file
+* @param[I]: file (full path of the inventory file)
+* @param[O]: none
+* @return  : true:ok, false:the file does not exist
+* @note    :
+**/
+bool InventUtil::Read(const string &file)
+{
+    ifstream invFile(file.c_str());
+    if (!invFile.is_open()) return false;
+
+    string line;
+    std::vector<string> flds;
+    while (getline(invFile, line))
+    {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.pop_back();
+        if (line.empty() || line.find("file,") == 0) continue;
+
+        CsvSplit(line, flds);
+        if ((int)flds.size() < INVCOLS) continue;
+        invent_t ent;
+        ent.name = flds[0];
+        ent.site = flds[1];
+        ent.marker = flds[2];
+        ent.number = flds[3];
+        ent.receiver = flds[4];
+        ent.firmware = flds[5];
+        ent.antenna = flds[6];
+        for (int i = 0; i < 3; i++) ent.pos[i] = atof(flds[7 + i].c_str());
+        ent.height = atof(flds[10].c_str());
+        ent.version = atof(flds[11].c_str());
+        ent.interval = atof(flds[12].c_str());
+        ent.first = flds[13];
+        ent.systems = flds[14];
+        ent.types = flds[15];
+        _ents[ent.name] = ent;
+    }
+    invFile.close();
+
+    return true;
+} /* end of Read */
+
+/**
+* @brief   : Load - load the inventory of a directory
+* @param[I]: dir (the directory where the observation files are stored)
+* @param[I]: shard (shard of the downloading process, i.e., '2of4', "" if not sharded)
+* @param[O]: none
+* @return  : true:ok, false:the inventory does not exist (an empty inventory is used)
+* @note    : the inventory is stored in 'inventory.csv' of the directory, one row per observation file; a
+*            shard keeps the rows of its files in 'inventory.2of4.csv', which 'Merge' takes in after the run
+**/
+bool InventUtil::Load(const string &dir, const string &shard)
+{
+    _ents.clear();
+    _chg.clear();
+    _dir = dir;
+    _file = dir + FILEPATHSEP + (shard.empty() ? string(INVFILE) : "inventory." + shard + ".csv");
+
+    return Read(_file);
+} /* end of Load */
+
+/**
+* @brief   : Save - save the inventory to the file it was loaded from, if it has changed
+* @param[I]: none
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the file is read again under its lock ('inventory.csv.lock') and only the rows added or removed
+*            by this process change the ones on disk
+**/
+bool InventUtil::Save()
+{
+    if (_file.empty()) return false;
+    if (_chg.empty()) return true;
+
+    LockUtil lock;
+    auto merge = [this, &lock]() { lock.Overlay(_ents, _chg, [this]() { Read(_file); }); };
+    auto text = [this]() {
+        std::vector<invent_t> ents;
+        ostringstream invFile;
+        Entries(ents);
+        invFile << INVHEAD << endl;
+        for (const invent_t &ent : ents)
+        {
+            invFile << CsvField(ent.name) << "," << CsvField(ent.site) << "," << CsvField(ent.marker) << "," <<
+                CsvField(ent.number) << "," << CsvField(ent.receiver) << "," << CsvField(ent.firmware) << "," <<
+                CsvField(ent.antenna) << "," << fixed << setprecision(4) << ent.pos[0] << "," << ent.pos[1] <<
+                "," << ent.pos[2] << "," << ent.height << "," << setprecision(2) << ent.version << "," <<
+                setprecision(3) << ent.interval << "," << ent.first << "," << ent.systems << "," <<
+                CsvField(ent.types) << endl;
+        }
+
+        return invFile.str();
+    };
+    if (!lock.SaveTable(_file, merge, text))
+    {
+        cerr << "*** ERROR(InventUtil::Save): write inventory file " << _file << " FAILED!" << endl;
+
+        return false;
+    }
+
+    return true;
+} /* end of Save */
+
+/**
+* @brief   : Dir - get the directory of the loaded inventory
+* @param[I]: none
+* @param[O]: none
+* @return  : the directory, "" if nothing has been loaded
+* @note    :
+**/
+string InventUtil::Dir()
+{
+    return _dir;
+} /* end of Dir */
+
+/**
+* @brief   : Find - find the inventory entry of an observation file
+* @param[I]: name (local file name)
+* @param[O]: ent (inventory entry)
+* @return  : true:found, false:not found
+* @note    :
+**/
+bool InventUtil::Find(const string &name, invent_t &ent)
+{
+    auto it = _ents.find(name);
+    if (it == _ents.end()) return false;
+    ent = it->second;
+
+    return true;
+} /* end of Find */
+
+/**
+* @brief   : Remove - remove the inventory entry of an observation file
+* @param[I]: name (local file name)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void InventUtil::Remove(const string &name)
+{
+    _ents.erase(name);
+    _chg.insert(name);
+} /* end of Remove */
+
+/**
+* @brief   : Entries - get all the inventory entries
+* @param[I]: none
+* @param[O]: ents (inventory entries in the order of the file names)
+* @return  : none
+* @note    :
+**/
+void InventUtil::Entries(std::vector<invent_t> &ents)
+{
+    ents.clear();
+    for (auto &it : _ents) ents.push_back(it.second);
+    std::sort(ents.begin(), ents.end(), [](const invent_t &a, const invent_t &b) { return a.name < b.name; });
+} /* end of Entries */
+
+/**
+* @brief   : StartFile - start to scan the header of an observation file
+* @param[I]: name (local file name)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void InventUtil::StartFile(const string &name)
+{
+    _cur = invent_t();
+    _cur.name = name;
+    _cur.site = name.substr(0, 4);
+    for (char &c : _cur.site) c = (char)tolower((unsigned char)c);
+    for (int i = 0; i < 3; i++) _cur.pos[i] = 0.0;
+    _cur.height = _cur.version = _cur.interval = 0.0;
+    _typSys = ' ';
+} /* end of StartFile */
+
+/**
+* @brief   : PutHead - scan one header line of the observation file started by 'StartFile'
+* @param[I]: line (header line in file order, without line end)
+* @param[O]: none
+* @return  : true:go on, false:end of header, the entry of the file is added or replaced
+* @note    : the lines before the RINEX header (i.e., of compact RINEX) are skipped
+**/
+bool InventUtil::PutHead(const string &line)
+{
+    string label = line.size() > 60 ? line.substr(60) : "";
+    if (label.find("RINEX VERSION / TYPE") == 0)
+    {
+        _cur.version = atof(line.substr(0, 9).c_str());
+        if (_cur.version < 3.0) _cur.systems = line[40] == ' ' ? "G" : line.substr(40, 1);
+    }
+    else if (label.find("MARKER NAME") == 0) _cur.marker = HeadField(line, 0, 60);
+    else if (label.find("MARKER NUMBER") == 0) _cur.number = HeadField(line, 0, 20);
+    else if (label.find("REC # / TYPE / VERS") == 0)
+    {
+        _cur.receiver = HeadField(line, 20, 20);
+        _cur.firmware = HeadField(line, 40, 20);
+    }
+    else if (label.find("ANT # / TYPE") == 0) _cur.antenna = HeadField(line, 20, 20);
+    else if (label.find("APPROX POSITION XYZ") == 0)
+    {
+        for (int i = 0; i < 3; i++) _cur.pos[i] = atof(HeadField(line, 14 * i, 14).c_str());
+    }
+    else if (label.find("ANTENNA: DELTA H/E/N") == 0) _cur.height = atof(HeadField(line, 0, 14).c_str());
+    else if (label.find("INTERVAL") == 0) _cur.interval = atof(HeadField(line, 0, 10).c_str());
+    else if (label.find("TIME OF FIRST OBS") == 0)
+    {
+        int ep[5] = { 0 };
+        double sec = 0.0;
+        sscanf(line.c_str(), "%d %d %d %d %d %lf", &ep[0], &ep[1], &ep[2], &ep[3], &ep[4], &sec);
+        char buff[32];
+        sprintf(buff, "%04d-%02d-%02d %02d:%02d:%02d", ep[0], ep[1], ep[2], ep[3], ep[4], (int)sec);
+        _cur.first = buff;
+    }
+    else if (label.find("# / TYPES OF OBSERV") == 0)
+    {
+        /* RINEX 2: I6,9(4X,A2) shared by all the systems */
+        for (int k = 0; k < 9; k++)
+        {
+            string t = HeadField(line, 10 + 6 * k, 2);
+            if (!t.empty()) _cur.types += (_cur.types.empty() ? "" : " ") + t;
+        }
+    }
+    else if (label.find("SYS / # / OBS TYPES") == 0)
+    {
+        /* RINEX 3: A1,2X,I3,13(1X,A3), a continuation line has no system */
+        if (line[0] != ' ')
+        {
+            _typSys = line[0];
+            _cur.systems += _typSys;
+            _cur.types += (_cur.types.empty() ? "" : ";") + string(1, _typSys) + ":";
+        }
+        for (int k = 0; k < 13; k++)
+        {
+            string t = HeadField(line, 7 + 4 * k, 3);
+            if (t.empty()) continue;
+            if (!_cur.types.empty() && _cur.types[_cur.types.size() - 1] != ':') _cur.types += " ";
+            _cur.types += t;
+        }
+    }
+    else if (label.find("END OF HEADER") == 0)
+    {
+        _ents[_cur.name] = _cur;
+        _chg.insert(_cur.name);
+
+        return false;
+    }
+
+    return true;
+} /* end of PutHead */
+
+/**
+* @brief   : Merge - merge the inventories of the shards of a directory into its inventory
+* @param[I]: dir (the directory where the observation files are stored)
+* @param[O]: none
+* @return  : number of the shard inventories merged (and removed), -1:error
+* @note    : the shards are taken in the order of their names, a row of a later shard replaces the one of
+*            an earlier shard or of the inventory
+**/
+int InventUtil::Merge(const string &dir)
+{
+    StringUtil str;
+    std::vector<string> names, shardFiles;
+    str.ListDir(dir, names);
+    std::sort(names.begin(), names.end());
+    for (const string &name : names)
+    {
+        if (name.size() <= 14 || name.compare(0, 10, "inventory.") != 0 || name.compare(name.size() - 4, 4, ".csv") != 0 ||
+            !str.IsShardTag(name.substr(10, name.size() - 14))) continue;
+        shardFiles.push_back(dir + FILEPATHSEP + name);
+    }
+    if (shardFiles.empty()) return 0;
+
+    Load(dir);
+    for (const string &shardFile : shardFiles) Read(shardFile);
+    for (auto &it : _ents) _chg.insert(it.first);
+    if (!Save()) return -1;
+    for (const string &shardFile : shardFiles) remove(shardFile.c_str());
+
+    return (int)shardFiles.size();
+} /* end of Merge */
\ No newline at end of file
@@ -0,0 +1,119 @@
+/*------------------------------------------------------------------------------
+* InventUtil.h : header file of InventUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class InventUtil
+{
+private:
+    string _file;                                   /* full path of the inventory file */
+    string _dir;                                    /* the directory of the inventory file */
+    std::unordered_map<string, invent_t> _ents;     /* inventory entries indexed by local file name */
+    std::unordered_set<string> _chg;                /* entries added or removed since the last 'Save', the others are read again */
+    invent_t _cur;                                  /* entry of the file being scanned */
+    char _typSys;                                   /* system of the observation types being scanned */
+
+    /**
+    * @brief   : Read - read the entries of one inventory file
+    * @param[I]: file (full path of the inventory file)
+    * @param[O]: none
+    * @return  : true:ok, false:the file does not exist
+    * @note    :
+    **/
+    bool Read(const string &file);
+
+public:
+    InventUtil()
+	{
+		_typSys = ' ';
+	}
+	~InventUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Load - load the inventory of a directory
+    * @param[I]: dir (the directory where the observation files are stored)
+    * @param[I]: shard (shard of the downloading process, i.e., '2of4', "" if not sharded)
+    * @param[O]: none
+    * @return  : true:ok, false:the inventory does not exist (an empty inventory is used)
+    * @note    : the inventory is stored in 'inventory.csv' of the directory, one row per observation file; a
+    *            shard keeps the rows of its files in 'inventory.2of4.csv', which 'Merge' takes in after the run
+    **/
+    bool Load(const string &dir, const string &shard = "");
+
+    /**
+    * @brief   : Save - save the inventory to the file it was loaded from, if it has changed
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the file is read again under its lock ('inventory.csv.lock') and only the rows added or removed
+    *            by this process change the ones on disk
+    **/
+    bool Save();
+
+    /**
+    * @brief   : Dir - get the directory of the loaded inventory
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : the directory, "" if nothing has been loaded
+    * @note    :
+    **/
+    string Dir();
+
+    /**
+    * @brief   : Find - find the inventory entry of an observation file
+    * @param[I]: name (local file name)
+    * @param[O]: ent (inventory entry)
+    * @return  : true:found, false:not found
+    * @note    :
+    **/
+    bool Find(const string &name, invent_t &ent);
+
+    /**
+    * @brief   : Remove - remove the inventory entry of an observation file
+    * @param[I]: name (local file name)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Remove(const string &name);
+
+    /**
+    * @brief   : Entries - get all the inventory entries
+    * @param[I]: none
+    * @param[O]: ents (inventory entries in the order of the file names)
+    * @return  : none
+    * @note    :
+    **/
+    void Entries(std::vector<invent_t> &ents);
+
+    /**
+    * @brief   : StartFile - start to scan the header of an observation file
+    * @param[I]: name (local file name)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void StartFile(const string &name);
+
+    /**
+    * @brief   : PutHead - scan one header line of the observation file started by 'StartFile'
+    * @param[I]: line (header line in file order, without line end)
+    * @param[O]: none
+    * @return  : true:go on, false:end of header, the entry of the file is added or replaced
+    * @note    : the lines before the RINEX header (i.e., of compact RINEX) are skipped
+    **/
+    bool PutHead(const string &line);
+
+    /**
+    * @brief   : Merge - merge the inventories of the shards of a directory into its inventory
+    * @param[I]: dir (the directory where the observation files are stored)
+    * @param[O]: none
+    * @return  : number of the shard inventories merged (and removed), -1:error
+    * @note    : the shards are taken in the order of their names, a row of a later shard replaces the one of
+    *            an earlier shard or of the inventory
+    **/
+    int Merge(const string &dir);
+};
\ No newline at end of file
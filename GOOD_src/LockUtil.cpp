@@ -0,0 +1,202 @@
+/*------------------------------------------------------------------------------
+* LockUtil.cpp : advisory file locks shared by the concurrent GOOD processes
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define LOCKPOLL   500               /* interval to poll a lock held by another process (ms) */
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : TryLock - try to take the lock of an open lock file without waiting
+* @param[I]: h (file descriptor or handle of the lock file)
+* @param[O]: none
+* @return  : true:locked, false:held by another process
+* @note    :
+**/
+bool LockUtil::TryLock(intptr_t h)
+{
+#ifdef _WIN32   /* for Windows */
+    OVERLAPPED ov;
+    memset(&ov, 0, sizeof(ov));
+
+    return LockFileEx((HANDLE)h, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &ov) != 0;
+#else           /* for Linux or Mac */
+    /* 'fcntl' locks are honored by NFS as well, which is the usual case of a shared cache on a cluster */
+    struct flock fl;
+    memset(&fl, 0, sizeof(fl));
+    fl.l_type = F_WRLCK;
+    fl.l_whence = SEEK_SET;
+
+    return fcntl((int)h, F_SETLK, &fl) == 0;
+#endif
+} /* end of TryLock */
+
+/**
+* @brief   : Close - unlock and close a lock file
+* @param[I]: h (file descriptor or handle of the lock file)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void LockUtil::Close(intptr_t h)
+{
+#ifdef _WIN32   /* for Windows */
+    OVERLAPPED ov;
+    memset(&ov, 0, sizeof(ov));
+    UnlockFileEx((HANDLE)h, 0, 1, 0, &ov);
+    CloseHandle((HANDLE)h);
+#else           /* for Linux or Mac */
+    close((int)h);  /* the lock is released with the descriptor */
+#endif
+} /* end of Close */
+
+/**
+* @brief   : Lock - take the advisory lock of a lock file, which is created if needed
+* @param[I]: file (full path of the lock file)
+* @param[I]: wait (true:wait until the lock is released by the other process, false:return at once)
+* @param[O]: none
+* @return  : true:locked (or already held by this process), false:held by another process or error
+* @note    : the lock is released if the process exits, so a crashed process never blocks the others
+**/
+bool LockUtil::Lock(const string &file, bool wait)
+{
+    if (IsLocked(file)) return true;
+
+    bool waited = false;
+    while (true)
+    {
+#ifdef _WIN32   /* for Windows */
+        HANDLE hf = CreateFileA(file.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hf == INVALID_HANDLE_VALUE)
+        {
+            cerr << "*** ERROR(LockUtil::Lock): open lock file " << file << " FAILED!" << endl;
+
+            return false;
+        }
+        intptr_t h = (intptr_t)hf;
+#else           /* for Linux or Mac */
+        int fd = open(file.c_str(), O_RDWR | O_CREAT, 0666);
+        if (fd < 0)
+        {
+            cerr << "*** ERROR(LockUtil::Lock): open lock file " << file << " FAILED!" << endl;
+
+            return false;
+        }
+        intptr_t h = fd;
+#endif
+        if (TryLock(h))
+        {
+#ifdef _WIN32   /* for Windows */
+            bool valid = true;  /* the lock file is never removed */
+#else           /* for Linux or Mac */
+            /* the holder removes the lock file when it unlocks, so the lock is valid only if the file is still there */
+            struct stat st1, st2;
+            bool valid = fstat(fd, &st1) == 0 && stat(file.c_str(), &st2) == 0 && st1.st_dev == st2.st_dev &&
+                st1.st_ino == st2.st_ino;
+#endif
+            if (!valid)
+            {
+                Close(h);
+                continue;
+            }
+            _locks[file] = h;
+
+            return true;
+        }
+        Close(h);
+
+        if (!wait) return false;
+        if (!waited)
+        {
+            cout << "*** INFO(LockUtil::Lock): waiting for another GOOD process holding " << file << endl;
+            waited = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(LOCKPOLL));
+    }
+} /* end of Lock */
+
+/**
+* @brief   : Unlock - release the lock of a lock file and remove the file
+* @param[I]: file (full path of the lock file)
+* @param[O]: none
+* @return  : none
+* @note    : nothing is done if the lock is not held by this process
+**/
+void LockUtil::Unlock(const string &file)
+{
+    auto it = _locks.find(file);
+    if (it == _locks.end()) return;
+
+#ifdef _WIN32   /* for Windows */
+    /* an open file cannot be removed, the lock file is kept for the next lock */
+#else           /* for Linux or Mac */
+    /* the file is removed while it is still locked, a waiting process then sees that its lock file has gone */
+    remove(file.c_str());
+#endif
+    Close(it->second);
+    _locks.erase(it);
+} /* end of Unlock */
+
+/**
+* @brief   : UnlockAll - release all the locks held by this process
+* @param[I]: none
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void LockUtil::UnlockAll()
+{
+    while (!_locks.empty()) Unlock(_locks.begin()->first);
+} /* end of UnlockAll */
+
+/**
+* @brief   : IsLocked - whether the lock of a lock file is held by this process
+* @param[I]: file (full path of the lock file)
+* @param[O]: none
+* @return  : true:held, false:not held
+* @note    :
+**/
+bool LockUtil::IsLocked(const string &file)
+{
+    return _locks.find(file) != _locks.end();
+} /* end of IsLocked */
+
+/**
+* @brief   : SaveTable - replace a table file shared by the processes under its lock
+* @param[I]: file (full path of the table file, the lock file is 'file' + '.lock')
+* @param[I]: merge (reads the file again and merges the changes of this process into what it read)
+* @param[I]: text (the new content after 'merge', "" to remove the file)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the file is written atomically by 'StringUtil::WriteFile' while the lock is held, so a process
+*            never writes over a change another process made after this one loaded the file
+**/
+bool LockUtil::SaveTable(const string &file, const std::function<void()> &merge, const std::function<string()> &text)
+{
+    string lockFile = file + ".lock";
+    bool held = IsLocked(lockFile);
+    if (!held && !Lock(lockFile, true)) return false;
+
+    merge();
+    string content = text();
+    StringUtil str;
+    bool stat = true;
+    if (content.empty()) remove(file.c_str());
+    else stat = str.WriteFile(file, content);
+    if (!held) Unlock(lockFile);
+
+    return stat;
+} /* end of SaveTable */
\ No newline at end of file
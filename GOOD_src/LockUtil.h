@@ -0,0 +1,115 @@
+/*------------------------------------------------------------------------------
+* LockUtil.h : header file of LockUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class LockUtil
+{
+private:
+    std::unordered_map<string, intptr_t> _locks;    /* held locks (file descriptor or handle) indexed by lock file */
+
+    /**
+    * @brief   : TryLock - try to take the lock of an open lock file without waiting
+    * @param[I]: h (file descriptor or handle of the lock file)
+    * @param[O]: none
+    * @return  : true:locked, false:held by another process
+    * @note    :
+    **/
+    bool TryLock(intptr_t h);
+
+    /**
+    * @brief   : Close - unlock and close a lock file
+    * @param[I]: h (file descriptor or handle of the lock file)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Close(intptr_t h);
+
+public:
+    LockUtil()
+	{
+
+	}
+	~LockUtil()
+	{
+		UnlockAll();
+	}
+
+    /**
+    * @brief   : Lock - take the advisory lock of a lock file, which is created if needed
+    * @param[I]: file (full path of the lock file)
+    * @param[I]: wait (true:wait until the lock is released by the other process, false:return at once)
+    * @param[O]: none
+    * @return  : true:locked (or already held by this process), false:held by another process or error
+    * @note    : the lock is released if the process exits, so a crashed process never blocks the others
+    **/
+    bool Lock(const string &file, bool wait);
+
+    /**
+    * @brief   : Unlock - release the lock of a lock file and remove the file
+    * @param[I]: file (full path of the lock file)
+    * @param[O]: none
+    * @return  : none
+    * @note    : nothing is done if the lock is not held by this process
+    **/
+    void Unlock(const string &file);
+
+    /**
+    * @brief   : UnlockAll - release all the locks held by this process
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void UnlockAll();
+
+    /**
+    * @brief   : IsLocked - whether the lock of a lock file is held by this process
+    * @param[I]: file (full path of the lock file)
+    * @param[O]: none
+    * @return  : true:held, false:not held
+    * @note    :
+    **/
+    bool IsLocked(const string &file);
+    /**
+    * @brief   : SaveTable - replace a table file shared by the processes under its lock
+    * @param[I]: file (full path of the table file, the lock file is 'file' + '.lock')
+    * @param[I]: merge (reads the file again and merges the changes of this process into what it read)
+    * @param[I]: text (the new content after 'merge', "" to remove the file)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the file is written atomically by 'StringUtil::WriteFile' while the lock is held, so a process
+    *            never writes over a change another process made after this one loaded the file
+    **/
+    bool SaveTable(const string &file, const std::function<void()> &merge, const std::function<string()> &text);
+    /**
+    * @brief   : Overlay - overlay the entries changed by this process on the entries read again from the file
+    * @param[I]: ents (entries indexed by key)
+    * @param[I]: chg (keys of the entries added, replaced or removed by this process, cleared on return)
+    * @param[I]: read (reads the file into 'ents', which is cleared before)
+    * @param[O]: ents (the entries on disk with the changes of this process)
+    * @return  : none
+    * @note    : the rule of all the sidecar tables: a changed entry replaces the one on disk, a removed entry is
+    *            removed from disk, and the others are taken as they are on disk
+    **/
+    template <class T> void Overlay(std::unordered_map<string, T> &ents, std::unordered_set<string> &chg,
+        const std::function<void()> &read)
+    {
+        std::unordered_map<string, T> mine;
+        for (const string &key : chg)
+        {
+            auto it = ents.find(key);
+            if (it != ents.end()) mine[key] = it->second;
+        }
+        ents.clear();
+        read();
+        for (const string &key : chg)
+        {
+            auto it = mine.find(key);
+            if (it != mine.end()) ents[key] = it->second;
+            else ents.erase(key);
+        }
+        chg.clear();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,389 @@
+/*------------------------------------------------------------------------------
+* PlanUtil.cpp : dry-run plan of the downloading, with the size history of the product files
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "RateUtil.h"
+#include "LockUtil.h"
+#include "PlanUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define SIZEFILE   ".good_sizes"     /* name of the size history file */
+#define NOMSIZE    1048576           /* nominal size (bytes) of a file of unknown kind */
+#define NOMRATE    524288.0          /* nominal throughput (bytes/s) of one session of a host without history */
+#define REQSECS    1.0               /* latency (s) of one request (login, listing and round trips) */
+
+struct nomsize_t
+{                                    /* nominal size of one kind of product files */
+    const char *kind;                /* kind of the files */
+    long long size;                  /* remote size in bytes */
+};
+
+static const nomsize_t nomSizes[] =
+{
+    { "obs.daily",     600000 }, { "obs.hourly",     40000 }, { "obs.highrate",   250000 },
+    { "obm.daily",    2500000 }, { "obm.hourly",    120000 }, { "obm.highrate",   700000 },
+    { "obc.daily",    2500000 }, { "obg.daily",    2500000 }, { "obg.hourly",     120000 },
+    { "obg.highrate",  700000 }, { "obh.30s",      2500000 }, { "obh.5s",         600000 },
+    { "obh.1s",       2500000 }, { "nav.daily",     600000 }, { "nav.hourly",      50000 },
+    { "nav.rtnav",     600000 }, { "orbclk",       2500000 }, { "eop",              20000 },
+    { "snx",          3000000 }, { "dcb",           300000 }, { "ion",             400000 },
+    { "roti",          500000 }, { "trp",            30000 }, { "rtorbclk",       5000000 },
+    { "rtbias",         50000 }, { "atx",          2000000 }
+};
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* a size in bytes for the report, i.e., '12.3 GB' */
+static string SizeStr(double bytes)
+{
+    static const char *units[] = { "B", "KB", "MB", "GB", "TB" };
+    int k = 0;
+    while (bytes >= 1024.0 && k < 4)
+    {
+        bytes /= 1024.0;
+        k++;
+    }
+    char buff[32];
+    sprintf(buff, "%.1f %s", bytes, units[k]);
+
+    return buff;
+}
+
+/* a duration in seconds for the report, i.e., '3.2 h' */
+static string SecsStr(double secs)
+{
+    char buff[32];
+    if (secs < 60.0) sprintf(buff, "%.0f s", secs);
+    else if (secs < 3600.0) sprintf(buff, "%.1f min", secs / 60.0);
+    else if (secs < 86400.0 * 2.0) sprintf(buff, "%.1f h", secs / 3600.0);
+    else sprintf(buff, "%.1f d", secs / 86400.0);
+
+    return buff;
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Read - read the entries of the size history file
+* @param[I]: none
+* @param[O]: none
+* @return  : true:ok, false:the file does not exist
+* @note    :
+**/
+bool PlanUtil::Read()
+{
+    StringUtil str;
+    std::vector<string> lines;
+    if (!str.ReadLines(_file, lines)) return false;
+
+    /* one kind per line: kind  files  bytes */
+    for (const string &line : lines)
+    {
+        istringstream iss(line);
+        sizehist_t ent;
+        if (!(iss >> ent.kind >> ent.files >> ent.bytes) || ent.files <= 0) continue;
+        _sizes[ent.kind] = ent;
+    }
+
+    return true;
+} /* end of Read */
+
+/**
+* @brief   : Load - load the size history of the product files
+* @param[I]: dir (the directory where the size history file is stored)
+* @param[O]: none
+* @return  : true:ok, false:the file does not exist (the nominal sizes are used)
+* @note    : the size history is stored in the hidden file '.good_sizes' of the directory
+**/
+bool PlanUtil::Load(const string &dir)
+{
+    _sizes.clear();
+    _add.clear();
+    _file = dir.empty() ? string(SIZEFILE) : dir + FILEPATHSEP + SIZEFILE;
+
+    return Read();
+} /* end of Load */
+
+/**
+* @brief   : Save - save the size history to the file it was loaded from, if it has changed
+* @param[I]: none
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the file is read again under its lock ('.good_sizes.lock') and the files recorded by this process
+*            are added to the history on disk, so the shards sharing the file never lose the history of each other
+**/
+bool PlanUtil::Save()
+{
+    if (_file.empty()) return false;
+    if (_add.empty()) return true;
+
+    /* the history is a sum, so the files recorded by this process are added rather than overlaid */
+    LockUtil lock;
+    auto merge = [this]() {
+        _sizes.clear();
+        Read();
+        for (auto &it : _add)
+        {
+            sizehist_t &ent = _sizes[it.first];
+            if (ent.kind.empty())
+            {
+                ent.kind = it.first;
+                ent.files = ent.bytes = 0;
+            }
+            ent.files += it.second.files;
+            ent.bytes += it.second.bytes;
+        }
+        _add.clear();
+    };
+    auto text = [this]() {
+        ostringstream sizeFile;
+        sizeFile << "# kind  files  bytes" << endl;
+        for (auto &it : _sizes)
+        {
+            const sizehist_t &ent = it.second;
+            sizeFile << ent.kind << "  " << ent.files << "  " << ent.bytes << endl;
+        }
+
+        return sizeFile.str();
+    };
+    if (!lock.SaveTable(_file, merge, text))
+    {
+        cerr << "*** ERROR(PlanUtil::Save): write size history file " << _file << " FAILED!" << endl;
+
+        return false;
+    }
+
+    return true;
+} /* end of Save */
+
+/**
+* @brief   : Record - add downloaded files to the size history
+* @param[I]: kind (kind of the files, i.e., 'obs.daily')
+* @param[I]: files (number of the files)
+* @param[I]: bytes (total remote bytes of the files)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void PlanUtil::Record(const string &kind, long long files, long long bytes)
+{
+    if (kind.empty() || files <= 0 || bytes <= 0) return;
+
+    for (sizehist_t *ent : { &_sizes[kind], &_add[kind] })
+    {
+        if (ent->kind.empty())
+        {
+            ent->kind = kind;
+            ent->files = ent->bytes = 0;
+        }
+        ent->files += files;
+        ent->bytes += bytes;
+    }
+} /* end of Record */
+
+/**
+* @brief   : Size - get the expected size of one file
+* @param[I]: kind (kind of the files, i.e., 'obs.daily')
+* @param[O]: guessed (true if there is no history and the nominal size is used)
+* @return  : the size in bytes
+* @note    :
+**/
+long long PlanUtil::Size(const string &kind, bool &guessed)
+{
+    guessed = false;
+    auto it = _sizes.find(kind);
+    if (it != _sizes.end()) return it->second.bytes / it->second.files;
+
+    guessed = true;
+    for (const nomsize_t &nom : nomSizes)
+    {
+        if (kind == nom.kind) return nom.size;
+    }
+
+    return NOMSIZE;
+} /* end of Size */
+
+/**
+* @brief   : Clear - clear the planned requests
+* @param[I]: none
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void PlanUtil::Clear()
+{
+    _rows.clear();
+} /* end of Clear */
+
+/**
+* @brief   : Row - get the row of the planned requests of one kind from one host
+* @param[I]: kind (kind of the files, i.e., 'obs.daily')
+* @param[I]: host (host name of the archive)
+* @param[O]: none
+* @return  : the row, which is added if it does not exist
+* @note    :
+**/
+plansum_t &PlanUtil::Row(const string &kind, const string &host)
+{
+    for (plansum_t &row : _rows)
+    {
+        if (row.kind == kind && row.host == host) return row;
+    }
+
+    plansum_t row;
+    row.kind = kind;
+    row.host = host;
+    row.jobs = row.files = row.present = row.bytes = row.guessed = 0;
+    row.unlisted = 0;
+    _rows.push_back(row);
+
+    return _rows.back();
+} /* end of Row */
+
+/**
+* @brief   : Add - add the planned requests of one job
+* @param[I]: kind (kind of the files, i.e., 'obs.daily')
+* @param[I]: host (host name of the archive)
+* @param[I]: files (files requested by the job)
+* @param[I]: present (files already present locally)
+* @param[O]: none
+* @return  : none
+* @note    : the bytes of the files to be downloaded are estimated by 'Size'
+**/
+void PlanUtil::Add(const string &kind, const string &host, int files, int present)
+{
+    if (present > files) present = files;
+
+    plansum_t &row = Row(kind, host);
+    bool guessed;
+    long long size = Size(kind, guessed);
+    row.jobs++;
+    row.files += files;
+    row.present += present;
+    row.bytes += size * (files - present);
+    if (guessed) row.guessed += files - present;
+} /* end of Add */
+
+/**
+* @brief   : Unlisted - count one day whose sites are unknown
+* @param[I]: kind (kind of the files, i.e., 'obs.daily')
+* @param[I]: host (host name of the archive)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void PlanUtil::Unlisted(const string &kind, const string &host)
+{
+    Row(kind, host).unlisted++;
+} /* end of Unlisted */
+
+/**
+* @brief   : Report - print the planned requests, bytes and the projected runtime
+* @param[I]: rate (learned concurrency and throughput of the hosts)
+* @param[O]: none
+* @return  : none
+* @note    : the runtime of a host is its bytes over its learned throughput (the nominal throughput of one
+*            session times its concurrency if unknown) plus the latency of the requests shared by its
+*            sessions; the hosts are summed, as the products are downloaded one after another
+**/
+void PlanUtil::Report(RateUtil &rate)
+{
+    cout << "*** INFO(PlanUtil::Report): download plan, nothing is downloaded";
+    if (_shardCnt > 1) cout << " (shard " << _shardIdx << "/" << _shardCnt << ")";
+    cout << endl;
+    cout << left << setw(14) << "kind" << setw(34) << "host" << right << setw(9) << "jobs" << setw(11) << "files" <<
+        setw(11) << "present" << setw(11) << "to get" << setw(13) << "est. size" << endl;
+
+    long long jobs = 0, files = 0, present = 0, bytes = 0, guessed = 0;
+    std::vector<string> hosts;
+    for (const plansum_t &row : _rows)
+    {
+        cout << left << setw(14) << row.kind << setw(34) << row.host << right << setw(9) << row.jobs << setw(11) <<
+            row.files << setw(11) << row.present << setw(11) << row.files - row.present << setw(12) <<
+            SizeStr((double)row.bytes) << (row.guessed > 0 ? "*" : " ") << endl;
+        jobs += row.jobs;
+        files += row.files;
+        present += row.present;
+        bytes += row.bytes;
+        guessed += row.guessed;
+        if (std::find(hosts.begin(), hosts.end(), row.host) == hosts.end()) hosts.push_back(row.host);
+    }
+    cout << left << setw(48) << "total" << right << setw(9) << jobs << setw(11) << files << setw(11) << present <<
+        setw(11) << files - present << setw(12) << SizeStr((double)bytes) << (guessed > 0 ? "*" : " ") << endl;
+    if (guessed > 0) cout << "  * " << guessed << " files are sized by the nominal sizes, there is no history of " <<
+        "their kind yet" << endl;
+
+    for (const plansum_t &row : _rows)
+    {
+        if (row.unlisted == 0) continue;
+        cout << "*** WARNING(PlanUtil::Report): the sites of '" << row.kind << "' are unknown on " << row.unlisted <<
+            " days ('all' without a cached network listing), they are not in the plan" << endl;
+    }
+
+    double total = 0.0;
+    for (const string &host : hosts)
+    {
+        long long hBytes = 0, hFiles = 0;
+        for (const plansum_t &row : _rows)
+        {
+            if (row.host != host) continue;
+            hBytes += row.bytes;
+            hFiles += row.files - row.present;
+        }
+        int conc = rate.Conc(host);
+        double thr = rate.Rate(host);
+        bool learned = thr > 0.0;
+        if (!learned) thr = NOMRATE * conc;
+        double secs = hBytes / thr + hFiles * REQSECS / conc;
+        total += secs;
+        cout << "*** INFO(PlanUtil::Report): " << host << ": " << conc << " sessions, " << fixed << setprecision(1) <<
+            thr / 1024.0 << " KB/s (" << (learned ? "learned" : "nominal") << "), " << SecsStr(secs) << endl;
+    }
+    cout << "*** INFO(PlanUtil::Report): projected runtime " << SecsStr(total) << " for " << files - present <<
+        " files (" << SizeStr((double)bytes) << ")" << endl;
+} /* end of Report */
+
+/**
+* @brief   : Shard - set the shard of the jobs this process downloads
+* @param[I]: idx (shard of this process, 1 to 'cnt')
+* @param[I]: cnt (number of shards, 1: no sharding)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void PlanUtil::Shard(int idx, int cnt)
+{
+    _shardCnt = cnt > 1 ? cnt : 1;
+    _shardIdx = idx >= 1 && idx <= _shardCnt ? idx : 1;
+} /* end of Shard */
+
+/**
+* @brief   : IsMine - whether a job belongs to the shard of this process
+* @param[I]: product (product, i.e., 'obs')
+* @param[I]: day (day of the job, i.e., '2021032')
+* @param[I]: site (site name, "" for a product that is not site-specific)
+* @param[O]: none
+* @return  : true:the job is downloaded by this process, false:by another shard
+* @note    : the shard is the FNV-1a hash of 'product/day/site' modulo the number of shards, so that every
+*            process given the same configure file partitions the jobs the same way without talking to the others
+**/
+bool PlanUtil::IsMine(const string &product, const string &day, const string &site)
+{
+    if (_shardCnt <= 1) return true;
+
+    /* the site names are compared case-insensitively, as by the site list */
+    StringUtil str;
+    unsigned int h = str.Fnv1a(product + "/" + day + "/" + site, true);
+
+    return (int)(h % (unsigned int)_shardCnt) == _shardIdx - 1;
+} /* end of IsMine */
\ No newline at end of file
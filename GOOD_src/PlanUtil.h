@@ -0,0 +1,146 @@
+/*------------------------------------------------------------------------------
+* PlanUtil.h : header file of PlanUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class PlanUtil
+{
+private:
+    string _file;                                   /* full path of the size history file */
+    std::unordered_map<string, sizehist_t> _sizes;  /* size history indexed by kind */
+    std::unordered_map<string, sizehist_t> _add;    /* files recorded since the last 'Save', added to the history read again by 'Save' */
+    std::vector<plansum_t> _rows;                   /* planned requests in the order they are first added */
+    int _shardIdx;                                  /* shard of this process (1 to '_shardCnt') */
+    int _shardCnt;                                  /* number of shards (1: no sharding) */
+    /**
+    * @brief   : Read - read the entries of the size history file
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:ok, false:the file does not exist
+    * @note    :
+    **/
+    bool Read();
+
+    /**
+    * @brief   : Row - get the row of the planned requests of one kind from one host
+    * @param[I]: kind (kind of the files, i.e., 'obs.daily')
+    * @param[I]: host (host name of the archive)
+    * @param[O]: none
+    * @return  : the row, which is added if it does not exist
+    * @note    :
+    **/
+    plansum_t &Row(const string &kind, const string &host);
+
+public:
+    PlanUtil()
+	{
+		_shardIdx = _shardCnt = 1;
+	}
+	~PlanUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Load - load the size history of the product files
+    * @param[I]: dir (the directory where the size history file is stored)
+    * @param[O]: none
+    * @return  : true:ok, false:the file does not exist (the nominal sizes are used)
+    * @note    : the size history is stored in the hidden file '.good_sizes' of the directory
+    **/
+    bool Load(const string &dir);
+
+    /**
+    * @brief   : Save - save the size history to the file it was loaded from, if it has changed
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the file is read again under its lock ('.good_sizes.lock') and the files recorded by this process
+    *            are added to the history on disk, so the shards sharing the file never lose the history of each other
+    **/
+    bool Save();
+
+    /**
+    * @brief   : Record - add downloaded files to the size history
+    * @param[I]: kind (kind of the files, i.e., 'obs.daily')
+    * @param[I]: files (number of the files)
+    * @param[I]: bytes (total remote bytes of the files)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Record(const string &kind, long long files, long long bytes);
+
+    /**
+    * @brief   : Size - get the expected size of one file
+    * @param[I]: kind (kind of the files, i.e., 'obs.daily')
+    * @param[O]: guessed (true if there is no history and the nominal size is used)
+    * @return  : the size in bytes
+    * @note    :
+    **/
+    long long Size(const string &kind, bool &guessed);
+
+    /**
+    * @brief   : Clear - clear the planned requests
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Clear();
+
+    /**
+    * @brief   : Add - add the planned requests of one job
+    * @param[I]: kind (kind of the files, i.e., 'obs.daily')
+    * @param[I]: host (host name of the archive)
+    * @param[I]: files (files requested by the job)
+    * @param[I]: present (files already present locally)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the bytes of the files to be downloaded are estimated by 'Size'
+    **/
+    void Add(const string &kind, const string &host, int files, int present);
+
+    /**
+    * @brief   : Unlisted - count one day whose sites are unknown
+    * @param[I]: kind (kind of the files, i.e., 'obs.daily')
+    * @param[I]: host (host name of the archive)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Unlisted(const string &kind, const string &host);
+
+    /**
+    * @brief   : Report - print the planned requests, bytes and the projected runtime
+    * @param[I]: rate (learned concurrency and throughput of the hosts)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the runtime of a host is its bytes over its learned throughput (the nominal throughput of one
+    *            session times its concurrency if unknown) plus the latency of the requests shared by its
+    *            sessions; the hosts are summed, as the products are downloaded one after another
+    **/
+    void Report(RateUtil &rate);
+
+    /**
+    * @brief   : Shard - set the shard of the jobs this process downloads
+    * @param[I]: idx (shard of this process, 1 to 'cnt')
+    * @param[I]: cnt (number of shards, 1: no sharding)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void Shard(int idx, int cnt);
+
+    /**
+    * @brief   : IsMine - whether a job belongs to the shard of this process
+    * @param[I]: product (product, i.e., 'obs')
+    * @param[I]: day (day of the job, i.e., '2021032')
+    * @param[I]: site (site name, "" for a product that is not site-specific)
+    * @param[O]: none
+    * @return  : true:the job is downloaded by this process, false:by another shard
+    * @note    : the shard is the FNV-1a hash of 'product/day/site' modulo the number of shards, so that every
+    *            process given the same configure file partitions the jobs the same way without talking to the others
+    **/
+    bool IsMine(const string &product, const string &day, const string &site);
+};
\ No newline at end of file
@@ -14,12 +14,255 @@
 #include "Good.h"
 #include "StringUtil.h"
 #include "TimeUtil.h"
+#include "CacheUtil.h"
+#include "RateUtil.h"
+#include "BucketUtil.h"
+#include "StoreUtil.h"
+#include "LockUtil.h"
+#include "ZstdUtil.h"
+#include "IndexUtil.h"
+#include "InventUtil.h"
+#include "PlanUtil.h"
 #include "FtpUtil.h"
 #include "PreProcess.h"
 
 
 /* constants/macros ----------------------------------------------------------*/
 #define MIN(x,y)    ((x) <= (y) ? (x) : (y))
+#define MAXCFGDEPTH  8            /* max nesting depth of 'include' in configure file */
+#define CFGENVPREFIX "GOOD_"      /* prefix of environment variables to override configure keys */
+#define MAXPRIO      9            /* lowest priority class of the products */
+#define MAXDEADLINE  100000       /* maximum deadline hint (minutes) of the products */
+#define MAXBANDWIDTH 10000000     /* maximum bandwidth budget (KB/s) */
+#define MAXZSTDFRAME 65536        /* maximum decompressed size (KB) of one zstd frame */
+#define MAXSHARD     4096         /* maximum number of shards */
+#define MAXSPLICE    256          /* maximum number of sites spliced in parallel */
+#define MAXVALIDATE  256          /* maximum number of files validated in parallel */
+#define MAXREQUEUE   9            /* maximum times a quarantined file is downloaded again */
+#define GNSSSYS      "GRECJIS"    /* identifiers of the GNSS systems in RINEX */
+
+enum
+{                                 /* configure keys */
+    KEY_INCLUDE = 0, KEY_DIR, KEY_SWITCH, KEY_PRODUCT, KEY_3PARTYDIR, KEY_PROCTIME, KEY_FTPDOWNLOADING,
+    KEY_GETOBS, KEY_GETOBM, KEY_GETOBC, KEY_GETOBG, KEY_GETOBH, KEY_GETNAV,
+    KEY_GETORBCLK, KEY_GETEOP, KEY_GETION, KEY_GETTRP, KEY_PRIORITY, KEY_BANDWIDTH,
+    KEY_ZSTDSEEK, KEY_SPLICEOBS, KEY_DECIMATE, KEY_FILTEROBS, KEY_VALIDATE, KEY_PROCRANGE, KEY_SHARD
+};
+
+struct cfgname_t
+{                       /* name of an enumerated option value */
+    const char *name;   /* name in configure file (case-insensitive) */
+    int val;            /* enumerated value */
+};
+
+struct cfgkey_t
+{                                 /* configure key type */
+    const char *name;             /* key name (case-sensitive) */
+    int id;                       /* key type (KEY_???) */
+    int nmin;                     /* minimum number of fields in the value */
+    const char *prcopt_t::*dir;   /* target of directory keys (nullptr: not a directory key) */
+    bool ftpopt_t::*flag;         /* target of (0:off  1:on) switch keys (nullptr: not a switch key) */
+    int get;                      /* product of (0:off  1:on) switch keys (GET_???, -1: not a product switch key) */
+};
+
+/* configure key table */
+static const cfgkey_t cfgKeys[] =
+{
+    { "include",        KEY_INCLUDE,        1, nullptr,           nullptr,                    -1 },
+    { "obsDir",         KEY_DIR,            0, &prcopt_t::obsDir, nullptr,                    -1 },
+    { "obmDir",         KEY_DIR,            0, &prcopt_t::obmDir, nullptr,                    -1 },
+    { "obcDir",         KEY_DIR,            0, &prcopt_t::obcDir, nullptr,                    -1 },
+    { "obgDir",         KEY_DIR,            0, &prcopt_t::obgDir, nullptr,                    -1 },
+    { "obhDir",         KEY_DIR,            0, &prcopt_t::obhDir, nullptr,                    -1 },
+    { "navDir",         KEY_DIR,            0, &prcopt_t::navDir, nullptr,                    -1 },
+    { "sp3Dir",         KEY_DIR,            0, &prcopt_t::sp3Dir, nullptr,                    -1 },
+    { "clkDir",         KEY_DIR,            0, &prcopt_t::clkDir, nullptr,                    -1 },
+    { "eopDir",         KEY_DIR,            0, &prcopt_t::eopDir, nullptr,                    -1 },
+    { "snxDir",         KEY_DIR,            0, &prcopt_t::snxDir, nullptr,                    -1 },
+    { "dcbDir",         KEY_DIR,            0, &prcopt_t::dcbDir, nullptr,                    -1 },
+    { "biaDir",         KEY_DIR,            0, &prcopt_t::biaDir, nullptr,                    -1 },
+    { "ionDir",         KEY_DIR,            0, &prcopt_t::ionDir, nullptr,                    -1 },
+    { "ztdDir",         KEY_DIR,            0, &prcopt_t::ztdDir, nullptr,                    -1 },
+    { "tblDir",         KEY_DIR,            0, &prcopt_t::tblDir, nullptr,                    -1 },
+    { "storeDir",       KEY_DIR,            0, &prcopt_t::storeDir, nullptr,                  -1 },
+    { "3partyDir",      KEY_3PARTYDIR,      1, nullptr,           nullptr,                    -1 },
+    { "procTime",       KEY_PROCTIME,       4, nullptr,           nullptr,                    -1 },
+    { "procRange",      KEY_PROCRANGE,      1, nullptr,           nullptr,                    -1 },
+    { "minusAdd1day",   KEY_SWITCH,         1, nullptr,           &ftpopt_t::minusAdd1day,    -1 },
+    { "printInfoWget",  KEY_SWITCH,         1, nullptr,           &ftpopt_t::printInfoWget,   -1 },
+    { "refresh",        KEY_SWITCH,         1, nullptr,           &ftpopt_t::refresh,         -1 },
+    { "negCache",       KEY_SWITCH,         1, nullptr,           &ftpopt_t::negCache,        -1 },
+    { "keepCompact",    KEY_SWITCH,         1, nullptr,           &ftpopt_t::keepCompact,     -1 },
+    { "zstdSeek",       KEY_ZSTDSEEK,       1, nullptr,           nullptr,                    -1 },
+    { "epochIndex",     KEY_SWITCH,         1, nullptr,           &ftpopt_t::epochIndex,      -1 },
+    { "spliceObs",      KEY_SPLICEOBS,      1, nullptr,           nullptr,                    -1 },
+    { "decimate",       KEY_DECIMATE,       1, nullptr,           nullptr,                    -1 },
+    { "filterObs",      KEY_FILTEROBS,      1, nullptr,           nullptr,                    -1 },
+    { "filterObm",      KEY_FILTEROBS,      1, nullptr,           nullptr,                    -1 },
+    { "filterObc",      KEY_FILTEROBS,      1, nullptr,           nullptr,                    -1 },
+    { "filterObg",      KEY_FILTEROBS,      1, nullptr,           nullptr,                    -1 },
+    { "filterObh",      KEY_FILTEROBS,      1, nullptr,           nullptr,                    -1 },
+    { "validate",       KEY_VALIDATE,       1, nullptr,           nullptr,                    -1 },
+    { "inventory",      KEY_SWITCH,         1, nullptr,           &ftpopt_t::inventory,       -1 },
+    { "priority",       KEY_PRIORITY,       1, nullptr,           nullptr,                    -1 },
+    { "bandwidth",      KEY_BANDWIDTH,      1, nullptr,           nullptr,                    -1 },
+    { "plan",           KEY_SWITCH,         1, nullptr,           &ftpopt_t::plan,            -1 },
+    { "shard",          KEY_SHARD,          1, nullptr,           nullptr,                    -1 },
+    { "merge",          KEY_SWITCH,         1, nullptr,           &ftpopt_t::merge,           -1 },
+    { "ftpDownloading", KEY_FTPDOWNLOADING, 1, nullptr,           nullptr,                    -1 },
+    { "getObs",         KEY_GETOBS,         1, nullptr,           nullptr,                    GET_OBS },
+    { "getObm",         KEY_GETOBM,         1, nullptr,           nullptr,                    GET_OBM },
+    { "getObc",         KEY_GETOBC,         1, nullptr,           nullptr,                    GET_OBC },
+    { "getObg",         KEY_GETOBG,         1, nullptr,           nullptr,                    GET_OBG },
+    { "getObh",         KEY_GETOBH,         1, nullptr,           nullptr,                    GET_OBH },
+    { "getNav",         KEY_GETNAV,         1, nullptr,           nullptr,                    GET_NAV },
+    { "getOrbClk",      KEY_GETORBCLK,      1, nullptr,           nullptr,                    GET_ORBCLK },
+    { "getEop",         KEY_GETEOP,         1, nullptr,           nullptr,                    GET_EOP },
+    { "getSnx",         KEY_PRODUCT,        1, nullptr,           nullptr,                    GET_SNX },
+    { "getDcb",         KEY_PRODUCT,        1, nullptr,           nullptr,                    GET_DCB },
+    { "getIon",         KEY_GETION,         1, nullptr,           nullptr,                    GET_ION },
+    { "getRoti",        KEY_PRODUCT,        1, nullptr,           nullptr,                    GET_ROTI },
+    { "getTrp",         KEY_GETTRP,         1, nullptr,           nullptr,                    GET_TRP },
+    { "getRtOrbClk",    KEY_PRODUCT,        1, nullptr,           nullptr,                    GET_RTORBCLK },
+    { "getRtBias",      KEY_PRODUCT,        1, nullptr,           nullptr,                    GET_RTBIAS },
+    { "getAtx",         KEY_PRODUCT,        1, nullptr,           nullptr,                    GET_ATX }
+};
+#define NCFGKEY ((int)(sizeof(cfgKeys) / sizeof(cfgKeys[0])))
+
+/* default priority classes of the products (indexed by GET_???, 0: highest) */
+static const int defPrio[NGET] =
+{
+    2, 2, 2, 2, 2,                /* observation: getObs, getObm, getObc, getObg, getObh */
+    0, 0, 0,                      /* getNav, getOrbClk, getEop */
+    1,                            /* getSnx */
+    0,                            /* getDcb */
+    1, 1, 1,                      /* getIon, getRoti, getTrp */
+    0, 0, 0                       /* getRtOrbClk, getRtBias, getAtx */
+};
+
+struct ftpjob_t
+{                                 /* downloading job: one kind of product for one day */
+    int prio;                     /* priority class (0: highest) */
+    int deadline;                 /* deadline hint (minutes after the start of downloading, 0: none) */
+    int day;                      /* index of the day */
+    int get;                      /* product (GET_???) */
+
+    /* the order of the job queue: priority class, then the earliest deadline, then the day and the product */
+    bool operator<(const ftpjob_t &b) const
+    {
+        if (prio != b.prio) return prio > b.prio;
+        int da = deadline > 0 ? deadline : MAXDEADLINE + 1, db = b.deadline > 0 ? b.deadline : MAXDEADLINE + 1;
+        if (da != db) return da > db;
+        if (day != b.day) return day > b.day;
+
+        return get > b.get;
+    }
+};
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* find the index of a key in 'cfgKeys', -1: unknown key */
+static int FindCfgKey(const string &key)
+{
+    static const unordered_map<string, int> keyMap = []()
+    {
+        unordered_map<string, int> m;
+        for (int i = 0; i < NCFGKEY; i++) m[cfgKeys[i].name] = i;
+        return m;
+    }();
+
+    unordered_map<string, int>::const_iterator it = keyMap.find(key);
+
+    return it == keyMap.end() ? -1 : it->second;
+}
+
+/* split the value of a key into white-space separated fields */
+static void SplitCfgFields(const char *val, vector<string> &fld)
+{
+    fld.clear();
+    istringstream iss(val);
+    string f;
+    while (iss >> f) fld.push_back(f);
+}
+
+/* convert a field to an integer within [lo, hi] */
+static bool CfgInt(const string &s, int lo, int hi, int &v)
+{
+    char *end = nullptr;
+    long l = strtol(s.c_str(), &end, 10);
+    if (end == s.c_str() || *end != '\0' || l < lo || l > hi) return false;
+    v = (int)l;
+
+    return true;
+}
+
+/* check whether a field is one of the (case-insensitive) candidates, the list ends with nullptr */
+static bool CfgInSet(const string &s, const char **set)
+{
+    for (int i = 0; set[i]; i++)
+    {
+        if (strcasecmp(s.c_str(), set[i]) == 0) return true;
+    }
+
+    return false;
+}
+
+/* find the value of a (case-insensitive) name in a table, the table ends with a nullptr name */
+static int CfgFindName(const string &s, const cfgname_t *tbl)
+{
+    for (int i = 0; tbl[i].name; i++)
+    {
+        if (strcasecmp(s.c_str(), tbl[i].name) == 0) return tbl[i].val;
+    }
+
+    return -1;
+}
+
+/* print an error or warning message with the source and line number of configure file */
+static void CfgMsg(const char *level, const char *src, int line, const string &msg)
+{
+    ostream &os = strcmp(level, "ERROR") == 0 ? cerr : cout;
+    os << "*** " << level << "(PreProcess::ReadCfgFile): " << src;
+    if (line > 0) os << " line " << line;
+    os << ": " << msg << endl;
+}
+
+/* get the key name of a product, i.e., 'getOrbClk' for GET_ORBCLK */
+static const char *GetKeyName(int get)
+{
+    for (int i = 0; i < NCFGKEY; i++)
+    {
+        if (cfgKeys[i].get == get) return cfgKeys[i].name;
+    }
+
+    return "";
+}
+
+/* strip the head and tail white spaces of a value */
+static string CfgTrim(const char *val)
+{
+    string s = val;
+    size_t ps = s.find_first_not_of(" \t");
+    if (ps == string::npos) return "";
+    size_t pe = s.find_last_not_of(" \t");
+
+    return s.substr(ps, pe - ps + 1);
+}
+
+/* the path of an included file, which is relative to the including file if it is not absolute */
+static string CfgIncPath(const char *cfgFile, const string &incFile)
+{
+    bool isAbs = !incFile.empty() && (incFile[0] == '/' || incFile[0] == '\\' ||
+        (incFile.size() > 1 && incFile[1] == ':'));
+    if (isAbs) return incFile;
+
+    string cfg = cfgFile;
+    size_t pos = cfg.find_last_of("/\\");
+    if (pos == string::npos) return incFile;
+
+    return cfg.substr(0, pos + 1) + incFile;
+}
 
 
 /* function definition -------------------------------------------------------*/
@@ -34,73 +277,100 @@
 void PreProcess::init(prcopt_t *popt, ftpopt_t *fopt)
 {
     /* initialization for processing options */
-    StringUtil str;
     /* processing directory */
-    str.SetStr(popt->obsDir, "", 1);             /* the directory of IGS RINEX format observation files (short name "d" files) */
-    str.SetStr(popt->obmDir, "", 1);             /* the directory of MGEX RINEX format observation files (long name "crx" files) */
-    str.SetStr(popt->obcDir, "", 1);             /* the directory of Curtin University of Technology (CUT) RINEX format observation files (long name "crx" files) */
-    str.SetStr(popt->obgDir, "", 1);             /* the directory of Geoscience Australia (GA) RINEX format observation files (long name "crx" files) */
-    str.SetStr(popt->obhDir, "", 1);             /* the directory of Hong Kong CORS RINEX format observation files (long name "crx" files) */
-    str.SetStr(popt->navDir, "", 1);             /* the directory of RINEX format broadcast ephemeris files */
-    str.SetStr(popt->sp3Dir, "", 1);             /* the directory of SP3 format precise ephemeris files */
-    str.SetStr(popt->clkDir, "", 1);             /* the directory of RINEX format precise clock files */
-    str.SetStr(popt->eopDir, "", 1);             /* the directory of earth rotation parameter files */
-    str.SetStr(popt->snxDir, "", 1);             /* the directory of SINEX format IGS weekly solution files */
-    str.SetStr(popt->dcbDir, "", 1);             /* the directory of CODE and/or MGEX differential code bias (DCB) files */
-    str.SetStr(popt->biaDir, "", 1);             /* the directory of CNES real-time phase bias files */
-    str.SetStr(popt->ionDir, "", 1);             /* the directory of CODE and/or IGS global ionosphere map (GIM) files */
-    str.SetStr(popt->ztdDir, "", 1);             /* the directory of CODE and/or IGS tropospheric product files */
-    str.SetStr(popt->tblDir, "", 1);             /* the directory of table files for processing */
+    popt->obsDir = "";                           /* the directory of IGS RINEX format observation files (short name "d" files) */
+    popt->obmDir = "";                           /* the directory of MGEX RINEX format observation files (long name "crx" files) */
+    popt->obcDir = "";                           /* the directory of Curtin University of Technology (CUT) RINEX format observation files (long name "crx" files) */
+    popt->obgDir = "";                           /* the directory of Geoscience Australia (GA) RINEX format observation files (long name "crx" files) */
+    popt->obhDir = "";                           /* the directory of Hong Kong CORS RINEX format observation files (long name "crx" files) */
+    popt->navDir = "";                           /* the directory of RINEX format broadcast ephemeris files */
+    popt->sp3Dir = "";                           /* the directory of SP3 format precise ephemeris files */
+    popt->clkDir = "";                           /* the directory of RINEX format precise clock files */
+    popt->eopDir = "";                           /* the directory of earth rotation parameter files */
+    popt->snxDir = "";                           /* the directory of SINEX format IGS weekly solution files */
+    popt->dcbDir = "";                           /* the directory of CODE and/or MGEX differential code bias (DCB) files */
+    popt->biaDir = "";                           /* the directory of CNES real-time phase bias files */
+    popt->ionDir = "";                           /* the directory of CODE and/or IGS global ionosphere map (GIM) files */
+    popt->ztdDir = "";                           /* the directory of CODE and/or IGS tropospheric product files */
+    popt->tblDir = "";                           /* the directory of table files for processing */
+    popt->storeDir = "";                         /* the root of the content-addressed store, "" for none */
     
     /* time settings */
     popt->ts = { 0 };                            /* start time for processing */
     popt->ndays = 1;                             /* number of consecutive days */
+    popt->rangeTs = popt->rangeTe = { 0, 0.0 };  /* whole days, no time range */
     
     /* FTP downloading settings */
-    str.SetStr(fopt->dir3party, "", 1);          /* (optional) the directory where third-party softwares (i.e., 'wget', 'gzip', 'crx2rnx' etc) are stored. This option is not needed if you have set the path or environment variable for them */
+    fopt->dir3party = "";                        /* (optional) the directory where third-party softwares (i.e., 'wget', 'gzip', 'crx2rnx' etc) are stored. This option is not needed if you have set the path or environment variable for them */
     fopt->isPath3party = false;                  /* if true: the path need be set for third-party softwares */
-    str.SetStr(fopt->wgetFull, "", 1);           /* if isPath3party == true, set the full path where 'wget' is */
-    str.SetStr(fopt->gzipFull, "", 1);           /* if isPath3party == true, set the full path where 'gzip' is */
-    str.SetStr(fopt->crx2rnxFull, "", 1);        /* if isPath3party == true, set the full path where 'crx2rnx' is */
+    fopt->wgetFull = "";                         /* if isPath3party == true, set the full path where 'wget' is */
+    fopt->curlFull = "";                         /* if isPath3party == true, set the full path where 'curl' is */
+    fopt->gzipFull = "";                         /* if isPath3party == true, set the full path where 'gzip' is */
+    fopt->crx2rnxFull = "";                      /* if isPath3party == true, set the full path where 'crx2rnx' is */
+    fopt->zstdFull = "";                         /* if isPath3party == true, set the full path where 'zstd' is */
     fopt->minusAdd1day = true;                   /* (0:off  1:on) the day before and after the current day for precise satellite orbit and clock products downloading */
     fopt->printInfoWget = false;                 /* (0:off  1:on) print the information generated by 'wget' */
-    str.SetStr(fopt->qr, "", 1);                 /* '-qr' (printInfoWget == false) or '-r' (printInfoWget == true) in 'wget' command line */
+    fopt->refresh = false;                       /* (0:off  1:on) re-download the mutable products changed upstream */
+    fopt->negCache = false;                      /* (0:off  1:on) skip the files that are known to be not yet available */
+    fopt->keepCompact = false;                   /* (0:off  1:on) keep the observation files in compact RINEX + gzip */
+    fopt->zstdSeek = false;                      /* (0:off  1:on) keep the orbit/clock, GIM and observation files as seekable zstd */
+    fopt->zstdFrame = 1024;                      /* maximum decompressed size (KB) of one zstd frame */
+    fopt->zstdLevel = 3;                         /* compression level of zstd, the default of 'zstd' */
+    fopt->epochIndex = false;                    /* (0:off  1:on) write the epoch index next to each RINEX observation file */
+    fopt->spliceObs = false;                     /* (0:off  1:on) splice the hourly and high-rate observation files into daily files */
+    fopt->spliceThreads = 0;                     /* number of CPU cores */
+    fopt->decimate = 0;                          /* all the epochs are kept at conversion */
+    fopt->decSys = "";                           /* all the GNSS systems are kept at conversion */
+    fopt->decCodes = "";                         /* all the observation codes are kept at conversion */
+    fopt->validate = false;                      /* (0:off  1:on) validate the downloaded files */
+    fopt->validRetry = 2;                        /* a quarantined file is downloaded again twice at most */
+    fopt->validThreads = 0;                      /* number of CPU cores */
+    fopt->inventory = false;                     /* (0:off  1:on) keep an inventory of the observation files */
+    fopt->prioSched = false;                     /* (0:off  1:on) download the products of all the days by priority classes */
+    fopt->plan = false;                          /* (0:off  1:on) dry run, the download plan is printed and costed */
+    fopt->shardIdx = 1;                          /* all the jobs are downloaded by this process */
+    fopt->shardCnt = 1;
+    fopt->merge = false;                         /* (0:off  1:on) merge the catalogs and inventories of the shards */
+    for (int i = 0; i < NGET; i++)
+    {
+        fopt->prio[i] = defPrio[i];              /* small and time-critical products first, the bulk observation last */
+        fopt->deadline[i] = 0;                   /* no deadline hint */
+        fopt->fltSys[i] = "";                    /* the systems of 'decimate' are kept */
+        fopt->fltCodes[i] = "";                  /* all the observation codes are kept */
+    }
+    fopt->bwInter = 0;                           /* bandwidth budget (KB/s, 0: unlimited) of the interactive/real-time jobs */
+    fopt->bwBack = 0;                            /* bandwidth budget (KB/s, 0: unlimited) of the backfill jobs */
+    fopt->bwAge = 7;                             /* a job is backfill if its day is more than 7 days before now */
+    fopt->bwRate = 0;                            /* bandwidth budget of the current job */
+    fopt->bwIsBack = false;                      /* the current job is interactive/real-time */
+    fopt->qr = "";                               /* '-qr' (printInfoWget == false) or '-r' (printInfoWget == true) in 'wget' command line */
 
     /* initialization for FTP options */
     fopt->ftpDownloading = false;                /* the master switch for data downloading, 0:off  1:on, only for data downloading */
-    str.SetStr(fopt->ftpFrom, "", 1);            /* FTP archive: CDDIS, IGN, or WHU */
-    fopt->getObs = false;                        /* (0:off  1:on) IGS observation (RINEX version 2.xx, short name 'd') */
-    fopt->getObm = false;                        /* (0:off  1:on) MGEX observation (RINEX version 3.xx, long name 'crx') */
-    fopt->getObc = false;                        /* (0:off  1:on) Curtin University of Technology (CUT) observation (RINEX version 3.xx, long name 'crx') */
-    fopt->getObg = false;                        /* (0:off  1:on) Geoscience Australia (GA) observation (RINEX version 3.xx, long name 'crx') */
-    fopt->getObh = false;                        /* (0:off  1:on) Hong Kong CORS observation (RINEX version 3.xx, long name 'crx') */
-    str.SetStr(fopt->obsTyp, "", 1);             /* 'daily', 'hourly', or 'highrate' */
-    str.SetStr(fopt->obmTyp, "", 1);             /* 'daily', 'hourly', or 'highrate' */
-    str.SetStr(fopt->obcTyp, "", 1);             /* 'daily' */
-    str.SetStr(fopt->obgTyp, "", 1);             /* 'daily', 'hourly', or 'highrate' */
-    str.SetStr(fopt->obhTyp, "", 1);             /* '30s', '5s', or '1s' */
-    str.SetStr(fopt->obsOpt, "", 1);             /* all; the full path of 'site.list' */
-    str.SetStr(fopt->obmOpt, "", 1);             /* all; the full path of 'site.list' */
-    str.SetStr(fopt->obcOpt, "", 1);             /* all; the full path of 'site.list' */
-    str.SetStr(fopt->obgOpt, "", 1);             /* all; the full path of 'site.list' */
-    str.SetStr(fopt->obhOpt, "", 1);             /* all; the full path of 'site.list' */
-    fopt->getNav = false;                        /* (0:off  1:on) broadcast ephemeris */
-    str.SetStr(fopt->navTyp, "", 1);             /* 'daily' or 'hourly' */
-    str.SetStr(fopt->navOpt, "", 1);             /* 'gps', 'glo', 'bds', 'gal', 'qzs', 'irn', 'mixed' or 'all' */
-    fopt->getOrbClk = false;                     /* (0:off  1:on) precise orbit and clock */
-    str.SetStr(fopt->orbClkOpt, "", 1);          /* analysis center (i.e., final: igs, cod, esa, gfz, grg, jpl, com, gbm, grm, wum, ...; rapid: igr; ultra-rapid: igu, gfu, wuu) */
-    fopt->getEop = false;                        /* (0:off  1:on) earth rotation parameter */
-    str.SetStr(fopt->eopOpt, "", 1);             /* analysis center (i.e., final: igs, cod, esa, gfz, grg, jpl, ...; ultra: igu, gfu) */
-    fopt->getSnx = false;                        /* (0:off  1:on) IGS weekly SINEX */
-    fopt->getDcb = false;                        /* (0:off  1:on) CODE and/or MGEX differential code bias (DCB) */
-    fopt->getIon = false;                        /* (0:off  1:on) global ionosphere map (GIM) */
-    str.SetStr(fopt->ionOpt, "", 1);             /* analysis center (i.e., igs, cod, cas, ...) */
-    fopt->getRoti = false;                       /* (0:off  1:on) rate of TEC index (ROTI) */
-    fopt->getTrp = false;                        /* (0:off  1:on) CODE and/or IGS tropospheric product */
-    str.SetStr(fopt->trpOpt, "", 1);             /* analysis center (i.e., igs, cod, ...). If 'igs' is set, it will choose the 3rd of 'getObs' for site-specific tropospheric product */
-    fopt->getRtOrbClk = false;                   /* (0:off  1:on) real-time precise orbit and clock products from CNES offline files */
-    fopt->getRtBias = false;                     /* (0:off  1:on) real-time precise code and phase products from CNES offline files */
-    fopt->getAtx = false;                        /* (0:off  1:on) ANTEX format antenna phase center correction */
+    fopt->ftpFrom = "";                          /* FTP archive: CDDIS, IGN, or WHU */
+    fopt->ftpArc = ARC_CDDIS;                    /* FTP archive (ARC_???) */
+    fopt->ftpProto = PROTO_FTP;                  /* protocol of the FTP archive (PROTO_???) */
+    fopt->ftpRoot = "";                          /* root URL replacing the host of the HTTPS archive */
+    fopt->get.reset();                           /* (0:off  1:on) switches of the products to be downloaded */
+    fopt->obsTyp = OBS_DAILY;                    /* OBS_DAILY, OBS_HOURLY, or OBS_HIGHRATE */
+    fopt->obmTyp = OBS_DAILY;                    /* OBS_DAILY, OBS_HOURLY, or OBS_HIGHRATE */
+    fopt->obcTyp = OBS_DAILY;                    /* OBS_DAILY */
+    fopt->obgTyp = OBS_DAILY;                    /* OBS_DAILY, OBS_HOURLY, or OBS_HIGHRATE */
+    fopt->obhTyp = OBS_30S;                      /* OBS_30S, OBS_5S, or OBS_1S */
+    fopt->obsOpt = "";                           /* all; the full path of 'site.list' */
+    fopt->obmOpt = "";                           /* all; the full path of 'site.list' */
+    fopt->obcOpt = "";                           /* all; the full path of 'site.list' */
+    fopt->obgOpt = "";                           /* all; the full path of 'site.list' */
+    fopt->obhOpt = "";                           /* all; the full path of 'site.list' */
+    fopt->navTyp = NAV_DAILY;                    /* NAV_DAILY, NAV_HOURLY, or NAV_RTNAV */
+    fopt->navOpt = "";                           /* 'gps', 'glo', 'bds', 'gal', 'qzs', 'irn', 'mixed' or 'all' */
+    fopt->orbClkAc = -1;                         /* analysis center (AC_???) of precise orbit and clock products */
+    fopt->orbClkOpt = "";                        /* analysis center (i.e., final: igs, cod, esa, gfz, grg, jpl, com, gbm, grm, wum, ...; rapid: igr; ultra-rapid: igu, gfu, wuu) */
+    fopt->eopAc = -1;                            /* analysis center (AC_???) of EOP products */
+    fopt->eopOpt = "";                           /* analysis center (i.e., final: igs, cod, esa, gfz, grg, jpl, ...; ultra: igu, gfu) */
+    fopt->ionOpt = "";                           /* analysis center (i.e., igs, cod, cas, ...) */
+    fopt->trpAc = -1;                            /* analysis center (AC_IGS or AC_COD) of tropospheric products */
+    fopt->trpOpt = "";                           /* analysis center (i.e., igs, cod, ...). If 'igs' is set, it will choose the 3rd of 'getObs' for site-specific tropospheric product */
 } /* end of init */
 
 /**
@@ -109,10 +379,58 @@ void PreProcess::init(prcopt_t *popt, ftpopt_t *fopt)
 * @param[O]: popt (processing options)
 * @param[O]: fopt (FTP options, nullptr:NO output)
 * @return  : true:ok, false:error
-* @note    :
+* @note    : the keys listed in 'cfgKeys' may be overridden by the environment
+*            variables 'GOOD_<key>' (i.e., GOOD_obsDir, GOOD_procTime, ...)
 **/
 bool PreProcess::ReadCfgFile(const char *cfgFile, prcopt_t *popt, ftpopt_t *fopt)
 {
+    /* the hour arrays are rebuilt from scratch, so that a configure file can be reloaded */
+    fopt->hhObs.clear();
+    fopt->hhObm.clear();
+    fopt->hhObg.clear();
+    fopt->hhObh.clear();
+    fopt->hhNav.clear();
+    fopt->hhOrbClk.clear();
+    fopt->hhEop.clear();
+
+    /* read the configure file and the files included by it */
+    if (!ReadCfgLines(cfgFile, 0, popt, fopt)) return false;
+
+    /* environment overrides */
+    for (int i = 0; i < NCFGKEY; i++)
+    {
+        if (cfgKeys[i].id == KEY_INCLUDE) continue;
+
+        string env = CFGENVPREFIX + string(cfgKeys[i].name);
+        const char *val = getenv(env.c_str());
+        if (val == nullptr) continue;
+
+        string src = "$" + env;
+        if (!SetCfgOpt(i, val, src.c_str(), 0, popt, fopt)) return false;
+    }
+
+    return true;
+} /* end of ReadCfgFile */
+
+/**
+* @brief   : ReadCfgLines - read the lines of one configure file (or included file)
+* @param[I]: cfgFile (configure file)
+* @param[I]: depth (nesting depth of 'include', 0:top-level file)
+* @param[O]: popt (processing options)
+* @param[O]: fopt (FTP options)
+* @return  : true:ok, false:error
+* @note    : '#' starts a comment line and '%' starts a trailing comment
+**/
+bool PreProcess::ReadCfgLines(const char *cfgFile, int depth, prcopt_t *popt, ftpopt_t *fopt)
+{
+    if (depth > MAXCFGDEPTH)
+    {
+        cerr << "*** ERROR(PreProcess::ReadCfgFile): configure file " << cfgFile << " is included more than " <<
+            MAXCFGDEPTH << " levels deep, please check for recursive 'include'" << endl;
+
+        return false;
+    }
+
     /* open configure file */
     FILE *fp = nullptr;
     if (!(fp = fopen(cfgFile, "r")))
@@ -123,369 +441,640 @@ bool PreProcess::ReadCfgFile(const char *cfgFile, prcopt_t *popt, ftpopt_t *fopt
     }
 
     StringUtil str;
-    TimeUtil tu;
-    char *p, sline[MAXCHARS] = { '\0' }, tmpLine[MAXCHARS] = { '\0' };
-    bool debug = false;
-    int j = 0;
-    gtime_t tt = { 0 };
-    if (debug) cout << "##################### Start of configure file #########################" << endl;
+    char sline[MAXCHARS] = { '\0' }, key[MAXCHARS] = { '\0' }, val[MAXCHARS] = { '\0' };
+    bool stat = true;
+    int line = 0;
     while (fgets(sline, MAXCHARS, fp))
     {
-        if ((sline != nullptr) && (sline[0] == '#')) continue;
+        line++;
+        char *p = strchr(sline, '\n');
+        if (p == nullptr && !feof(fp))
+        {
+            CfgMsg("ERROR", cfgFile, line, "line is longer than " + to_string(MAXCHARS - 1) + " characters");
+            stat = false;
+            break;
+        }
+        if (p) *p = '\0';
+        if ((p = strchr(sline, '\r'))) *p = '\0';
 
-        p = strrchr(sline, '=');
+        /* strip trailing comment and skip comment or blank lines */
+        if ((p = strchr(sline, '%'))) *p = '\0';
+        str.TrimSpace(sline);
+        if (sline[0] == '\0' || sline[0] == '#') continue;
 
-        /* processing directory */
-        if (strstr(sline, "obsDir"))                  /* the directory of IGS RINEX format observation files (short name "d" files) */
+        if (!(p = strchr(sline, '=')))
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->obsDir, tmpLine);
-            if (debug) cout << "* obsDir = " << popt->obsDir << endl;
+            CfgMsg("WARNING", cfgFile, line, "no '=' found, line ignored");
+            continue;
         }
-        else if (strstr(sline, "obmDir"))             /* the directory of MGEX RINEX format observation files (long name "crx" files) */
+        *p = '\0';
+        strcpy(key, sline);
+        strcpy(val, p + 1);
+        str.TrimSpace(key);
+
+        int idx = FindCfgKey(key);
+        if (idx < 0)
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->obmDir, tmpLine);
-            if (debug) cout << "* obmDir = " << popt->obmDir << endl;
+            CfgMsg("WARNING", cfgFile, line, "unknown key '" + string(key) + "', line ignored");
+            continue;
         }
-        else if (strstr(sline, "obcDir"))             /* the directory of Curtin University of Technology (CUT) RINEX format observation files (long name "crx" files) */
+
+        if (cfgKeys[idx].id == KEY_INCLUDE)
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->obcDir, tmpLine);
-            if (debug) cout << "* obcDir = " << popt->obcDir << endl;
+            string incFile = CfgIncPath(cfgFile, CfgTrim(val));
+            if (!ReadCfgLines(incFile.c_str(), depth + 1, popt, fopt))
+            {
+                CfgMsg("ERROR", cfgFile, line, "failed to read included file " + incFile);
+                stat = false;
+                break;
+            }
+            continue;
         }
-        else if (strstr(sline, "obgDir"))             /* the directory of Geoscience Australia (GA) RINEX format observation files (long name "crx" files) */
+
+        if (!SetCfgOpt(idx, val, cfgFile, line, popt, fopt))
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->obgDir, tmpLine);
-            if (debug) cout << "* obgDir = " << popt->obgDir << endl;
+            stat = false;
+            break;
         }
-        else if (strstr(sline, "obhDir"))             /* the directory of Hong Kong CORS RINEX format observation files (long name "crx" files) */
-        {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->obhDir, tmpLine);
-            if (debug) cout << "* obhDir = " << popt->obhDir << endl;
-        }
-        else if (strstr(sline, "navDir"))             /* the directory of RINEX format broadcast ephemeris files */
+    }
+    fclose(fp);
+
+    return stat;
+} /* end of ReadCfgLines */
+
+/**
+* @brief   : SetCfgOpt - validate the value of one configure key and set it into the options
+* @param[I]: idx (index of the key in 'cfgKeys')
+* @param[I]: val (value string, without trailing comment)
+* @param[I]: src (source of the value, i.e., file name or environment variable)
+* @param[I]: line (line number in 'src', 0:not from a file)
+* @param[O]: popt (processing options)
+* @param[O]: fopt (FTP options)
+* @return  : true:ok, false:error
+* @note    :
+**/
+bool PreProcess::SetCfgOpt(int idx, const char *val, const char *src, int line, prcopt_t *popt, ftpopt_t *fopt)
+{
+    const cfgkey_t *key = &cfgKeys[idx];
+    StringUtil str;
+    TimeUtil tu;
+
+    vector<string> fld;
+    SplitCfgFields(val, fld);
+    if ((int)fld.size() < key->nmin)
+    {
+        CfgMsg("ERROR", src, line, "'" + string(key->name) + "' needs at least " + to_string(key->nmin) + " field(s)");
+
+        return false;
+    }
+
+    /* directory keys */
+    if (key->dir)
+    {
+        char tmpLine[MAXCHARS] = { '\0' };
+        str.SetStr(tmpLine, val, MAXSTRPATH - 1);
+        str.TrimSpace(tmpLine);
+        str.CutFilePathSep(tmpLine);
+        popt->*(key->dir) = str.Intern(tmpLine);
+
+        return true;
+    }
+
+    /* the first field of all other keys is an integer */
+    int j = 0;
+    if (!CfgInt(fld[0], key->id == KEY_PROCTIME ? 1 : 0, key->id == KEY_PROCTIME ? 2 : 1, j))
+    {
+        CfgMsg("ERROR", src, line, "invalid value '" + fld[0] + "' of '" + string(key->name) + "', " +
+            (key->id == KEY_PROCTIME ? "1 or 2" : "0 or 1") + " is expected");
+
+        return false;
+    }
+
+    /* (0:off  1:on) switch keys */
+    if (key->flag)
+    {
+        fopt->*(key->flag) = j == 1;
+
+        return true;
+    }
+    if (key->id == KEY_PRODUCT)
+    {
+        fopt->get[key->get] = j == 1;
+
+        return true;
+    }
+
+    /* keys with several fields */
+    int hh = 0, nh = 24;
+    switch (key->id)
+    {
+    case KEY_3PARTYDIR:   /* (optional) the directory where third-party softwares (i.e., 'wget', 'gzip', 'crx2rnx' etc) are stored */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
+            fopt->isPath3party = j == 1;
+            if (fld.size() < 2)
+            {
+                if (fopt->isPath3party)
+                {
+                    CfgMsg("ERROR", src, line, "the directory of third-party softwares is MISSING");
+
+                    return false;
+                }
+                break;
+            }
+
+            char tmpLine[MAXCHARS] = { '\0' };
+            str.SetStr(tmpLine, fld[1].c_str(), MAXSTRPATH - 1);
             str.CutFilePathSep(tmpLine);
-            strcpy(popt->navDir, tmpLine);
-            if (debug) cout << "* navDir = " << popt->navDir << endl;
+            fopt->dir3party = str.Intern(tmpLine);
+
+            string tmpDir = fopt->dir3party;
+            if (access(tmpDir.c_str(), 0) == -1)
+            {
+                /* If the directory does not exist, creat it */
+#ifdef _WIN32   /* for Windows */
+                string cmd = "mkdir " + tmpDir;
+#else           /* for Linux or Mac */
+                string cmd = "mkdir -p " + tmpDir;
+#endif
+                std::system(cmd.c_str());
+            }
         }
-        else if (strstr(sline, "sp3Dir"))             /* the directory of SP3 format precise ephemeris files */
+        break;
+    case KEY_PROCTIME:    /* start time for processing */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->sp3Dir, tmpLine);
-            if (debug) cout << "* sp3Dir = " << popt->sp3Dir << endl;
+            double date[6] = { 0.0 };
+            int nf = j == 1 ? 5 : 4;
+            if ((int)fld.size() < nf)
+            {
+                CfgMsg("ERROR", src, line, "the parameter of number of consecutive days is MISSING, please check it!");
+
+                return false;
+            }
+
+            int year = 0, ndays = 0;
+            bool ok = CfgInt(fld[1], 1980, 2099, year) && CfgInt(fld[nf - 1], 1, 36600, ndays);
+            if (j == 1)
+            {
+                int month = 0, day = 0;
+                ok = ok && CfgInt(fld[2], 1, 12, month) && CfgInt(fld[3], 1, 31, day);
+                date[0] = year;
+                date[1] = month;
+                date[2] = day;
+                if (ok) popt->ts = tu.ymdhms2time(date);
+            }
+            else
+            {
+                int doy = 0;
+                ok = ok && CfgInt(fld[2], 1, 366, doy);
+                if (ok) popt->ts = tu.yrdoy2time(year, doy);
+            }
+            if (!ok)
+            {
+                CfgMsg("ERROR", src, line, "invalid 'procTime' = " + CfgTrim(val) + ", expected '1 yyyy mm dd ndays' or '2 yyyy doy ndays'");
+
+                return false;
+            }
+            popt->ndays = ndays;
+            popt->rangeTs = popt->rangeTe = { 0, 0.0 };
         }
-        else if (strstr(sline, "clkDir"))             /* the directory of RINEX format precise clock files */
+        break;
+    case KEY_PROCRANGE:   /* (0:off  1:on)  start 'yyyy mm dd hh mm ss'  end 'yyyy mm dd hh mm ss' */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->clkDir, tmpLine);
-            if (debug) cout << "* clkDir = " << popt->clkDir << endl;
+            if (j == 0) break;
+
+            gtime_t ts, te;
+            bool ok = fld.size() >= 13;
+            if (ok)
+            {
+                string sTs = fld[1], sTe = fld[7];
+                for (int i = 2; i < 7; i++)
+                {
+                    sTs += " " + fld[i];
+                    sTe += " " + fld[i + 6];
+                }
+                ok = tu.str2time(sTs.c_str(), 0, 32, ts) && tu.str2time(sTe.c_str(), 0, 32, te) &&
+                    tu.TimeDiff(te, ts) > 0.0 && ts.mjd >= 44244;  /* 1980-01-01 */
+            }
+            if (!ok)
+            {
+                CfgMsg("ERROR", src, line, "invalid 'procRange' = " + CfgTrim(val) + ", expected '1 yyyy mm dd hh mm ss  " +
+                    "yyyy mm dd hh mm ss' with the end after the start");
+
+                return false;
+            }
+
+            /* it replaces 'procTime': the days from the one of the start to the one of the end */
+            popt->rangeTs = ts;
+            popt->rangeTe = te;
+            popt->ts = { ts.mjd, 0.0 };
+            popt->ndays = te.mjd - ts.mjd + (te.sod > 0.0 ? 1 : 0);
         }
-        else if (strstr(sline, "eopDir"))             /* the directory of earth rotation parameter files */
+        break;
+    case KEY_FTPDOWNLOADING:  /* the master switch for data downloading; the FTP archive, i.e., CDDIS, IGN, or WHU;
+                                 (optional) the protocol, i.e., ftp, https, or the root URL of an HTTPS mirror */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->eopDir, tmpLine);
-            if (debug) cout << "* eopDir = " << popt->eopDir << endl;
+            fopt->ftpDownloading = j == 1;
+            if (fld.size() < 2)
+            {
+                if (fopt->ftpDownloading)
+                {
+                    CfgMsg("ERROR", src, line, "the FTP archive (CDDIS, IGN, or WHU) is MISSING");
+
+                    return false;
+                }
+                break;
+            }
+
+            FtpUtil ftp;
+            fopt->ftpArc = ftp.FindArc(fld[1].c_str());
+            if (fopt->ftpArc < 0)
+            {
+                CfgMsg("WARNING", src, line, "unknown FTP archive '" + fld[1] + "', CDDIS is used instead");
+                fopt->ftpArc = ARC_CDDIS;
+            }
+            fopt->ftpFrom = str.Intern(fld[1]);
+
+            if (fld.size() < 3 || strcasecmp(fld[2].c_str(), "ftp") == 0) fopt->ftpProto = PROTO_FTP;
+            else if (strcasecmp(fld[2].c_str(), "https") == 0) fopt->ftpProto = PROTO_HTTPS;
+            else if (fld[2].compare(0, 7, "http://") == 0 || fld[2].compare(0, 8, "https://") == 0)
+            {
+                fopt->ftpProto = PROTO_HTTPS;
+                fopt->ftpRoot = str.Intern(fld[2]);
+            }
+            else
+            {
+                CfgMsg("WARNING", src, line, "unknown protocol '" + fld[2] + "', FTP is used instead");
+                fopt->ftpProto = PROTO_FTP;
+            }
         }
-        else if (strstr(sline, "snxDir"))             /* the directory of SINEX format IGS weekly solution files */
+        break;
+    case KEY_GETOBS:      /* IGS observation: (0:off  1:on) type  all/site.list  start-hour  number-of-hours */
+    case KEY_GETOBM:      /* MGEX observation */
+    case KEY_GETOBC:      /* Curtin University of Technology (CUT) observation */
+    case KEY_GETOBG:      /* Geoscience Australia (GA) observation */
+    case KEY_GETOBH:      /* Hong Kong CORS observation */
+    case KEY_GETNAV:      /* broadcast ephemeris: (0:off  1:on) type  system  start-hour  number-of-hours */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->snxDir, tmpLine);
-            if (debug) cout << "* snxDir = " << popt->snxDir << endl;
+            static const cfgname_t obsTyps[] = { { "daily", OBS_DAILY }, { "hourly", OBS_HOURLY },
+                { "highrate", OBS_HIGHRATE }, { nullptr, -1 } };
+            static const cfgname_t obcTyps[] = { { "daily", OBS_DAILY }, { nullptr, -1 } };
+            static const cfgname_t obhTyps[] = { { "30s", OBS_30S }, { "5s", OBS_5S }, { "05s", OBS_5S },
+                { "1s", OBS_1S }, { "01s", OBS_1S }, { nullptr, -1 } };
+            static const cfgname_t navTyps[] = { { "daily", NAV_DAILY }, { "hourly", NAV_HOURLY },
+                { "rtnav", NAV_RTNAV }, { nullptr, -1 } };
+            static const char *navOpts[] = { "gps", "glo", "bds", "gal", "qzs", "irn", "mixed", "all", nullptr };
+
+            int get = key->get;
+            int *typ = nullptr;
+            const char **opt = nullptr;
+            std::vector<int> *hhs = nullptr;
+            const cfgname_t *typs = obsTyps;
+            const char **opts = nullptr;
+            switch (key->id)
+            {
+            case KEY_GETOBS: typ = &fopt->obsTyp; opt = &fopt->obsOpt; hhs = &fopt->hhObs; break;
+            case KEY_GETOBM: typ = &fopt->obmTyp; opt = &fopt->obmOpt; hhs = &fopt->hhObm; break;
+            case KEY_GETOBC: typ = &fopt->obcTyp; opt = &fopt->obcOpt; typs = obcTyps;     break;
+            case KEY_GETOBG: typ = &fopt->obgTyp; opt = &fopt->obgOpt; hhs = &fopt->hhObg; break;
+            case KEY_GETOBH: typ = &fopt->obhTyp; opt = &fopt->obhOpt; hhs = &fopt->hhObh; typs = obhTyps; break;
+            case KEY_GETNAV: typ = &fopt->navTyp; opt = &fopt->navOpt; hhs = &fopt->hhNav; typs = navTyps; opts = navOpts; break;
+            }
+
+            fopt->get[get] = j == 1;
+            if (!fopt->get[get]) break;
+            if (fld.size() < 3)
+            {
+                CfgMsg("ERROR", src, line, "'" + string(key->name) + "' needs at least 3 fields when it is on");
+
+                return false;
+            }
+            int t = CfgFindName(fld[1], typs);
+            if (t < 0)
+            {
+                CfgMsg("ERROR", src, line, "unsupported type '" + fld[1] + "' of '" + string(key->name) + "'");
+
+                return false;
+            }
+            if (opts && !CfgInSet(fld[2], opts))
+            {
+                CfgMsg("ERROR", src, line, "unsupported option '" + fld[2] + "' of '" + string(key->name) + "'");
+
+                return false;
+            }
+            if ((fld.size() > 3 && !CfgInt(fld[3], 0, 23, hh)) || (fld.size() > 4 && !CfgInt(fld[4], 0, 24, nh)))
+            {
+                CfgMsg("ERROR", src, line, "the start hour (0-23) or the number of hours (0-24) of '" +
+                    string(key->name) + "' is invalid");
+
+                return false;
+            }
+            *typ = t;
+            *opt = str.Intern(fld[2]);
+
+            if (hhs)
+            {
+                hhs->clear();
+                int imax = MIN(hh + nh, 24);
+                for (int i = hh; i < imax; i++) hhs->push_back(i);
+            }
         }
-        else if (strstr(sline, "dcbDir"))             /* the directory of CODE and/or MGEX differential code bias (DCB) files */
+        break;
+    case KEY_GETORBCLK:   /* precise orbit and clock: (0:off  1:on) AC  start-hour  number-of-sessions */
+    case KEY_GETEOP:      /* earth rotation parameter: (0:off  1:on) AC  start-hour  number-of-sessions */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->dcbDir, tmpLine);
-            if (debug) cout << "* dcbDir = " << popt->dcbDir << endl;
+            bool isOrbClk = key->id == KEY_GETORBCLK;
+            int get = key->get;
+            const char **ac = isOrbClk ? &fopt->orbClkOpt : &fopt->eopOpt;
+            int *acId = isOrbClk ? &fopt->orbClkAc : &fopt->eopAc;
+            std::vector<int> *hhs = isOrbClk ? &fopt->hhOrbClk : &fopt->hhEop;
+
+            fopt->get[get] = j == 1;
+            if (!fopt->get[get]) break;
+            if (fld.size() < 2)
+            {
+                CfgMsg("ERROR", src, line, "the analysis center of '" + string(key->name) + "' is MISSING");
+
+                return false;
+            }
+            if ((fld.size() > 2 && !CfgInt(fld[2], 0, 23, hh)) || (fld.size() > 3 && !CfgInt(fld[3], 0, 24, nh)))
+            {
+                CfgMsg("ERROR", src, line, "the start hour (0-23) or the number of sessions (0-24) of '" +
+                    string(key->name) + "' is invalid");
+
+                return false;
+            }
+            FtpUtil ftp;
+            *acId = ftp.FindAc(fld[1].c_str());
+            if (*acId < 0 || (!isOrbClk && ftp.IsMgexAc(*acId)))
+            {
+                CfgMsg("ERROR", src, line, "unsupported analysis center '" + fld[1] + "' of '" + string(key->name) + "'");
+
+                return false;
+            }
+            string sac = fld[1];
+            str.ToLower(sac);
+            *ac = str.Intern(sac);
+
+            int step = ftp.UltraStep(*acId);
+            int imax = 24;
+            for (int i = 0; i < imax; i += step)
+            {
+                if (hh > i) hh = i + step;
+                else break;
+            }
+            hhs->clear();
+            imax = MIN(hh + nh * step, 24);
+            for (int i = hh; i < imax; i += step) hhs->push_back(i);
         }
-        else if (strstr(sline, "biaDir"))             /* the directory of CNES real-time phase bias files */
+        break;
+    case KEY_GETION:      /* global ionosphere map (GIM): (0:off  1:on) AC */
+    case KEY_GETTRP:      /* tropospheric product: (0:off  1:on) AC */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->biaDir, tmpLine);
-            if (debug) cout << "* biaDir = " << popt->biaDir << endl;
+            bool isIon = key->id == KEY_GETION;
+            int get = key->get;
+            const char **ac = isIon ? &fopt->ionOpt : &fopt->trpOpt;
+
+            fopt->get[get] = j == 1;
+            if (!fopt->get[get]) break;
+            if (fld.size() < 2)
+            {
+                CfgMsg("ERROR", src, line, "the analysis center of '" + string(key->name) + "' is MISSING");
+
+                return false;
+            }
+            *ac = str.Intern(fld[1]);
+            if (!isIon)
+            {
+                FtpUtil ftp;
+                fopt->trpAc = ftp.FindAc(fld[1].c_str());
+                if (fopt->trpAc != AC_IGS && fopt->trpAc != AC_COD)
+                {
+                    CfgMsg("ERROR", src, line, "unsupported analysis center '" + fld[1] + "' of '" + string(key->name) + "'");
+
+                    return false;
+                }
+            }
         }
-        else if (strstr(sline, "ionDir"))             /* the directory of CODE and/or IGS global ionosphere map (GIM) files */
+        break;
+    case KEY_PRIORITY:    /* (0:off  1:on) priority scheduling; product:class[:deadline-minutes] ... */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->ionDir, tmpLine);
-            if (debug) cout << "* ionDir = " << popt->ionDir << endl;
+            fopt->prioSched = j == 1;
+            for (size_t k = 1; k < fld.size(); k++)
+            {
+                vector<string> sub;
+                size_t ps = 0, pe;
+                while ((pe = fld[k].find(':', ps)) != string::npos)
+                {
+                    sub.push_back(fld[k].substr(ps, pe - ps));
+                    ps = pe + 1;
+                }
+                sub.push_back(fld[k].substr(ps));
+
+                int idxGet = FindCfgKey(sub[0]), cls = 0, ddl = 0;
+                if (idxGet < 0 || cfgKeys[idxGet].get < 0)
+                {
+                    CfgMsg("ERROR", src, line, "unknown product '" + sub[0] + "' of 'priority', i.e., getOrbClk is expected");
+
+                    return false;
+                }
+                if (sub.size() < 2 || sub.size() > 3 || !CfgInt(sub[1], 0, MAXPRIO, cls) ||
+                    (sub.size() == 3 && !CfgInt(sub[2], 0, MAXDEADLINE, ddl)))
+                {
+                    CfgMsg("ERROR", src, line, "invalid value '" + fld[k] + "' of 'priority', product:class[:deadline] " +
+                        "with class 0-" + to_string(MAXPRIO) + " and deadline in minutes is expected");
+
+                    return false;
+                }
+                fopt->prio[cfgKeys[idxGet].get] = cls;
+                fopt->deadline[cfgKeys[idxGet].get] = ddl;
+            }
         }
-        else if (strstr(sline, "ztdDir"))             /* the directory of CODE and/or IGS tropospheric product files */
+        break;
+    case KEY_BANDWIDTH:   /* (0:off  1:on) interactive-KB/s  backfill-KB/s  [backfill-age-days] */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->ztdDir, tmpLine);
-            if (debug) cout << "* ztdDir = " << popt->ztdDir << endl;
+            fopt->bwInter = fopt->bwBack = 0;
+            if (j == 0) break;
+            if (fld.size() < 3)
+            {
+                CfgMsg("ERROR", src, line, "the bandwidth budgets of 'bandwidth' are MISSING");
+
+                return false;
+            }
+            if (!CfgInt(fld[1], 0, MAXBANDWIDTH, fopt->bwInter) || !CfgInt(fld[2], 0, MAXBANDWIDTH, fopt->bwBack))
+            {
+                CfgMsg("ERROR", src, line, "invalid bandwidth budget of 'bandwidth', KB/s (0: unlimited) is expected");
+
+                return false;
+            }
+            if (fld.size() > 3 && !CfgInt(fld[3], 0, 36500, fopt->bwAge))
+            {
+                CfgMsg("ERROR", src, line, "invalid backfill age '" + fld[3] + "' of 'bandwidth', days are expected");
+
+                return false;
+            }
         }
-        else if (strstr(sline, "tblDir"))             /* the directory of table files for processing */
+        break;
+    case KEY_SHARD:       /* (0:off  1:on)  i/K, this process downloads the shard i of the K shards of the jobs */
         {
-            sscanf(p + 1, "%[^%]", tmpLine);          /* %[^%] denotes regular expression, which means that using % as the end sign of the input string */
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(popt->tblDir, tmpLine);
-            if (debug) cout << "* tblDir = " << popt->tblDir << endl;
+            fopt->shardIdx = fopt->shardCnt = 1;
+            if (j == 0) break;
+
+            size_t ipos = fld.size() > 1 ? fld[1].find('/') : string::npos;
+            int idx = 0, cnt = 0;
+            if (ipos == string::npos || !CfgInt(fld[1].substr(0, ipos), 1, MAXSHARD, idx) ||
+                !CfgInt(fld[1].substr(ipos + 1), 1, MAXSHARD, cnt) || idx > cnt)
+            {
+                CfgMsg("ERROR", src, line, "invalid 'shard' = " + CfgTrim(val) + ", expected '1 i/K' with 1 <= i <= K <= " +
+                    to_string(MAXSHARD));
+
+                return false;
+            }
+            fopt->shardIdx = idx;
+            fopt->shardCnt = cnt;
         }
-        else if (strstr(sline, "3partyDir"))          /* (optional) the directory where third-party softwares (i.e., 'wget', 'gzip', 'crx2rnx' etc) are stored. This option is not needed if you have set the path or environment variable for them */
+        break;
+    case KEY_ZSTDSEEK:    /* (0:off  1:on)  [frame-KB]  [level] */
         {
-            sscanf(p + 1, "%d %s", &j, &tmpLine);
-            str.TrimSpace(tmpLine);
-            str.CutFilePathSep(tmpLine);
-            strcpy(fopt->dir3party, tmpLine);
-            fopt->isPath3party = j == 1 ? true : false;
-            if (debug) cout << "* 3partyDir = " << fopt->dir3party << "  " << fopt->isPath3party << endl;
+            fopt->zstdSeek = j == 1;
+            if (fld.size() > 1 && !CfgInt(fld[1], 1, MAXZSTDFRAME, fopt->zstdFrame))
+            {
+                CfgMsg("ERROR", src, line, "invalid frame size '" + fld[1] + "' of 'zstdSeek', KB (1-" +
+                    to_string(MAXZSTDFRAME) + ") is expected");
 
-            string tmpDir = fopt->dir3party;
-            if (access(tmpDir.c_str(), 0) == -1)
+                return false;
+            }
+            if (fld.size() > 2 && !CfgInt(fld[2], 1, 19, fopt->zstdLevel))
             {
-                /* If the directory does not exist, creat it */
-#ifdef _WIN32   /* for Windows */
-                string cmd = "mkdir " + tmpDir;
-#else           /* for Linux or Mac */
-                string cmd = "mkdir -p " + tmpDir;
-#endif
-                std::system(cmd.c_str());
+                CfgMsg("ERROR", src, line, "invalid level '" + fld[2] + "' of 'zstdSeek', 1-19 is expected");
+
+                return false;
             }
         }
+        break;
+    case KEY_SPLICEOBS:   /* (0:off  1:on)  [threads] */
+        {
+            fopt->spliceObs = j == 1;
+            if (fld.size() > 1 && !CfgInt(fld[1], 0, MAXSPLICE, fopt->spliceThreads))
+            {
+                CfgMsg("ERROR", src, line, "invalid number of threads '" + fld[1] + "' of 'spliceObs', 0-" +
+                    to_string(MAXSPLICE) + " is expected");
 
-        /* time settings */
-        else if (strstr(sline, "procTime"))           /* start time for processing */
+                return false;
+            }
+        }
+        break;
+    case KEY_DECIMATE:    /* (0:off  1:on)  interval-s  [systems] */
         {
-            sscanf(p + 1, "%d", &j);
-            if (j == 1)
+            fopt->decimate = 0;
+            fopt->decSys = "";
+            if (j == 0) break;
+            if (fld.size() < 2 || !CfgInt(fld[1], 1, 86400, fopt->decimate))
             {
-                double date[6] = { 0.0 };
-                if (sscanf(p + 1, "%d %lf %lf %lf %d", &j, date + 0, date + 1, date + 2,
-                    &popt->ndays) < 5)
-                {
-                    cerr << "*** ERROR(PreProcess::ReadCfgFile): the parameter of number of consecutive days is MISSING, please check it!" << endl;
-                    
-                    return false;
-                }
-                popt->ts = tu.ymdhms2time(date);
+                CfgMsg("ERROR", src, line, "invalid interval of 'decimate', seconds (1-86400) are expected");
+
+                return false;
             }
-            else if (j == 2)
+            if (fld.size() > 2)
             {
-                double year = 0.0, doy = 0.0;
-                if (sscanf(p + 1, "%d %lf %lf %d", &j, &year, &doy, &popt->ndays) < 4)
+                string sys = fld[2];
+                str.ToUpper(sys);
+                if (sys == "ALL") sys = "";
+                if (sys.find_first_not_of(GNSSSYS) != string::npos)
                 {
-                    cerr << "*** ERROR(PreProcess::ReadCfgFile): the parameter of number of consecutive days is MISSING, please check it!" << endl;
+                    CfgMsg("ERROR", src, line, "invalid systems '" + fld[2] + "' of 'decimate', any of '" +
+                        GNSSSYS + "' or 'all' is expected");
 
                     return false;
-                };
-                int iYear = (int)year, iDoy = (int)doy;
-                popt->ts = tu.yrdoy2time(iYear, iDoy);
+                }
+                fopt->decSys = str.Intern(sys);
             }
-
-            if (debug) cout << "* procTime = " << popt->ts.mjd << "  " << popt->ts.sod << endl;
         }
-
-        /* FTP downloading settings */
-        else if (strstr(sline, "minusAdd1day"))       /* (0:off  1:on) the day before and after the current day for precise satellite orbit and clock products downloading */
+        break;
+    case KEY_FILTEROBS:   /* (0:off  1:on)  systems  [codes] */
         {
-            sscanf(p + 1, "%d", &j);
-            fopt->minusAdd1day = j == 1 ? true : false;
-            if (debug) cout << "* minusAdd1day = " << fopt->minusAdd1day << endl;
-        }
-        else if (strstr(sline, "printInfoWget"))      /* (0:off  1:on) print the information generated by 'wget' */
-        {
-            sscanf(p + 1, "%d", &j);
-            fopt->printInfoWget = j == 1 ? true : false;
-            if (debug) cout << "* printInfoWget = " << fopt->printInfoWget << endl;
-        }
+            /* 'filterObm' is for the product of 'getObm' and so on */
+            int get = cfgKeys[FindCfgKey("get" + string(key->name).substr(6))].get;
+            fopt->fltSys[get] = fopt->fltCodes[get] = "";
+            if (j == 0) break;
+            if (fld.size() < 2)
+            {
+                CfgMsg("ERROR", src, line, "the systems of '" + string(key->name) + "' are MISSING");
 
-        /* handling of FTP downloading */
-        else if (strstr(sline, "ftpDownloading"))     /* the master switch for data downloading (0:off  1:on, only for data downloading); the FTP archive, i.e., CDDIS, IGN */
-        {
-            sscanf(p + 1, "%d %s", &j, &fopt->ftpFrom);
-            fopt->ftpDownloading = j == 1 ? true : false;
-            if (debug) cout << "* ftpDownloading = " << fopt->ftpDownloading << "  " << fopt->ftpFrom << endl;
+                return false;
+            }
+            string sys = fld[1];
+            str.ToUpper(sys);
+            if (sys == "ALL") sys = "";
+            if (sys.find_first_not_of(GNSSSYS) != string::npos)
+            {
+                CfgMsg("ERROR", src, line, "invalid systems '" + fld[1] + "' of '" + key->name + "', any of '" +
+                    GNSSSYS + "' or 'all' is expected");
 
-            if (fopt->ftpDownloading)
+                return false;
+            }
+            fopt->fltSys[get] = str.Intern(sys);
+            if (fld.size() > 2)
             {
-                int hh = 0, nh = 0, step = 1;
-                while (fgets(sline, MAXCHARS, fp))
+                /* observation codes of RINEX 3 (i.e., C1C) or RINEX 2 (i.e., P2), '*' and '?' are allowed */
+                string codes = fld[2];
+                str.ToUpper(codes);
+                if (codes == "ALL") codes = "";
+                if (codes.find_first_not_of("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789*?,") != string::npos)
                 {
-                    if ((sline != nullptr) && (sline[0] == '#')) continue;
-                    p = strrchr(sline, '=');
-
-                    if (strstr(sline, "getObs"))      /* (0:off  1:on) IGS observation (RINEX version 2.xx, short name 'd') */
-                    {
-                        sscanf(p + 1, "%d %s %s %d %d", &j, &fopt->obsTyp, &fopt->obsOpt, &hh, &nh);
-                        fopt->getObs = j == 1 ? true : false;
-                        if (debug) cout << "* getObs = " << fopt->getObs << "  " << fopt->obsTyp << "  " << fopt->obsOpt << endl;
-                        
-                        int imax = MIN(hh + nh, 24);
-                        for (int i = hh; i < imax; i++) fopt->hhObs.push_back(i);
-                    }
-                    else if (strstr(sline, "getObm")) /* (0:off  1:on) MGEX observation (RINEX version 3.xx, long name 'crx') */
-                    {
-                        sscanf(p + 1, "%d %s %s %d %d", &j, &fopt->obmTyp, &fopt->obmOpt, &hh, &nh);
-                        fopt->getObm = j == 1 ? true : false;
-                        if (debug) cout << "* getObm = " << fopt->getObm << "  " << fopt->obmTyp << "  " << fopt->obmOpt << endl;
-
-                        int imax = MIN(hh + nh, 24);
-                        for (int i = hh; i < imax; i++) fopt->hhObm.push_back(i);
-                    }
-                    else if (strstr(sline, "getObc")) /* (0:off  1:on) Curtin University of Technology (CUT) observation (RINEX version 3.xx, long name 'crx') */
-                    {
-                        sscanf(p + 1, "%d %s %s %d %d", &j, &fopt->obcTyp, &fopt->obcOpt, &hh, &nh);
-                        fopt->getObc = j == 1 ? true : false;
-                        if (debug) cout << "* getObc = " << fopt->getObc << "  " << fopt->obcTyp << "  " << fopt->obcOpt << endl;
-                    }
-                    else if (strstr(sline, "getObg")) /* (0:off  1:on) Geoscience Australia (GA) observation (RINEX version 3.xx, long name 'crx') */
-                    {
-                        sscanf(p + 1, "%d %s %s %d %d", &j, &fopt->obgTyp, &fopt->obgOpt, &hh, &nh);
-                        fopt->getObg = j == 1 ? true : false;
-                        if (debug) cout << "* getObg = " << fopt->getObg << "  " << fopt->obgTyp << "  " << fopt->obgOpt << endl;
-
-                        int imax = MIN(hh + nh, 24);
-                        for (int i = hh; i < imax; i++) fopt->hhObg.push_back(i);
-                    }
-                    else if (strstr(sline, "getObh")) /* (0:off  1:on) Hong Kong CORS observation (RINEX version 3.xx, long name 'crx') */
-                    {
-                        sscanf(p + 1, "%d %s %s %d %d", &j, &fopt->obhTyp, &fopt->obhOpt, &hh, &nh);
-                        fopt->getObh = j == 1 ? true : false;
-                        if (debug) cout << "* getObh = " << fopt->getObh << "  " << fopt->obhTyp << "  " << fopt->obhOpt << endl;
-
-                        int imax = MIN(hh + nh, 24);
-                        for (int i = hh; i < imax; i++) fopt->hhObh.push_back(i);
-                    }
-                    else if (strstr(sline, "getNav")) /* (0:off  1:on) broadcast ephemeris */
-                    {
-                        sscanf(p + 1, "%d %s %s %d %d", &j, &fopt->navTyp, &fopt->navOpt, &hh, &nh);
-                        fopt->getNav = j == 1 ? true : false;
-                        if (debug) cout << "* getNav = " << fopt->getNav << "  " << fopt->navTyp << "  " << fopt->navOpt << endl;
-
-                        int imax = MIN(hh + nh, 24);
-                        for (int i = hh; i < imax; i += step) fopt->hhNav.push_back(i);
-                    }
-                    else if (strstr(sline, "getOrbClk"))   /* (0:off  1:on) precise orbit and clock */
-                    {
-                        sscanf(p + 1, "%d %s %d %d", &j, &fopt->orbClkOpt, &hh, &nh);
-                        fopt->getOrbClk = j == 1 ? true : false;
-                        if (debug) cout << "* getOrbClk = " << fopt->getOrbClk << "  " << fopt->orbClkOpt << endl;
-
-                        if (strcmp(fopt->orbClkOpt, "igu") == 0) step = 6;
-                        else if (strcmp(fopt->orbClkOpt, "gfu") == 0) step = 3;
-                        else if (strcmp(fopt->orbClkOpt, "wuu") == 0) step = 1;
-                        else step = 24;
-                        int imax = 24;
-                        for (int i = 0; i < imax; i += step)
-                        {
-                            if (hh > i) hh = i + step;
-                            else break;
-                        }
-                        imax = MIN(hh + nh * step, 24);
-                        for (int i = hh; i < imax; i += step) fopt->hhOrbClk.push_back(i);
-                    }
-                    else if (strstr(sline, "getEop")) /* (0:off  1:on) earth rotation parameter */
-                    {
-                        sscanf(p + 1, "%d %s %d %d", &j, &fopt->eopOpt, &hh, &nh);
-                        fopt->getEop = j == 1 ? true : false;
-                        if (debug) cout << "* getEop = " << fopt->getEop << "  " << fopt->eopOpt << endl;
-
-                        if (strcmp(fopt->eopOpt, "igu") == 0) step = 6;
-                        else if (strcmp(fopt->eopOpt, "gfu") == 0) step = 3;
-                        else step = 24;
-                        int imax = 24;
-                        for (int i = 0; i < imax; i += step)
-                        {
-                            if (hh > i) hh = i + step;
-                            else break;
-                        }
-                        imax = MIN(hh + nh * step, 24);
-                        for (int i = hh; i < imax; i += step) fopt->hhEop.push_back(i);
-                    }
-                    else if (strstr(sline, "getSnx")) /* (0:off  1:on) IGS weekly SINEX */
-                    {
-                        sscanf(p + 1, "%d", &j);
-                        fopt->getSnx = j == 1 ? true : false;
-                        if (debug) cout << "* getSnx = " << fopt->getSnx << endl;
-                    }
-                    else if (strstr(sline, "getDcb")) /* (0:off  1:on) CODE and/or MGEX differential code bias (DCB) */
-                    {
-                        sscanf(p + 1, "%d", &j);
-                        fopt->getDcb = j == 1 ? true : false;
-                        if (debug) cout << "* getDcb = " << fopt->getDcb << endl;
-                    }
-                    else if (strstr(sline, "getIon")) /* (0:off  1:on) CODE and/or IGS global ionosphere map (GIM) */
-                    {
-                        sscanf(p + 1, "%d %s", &j, &fopt->ionOpt);
-                        fopt->getIon = j == 1 ? true : false;
-                        if (debug) cout << "* getIon = " << fopt->getIon << "  " << fopt->ionOpt << endl;
-                    }
-                    else if (strstr(sline, "getRoti"))/* (0:off  1:on) Rate of TEC index (ROTI) */
-                    {
-                        sscanf(p + 1, "%d", &j);
-                        fopt->getRoti = j == 1 ? true : false;
-                        if (debug) cout << "* getRoti = " << fopt->getRoti << endl;
-                    }
-                    else if (strstr(sline, "getTrp")) /* (0:off  1:on) CODE and/or IGS tropospheric product */
-                    {
-                        sscanf(p + 1, "%d %s", &j, &fopt->trpOpt);
-                        fopt->getTrp = j == 1 ? true : false;
-                        if (debug) cout << "* getTrp = " << fopt->getTrp << "  " << fopt->trpOpt << endl;
-                    }
-                    else if (strstr(sline, "getRtOrbClk")) /* (0:off  1:on) real-time precise orbit and clock products from CNES offline files */
-                    {
-                        sscanf(p + 1, "%d", &j);
-                        fopt->getRtOrbClk = j == 1 ? true : false;
-                        if (debug) cout << "* getRtOrbClk = " << fopt->getRtOrbClk << endl;
-                    }
-                    else if (strstr(sline, "getRtBias"))   /* (0:off  1:on) real-time code and phase bias products from CNES offline files */
-                    {
-                        sscanf(p + 1, "%d", &j);
-                        fopt->getRtBias = j == 1 ? true : false;
-                        if (debug) cout << "* getRtBias = " << fopt->getRtBias << endl;
-                    }
-                    else if (strstr(sline, "getAtx")) /* (0:off  1:on) ANTEX format antenna phase center correction */
-                    {
-                        sscanf(p + 1, "%d", &j);
-                        fopt->getAtx = j == 1 ? true : false;
-                        if (debug) cout << "* getAtx = " << fopt->getAtx << endl;
-                        break;
-                    }
+                    CfgMsg("ERROR", src, line, "invalid codes '" + fld[2] + "' of '" + key->name +
+                        "', a comma separated list (i.e., C1C,L1C,C2W,L2W) or 'all' is expected");
+
+                    return false;
                 }
+                fopt->fltCodes[get] = str.Intern(codes);
             }
         }
-    }
-    fclose(fp);
+        break;
+    case KEY_VALIDATE:    /* (0:off  1:on)  [retries]  [threads] */
+        {
+            fopt->validate = j == 1;
+            if (fld.size() > 1 && !CfgInt(fld[1], 0, MAXREQUEUE, fopt->validRetry))
+            {
+                CfgMsg("ERROR", src, line, "invalid number of retries '" + fld[1] + "' of 'validate', 0-" +
+                    to_string(MAXREQUEUE) + " is expected");
+
+                return false;
+            }
+            if (fld.size() > 2 && !CfgInt(fld[2], 0, MAXVALIDATE, fopt->validThreads))
+            {
+                CfgMsg("ERROR", src, line, "invalid number of threads '" + fld[2] + "' of 'validate', 0-" +
+                    to_string(MAXVALIDATE) + " is expected");
 
-    if (debug) cout << "##################### End of configure file ###########################" << endl;
+                return false;
+            }
+        }
+        break;
+    }
 
     return true;
-} /* end of ReadCfgFile */
+} /* end of SetCfgOpt */
+
+/**
+* @brief   : SetOpt - set one option by the key and value as in configure file
+* @param[I]: key (key name, i.e., obsDir, procTime, getObs, ...)
+* @param[I]: val (value string)
+* @param[O]: popt (processing options)
+* @param[O]: fopt (FTP options)
+* @return  : true:ok, false:error
+* @note    : 'include' is not supported here
+**/
+bool PreProcess::SetOpt(const char *key, const char *val, prcopt_t *popt, ftpopt_t *fopt)
+{
+    int idx = FindCfgKey(key);
+    if (idx < 0 || cfgKeys[idx].id == KEY_INCLUDE)
+    {
+        cerr << "*** ERROR(PreProcess::SetOpt): unknown key '" << key << "'" << endl;
+
+        return false;
+    }
+
+    return SetCfgOpt(idx, val, key, 0, popt, fopt);
+} /* end of SetOpt */
 
 /**
 * @brief   : run - start iPPP-RTK processing
@@ -502,186 +1091,265 @@ void PreProcess::run(const char *cfgFile)
     init(&popt, &fopt);
 
     /* read configure file to get processing information */
-    ReadCfgFile(cfgFile, &popt, &fopt);
+    if (!ReadCfgFile(cfgFile, &popt, &fopt)) return;
 
     /* data downloading for GNSS further processing */
-    if (fopt.ftpDownloading)
+    if (fopt.ftpDownloading) Download(&popt, &fopt);
+} /* end of run */
+
+/**
+* @brief   : Download - data downloading day by day, or by priority classes of the products over all the days
+* @param[I]: prcopt (processing options)
+* @param[I]: ftpopt (FTP options)
+* @param[O]: none
+* @return  : true:all the requested files are downloaded (or have existed), false:some of them failed
+* @note    : the directories and start time are changed day by day, so the copies of options are used;
+*            with 'priority' on, the jobs (one product for one day) are taken from a priority queue, so
+*            that the small and time-critical products never wait behind the bulk observation
+**/
+bool PreProcess::Download(const prcopt_t *prcopt, const ftpopt_t *ftpopt)
+{
+    prcopt_t popt = *prcopt;
+    ftpopt_t fopt = *ftpopt;
+    FtpUtil ftp;
+    TimeUtil tu;
+    StringUtil str;
+    string obsDirMain = popt.obsDir;
+    string obmDirMain = popt.obmDir;
+    string obcDirMain = popt.obcDir;
+    string obgDirMain = popt.obgDir;
+    string obhDirMain = popt.obhDir;
+    string navDirMain = popt.navDir;
+    string ztdDirMain = popt.ztdDir;
+    vector<prcopt_t> days;  /* the options of each day for priority scheduling, the dry run or the merge of the shards */
+    unordered_set<string> dayDirs;  /* the directories of the days, which 'popt' and 'days' point to until the end */
+    auto dayDir = [&dayDirs](const char *dir) { return dayDirs.insert(dir).first->c_str(); };
+    for (int i = 0; i < popt.ndays; i++)
     {
-        FtpUtil ftp;
-        TimeUtil tu;
-        StringUtil str;
-        string obsDirMain = popt.obsDir;
-        string obmDirMain = popt.obmDir;
-        string obcDirMain = popt.obcDir;
-        string obgDirMain = popt.obgDir;
-        string obhDirMain = popt.obhDir;
-        string navDirMain = popt.navDir;
-        string ztdDirMain = popt.ztdDir;
-        for (int i = 0; i < popt.ndays; i++)
+        int yyyy, doy;
+        tu.time2yrdoy(popt.ts, &yyyy, &doy);
+        string sYyyy = str.yyyy2str(yyyy);
+        string sDoy = str.doy2str(doy);
+
+        /* creat new IGS observation sub-directory */
+        if (fopt.get[GET_OBS])
         {
-            int yyyy, doy;
-            tu.time2yrdoy(popt.ts, &yyyy, &doy);
-            string sYyyy = str.yyyy2str(yyyy);
-            string sDoy = str.doy2str(doy);
-
-            /* creat new IGS observation sub-directory */
-            if (fopt.getObs)
-            {
-                char dir[MAXSTRPATH] = { '\0' };
-                char sep = (char)FILEPATHSEP;
-                sprintf(dir, "%s%c%s%c%s", obsDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
-                str.TrimSpace(dir);
-                str.CutFilePathSep(dir);
-                strcpy(popt.obsDir, dir);
-                string tmpDir = dir;
-                if (access(tmpDir.c_str(), 0) == -1)
-                {
-                    /* If the directory does not exist, creat it */
+            char dir[MAXSTRPATH] = { '\0' };
+            char sep = (char)FILEPATHSEP;
+            sprintf(dir, "%s%c%s%c%s", obsDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
+            str.TrimSpace(dir);
+            str.CutFilePathSep(dir);
+            popt.obsDir = dayDir(dir);
+            string tmpDir = dir;
+            if (!fopt.plan && !fopt.merge && access(tmpDir.c_str(), 0) == -1)
+            {
+                /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                    string cmd = "mkdir " + tmpDir;
+                string cmd = "mkdir " + tmpDir;
 #else           /* for Linux or Mac */
-                    string cmd = "mkdir -p " + tmpDir;
+                string cmd = "mkdir -p " + tmpDir;
 #endif
-                    std::system(cmd.c_str());
-                }
+                std::system(cmd.c_str());
             }
+        }
 
-            /* creat new MGEX observation sub-directory */
-            if (fopt.getObm)
+        /* creat new MGEX observation sub-directory */
+        if (fopt.get[GET_OBM])
+        {
+            char dir[MAXSTRPATH] = { '\0' };
+            char sep = (char)FILEPATHSEP;
+            sprintf(dir, "%s%c%s%c%s", obmDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
+            str.TrimSpace(dir);
+            str.CutFilePathSep(dir);
+            popt.obmDir = dayDir(dir);
+            string tmpDir = dir;
+            if (!fopt.plan && !fopt.merge && access(tmpDir.c_str(), 0) == -1)
             {
-                char dir[MAXSTRPATH] = { '\0' };
-                char sep = (char)FILEPATHSEP;
-                sprintf(dir, "%s%c%s%c%s", obmDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
-                str.TrimSpace(dir);
-                str.CutFilePathSep(dir);
-                strcpy(popt.obmDir, dir);
-                string tmpDir = dir;
-                if (access(tmpDir.c_str(), 0) == -1)
-                {
-                    /* If the directory does not exist, creat it */
+                /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                    string cmd = "mkdir " + tmpDir;
+                string cmd = "mkdir " + tmpDir;
 #else           /* for Linux or Mac */
-                    string cmd = "mkdir -p " + tmpDir;
+                string cmd = "mkdir -p " + tmpDir;
 #endif
-                    std::system(cmd.c_str());
-                }
+                std::system(cmd.c_str());
             }
+        }
 
-            /* creat new Curtin University of Technology (CUT) observation sub-directory */
-            if (fopt.getObc)
+        /* creat new Curtin University of Technology (CUT) observation sub-directory */
+        if (fopt.get[GET_OBC])
+        {
+            char dir[MAXSTRPATH] = { '\0' };
+            char sep = (char)FILEPATHSEP;
+            sprintf(dir, "%s%c%s%c%s", obcDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
+            str.TrimSpace(dir);
+            str.CutFilePathSep(dir);
+            popt.obcDir = dayDir(dir);
+            string tmpDir = dir;
+            if (!fopt.plan && !fopt.merge && access(tmpDir.c_str(), 0) == -1)
             {
-                char dir[MAXSTRPATH] = { '\0' };
-                char sep = (char)FILEPATHSEP;
-                sprintf(dir, "%s%c%s%c%s", obcDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
-                str.TrimSpace(dir);
-                str.CutFilePathSep(dir);
-                strcpy(popt.obcDir, dir);
-                string tmpDir = dir;
-                if (access(tmpDir.c_str(), 0) == -1)
-                {
-                    /* If the directory does not exist, creat it */
+                /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                    string cmd = "mkdir " + tmpDir;
+                string cmd = "mkdir " + tmpDir;
 #else           /* for Linux or Mac */
-                    string cmd = "mkdir -p " + tmpDir;
+                string cmd = "mkdir -p " + tmpDir;
 #endif
-                    std::system(cmd.c_str());
-                }
+                std::system(cmd.c_str());
             }
+        }
 
-            /* creat new Geoscience Australia (GA) observation sub-directory */
-            if (fopt.getObg)
+        /* creat new Geoscience Australia (GA) observation sub-directory */
+        if (fopt.get[GET_OBG])
+        {
+            char dir[MAXSTRPATH] = { '\0' };
+            char sep = (char)FILEPATHSEP;
+            sprintf(dir, "%s%c%s%c%s", obgDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
+            str.TrimSpace(dir);
+            str.CutFilePathSep(dir);
+            popt.obgDir = dayDir(dir);
+            string tmpDir = dir;
+            if (!fopt.plan && !fopt.merge && access(tmpDir.c_str(), 0) == -1)
             {
-                char dir[MAXSTRPATH] = { '\0' };
-                char sep = (char)FILEPATHSEP;
-                sprintf(dir, "%s%c%s%c%s", obgDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
-                str.TrimSpace(dir);
-                str.CutFilePathSep(dir);
-                strcpy(popt.obgDir, dir);
-                string tmpDir = dir;
-                if (access(tmpDir.c_str(), 0) == -1)
-                {
-                    /* If the directory does not exist, creat it */
+                /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                    string cmd = "mkdir " + tmpDir;
+                string cmd = "mkdir " + tmpDir;
 #else           /* for Linux or Mac */
-                    string cmd = "mkdir -p " + tmpDir;
+                string cmd = "mkdir -p " + tmpDir;
 #endif
-                    std::system(cmd.c_str());
-                }
+                std::system(cmd.c_str());
             }
+        }
 
-            /* creat new Hong Kong CORS observation sub-directory */
-            if (fopt.getObh)
+        /* creat new Hong Kong CORS observation sub-directory */
+        if (fopt.get[GET_OBH])
+        {
+            char dir[MAXSTRPATH] = { '\0' };
+            char sep = (char)FILEPATHSEP;
+            sprintf(dir, "%s%c%s%c%s", obhDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
+            str.TrimSpace(dir);
+            str.CutFilePathSep(dir);
+            popt.obhDir = dayDir(dir);
+            string tmpDir = dir;
+            if (!fopt.plan && !fopt.merge && access(tmpDir.c_str(), 0) == -1)
             {
-                char dir[MAXSTRPATH] = { '\0' };
-                char sep = (char)FILEPATHSEP;
-                sprintf(dir, "%s%c%s%c%s", obhDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
-                str.TrimSpace(dir);
-                str.CutFilePathSep(dir);
-                strcpy(popt.obhDir, dir);
-                string tmpDir = dir;
-                if (access(tmpDir.c_str(), 0) == -1)
-                {
-                    /* If the directory does not exist, creat it */
+                /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                    string cmd = "mkdir " + tmpDir;
+                string cmd = "mkdir " + tmpDir;
 #else           /* for Linux or Mac */
-                    string cmd = "mkdir -p " + tmpDir;
+                string cmd = "mkdir -p " + tmpDir;
 #endif
-                    std::system(cmd.c_str());
-                }
+                std::system(cmd.c_str());
             }
+        }
 
-            /* creat new NAV sub-directory */
-            if (fopt.getNav)
+        /* creat new NAV sub-directory */
+        if (fopt.get[GET_NAV])
+        {
+            char dir[MAXSTRPATH] = { '\0' };
+            char sep = (char)FILEPATHSEP;
+            sprintf(dir, "%s%c%s%c%s", navDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
+            str.TrimSpace(dir);
+            str.CutFilePathSep(dir);
+            popt.navDir = dayDir(dir);
+            string tmpDir = dir;
+            if (!fopt.plan && !fopt.merge && access(tmpDir.c_str(), 0) == -1)
             {
-                char dir[MAXSTRPATH] = { '\0' };
-                char sep = (char)FILEPATHSEP;
-                sprintf(dir, "%s%c%s%c%s", navDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
-                str.TrimSpace(dir);
-                str.CutFilePathSep(dir);
-                strcpy(popt.navDir, dir);
-                string tmpDir = dir;
-                if (access(tmpDir.c_str(), 0) == -1)
-                {
-                    /* If the directory does not exist, creat it */
+                /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                    string cmd = "mkdir " + tmpDir;
+                string cmd = "mkdir " + tmpDir;
 #else           /* for Linux or Mac */
-                    string cmd = "mkdir -p " + tmpDir;
+                string cmd = "mkdir -p " + tmpDir;
 #endif
-                    std::system(cmd.c_str());
-                }
+                std::system(cmd.c_str());
             }
+        }
 
-            /* creat new ZTD sub-directory */
-            if (fopt.getTrp)
+        /* creat new ZTD sub-directory */
+        if (fopt.get[GET_TRP])
+        {
+            char dir[MAXSTRPATH] = { '\0' };
+            char sep = (char)FILEPATHSEP;
+            sprintf(dir, "%s%c%s%c%s", ztdDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
+            str.TrimSpace(dir);
+            str.CutFilePathSep(dir);
+            popt.ztdDir = dayDir(dir);
+            string tmpDir = dir;
+            if (!fopt.plan && !fopt.merge && access(tmpDir.c_str(), 0) == -1)
             {
-                char dir[MAXSTRPATH] = { '\0' };
-                char sep = (char)FILEPATHSEP;
-                sprintf(dir, "%s%c%s%c%s", ztdDirMain.c_str(), sep, sYyyy.c_str(), sep, sDoy.c_str());
-                str.TrimSpace(dir);
-                str.CutFilePathSep(dir);
-                strcpy(popt.ztdDir, dir);
-                string tmpDir = dir;
-                if (access(tmpDir.c_str(), 0) == -1)
-                {
-                    /* If the directory does not exist, creat it */
+                /* If the directory does not exist, creat it */
 #ifdef _WIN32   /* for Windows */
-                    string cmd = "mkdir " + tmpDir;
+                string cmd = "mkdir " + tmpDir;
 #else           /* for Linux or Mac */
-                    string cmd = "mkdir -p " + tmpDir;
+                string cmd = "mkdir -p " + tmpDir;
 #endif
-                    std::system(cmd.c_str());
-                }
+                std::system(cmd.c_str());
             }
+        }
+
+        /* the main entry of FTP downloader */
+        if (fopt.prioSched || fopt.plan || fopt.merge) days.push_back(popt);
+        else ftp.FtpDownload(&popt, &fopt);
+
+        popt.ts = tu.TimeAdd(popt.ts, 86400.0);
+    }
 
-            /* the main entry of FTP downloader */
-            ftp.FtpDownload(&popt, &fopt);
+    /* a dry run expands and costs the jobs of all the days, nothing is downloaded */
+    if (fopt.plan)
+    {
+        ftp.FtpPlan(days, &fopt);
+
+        return true;
+    }
 
-            popt.ts = tu.TimeAdd(popt.ts, 86400.0);
+    /* the catalogs and inventories of the shards are merged once all of them have finished, nothing is downloaded */
+    if (fopt.merge)
+    {
+        ftp.FtpMerge(days, &fopt);
+
+        return true;
+    }
+    if (!fopt.prioSched) return ftp.FailedFiles() == 0;
+
+    /* the job queue over all the days */
+    priority_queue<ftpjob_t> jobs;
+    for (size_t i = 0; i < days.size(); i++)
+    {
+        for (int get = 0; get < NGET; get++)
+        {
+            if (!fopt.get[get]) continue;
+            ftpjob_t job = { fopt.prio[get], fopt.deadline[get], (int)i, get };
+            jobs.push(job);
         }
     }
-} /* end of run */
\ No newline at end of file
+
+    ftp.FtpInit(&fopt);
+    auto t0 = chrono::steady_clock::now();
+    while (!jobs.empty())
+    {
+        ftpjob_t job = jobs.top();
+        jobs.pop();
+        ftp.FtpGet(&days[job.day], &fopt, job.get);
+
+        /* the files quarantined by the validation are downloaded again, the job keeps its place in the queue */
+        if (ftp.IsRequeued())
+        {
+            int yyyy, doy;
+            tu.time2yrdoy(days[job.day].ts, &yyyy, &doy);
+            cout << "*** INFO(PreProcess::Download): '" << GetKeyName(job.get) << "' of " << str.yyyy2str(yyyy) <<
+                "/" << str.doy2str(doy) << " is re-queued for its quarantined files" << endl;
+            jobs.push(job);
+        }
+
+        /* the deadline is a hint, a late job is reported but not cancelled */
+        double mins = chrono::duration<double>(chrono::steady_clock::now() - t0).count() / 60.0;
+        if (job.deadline > 0 && mins > job.deadline)
+        {
+            int yyyy, doy;
+            tu.time2yrdoy(days[job.day].ts, &yyyy, &doy);
+            cout << "*** WARNING(PreProcess::Download): '" << GetKeyName(job.get) << "' of " << str.yyyy2str(yyyy) <<
+                "/" << str.doy2str(doy) << " finished at " << fixed << setprecision(1) << mins <<
+                " minutes, later than its deadline of " << job.deadline << " minutes" << endl;
+        }
+    }
+
+    return ftp.FailedFiles() == 0;
+} /* end of Download */
\ No newline at end of file
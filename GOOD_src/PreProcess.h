@@ -8,23 +8,38 @@ class PreProcess
 private:
 
     /**
-    * @brief   : init - some initializations before processing
+    * @brief   : ReadCfgFile - read configure file to get processing options
+    * @param[I]: cfgFile (configure file)
     * @param[O]: popt (processing options)
     * @param[O]: fopt (FTP options, nullptr:NO output)
-    * @return  : none
-    * @note    :
+    * @return  : true:ok, false:error
+    * @note    : the keys may be overridden by the environment variables 'GOOD_<key>'
     **/
-    void init(prcopt_t *popt, ftpopt_t *fopt);
+    bool ReadCfgFile(const char *cfgFile, prcopt_t *popt, ftpopt_t *fopt);
 
     /**
-    * @brief   : ReadCfgFile - read configure file to get processing options
+    * @brief   : ReadCfgLines - read the lines of one configure file (or included file)
     * @param[I]: cfgFile (configure file)
+    * @param[I]: depth (nesting depth of 'include', 0:top-level file)
     * @param[O]: popt (processing options)
-    * @param[O]: fopt (FTP options, nullptr:NO output)
+    * @param[O]: fopt (FTP options)
     * @return  : true:ok, false:error
     * @note    :
     **/
-    bool ReadCfgFile(const char *cfgFile, prcopt_t *popt, ftpopt_t *fopt);
+    bool ReadCfgLines(const char *cfgFile, int depth, prcopt_t *popt, ftpopt_t *fopt);
+
+    /**
+    * @brief   : SetCfgOpt - validate the value of one configure key and set it into the options
+    * @param[I]: idx (index of the key in configure key table)
+    * @param[I]: val (value string, without trailing comment)
+    * @param[I]: src (source of the value, i.e., file name or environment variable)
+    * @param[I]: line (line number in 'src', 0:not from a file)
+    * @param[O]: popt (processing options)
+    * @param[O]: fopt (FTP options)
+    * @return  : true:ok, false:error
+    * @note    :
+    **/
+    bool SetCfgOpt(int idx, const char *val, const char *src, int line, prcopt_t *popt, ftpopt_t *fopt);
 
 public:
     PreProcess()
@@ -44,4 +59,35 @@ public:
     * @note    :
     **/
     void run(const char *cfgFile);
+
+    /**
+    * @brief   : init - some initializations before processing
+    * @param[O]: popt (processing options)
+    * @param[O]: fopt (FTP options, nullptr:NO output)
+    * @return  : none
+    * @note    :
+    **/
+    void init(prcopt_t *popt, ftpopt_t *fopt);
+
+    /**
+    * @brief   : SetOpt - set one option by the key and value as in configure file
+    * @param[I]: key (key name, i.e., obsDir, procTime, getObs, ...)
+    * @param[I]: val (value string)
+    * @param[O]: popt (processing options)
+    * @param[O]: fopt (FTP options)
+    * @return  : true:ok, false:error
+    * @note    : 'include' is not supported here
+    **/
+    bool SetOpt(const char *key, const char *val, prcopt_t *popt, ftpopt_t *fopt);
+
+    /**
+    * @brief   : Download - data downloading day by day, or by priority classes of the products over all the days
+    * @param[I]: prcopt (processing options)
+    * @param[I]: ftpopt (FTP options)
+    * @param[O]: none
+    * @return  : true:all the requested files are downloaded (or have existed), false:some of them failed
+    * @note    : with 'priority' on, the jobs (one product for one day) are taken from a priority queue, so
+    *            that the small and time-critical products never wait behind the bulk observation
+    **/
+    bool Download(const prcopt_t *prcopt, const ftpopt_t *ftpopt);
 };
\ No newline at end of file
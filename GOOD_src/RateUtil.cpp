@@ -0,0 +1,195 @@
+/*------------------------------------------------------------------------------
+* RateUtil.cpp : adaptive download concurrency of the hosts
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "RateUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define HOSTFILE   ".good_hosts"     /* name of the host rate file */
+#define INITCONC   2                 /* initial concurrency of an unknown host */
+#define MAXCONC    16                /* maximum concurrency of one host */
+#define MINSECS    2.0               /* minimum wall-clock time (s) of a batch to measure the throughput */
+#define RATEGAIN   0.05              /* relative throughput gain that counts as an improvement */
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Read - read the entries of the host rate file
+* @param[I]: none
+* @param[O]: none
+* @return  : true:ok, false:the file does not exist
+* @note    :
+**/
+bool RateUtil::Read()
+{
+    StringUtil str;
+    std::vector<string> lines;
+    if (!str.ReadLines(_file, lines)) return false;
+
+    /* one entry per line: host  concurrency  throughput */
+    for (const string &line : lines)
+    {
+        istringstream iss(line);
+        hostrate_t ent;
+        if (!(iss >> ent.host >> ent.conc >> ent.rate)) continue;
+        if (ent.conc < 1) ent.conc = 1;
+        else if (ent.conc > MAXCONC) ent.conc = MAXCONC;
+        _ents[ent.host] = ent;
+    }
+
+    return true;
+} /* end of Read */
+
+/**
+* @brief   : Load - load the learned concurrency of the hosts
+* @param[I]: dir (the directory where the host rate file is stored)
+* @param[O]: none
+* @return  : true:ok, false:the file does not exist (the initial concurrency is used)
+* @note    : the learned concurrency is stored in the hidden file '.good_hosts' of the directory
+**/
+bool RateUtil::Load(const string &dir)
+{
+    _ents.clear();
+    _chg.clear();
+    _file = dir.empty() ? string(HOSTFILE) : dir + FILEPATHSEP + HOSTFILE;
+
+    return Read();
+} /* end of Load */
+
+/**
+* @brief   : Save - save the learned concurrency to the file it was loaded from
+* @param[I]: none
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the file is read again under its lock ('.good_hosts.lock') and only the hosts reported by this
+*            process replace the ones on disk, so the processes sharing the file never undo the learning
+*            of each other
+**/
+bool RateUtil::Save()
+{
+    if (_file.empty()) return false;
+    if (_chg.empty()) return true;
+
+    LockUtil lock;
+    auto merge = [this, &lock]() { lock.Overlay(_ents, _chg, [this]() { Read(); }); };
+    auto text = [this]() {
+        ostringstream hostFile;
+        hostFile << "# host  concurrency  throughput(bytes/s)" << endl;
+        for (auto &it : _ents)
+        {
+            const hostrate_t &ent = it.second;
+            hostFile << ent.host << "  " << ent.conc << "  " << fixed << setprecision(0) << ent.rate << endl;
+        }
+
+        return hostFile.str();
+    };
+    if (!lock.SaveTable(_file, merge, text))
+    {
+        cerr << "*** ERROR(RateUtil::Save): write host rate file " << _file << " FAILED!" << endl;
+
+        return false;
+    }
+
+    return true;
+} /* end of Save */
+
+/**
+* @brief   : Host - get the host name of a URL
+* @param[I]: url (i.e., 'ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily')
+* @param[O]: none
+* @return  : the host name (i.e., 'gdc.cddis.eosdis.nasa.gov'), including the port if any
+* @note    :
+**/
+string RateUtil::Host(const string &url)
+{
+    size_t pos = url.find("://");
+    pos = pos == string::npos ? 0 : pos + 3;
+    size_t end = url.find('/', pos);
+
+    return url.substr(pos, end == string::npos ? string::npos : end - pos);
+} /* end of Host */
+
+/**
+* @brief   : Conc - get the current concurrency of a host
+* @param[I]: host (host name)
+* @param[O]: none
+* @return  : number of concurrent sessions or streams
+* @note    :
+**/
+int RateUtil::Conc(const string &host)
+{
+    auto it = _ents.find(host);
+
+    return it == _ents.end() ? INITCONC : it->second.conc;
+} /* end of Conc */
+
+/**
+* @brief   : Rate - get the aggregate throughput of a host measured at the last adjustment
+* @param[I]: host (host name)
+* @param[O]: none
+* @return  : throughput in bytes/s, 0 if unknown
+* @note    :
+**/
+double RateUtil::Rate(const string &host)
+{
+    auto it = _ents.find(host);
+
+    return it == _ents.end() ? 0.0 : it->second.rate;
+} /* end of Rate */
+
+/**
+* @brief   : Report - adjust the concurrency of a host by the result of one batch (AIMD)
+* @param[I]: host (host name)
+* @param[I]: used (number of sessions or streams actually used by the batch)
+* @param[I]: bytes (bytes downloaded by the batch)
+* @param[I]: secs (wall-clock time of the batch in seconds)
+* @param[I]: err (true if the batch met errors, i.e., refused logins, 421/550 replies, or timeouts)
+* @param[O]: none
+* @return  : the new concurrency of the host
+* @note    : the concurrency is increased by one while the aggregate throughput keeps improving,
+*            decreased by one on a plateau, and halved on errors
+**/
+int RateUtil::Report(const string &host, int used, long long bytes, double secs, bool err)
+{
+    auto it = _ents.find(host);
+    if (it == _ents.end())
+    {
+        hostrate_t ent = { host, INITCONC, 0.0 };
+        it = _ents.insert(make_pair(host, ent)).first;
+    }
+    hostrate_t &ent = it->second;
+    _chg.insert(host);
+
+    /* multiplicative decrease on errors, the throughput is measured again from there */
+    if (err)
+    {
+        ent.conc = ent.conc > 1 ? ent.conc / 2 : 1;
+        ent.rate = 0.0;
+
+        return ent.conc;
+    }
+
+    /* the sample says nothing about the limit if the limit was not reached or the batch was too short */
+    if (used < ent.conc || bytes <= 0 || secs < MINSECS) return ent.conc;
+
+    double rate = bytes / secs;
+    if (ent.rate <= 0.0 || rate > ent.rate * (1.0 + RATEGAIN))
+    {
+        /* additive increase while the aggregate throughput keeps improving */
+        if (ent.conc < MAXCONC) ent.conc++;
+    }
+    else if (ent.conc > 1) ent.conc--;  /* plateau: more sessions only add load on the server */
+    ent.rate = rate;
+
+    return ent.conc;
+} /* end of Report */
\ No newline at end of file
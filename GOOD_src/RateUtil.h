@@ -0,0 +1,92 @@
+/*------------------------------------------------------------------------------
+* RateUtil.h : header file of RateUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class RateUtil
+{
+private:
+    string _file;                                   /* full path of the host rate file */
+    std::unordered_map<string, hostrate_t> _ents;   /* learned concurrency indexed by host name */
+    std::unordered_set<string> _chg;                /* hosts reported since 'Load', the others are read again by 'Save' */
+
+    /**
+    * @brief   : Read - read the entries of the host rate file
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:ok, false:the file does not exist
+    * @note    :
+    **/
+    bool Read();
+
+public:
+    RateUtil()
+	{
+
+	}
+	~RateUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Load - load the learned concurrency of the hosts
+    * @param[I]: dir (the directory where the host rate file is stored)
+    * @param[O]: none
+    * @return  : true:ok, false:the file does not exist (the initial concurrency is used)
+    * @note    : the learned concurrency is stored in the hidden file '.good_hosts' of the directory
+    **/
+    bool Load(const string &dir);
+
+    /**
+    * @brief   : Save - save the learned concurrency to the file it was loaded from
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the file is read again under its lock ('.good_hosts.lock') and only the hosts reported by this
+    *            process replace the ones on disk, so the processes sharing the file never undo the learning
+    *            of each other
+    **/
+    bool Save();
+
+    /**
+    * @brief   : Host - get the host name of a URL
+    * @param[I]: url (i.e., 'ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily')
+    * @param[O]: none
+    * @return  : the host name (i.e., 'gdc.cddis.eosdis.nasa.gov'), including the port if any
+    * @note    :
+    **/
+    string Host(const string &url);
+
+    /**
+    * @brief   : Conc - get the current concurrency of a host
+    * @param[I]: host (host name)
+    * @param[O]: none
+    * @return  : number of concurrent sessions or streams
+    * @note    :
+    **/
+    int Conc(const string &host);
+
+    /**
+    * @brief   : Rate - get the aggregate throughput of a host measured at the last adjustment
+    * @param[I]: host (host name)
+    * @param[O]: none
+    * @return  : throughput in bytes/s, 0 if unknown
+    * @note    :
+    **/
+    double Rate(const string &host);
+
+    /**
+    * @brief   : Report - adjust the concurrency of a host by the result of one batch (AIMD)
+    * @param[I]: host (host name)
+    * @param[I]: used (number of sessions or streams actually used by the batch)
+    * @param[I]: bytes (bytes downloaded by the batch)
+    * @param[I]: secs (wall-clock time of the batch in seconds)
+    * @param[I]: err (true if the batch met errors, i.e., refused logins, 421/550 replies, or timeouts)
+    * @param[O]: none
+    * @return  : the new concurrency of the host
+    * @note    : the concurrency is increased by one while the aggregate throughput keeps improving,
+    *            decreased by one on a plateau, and halved on errors
+    **/
+    int Report(const string &host, int used, long long bytes, double secs, bool err);
+};
\ No newline at end of file
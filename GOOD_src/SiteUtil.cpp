@@ -0,0 +1,362 @@
+/*------------------------------------------------------------------------------
+* SiteUtil.cpp : selection of the sites of observation downloading by names, patterns, networks and regions
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*    [1] T. Takasu, RTKLIB: An Open Source Program Package for GNSS Positioning, 2013
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "SiteUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define SEL_NAME     0               /* site name, i.e., 'abmf' */
+#define SEL_PATTERN  1               /* wildcard pattern of the site names, i.e., 'alg*' */
+#define SEL_NET      2               /* network, i.e., '@igs' */
+#define SEL_BOX      3               /* bounding box, i.e., 'box 30 60 -10 40' */
+
+#define PI           3.1415926535897932  /* pi */
+#define RE_WGS84     6378137.0           /* earth semimajor axis (WGS84) (m) */
+#define FE_WGS84     (1.0 / 298.257223563)  /* earth flattening (WGS84) */
+
+static const char *netNames[] = { "igs", "mgex", "euref" };  /* networks of the selector '@' */
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* the site name in lower case */
+static string LowerName(const string &name)
+{
+    string low = name;
+    for (char &c : low) c = (char)tolower((unsigned char)c);
+
+    return low;
+}
+
+/* degrees of a SINEX angle 'DDD MM SS.S' (the sign may be on a zero degree, i.e., ' -0 30 12.0') */
+static bool SinexAngle(const string &fld, double &deg)
+{
+    int d, m;
+    double s;
+    if (sscanf(fld.c_str(), "%d %d %lf", &d, &m, &s) != 3) return false;
+    deg = abs(d) + m / 60.0 + s / 3600.0;
+    if (fld.find('-') != string::npos) deg = -deg;
+
+    return true;
+}
+
+/* latitude and longitude (deg) of an ECEF position (see ecef2pos of RTKLIB) */
+static void Ecef2LatLon(const double pos[3], double &lat, double &lon)
+{
+    double e2 = FE_WGS84 * (2.0 - FE_WGS84), r2 = pos[0] * pos[0] + pos[1] * pos[1];
+    double z = pos[2], zk = 0.0, v = RE_WGS84, sinp = 0.0;
+    for (int i = 0; i < 20 && fabs(z - zk) >= 1E-4; i++)
+    {
+        zk = z;
+        sinp = z / sqrt(r2 + z * z);
+        v = RE_WGS84 / sqrt(1.0 - e2 * sinp * sinp);
+        z = pos[2] + v * e2 * sinp;
+    }
+    lat = (r2 > 1E-12 ? atan(z / sqrt(r2)) : (pos[2] > 0.0 ? PI / 2.0 : -PI / 2.0)) * 180.0 / PI;
+    lon = (r2 > 1E-12 ? atan2(pos[1], pos[0]) : 0.0) * 180.0 / PI;
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : Parse - parse the lines of the site list into selectors
+* @param[I]: lines (lines of 'site.list' or the in-memory site list)
+* @param[O]: none
+* @return  : number of selectors
+* @note    : one selector per line, with the head and tail spaces and the comment after '#' skipped:
+*            'abmf' (site name), 'alg*' (wildcard pattern), '@igs', '@mgex', '@euref' (network),
+*            'box lat1 lat2 lon1 lon2' (bounding box in degrees); a leading '-' excludes the sites selected.
+*            A network only selects the sites, their files are taken from the archive being used
+**/
+int SiteUtil::Parse(const std::vector<string> &lines)
+{
+    _sels.clear();
+    _cands.clear();
+    _candSet.clear();
+    _nets.clear();
+    _pos.clear();
+
+    for (const string &line : lines)
+    {
+        string text = line.substr(0, line.find('#'));
+        istringstream iss(text);
+        std::vector<string> fld;
+        string f;
+        while (iss >> f) fld.push_back(f);
+        if (fld.empty()) continue;
+
+        sitesel_t sel;
+        sel.exclude = fld[0][0] == '-';
+        if (sel.exclude) fld[0].erase(0, 1);
+        if (fld[0].empty() && fld.size() > 1) fld.erase(fld.begin());  /* '- abmf' */
+        for (int i = 0; i < 4; i++) sel.box[i] = 0.0;
+
+        if (LowerName(fld[0]) == "box")
+        {
+            sel.type = SEL_BOX;
+            sel.text = "box";
+            bool ok = fld.size() == 5;
+            for (int i = 0; ok && i < 4; i++)
+            {
+                char *end = nullptr;
+                sel.box[i] = strtod(fld[i + 1].c_str(), &end);
+                ok = *end == '\0';
+            }
+            if (!ok || sel.box[0] > sel.box[1] || fabs(sel.box[0]) > 90.0 || fabs(sel.box[1]) > 90.0 ||
+                fabs(sel.box[2]) > 180.0 || fabs(sel.box[3]) > 180.0)
+            {
+                cout << "*** WARNING(SiteUtil::Parse): invalid bounding box '" << text <<
+                    "', it should be 'box lat1 lat2 lon1 lon2' in degrees" << endl;
+                continue;
+            }
+        }
+        else if (fld.size() > 1 || fld[0].empty())
+        {
+            cout << "*** WARNING(SiteUtil::Parse): invalid selector '" << text << "', one site name, pattern or " <<
+                "network per line" << endl;
+            continue;
+        }
+        else if (fld[0][0] == '@')
+        {
+            sel.type = SEL_NET;
+            sel.text = LowerName(fld[0].substr(1));
+            bool known = false;
+            for (const char *net : netNames) known = known || sel.text == net;
+            if (!known)
+            {
+                cout << "*** WARNING(SiteUtil::Parse): unknown network '" << fld[0] << "', it should be '@igs', " <<
+                    "'@mgex' or '@euref'" << endl;
+                continue;
+            }
+        }
+        else if (fld[0].find_first_of("*?") != string::npos)
+        {
+            sel.type = SEL_PATTERN;
+            sel.text = LowerName(fld[0]);
+        }
+        else
+        {
+            sel.type = SEL_NAME;
+            sel.text = fld[0];
+        }
+        _sels.push_back(sel);
+    }
+
+    return (int)_sels.size();
+} /* end of Parse */
+
+/**
+* @brief   : Networks - get the networks whose sites are needed to resolve the selectors
+* @param[I]: none
+* @param[O]: nets (networks, i.e., 'igs')
+* @return  : none
+* @note    : the patterns and the bounding boxes are matched against the IGS and MGEX networks if no
+*            network is given in the site list
+**/
+void SiteUtil::Networks(std::vector<string> &nets)
+{
+    nets.clear();
+    bool needCand = false;
+    for (const sitesel_t &sel : _sels)
+    {
+        if (sel.type == SEL_PATTERN || sel.type == SEL_BOX) needCand = true;
+        if (sel.type == SEL_NET && std::find(nets.begin(), nets.end(), sel.text) == nets.end()) nets.push_back(sel.text);
+    }
+    if (needCand && nets.empty())
+    {
+        nets.push_back("igs");
+        nets.push_back("mgex");
+    }
+} /* end of Networks */
+
+/**
+* @brief   : HasBox - whether a bounding box is used
+* @param[I]: none
+* @param[O]: none
+* @return  : true:used, false:not used
+* @note    :
+**/
+bool SiteUtil::HasBox()
+{
+    for (const sitesel_t &sel : _sels)
+    {
+        if (sel.type == SEL_BOX) return true;
+    }
+
+    return false;
+} /* end of HasBox */
+
+/**
+* @brief   : AddCand - add one candidate site
+* @param[I]: site (site name in lower case)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void SiteUtil::AddCand(const string &site)
+{
+    if (_candSet.insert(site).second) _cands.push_back(site);
+} /* end of AddCand */
+
+/**
+* @brief   : AddNetwork - add the sites of one network, taken from the remote listing
+* @param[I]: net (network, i.e., 'igs')
+* @param[I]: sites (site names)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void SiteUtil::AddNetwork(const string &net, const std::vector<string> &sites)
+{
+    std::unordered_set<string> &netSites = _nets[LowerName(net)];
+    for (const string &site : sites)
+    {
+        string low = LowerName(site);
+        if (netSites.insert(low).second) AddCand(low);
+    }
+} /* end of AddNetwork */
+
+/**
+* @brief   : AddSinex - add the positions of the sites in the SITE/ID block of a SINEX file
+* @param[I]: file (SINEX file, i.e., the IGS station SINEX 'igs_with_former.snx')
+* @param[O]: none
+* @return  : number of the sites added, -1:the file cannot be opened
+* @note    : the sites become candidates of the patterns and the bounding boxes
+**/
+int SiteUtil::AddSinex(const string &file)
+{
+    ifstream snxFile(file.c_str());
+    if (!snxFile.is_open()) return -1;
+
+    /* ' CODE PT __DOMES__ T _STATION DESCRIPTION__ _LONGITUDE_ _LATITUDE__ HEIGHT_', the longitude is east 0-360 */
+    int n = 0;
+    bool inBlock = false;
+    string line;
+    while (getline(snxFile, line))
+    {
+        if (line.compare(0, 8, "+SITE/ID") == 0) inBlock = true;
+        else if (line.compare(0, 8, "-SITE/ID") == 0) break;
+        else if (inBlock && line.size() >= 67 && line[0] == ' ')
+        {
+            double lat, lon;
+            if (!SinexAngle(line.substr(44, 11), lon) || !SinexAngle(line.substr(56, 11), lat)) continue;
+            if (lon > 180.0) lon -= 360.0;
+            string low = LowerName(line.substr(1, 4));
+            _pos[low] = std::make_pair(lat, lon);
+            AddCand(low);
+            n++;
+        }
+    }
+    snxFile.close();
+
+    return n;
+} /* end of AddSinex */
+
+/**
+* @brief   : AddPosition - add the position of one site
+* @param[I]: site (site name)
+* @param[I]: pos (ECEF position (m), i.e., 'APPROX POSITION XYZ' of the inventory)
+* @param[O]: none
+* @return  : none
+* @note    : the site becomes a candidate of the patterns and the bounding boxes
+**/
+void SiteUtil::AddPosition(const string &site, const double pos[3])
+{
+    if (pos[0] * pos[0] + pos[1] * pos[1] + pos[2] * pos[2] < 1E6) return;  /* unknown */
+
+    string low = LowerName(site);
+    double lat, lon;
+    Ecef2LatLon(pos, lat, lon);
+    _pos[low] = std::make_pair(lat, lon);
+    AddCand(low);
+} /* end of AddPosition */
+
+/**
+* @brief   : IsSelected - whether a candidate site is selected by one selector
+* @param[I]: sel (selector)
+* @param[I]: site (site name in lower case)
+* @param[O]: none
+* @return  : true:selected, false:not selected
+* @note    :
+**/
+bool SiteUtil::IsSelected(const sitesel_t &sel, const string &site)
+{
+    if (sel.type == SEL_NAME) return LowerName(sel.text) == site;
+    if (sel.type == SEL_PATTERN)
+    {
+        StringUtil str;
+
+        return str.WildMatch(sel.text.c_str(), site.c_str());
+    }
+    if (sel.type == SEL_NET)
+    {
+        auto it = _nets.find(sel.text);
+
+        return it != _nets.end() && it->second.count(site) > 0;
+    }
+
+    /* a longitude range with lon1 > lon2 crosses the 180 degree meridian */
+    auto it = _pos.find(site);
+    if (it == _pos.end()) return false;
+    double lat = it->second.first, lon = it->second.second;
+    if (lat < sel.box[0] || lat > sel.box[1]) return false;
+    if (sel.box[2] <= sel.box[3]) return lon >= sel.box[2] && lon <= sel.box[3];
+
+    return lon >= sel.box[2] || lon <= sel.box[3];
+} /* end of IsSelected */
+
+/**
+* @brief   : Resolve - resolve the selectors into the site names
+* @param[I]: none
+* @param[O]: sites (site names without duplicates, in the order they are first selected)
+* @return  : none
+* @note    : a site is kept if it is selected by any selector without '-' and by none with '-'; the site
+*            names are compared case-insensitively, a name given as it is keeps its case
+**/
+void SiteUtil::Resolve(std::vector<string> &sites)
+{
+    sites.clear();
+    std::unordered_set<string> seen;
+    for (const sitesel_t &sel : _sels)
+    {
+        if (sel.exclude) continue;
+
+        /* a site name is taken even if it is in no listing, i.e., a site of GA or HK CORS */
+        std::vector<string> picks;
+        if (sel.type == SEL_NAME) picks.push_back(sel.text);
+        else
+        {
+            for (const string &cand : _cands)
+            {
+                if (IsSelected(sel, cand)) picks.push_back(cand);
+            }
+        }
+
+        for (const string &pick : picks)
+        {
+            string low = LowerName(pick);
+            if (seen.count(low) > 0) continue;
+            bool excluded = false;
+            for (const sitesel_t &exc : _sels)
+            {
+                if (exc.exclude && IsSelected(exc, low))
+                {
+                    excluded = true;
+                    break;
+                }
+            }
+            seen.insert(low);
+            if (!excluded) sites.push_back(pick);
+        }
+    }
+} /* end of Resolve */
\ No newline at end of file
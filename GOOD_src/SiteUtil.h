@@ -0,0 +1,113 @@
+/*------------------------------------------------------------------------------
+* SiteUtil.h : header file of SiteUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class SiteUtil
+{
+private:
+    std::vector<sitesel_t> _sels;                   /* selectors in the order of the site list */
+    std::vector<string> _cands;                     /* candidate sites (lower case) in the order they are added */
+    std::unordered_set<string> _candSet;            /* candidate sites for the lookup */
+    std::unordered_map<string, std::unordered_set<string> > _nets;  /* sites of each network */
+    std::unordered_map<string, std::pair<double, double> > _pos;    /* latitude and longitude (deg) of the sites */
+
+    /**
+    * @brief   : AddCand - add one candidate site
+    * @param[I]: site (site name in lower case)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void AddCand(const string &site);
+
+    /**
+    * @brief   : IsSelected - whether a candidate site is selected by one selector
+    * @param[I]: sel (selector)
+    * @param[I]: site (site name in lower case)
+    * @param[O]: none
+    * @return  : true:selected, false:not selected
+    * @note    :
+    **/
+    bool IsSelected(const sitesel_t &sel, const string &site);
+
+public:
+    SiteUtil()
+	{
+
+	}
+	~SiteUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Parse - parse the lines of the site list into selectors
+    * @param[I]: lines (lines of 'site.list' or the in-memory site list)
+    * @param[O]: none
+    * @return  : number of selectors
+    * @note    : one selector per line, with the head and tail spaces and the comment after '#' skipped:
+    *            'abmf' (site name), 'alg*' (wildcard pattern), '@igs', '@mgex', '@euref' (network),
+    *            'box lat1 lat2 lon1 lon2' (bounding box in degrees); a leading '-' excludes the sites selected.
+    *            A network only selects the sites, their files are taken from the archive being used
+    **/
+    int Parse(const std::vector<string> &lines);
+
+    /**
+    * @brief   : Networks - get the networks whose sites are needed to resolve the selectors
+    * @param[I]: none
+    * @param[O]: nets (networks, i.e., 'igs')
+    * @return  : none
+    * @note    : the patterns and the bounding boxes are matched against the IGS and MGEX networks if no
+    *            network is given in the site list
+    **/
+    void Networks(std::vector<string> &nets);
+
+    /**
+    * @brief   : HasBox - whether a bounding box is used
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : true:used, false:not used
+    * @note    :
+    **/
+    bool HasBox();
+
+    /**
+    * @brief   : AddNetwork - add the sites of one network, taken from the remote listing
+    * @param[I]: net (network, i.e., 'igs')
+    * @param[I]: sites (site names)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void AddNetwork(const string &net, const std::vector<string> &sites);
+
+    /**
+    * @brief   : AddSinex - add the positions of the sites in the SITE/ID block of a SINEX file
+    * @param[I]: file (SINEX file, i.e., the IGS station SINEX 'igs_with_former.snx')
+    * @param[O]: none
+    * @return  : number of the sites added, -1:the file cannot be opened
+    * @note    : the sites become candidates of the patterns and the bounding boxes
+    **/
+    int AddSinex(const string &file);
+
+    /**
+    * @brief   : AddPosition - add the position of one site
+    * @param[I]: site (site name)
+    * @param[I]: pos (ECEF position (m), i.e., 'APPROX POSITION XYZ' of the inventory)
+    * @param[O]: none
+    * @return  : none
+    * @note    : the site becomes a candidate of the patterns and the bounding boxes
+    **/
+    void AddPosition(const string &site, const double pos[3]);
+
+    /**
+    * @brief   : Resolve - resolve the selectors into the site names
+    * @param[I]: none
+    * @param[O]: sites (site names without duplicates, in the order they are first selected)
+    * @return  : none
+    * @note    : a site is kept if it is selected by any selector without '-' and by none with '-'; the site
+    *            names are compared case-insensitively, a name given as it is keeps its case
+    **/
+    void Resolve(std::vector<string> &sites);
+};
\ No newline at end of file
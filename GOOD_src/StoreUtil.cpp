@@ -0,0 +1,423 @@
+/*------------------------------------------------------------------------------
+* StoreUtil.cpp : content-addressed store of the products shared by the projects
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*    [1] NIST FIPS 180-4, Secure Hash Standard (SHS), 2015
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "StoreUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define OBJDIR     "objects"         /* sub-directory of the blobs */
+#define REFDIR     "refs"            /* sub-directory of the product names */
+#define LOCKDIR    "locks"           /* sub-directory of the lock files */
+
+static const uint32_t sha256K[64] = {  /* round constants of SHA-256 */
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* rotate right of a 32-bit word */
+static inline uint32_t Rotr(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+/* SHA-256 compression of one 64-byte block */
+static void Sha256Block(uint32_t h[8], const unsigned char *blk)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = ((uint32_t)blk[4 * i] << 24) | ((uint32_t)blk[4 * i + 1] << 16) |
+            ((uint32_t)blk[4 * i + 2] << 8) | (uint32_t)blk[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t t1 = k + (Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25)) + ((e & f) ^ (~e & g)) + sha256K[i] + w[i];
+        uint32_t t2 = (Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        k = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+}
+
+/* create a directory (the parent must exist), an existing directory is not an error */
+static void MakeDir(const string &dir)
+{
+#ifdef _WIN32   /* for Windows */
+    _mkdir(dir.c_str());
+#else           /* for Linux or Mac */
+    mkdir(dir.c_str(), 0777);
+#endif
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : RefFile - get the full path of the reference file of a product name
+* @param[I]: name (product file name, i.e., 'igs14.atx')
+* @param[O]: none
+* @return  : the full path of the reference file
+* @note    :
+**/
+string StoreUtil::RefFile(const string &name)
+{
+    return RefDir() + FILEPATHSEP + name;
+} /* end of RefFile */
+
+/**
+* @brief   : BlobFile - get the full path of the blob of a content hash
+* @param[I]: hash (SHA-256 of the content in hex)
+* @param[O]: none
+* @return  : the full path of the blob file
+* @note    :
+**/
+string StoreUtil::BlobFile(const string &hash)
+{
+    return _root + FILEPATHSEP + OBJDIR + FILEPATHSEP + hash.substr(0, 2) + FILEPATHSEP + hash;
+} /* end of BlobFile */
+
+/**
+* @brief   : ReadRef - get the content hash that a product name refers to
+* @param[I]: name (product file name)
+* @param[O]: hash (SHA-256 of the content in hex)
+* @return  : true:found, false:not in the store
+* @note    :
+**/
+bool StoreUtil::ReadRef(const string &name, string &hash)
+{
+    hash = "";
+    if (_root.empty()) return false;
+
+    ifstream refFile(RefFile(name).c_str());
+    if (!refFile.is_open()) return false;
+    refFile >> hash;
+    refFile.close();
+
+    return hash.size() == 64;
+} /* end of ReadRef */
+
+/**
+* @brief   : LinkFile - hard link a file to a new name, or copy it if the link is not possible
+* @param[I]: src (source file)
+* @param[I]: dst (destination file, it must not exist)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the copy is used across file systems or on file systems without hard links
+**/
+bool StoreUtil::LinkFile(const string &src, const string &dst)
+{
+#ifdef _WIN32   /* for Windows */
+    if (CreateHardLinkA(dst.c_str(), src.c_str(), NULL)) return true;
+#else           /* for Linux or Mac */
+    if (link(src.c_str(), dst.c_str()) == 0) return true;
+#endif
+
+    ifstream in(src.c_str(), ios::binary);
+    ofstream out(dst.c_str(), ios::binary);
+    if (!in.is_open() || !out.is_open()) return false;
+    out << in.rdbuf();
+    out.close();
+    if (!out)
+    {
+        remove(dst.c_str());
+
+        return false;
+    }
+
+    return true;
+} /* end of LinkFile */
+
+/**
+* @brief   : Open - open (and create if needed) the content-addressed store
+* @param[I]: root (root directory of the store, full path)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the blobs are stored in 'root/objects/xx/<SHA-256>', the product names in 'root/refs/<scope>/<name>'
+*            and the lock files in 'root/locks/<scope>'
+**/
+bool StoreUtil::Open(const string &root)
+{
+    _root = "";
+    _scope = "";
+    if (root.empty()) return false;
+
+    if (access(root.c_str(), 0) == -1)
+    {
+#ifdef _WIN32   /* for Windows */
+        string cmd = "mkdir " + root;
+#else           /* for Linux or Mac */
+        string cmd = "mkdir -p " + root;
+#endif
+        std::system(cmd.c_str());
+    }
+    MakeDir(root + FILEPATHSEP + OBJDIR);
+    MakeDir(root + FILEPATHSEP + REFDIR);
+    MakeDir(root + FILEPATHSEP + LOCKDIR);
+    if (access((root + FILEPATHSEP + REFDIR).c_str(), 0) == -1)
+    {
+        cerr << "*** ERROR(StoreUtil::Open): failed to create the store " << root << endl;
+
+        return false;
+    }
+    _root = root;
+
+    return true;
+} /* end of Open */
+
+/**
+* @brief   : Scope - set the scope of the product names of the current product
+* @param[I]: scope (components separated by '/', i.e., 'obs/gdc.cddis.eosdis.nasa.gov/1a2b3c4d')
+* @param[O]: none
+* @return  : none
+* @note    : the same file name is a different product in another scope, i.e., the daily observation file
+*            'abmf0320.21o' of IGS and of MGEX, or of two conversion filters
+**/
+void StoreUtil::Scope(const string &scope)
+{
+    _scope = "";
+    string refDir = _root + FILEPATHSEP + REFDIR, lockDir = _root + FILEPATHSEP + LOCKDIR;
+    size_t ipos = 0;
+    while (ipos < scope.size())
+    {
+        size_t jpos = scope.find('/', ipos);
+        if (jpos == string::npos) jpos = scope.size();
+        string part = scope.substr(ipos, jpos - ipos);
+        ipos = jpos + 1;
+        if (part.empty() || part == "." || part == "..") continue;
+
+        _scope += (_scope.empty() ? "" : string(1, (char)FILEPATHSEP)) + part;
+        refDir += FILEPATHSEP + part;
+        lockDir += FILEPATHSEP + part;
+        if (!_root.empty())
+        {
+            MakeDir(refDir);
+            MakeDir(lockDir);
+        }
+    }
+} /* end of Scope */
+
+/**
+* @brief   : RefDir - get the directory of the product names of the current scope
+* @param[I]: none
+* @param[O]: none
+* @return  : the full path of the directory, where the catalog of the scope is kept as well
+* @note    :
+**/
+string StoreUtil::RefDir()
+{
+    return _root + FILEPATHSEP + REFDIR + (_scope.empty() ? "" : FILEPATHSEP + _scope);
+} /* end of RefDir */
+
+/**
+* @brief   : Root - get the root directory of the opened store
+* @param[I]: none
+* @param[O]: none
+* @return  : the root directory, "" if no store is opened
+* @note    :
+**/
+string StoreUtil::Root()
+{
+    return _root;
+} /* end of Root */
+
+/**
+* @brief   : LockFile - get the full path of the lock file of a name in the store
+* @param[I]: name (product file name, or the name of a file shared by the processes like '.good_catalog')
+* @param[O]: none
+* @return  : the full path of the lock file
+* @note    :
+**/
+string StoreUtil::LockFile(const string &name)
+{
+    return _root + FILEPATHSEP + LOCKDIR + (_scope.empty() ? "" : FILEPATHSEP + _scope) + FILEPATHSEP + name + ".lock";
+} /* end of LockFile */
+
+/**
+* @brief   : Link - link the stored version of a product into the current directory
+* @param[I]: name (product file name, also the local file name)
+* @param[O]: none
+* @return  : true:linked, false:the product is not in the store
+* @note    :
+**/
+bool StoreUtil::Link(const string &name)
+{
+    string hash;
+    if (!ReadRef(name, hash)) return false;
+    string blob = BlobFile(hash);
+    if (access(blob.c_str(), 0) == -1) return false;
+
+    StringUtil str;
+    string tmpFile = str.TmpName(name);
+    remove(tmpFile.c_str());
+    if (!LinkFile(blob, tmpFile)) return false;
+    remove(name.c_str());
+    if (rename(tmpFile.c_str(), name.c_str()) != 0)
+    {
+        remove(tmpFile.c_str());
+
+        return false;
+    }
+
+    return true;
+} /* end of Link */
+
+/**
+* @brief   : Put - put a local file into the store and replace it by a link to the blob
+* @param[I]: name (product file name in the current directory)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : a file that is already linked to the blob of its name is not hashed again
+**/
+bool StoreUtil::Put(const string &name)
+{
+    if (_root.empty() || access(name.c_str(), 0) == -1) return false;
+    if (IsLinked(name)) return true;
+
+    StringUtil str;
+    string hash;
+    if (!HashFile(name, hash)) return false;
+    string blob = BlobFile(hash);
+    if (access(blob.c_str(), 0) == -1)
+    {
+        /* a new content: the local file becomes the blob (a temporary name keeps the blob complete when it appears) */
+        MakeDir(_root + FILEPATHSEP + OBJDIR + FILEPATHSEP + hash.substr(0, 2));
+        string tmpBlob = str.TmpName(blob);
+        remove(tmpBlob.c_str());
+        if (!LinkFile(name, tmpBlob) || rename(tmpBlob.c_str(), blob.c_str()) != 0)
+        {
+            cerr << "*** ERROR(StoreUtil::Put): failed to store " << name << " in " << _root << endl;
+            remove(tmpBlob.c_str());
+
+            return false;
+        }
+    }
+    else
+    {
+        /* the same content is stored already: the local copy is replaced by a link to the blob */
+        string tmpFile = str.TmpName(name);
+        remove(tmpFile.c_str());
+        if (LinkFile(blob, tmpFile))
+        {
+            remove(name.c_str());
+            rename(tmpFile.c_str(), name.c_str());
+        }
+    }
+
+    /* the name refers to the latest content */
+    return str.WriteFile(RefFile(name), hash + "\n");
+} /* end of Put */
+
+/**
+* @brief   : IsLinked - whether a local file is the blob that its name refers to
+* @param[I]: name (product file name in the current directory)
+* @param[O]: none
+* @return  : true:linked, false:not linked or not in the store
+* @note    :
+**/
+bool StoreUtil::IsLinked(const string &name)
+{
+#ifdef _WIN32   /* for Windows */
+    return false;  /* no inode numbers, the file is hashed again */
+#else           /* for Linux or Mac */
+    string hash;
+    if (!ReadRef(name, hash)) return false;
+
+    struct stat st1, st2;
+    if (stat(name.c_str(), &st1) != 0 || stat(BlobFile(hash).c_str(), &st2) != 0) return false;
+
+    return st1.st_dev == st2.st_dev && st1.st_ino == st2.st_ino;
+#endif
+} /* end of IsLinked */
+
+/**
+* @brief   : Drop - drop a product name from the store, so that it is not linked again
+* @param[I]: name (product file name)
+* @param[O]: none
+* @return  : true:dropped, false:the name is not in the store
+* @note    : the blob is kept, other names may refer to it
+**/
+bool StoreUtil::Drop(const string &name)
+{
+    if (_root.empty()) return false;
+
+    return remove(RefFile(name).c_str()) == 0;
+} /* end of Drop */
+
+/**
+* @brief   : HashFile - get the SHA-256 of a file
+* @param[I]: file (file name)
+* @param[O]: hash (SHA-256 in hex)
+* @return  : true:ok, false:the file is not readable
+* @note    :
+**/
+bool StoreUtil::HashFile(const string &file, string &hash)
+{
+    hash = "";
+    ifstream in(file.c_str(), ios::binary);
+    if (!in.is_open()) return false;
+
+    uint32_t h[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    unsigned char buf[65536 + 128];
+    unsigned long long len = 0;
+    while (true)
+    {
+        in.read((char *)buf, 65536);
+        size_t n = (size_t)in.gcount();
+        len += n;
+        if (n == 65536)
+        {
+            for (size_t i = 0; i < n; i += 64) Sha256Block(h, buf + i);
+            continue;
+        }
+
+        /* the last (partial) block with the padding and the length in bits */
+        size_t nb = n / 64 * 64;
+        for (size_t i = 0; i < nb; i += 64) Sha256Block(h, buf + i);
+        size_t rest = n - nb, padLen = rest < 56 ? 64 : 128;
+        unsigned char *tail = buf + nb;
+        tail[rest] = 0x80;
+        for (size_t i = rest + 1; i < padLen - 8; i++) tail[i] = 0;
+        for (int i = 0; i < 8; i++) tail[padLen - 1 - i] = (unsigned char)((len * 8) >> (8 * i));
+        for (size_t i = 0; i < padLen; i += 64) Sha256Block(h, tail + i);
+        break;
+    }
+    in.close();
+
+    char hex[65] = { '\0' };
+    for (int i = 0; i < 8; i++) sprintf(hex + 8 * i, "%08x", h[i]);
+    hash = hex;
+
+    return true;
+} /* end of HashFile */
\ No newline at end of file
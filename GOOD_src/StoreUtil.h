@@ -0,0 +1,150 @@
+/*------------------------------------------------------------------------------
+* StoreUtil.h : header file of StoreUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class StoreUtil
+{
+private:
+    string _root;                                   /* root directory of the store, "" if not opened */
+    string _scope;                                  /* scope of the product names, i.e., 'obs/<host>/<settings hash>' */
+
+    /**
+    * @brief   : RefFile - get the full path of the reference file of a product name
+    * @param[I]: name (product file name, i.e., 'igs14.atx')
+    * @param[O]: none
+    * @return  : the full path of the reference file
+    * @note    :
+    **/
+    string RefFile(const string &name);
+
+    /**
+    * @brief   : BlobFile - get the full path of the blob of a content hash
+    * @param[I]: hash (SHA-256 of the content in hex)
+    * @param[O]: none
+    * @return  : the full path of the blob file
+    * @note    :
+    **/
+    string BlobFile(const string &hash);
+
+    /**
+    * @brief   : ReadRef - get the content hash that a product name refers to
+    * @param[I]: name (product file name)
+    * @param[O]: hash (SHA-256 of the content in hex)
+    * @return  : true:found, false:not in the store
+    * @note    :
+    **/
+    bool ReadRef(const string &name, string &hash);
+
+    /**
+    * @brief   : LinkFile - hard link a file to a new name, or copy it if the link is not possible
+    * @param[I]: src (source file)
+    * @param[I]: dst (destination file, it must not exist)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the copy is used across file systems or on file systems without hard links
+    **/
+    bool LinkFile(const string &src, const string &dst);
+
+public:
+    StoreUtil()
+	{
+
+	}
+	~StoreUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : Open - open (and create if needed) the content-addressed store
+    * @param[I]: root (root directory of the store, full path)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the blobs are stored in 'root/objects/xx/<SHA-256>', the product names in 'root/refs/<scope>/<name>'
+    *            and the lock files in 'root/locks/<scope>'
+    **/
+    bool Open(const string &root);
+
+    /**
+    * @brief   : Scope - set the scope of the product names of the current product
+    * @param[I]: scope (components separated by '/', i.e., 'obs/gdc.cddis.eosdis.nasa.gov/1a2b3c4d')
+    * @param[O]: none
+    * @return  : none
+    * @note    : the same file name is a different product in another scope, i.e., the daily observation file
+    *            'abmf0320.21o' of IGS and of MGEX, or of two conversion filters
+    **/
+    void Scope(const string &scope);
+
+    /**
+    * @brief   : RefDir - get the directory of the product names of the current scope
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : the full path of the directory, where the catalog of the scope is kept as well
+    * @note    :
+    **/
+    string RefDir();
+
+    /**
+    * @brief   : Root - get the root directory of the opened store
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : the root directory, "" if no store is opened
+    * @note    :
+    **/
+    string Root();
+
+    /**
+    * @brief   : LockFile - get the full path of the lock file of a name in the store
+    * @param[I]: name (product file name, or the name of a file shared by the processes like '.good_catalog')
+    * @param[O]: none
+    * @return  : the full path of the lock file
+    * @note    :
+    **/
+    string LockFile(const string &name);
+
+    /**
+    * @brief   : Link - link the stored version of a product into the current directory
+    * @param[I]: name (product file name, also the local file name)
+    * @param[O]: none
+    * @return  : true:linked, false:the product is not in the store
+    * @note    :
+    **/
+    bool Link(const string &name);
+
+    /**
+    * @brief   : Put - put a local file into the store and replace it by a link to the blob
+    * @param[I]: name (product file name in the current directory)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : a file that is already linked to the blob of its name is not hashed again
+    **/
+    bool Put(const string &name);
+
+    /**
+    * @brief   : IsLinked - whether a local file is the blob that its name refers to
+    * @param[I]: name (product file name in the current directory)
+    * @param[O]: none
+    * @return  : true:linked, false:not linked or not in the store
+    * @note    :
+    **/
+    bool IsLinked(const string &name);
+
+    /**
+    * @brief   : Drop - drop a product name from the store, so that it is not linked again
+    * @param[I]: name (product file name)
+    * @param[O]: none
+    * @return  : true:dropped, false:the name is not in the store
+    * @note    : the blob is kept, other names may refer to it
+    **/
+    bool Drop(const string &name);
+
+    /**
+    * @brief   : HashFile - get the SHA-256 of a file
+    * @param[I]: file (file name)
+    * @param[O]: hash (SHA-256 in hex)
+    * @return  : true:ok, false:the file is not readable
+    * @note    :
+    **/
+    bool HashFile(const string &file, string &hash);
+};
\ No newline at end of file
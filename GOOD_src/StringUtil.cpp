@@ -288,4 +288,251 @@ void StringUtil::GetFilesAll(string dir, string suffix, vector<string> &files)
     cmd = "rm -rf " + fileList;
 #endif
     std::system(cmd.c_str());
-} /* end of GetFilesAll */
\ No newline at end of file
+} /* end of GetFilesAll */
+
+/**
+* @brief   : ListDir - get the name list of the regular files in a directory
+* @param[I]: dir (the directory)
+* @param[O]: files (the name list of the files)
+* @return  : none
+* @note    : the current directory is not changed
+**/
+void StringUtil::ListDir(const string &dir, vector<string> &files)
+{
+#ifdef _WIN32   /* for Windows */
+    WIN32_FIND_DATAA fd;
+    HANDLE hFind = FindFirstFileA((dir + "\\*").c_str(), &fd);
+    if (hFind == INVALID_HANDLE_VALUE) return;
+    do
+    {
+        if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) files.push_back(fd.cFileName);
+    } while (FindNextFileA(hFind, &fd));
+    FindClose(hFind);
+#else           /* for Linux or Mac */
+    DIR *dp = opendir(dir.c_str());
+    if (dp == nullptr) return;
+    struct dirent *ep;
+    while ((ep = readdir(dp)) != nullptr)
+    {
+        struct stat st;
+        string path = dir + FILEPATHSEP + ep->d_name;
+        if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) files.push_back(ep->d_name);
+    }
+    closedir(dp);
+#endif
+} /* end of ListDir */
+
+/**
+* @brief   : ListSubDirs - get the name list of the sub-directories of a directory
+* @param[I]: dir (the directory)
+* @param[O]: dirs (the name list of the sub-directories, without '.' and '..')
+* @return  : none
+* @note    : the current directory is not changed
+**/
+void StringUtil::ListSubDirs(const string &dir, vector<string> &dirs)
+{
+#ifdef _WIN32   /* for Windows */
+    WIN32_FIND_DATAA fd;
+    HANDLE hFind = FindFirstFileA((dir + "\\*").c_str(), &fd);
+    if (hFind == INVALID_HANDLE_VALUE) return;
+    do
+    {
+        if ((fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && strcmp(fd.cFileName, ".") != 0 &&
+            strcmp(fd.cFileName, "..") != 0) dirs.push_back(fd.cFileName);
+    } while (FindNextFileA(hFind, &fd));
+    FindClose(hFind);
+#else           /* for Linux or Mac */
+    DIR *dp = opendir(dir.c_str());
+    if (dp == nullptr) return;
+    struct dirent *ep;
+    while ((ep = readdir(dp)) != nullptr)
+    {
+        if (strcmp(ep->d_name, ".") == 0 || strcmp(ep->d_name, "..") == 0) continue;
+        struct stat st;
+        string path = dir + FILEPATHSEP + ep->d_name;
+        if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) dirs.push_back(ep->d_name);
+    }
+    closedir(dp);
+#endif
+} /* end of ListSubDirs */
+
+/**
+* @brief   : FileSize - get the size of a file
+* @param[I]: file (file name)
+* @param[O]: none
+* @return  : the size in bytes, -1 if the file does not exist
+* @note    :
+**/
+long long StringUtil::FileSize(const string &file)
+{
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0) return -1;
+
+    return (long long)st.st_size;
+} /* end of FileSize */
+
+/**
+* @brief   : Fnv1a - get the 32-bit FNV-1a hash of a string
+* @param[I]: str (string to be hashed)
+* @param[I]: noCase (true:the letters are hashed in lower case)
+* @return  : the hash
+* @note    : it is stable across platforms and runs, as the names in the store and the shards rely on it
+**/
+unsigned int StringUtil::Fnv1a(const string &str, bool noCase)
+{
+    unsigned int h = 2166136261u;  /* offset basis */
+    for (char c : str)
+    {
+        h ^= noCase ? (unsigned char)tolower((unsigned char)c) : (unsigned char)c;
+        h *= 16777619u;  /* FNV prime */
+    }
+
+    return h;
+} /* end of Fnv1a */
+
+/**
+* @brief   : IsShardTag - whether a string is the tag of a shard
+* @param[I]: tag (i.e., '2of4')
+* @return  : true:a shard tag, false:not
+* @note    : the sidecar files of a shard are named with its tag, i.e., 'inventory.2of4.csv'
+**/
+bool StringUtil::IsShardTag(const string &tag)
+{
+    size_t ipos = tag.find("of");
+    if (ipos == string::npos || ipos == 0 || ipos + 2 >= tag.size()) return false;
+    for (size_t i = 0; i < tag.size(); i++)
+    {
+        if ((i < ipos || i >= ipos + 2) && !isdigit((unsigned char)tag[i])) return false;
+    }
+
+    return true;
+} /* end of IsShardTag */
+
+/**
+* @brief   : TmpName - get the name of the temporary file (or directory) of a file for this process
+* @param[I]: file (the file, with or without path)
+* @return  : the name, i.e., '.good_catalog.12345_7.tmp'
+* @note    : the name has the process ID and a count of the calls in the process, so that neither the
+*            processes working in the same directory nor the threads of a process write the same temporary file
+**/
+string StringUtil::TmpName(const string &file)
+{
+    static std::atomic<unsigned int> nCall(0);
+
+    return file + "." + to_string(getpid()) + "_" + to_string(nCall++) + ".tmp";
+} /* end of TmpName */
+
+/**
+* @brief   : ReadLines - read the lines of a hidden table file (i.e., '.good_catalog')
+* @param[I]: file (the file, with or without path)
+* @param[O]: lines (the lines, without the empty ones and the comments starting with '#')
+* @return  : true:ok, false:the file does not exist
+* @note    :
+**/
+bool StringUtil::ReadLines(const string &file, vector<string> &lines)
+{
+    lines.clear();
+    ifstream inFile(file.c_str());
+    if (!inFile.is_open()) return false;
+
+    string line;
+    while (getline(inFile, line))
+    {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        lines.push_back(line);
+    }
+    inFile.close();
+
+    return true;
+} /* end of ReadLines */
+
+/**
+* @brief   : WriteFile - replace the content of a file as a whole
+* @param[I]: file (the file, with or without path)
+* @param[I]: text (the new content, which may be binary)
+* @param[O]: none
+* @return  : true:ok, false:error (the file is not changed)
+* @note    : a temporary file of the process is written and renamed, so that an interrupted run never
+*            leaves a truncated file and the readers see either the old or the new content
+**/
+bool StringUtil::WriteFile(const string &file, const string &text)
+{
+    string tmpFile = TmpName(file);
+    ofstream outFile(tmpFile.c_str(), ios::binary);
+    if (!outFile.is_open()) return false;
+    outFile.write(text.data(), text.size());
+    outFile.close();
+    if (outFile.fail())
+    {
+        remove(tmpFile.c_str());
+
+        return false;
+    }
+
+#ifdef _WIN32   /* for Windows */
+    remove(file.c_str());
+#endif
+    if (rename(tmpFile.c_str(), file.c_str()) != 0)
+    {
+        remove(tmpFile.c_str());
+
+        return false;
+    }
+
+    return true;
+} /* end of WriteFile */
+
+/**
+* @brief   : WildMatch - match a string against a wildcard pattern
+* @param[I]: pat (pattern with '*' for any characters and '?' for one character)
+* @param[I]: str (string to be matched)
+* @return  : true:matched, false:not matched
+* @note    : the last '*' is backtracked only, which is linear for the patterns of the file names
+**/
+bool StringUtil::WildMatch(const char *pat, const char *str)
+{
+    const char *star = nullptr, *back = nullptr;
+    while (*str != '\0')
+    {
+        if (*pat == '*')
+        {
+            star = pat++;
+            back = str;
+        }
+        else if (*pat == '?' || *pat == *str)
+        {
+            pat++;
+            str++;
+        }
+        else if (star != nullptr)
+        {
+            pat = star + 1;
+            str = ++back;
+        }
+        else return false;
+    }
+    while (*pat == '*') pat++;
+
+    return *pat == '\0';
+} /* end of WildMatch */
+
+/**
+* @brief   : Intern - get the interned copy of a string
+* @param[I]: src (source string)
+* @return  : the interned string, which is shared by all the equal strings and never released
+* @note    : it is thread-safe; as the pool never shrinks, it is meant for the option strings set once, not
+*            for the strings made per day or per job
+**/
+const char *StringUtil::Intern(const string &src)
+{
+    static std::unordered_set<string> pool;
+    static std::mutex poolMutex;
+
+    if (src.empty()) return "";
+
+    /* the elements of unordered_set are never moved, so the pointers stay valid */
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    return pool.insert(src).first->c_str();
+} /* end of Intern */
\ No newline at end of file
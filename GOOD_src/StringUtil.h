@@ -135,4 +135,95 @@ public:
     * @note    :
     **/
     void GetFilesAll(string dir, string suffix, vector<string> &files);
+
+    /**
+    * @brief   : ListDir - get the name list of the regular files in a directory
+    * @param[I]: dir (the directory)
+    * @param[O]: files (the name list of the files)
+    * @return  : none
+    * @note    : the current directory is not changed
+    **/
+    void ListDir(const string &dir, vector<string> &files);
+
+    /**
+    * @brief   : ListSubDirs - get the name list of the sub-directories of a directory
+    * @param[I]: dir (the directory)
+    * @param[O]: dirs (the name list of the sub-directories, without '.' and '..')
+    * @return  : none
+    * @note    : the current directory is not changed
+    **/
+    void ListSubDirs(const string &dir, vector<string> &dirs);
+
+    /**
+    * @brief   : FileSize - get the size of a file
+    * @param[I]: file (file name)
+    * @param[O]: none
+    * @return  : the size in bytes, -1 if the file does not exist
+    * @note    :
+    **/
+    long long FileSize(const string &file);
+
+    /**
+    * @brief   : WildMatch - match a string against a wildcard pattern
+    * @param[I]: pat (pattern with '*' for any characters and '?' for one character)
+    * @param[I]: str (string to be matched)
+    * @return  : true:matched, false:not matched
+    * @note    :
+    **/
+    bool WildMatch(const char *pat, const char *str);
+
+    /**
+    * @brief   : Fnv1a - get the 32-bit FNV-1a hash of a string
+    * @param[I]: str (string to be hashed)
+    * @param[I]: noCase (true:the letters are hashed in lower case)
+    * @return  : the hash
+    * @note    : it is stable across platforms and runs, as the names in the store and the shards rely on it
+    **/
+    unsigned int Fnv1a(const string &str, bool noCase);
+
+    /**
+    * @brief   : IsShardTag - whether a string is the tag of a shard
+    * @param[I]: tag (i.e., '2of4')
+    * @return  : true:a shard tag, false:not
+    * @note    : the sidecar files of a shard are named with its tag, i.e., 'inventory.2of4.csv'
+    **/
+    bool IsShardTag(const string &tag);
+
+    /**
+    * @brief   : TmpName - get the name of the temporary file (or directory) of a file for this process
+    * @param[I]: file (the file, with or without path)
+    * @return  : the name, i.e., '.good_catalog.12345_7.tmp'
+    * @note    : the name has the process ID and a count of the calls in the process, so that neither the
+    *            processes working in the same directory nor the threads of a process write the same temporary file
+    **/
+    string TmpName(const string &file);
+
+    /**
+    * @brief   : ReadLines - read the lines of a hidden table file (i.e., '.good_catalog')
+    * @param[I]: file (the file, with or without path)
+    * @param[O]: lines (the lines, without the empty ones and the comments starting with '#')
+    * @return  : true:ok, false:the file does not exist
+    * @note    :
+    **/
+    bool ReadLines(const string &file, vector<string> &lines);
+
+    /**
+    * @brief   : WriteFile - replace the content of a file as a whole
+    * @param[I]: file (the file, with or without path)
+    * @param[I]: text (the new content, which may be binary)
+    * @param[O]: none
+    * @return  : true:ok, false:error (the file is not changed)
+    * @note    : a temporary file of the process is written and renamed, so that an interrupted run never
+    *            leaves a truncated file and the readers see either the old or the new content
+    **/
+    bool WriteFile(const string &file, const string &text);
+
+    /**
+    * @brief   : Intern - get the interned copy of a string
+    * @param[I]: src (source string)
+    * @return  : the interned string, which is shared by all the equal strings and never released
+    * @note    : it is thread-safe; as the pool never shrinks, it is meant for the option strings set once, not
+    *            for the strings made per day or per job
+    **/
+    const char *Intern(const string &src);
 };
\ No newline at end of file
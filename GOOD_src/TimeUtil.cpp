@@ -566,4 +566,21 @@ char* TimeUtil::TimeStr(gtime_t tt, int n)
     time2str(tt, buff, n);
 
     return buff;
-} /* end of TimeStr */
\ No newline at end of file
+} /* end of TimeStr */
+
+/**
+* @brief   : TimeNow - get the current time of the system clock
+* @param[I]: none
+* @param[O]: none
+* @return  : current time (UTC)
+* @note    :
+**/
+gtime_t TimeUtil::TimeNow()
+{
+    time_t now = time(nullptr);
+    gtime_t tt;
+    tt.mjd = 40587 + (int)(now / 86400);   /* MJD of 1970/01/01 is 40587 */
+    tt.sod = (double)(now % 86400);
+
+    return tt;
+} /* end of TimeNow */
\ No newline at end of file
@@ -268,4 +268,13 @@ public:
     * @note    :
     **/
     char* TimeStr(gtime_t tt, int n);
+
+    /**
+    * @brief   : TimeNow - get the current time of the system clock
+    * @param[I]: none
+    * @param[O]: none
+    * @return  : current time (UTC)
+    * @note    :
+    **/
+    gtime_t TimeNow();
 };
\ No newline at end of file
@@ -0,0 +1,320 @@
+/*------------------------------------------------------------------------------
+* ZstdUtil.cpp : seekable zstd files of the archived products
+*
+* Copyright (C) 2020-2099 by SpAtial SurveyIng and Navigation (SASIN) Group, all rights reserved.
+*    This file is part of GAMP II - GOOD (Gnss Observations and prOducts Downloader)
+*
+* References:
+*    [1] Y. Collet, M. Kucherawy, Zstandard Compression and the application/zstd Media Type, RFC 8878, 2021
+*    [2] Zstandard Seekable Format, contrib/seekable_format/zstd_seekable_compression_format.md of zstd
+*
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "ZstdUtil.h"
+
+
+/* constants/macros ----------------------------------------------------------*/
+#define MIN(x,y)   ((x) <= (y) ? (x) : (y))
+#define MAX(x,y)   ((x) >= (y) ? (x) : (y))
+#define ZSTDMAGIC  0xFD2FB528        /* magic number of a zstd frame */
+#define SKIPMAGIC  0x184D2A5E        /* magic number of the skippable frame of the seek table */
+#define SEEKMAGIC  0x8F92EAB1        /* magic number at the end of the seek table */
+#define FOOTSIZE   9                 /* size of the seek table footer */
+#define MAXFRAMEKB 65536             /* maximum decompressed size (KB) of one frame */
+
+
+/* local functions -----------------------------------------------------------*/
+
+/* write a 32-bit little-endian word */
+static void PutU32(ofstream &out, uint32_t v)
+{
+    unsigned char b[4] = { (unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24) };
+    out.write((const char *)b, 4);
+}
+
+/* read a 32-bit little-endian word */
+static uint32_t GetU32(const unsigned char *b)
+{
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+/* compressed size of the zstd frame at an offset of a file, -1 if it is not a whole zstd frame */
+static long long FrameSize(ifstream &in, long long off, long long size)
+{
+    unsigned char hd[6];
+    in.clear();
+    in.seekg(off);
+    if (off + 6 > size || !in.read((char *)hd, 6) || GetU32(hd) != ZSTDMAGIC) return -1;
+
+    /* frame header: magic, descriptor, window descriptor, dictionary ID, frame content size */
+    int desc = hd[4], fcsFlag = desc >> 6, single = (desc >> 5) & 1, checksum = (desc >> 2) & 1;
+    const int dictSizes[4] = { 0, 1, 2, 4 }, fcsSizes[4] = { 0, 2, 4, 8 };
+    long long pos = off + 5 + (single ? 0 : 1) + dictSizes[desc & 3] + (fcsFlag == 0 ? single : fcsSizes[fcsFlag]);
+
+    /* blocks: 3-byte header of the last flag, the type and the size, an RLE block holds one byte */
+    for (bool last = false; !last; )
+    {
+        unsigned char bh[3];
+        in.seekg(pos);
+        if (pos + 3 > size || !in.read((char *)bh, 3)) return -1;
+        uint32_t h = (uint32_t)bh[0] | ((uint32_t)bh[1] << 8) | ((uint32_t)bh[2] << 16);
+        int type = (h >> 1) & 3;
+        if (type == 3) return -1;
+        last = (h & 1) != 0;
+        pos += 3 + (type == 1 ? 1 : (h >> 3));
+    }
+    pos += checksum ? 4 : 0;
+
+    return pos <= size ? pos - off : -1;
+}
+
+
+/* function definition -------------------------------------------------------*/
+
+/**
+* @brief   : SetTool - set the 'zstd' command
+* @param[I]: zstdFull ('zstd' or its full path)
+* @param[O]: none
+* @return  : none
+* @note    :
+**/
+void ZstdUtil::SetTool(const string &zstdFull)
+{
+    if (!zstdFull.empty()) _zstdFull = zstdFull;
+} /* end of SetTool */
+
+/**
+* @brief   : Compress - compress a file to seekable zstd
+* @param[I]: file (source file)
+* @param[I]: zstFile (seekable zstd file)
+* @param[I]: frameKB (maximum decompressed size of one frame in KB)
+* @param[I]: level (compression level of zstd, 1-19)
+* @param[O]: none
+* @return  : true:ok, false:error
+* @note    : the frames are independent and end at line ends, and the seek table is appended in a skippable
+*            frame, so any zstd decoder reads the file as a whole and a seekable one reads any frame alone;
+*            all the frames are compressed by one 'zstd' process ('--filelist', zstd 1.4.6 or later)
+**/
+bool ZstdUtil::Compress(const string &file, const string &zstFile, int frameKB, int level)
+{
+    ifstream in(file.c_str(), ios::binary);
+    if (!in.is_open())
+    {
+        cerr << "*** ERROR(ZstdUtil::Compress): open file " << file << " FAILED!" << endl;
+
+        return false;
+    }
+    StringUtil str;
+    string tmpFile = str.TmpName(zstFile), listFile = tmpFile + ".list";
+
+    /* one chunk file per frame of whole lines, a single line longer than the frame size makes a frame alone */
+    size_t frameBytes = (size_t)MIN(MAX(frameKB, 1), MAXFRAMEKB) * 1024;
+    std::vector<string> chunkFiles;
+    std::vector<uint32_t> cSizes, dSizes;
+    string chunk, line, list;
+    bool ok = true;
+    while (ok)
+    {
+        bool end = !getline(in, line);
+        if (!end)
+        {
+            chunk += line;
+            if (!in.eof()) chunk += '\n';
+        }
+        if (!end && chunk.size() < frameBytes) continue;
+        if (chunk.empty()) break;
+
+        string chunkFile = tmpFile + "." + to_string(chunkFiles.size());
+        chunkFiles.push_back(chunkFile);
+        list += chunkFile + "\n";
+        ofstream chunkOut(chunkFile.c_str(), ios::binary);
+        chunkOut.write(chunk.data(), chunk.size());
+        chunkOut.close();
+        if (!chunkOut)
+        {
+            cerr << "*** ERROR(ZstdUtil::Compress): write file " << chunkFile << " FAILED!" << endl;
+            ok = false;
+        }
+        dSizes.push_back((uint32_t)chunk.size());
+        chunk.clear();
+        if (end) break;
+    }
+    in.close();
+
+    /* a single zstd process writes the frames of all the chunks one after the other in the list order */
+    string cmd = _zstdFull + " -q -f -" + to_string(MIN(MAX(level, 1), 19)) + " -c --filelist " + listFile +
+        " > " + tmpFile;
+    if (ok && !chunkFiles.empty())
+    {
+        ofstream listOut(listFile.c_str(), ios::binary);
+        listOut << list;
+        listOut.close();
+        ok = listOut && std::system(cmd.c_str()) == 0;
+        if (!ok) cerr << "*** ERROR(ZstdUtil::Compress): failed to run " << cmd << endl;
+    }
+    else if (ok) ok = ofstream(tmpFile.c_str(), ios::binary).is_open();
+    for (const string &chunkFile : chunkFiles) remove(chunkFile.c_str());
+    remove(listFile.c_str());
+
+    /* the compressed size of each frame is taken from its block headers */
+    long long size = 0;
+    if (ok)
+    {
+        ifstream zin(tmpFile.c_str(), ios::binary);
+        zin.seekg(0, ios::end);
+        size = (long long)zin.tellg();
+        for (long long off = 0; ok && off < size; )
+        {
+            long long cSize = FrameSize(zin, off, size);
+            ok = cSize > 0 && cSizes.size() < dSizes.size();
+            if (ok) cSizes.push_back((uint32_t)cSize);
+            off += cSize;
+        }
+        ok = ok && cSizes.size() == dSizes.size();
+        if (!ok) cerr << "*** ERROR(ZstdUtil::Compress): unexpected zstd frames from " << cmd << endl;
+    }
+
+    if (ok)
+    {
+        /* seek table: skippable frame header, entries of compressed and decompressed sizes, footer */
+        ofstream out(tmpFile.c_str(), ios::binary | ios::app);
+        uint32_t nFrames = (uint32_t)cSizes.size();
+        PutU32(out, SKIPMAGIC);
+        PutU32(out, nFrames * 8 + FOOTSIZE);
+        for (uint32_t i = 0; i < nFrames; i++)
+        {
+            PutU32(out, cSizes[i]);
+            PutU32(out, dSizes[i]);
+        }
+        PutU32(out, nFrames);
+        out.put((char)0);  /* descriptor: no checksums in the entries */
+        PutU32(out, SEEKMAGIC);
+        out.close();
+        ok = !out.fail();
+    }
+    if (!ok)
+    {
+        remove(tmpFile.c_str());
+
+        return false;
+    }
+
+    remove(zstFile.c_str());
+    if (rename(tmpFile.c_str(), zstFile.c_str()) != 0)
+    {
+        cerr << "*** ERROR(ZstdUtil::Compress): rename file " << tmpFile << " FAILED!" << endl;
+
+        return false;
+    }
+
+    return true;
+} /* end of Compress */
+
+/**
+* @brief   : ReadTable - read the seek table of a seekable zstd file
+* @param[I]: zstFile (seekable zstd file)
+* @param[O]: frames (frames in file order)
+* @return  : true:ok, false:not a seekable zstd file
+* @note    :
+**/
+bool ZstdUtil::ReadTable(const string &zstFile, std::vector<zstframe_t> &frames)
+{
+    frames.clear();
+    ifstream in(zstFile.c_str(), ios::binary);
+    if (!in.is_open()) return false;
+
+    in.seekg(0, ios::end);
+    long long size = (long long)in.tellg();
+    if (size < FOOTSIZE + 8) return false;
+
+    unsigned char foot[FOOTSIZE];
+    in.seekg(size - FOOTSIZE);
+    if (!in.read((char *)foot, FOOTSIZE) || GetU32(foot + 5) != SEEKMAGIC) return false;
+    uint32_t nFrames = GetU32(foot);
+    int entSize = (foot[4] & 0x80) ? 12 : 8;
+    long long tabSize = (long long)nFrames * entSize + FOOTSIZE;
+    if (size < tabSize + 8) return false;
+
+    std::vector<unsigned char> tab((size_t)tabSize + 8);
+    in.seekg(size - tabSize - 8);
+    if (!in.read((char *)tab.data(), tab.size())) return false;
+    if (GetU32(tab.data()) != SKIPMAGIC || GetU32(tab.data() + 4) != (uint32_t)tabSize) return false;
+
+    long long cOff = 0, dOff = 0;
+    for (uint32_t i = 0; i < nFrames; i++)
+    {
+        zstframe_t fr;
+        fr.cOff = cOff;
+        fr.cSize = GetU32(tab.data() + 8 + (size_t)i * entSize);
+        fr.dOff = dOff;
+        fr.dSize = GetU32(tab.data() + 12 + (size_t)i * entSize);
+        frames.push_back(fr);
+        cOff += fr.cSize;
+        dOff += fr.dSize;
+    }
+
+    return cOff == size - tabSize - 8;
+} /* end of ReadTable */
+
+/**
+* @brief   : Extract - decompress only the frames holding a range of the decompressed data
+* @param[I]: zstFile (seekable zstd file)
+* @param[I]: off (offset of the range in the decompressed data)
+* @param[I]: len (length of the range in bytes, <= 0: up to the end)
+* @param[I]: outFile (file of the decompressed frames)
+* @param[O]: start (offset of the first byte of 'outFile' in the decompressed data)
+* @return  : true:ok, false:error
+* @note    : whole frames are written, so 'outFile' starts and ends at line ends
+**/
+bool ZstdUtil::Extract(const string &zstFile, long long off, long long len, const string &outFile, long long &start)
+{
+    start = 0;
+    std::vector<zstframe_t> frames;
+    if (!ReadTable(zstFile, frames))
+    {
+        cerr << "*** ERROR(ZstdUtil::Extract): " << zstFile << " is not a seekable zstd file" << endl;
+
+        return false;
+    }
+
+    /* the frames overlapping [off, off + len) */
+    int first = -1, last = -1;
+    for (int i = 0; i < (int)frames.size(); i++)
+    {
+        if (frames[i].dOff + frames[i].dSize <= off) continue;
+        if (len > 0 && frames[i].dOff >= off + len) break;
+        if (first < 0) first = i;
+        last = i;
+    }
+    if (first < 0)
+    {
+        /* the range is beyond the data */
+        ofstream out(outFile.c_str(), ios::binary);
+
+        return out.is_open();
+    }
+    start = frames[first].dOff;
+
+    /* copy the compressed frames and decompress them alone */
+    string partFile = outFile + ".zst";
+    ifstream in(zstFile.c_str(), ios::binary);
+    ofstream part(partFile.c_str(), ios::binary);
+    if (!in.is_open() || !part.is_open()) return false;
+    in.seekg(frames[first].cOff);
+    long long n = frames[last].cOff + frames[last].cSize - frames[first].cOff;
+    char buff[65536];
+    while (n > 0 && in.read(buff, MIN(n, (long long)sizeof(buff))))
+    {
+        part.write(buff, in.gcount());
+        n -= in.gcount();
+    }
+    part.close();
+
+    string cmd = _zstdFull + " -q -d -f -c " + partFile + " > " + outFile;
+    bool ok = n == 0 && std::system(cmd.c_str()) == 0;
+    remove(partFile.c_str());
+    if (!ok) cerr << "*** ERROR(ZstdUtil::Extract): failed to decompress the frames of " << zstFile << endl;
+
+    return ok;
+} /* end of Extract */
\ No newline at end of file
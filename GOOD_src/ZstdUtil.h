@@ -0,0 +1,64 @@
+/*------------------------------------------------------------------------------
+* ZstdUtil.h : header file of ZstdUtil.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+class ZstdUtil
+{
+private:
+    string _zstdFull;                               /* 'zstd' command (full path if the third-party directory is set) */
+
+public:
+    ZstdUtil()
+	{
+		_zstdFull = "zstd";
+	}
+	~ZstdUtil()
+	{
+
+	}
+
+    /**
+    * @brief   : SetTool - set the 'zstd' command
+    * @param[I]: zstdFull ('zstd' or its full path)
+    * @param[O]: none
+    * @return  : none
+    * @note    :
+    **/
+    void SetTool(const string &zstdFull);
+
+    /**
+    * @brief   : Compress - compress a file to seekable zstd
+    * @param[I]: file (source file)
+    * @param[I]: zstFile (seekable zstd file)
+    * @param[I]: frameKB (maximum decompressed size of one frame in KB)
+    * @param[I]: level (compression level of zstd, 1-19)
+    * @param[O]: none
+    * @return  : true:ok, false:error
+    * @note    : the frames are independent and end at line ends, and the seek table is appended in a skippable
+    *            frame, so any zstd decoder reads the file as a whole and a seekable one reads any frame alone;
+    *            all the frames are compressed by one 'zstd' process ('--filelist', zstd 1.4.6 or later)
+    **/
+    bool Compress(const string &file, const string &zstFile, int frameKB, int level);
+
+    /**
+    * @brief   : ReadTable - read the seek table of a seekable zstd file
+    * @param[I]: zstFile (seekable zstd file)
+    * @param[O]: frames (frames in file order)
+    * @return  : true:ok, false:not a seekable zstd file
+    * @note    :
+    **/
+    bool ReadTable(const string &zstFile, std::vector<zstframe_t> &frames);
+
+    /**
+    * @brief   : Extract - decompress only the frames holding a range of the decompressed data
+    * @param[I]: zstFile (seekable zstd file)
+    * @param[I]: off (offset of the range in the decompressed data)
+    * @param[I]: len (length of the range in bytes, <= 0: up to the end)
+    * @param[I]: outFile (file of the decompressed frames)
+    * @param[O]: start (offset of the first byte of 'outFile' in the decompressed data)
+    * @return  : true:ok, false:error
+    * @note    : whole frames are written, so 'outFile' starts and ends at line ends
+    **/
+    bool Extract(const string &zstFile, long long off, long long len, const string &outFile, long long &start);
+};
\ No newline at end of file
@@ -6,11 +6,62 @@
 #include "Good.h"
 #include "PreProcess.h"
 #include "StringUtil.h"
+#include "TimeUtil.h"
+#include "GoodLib.h"
 
 
 /* ppp_run main --------------------------------------------------------------*/
 int main(int argc, char * argv[])
 {
+    /* 'run_GOOD -x obsFile' writes the RINEX of an observation file (i.e., kept by 'keepCompact') to standard output,
+       'run_GOOD -x obsFile "yyyy mm dd hh mm ss" "yyyy mm dd hh mm ss"' only the header and the epochs in [start, end) */
+    if ((argc == 3 || argc == 5) && strcmp(argv[1], "-x") == 0)
+    {
+        GoodLib good;
+        auto onLine = [](const char *line) { return fputs(line, stdout) >= 0 && fputc('\n', stdout) != EOF; };
+        bool ok = false;
+        if (argc == 3) ok = good.ReadObs(argv[2], onLine);
+        else
+        {
+            TimeUtil tu;
+            gtime_t ts, te;
+            if (!tu.str2time(argv[3], 0, 32, ts) || !tu.str2time(argv[4], 0, 32, te))
+                cerr << "*** ERROR(main): invalid time window '" << argv[3] << "' - '" << argv[4] << "'" << endl;
+            else ok = good.ReadObs(argv[2], ts, te, onLine);
+        }
+
+        return ok ? 0 : 1;
+    }
+
+    /* 'run_GOOD --plan cfgFile' prints and costs the download plan without downloading, as the key 'plan' of the
+       configure file, which is overridden by the environment variable; likewise 'run_GOOD --shard i/K cfgFile'
+       downloads the shard i of the K shards of the jobs (key 'shard') and 'run_GOOD --merge cfgFile' merges the
+       catalogs and inventories of the shards after all of them have finished (key 'merge') */
+    int iarg = 1;
+    for (; iarg < argc && strncmp(argv[iarg], "--", 2) == 0; iarg++)
+    {
+        string key, val;
+        if (strcmp(argv[iarg], "--plan") == 0 || strcmp(argv[iarg], "--merge") == 0)
+        {
+            key = string("GOOD_") + (argv[iarg] + 2);
+            val = "1";
+        }
+        else if (strcmp(argv[iarg], "--shard") == 0 && iarg + 1 < argc)
+        {
+            key = "GOOD_shard";
+            val = string("1 ") + argv[++iarg];
+        }
+        if (!key.empty())
+        {
+#ifdef _WIN32  /* for Windows */
+            _putenv_s(key.c_str(), val.c_str());
+#else          /* for Linux or Mac */
+            setenv(key.c_str(), val.c_str(), 1);
+#endif
+        }
+        else cout << " * The command-line option " << argv[iarg] << " is unknown, it is ignored" << endl;
+    }
+
 #ifdef _WIN32  /* for Windows */
     char cfgFile[1000] = "D:\\data\\gamp_good.cfg";
     /*char *cfgFile;
@@ -23,13 +74,13 @@ int main(int argc, char * argv[])
     else cfgFile = argv[1];*/
 #else          /* for Linux or Mac */
     char *cfgFile;
-    if (argc == 1)
+    if (argc == iarg)
     {
         cout << " * The input command-line parameter indicating configure file is lost, please check it!" << endl;
         
         return 0;
     }
-    else cfgFile = argv[1];
+    else cfgFile = argv[iarg];
 #endif
 
 #if (defined(_WIN32) && !defined(MinGW))  /* for Windows */
@@ -0,0 +1,27 @@
+/*------------------------------------------------------------------------------
+* TestUtil.h : the checks shared by the test programs of test/test_*.cpp
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+static int nFail = 0;             /* number of the failed checks of the test program */
+
+/* count and print a failed check, the test goes on */
+#define CHECK(cond) do { if (!(cond)) { cerr << "FAILED: " << #cond << " (line " << __LINE__ << ")" << endl; nFail++; } } while (0)
+
+/* content of a file, "" if it does not exist */
+inline string ReadAll(const string &file)
+{
+    ifstream in(file.c_str(), ios::binary);
+    ostringstream text;
+    text << in.rdbuf();
+
+    return text.str();
+}
+
+/* print the result of a test program, the exit code of 'main' */
+inline int TestResult(const char *name)
+{
+    cout << (nFail == 0 ? "PASSED" : "FAILED") << ": " << name << endl;
+
+    return nFail == 0 ? 0 : 1;
+}
\ No newline at end of file
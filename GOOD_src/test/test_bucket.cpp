@@ -0,0 +1,48 @@
+/*------------------------------------------------------------------------------
+* test_bucket.cpp : the bandwidth budget shared by the processes lets a full bucket go at once and makes the
+*                   next batch wait for the debt of the bytes charged
+*
+* usage : test_bucket
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "BucketUtil.h"
+#include "TestUtil.h"
+
+int main()
+{
+    const string dir = "test_bucket.tmp";
+    string cmd = "rm -rf " + dir + " && mkdir -p " + dir;
+    std::system(cmd.c_str());
+
+    /* no budget: nothing is waited for or written */
+    BucketUtil a, b;
+    a.Open(dir);
+    b.Open(dir);
+    CHECK(a.Take("back", 0) == 0.0);
+    a.Charge("back", 0, 100000000);
+    CHECK(access((dir + "/.good_bucket.back").c_str(), 0) == -1);
+
+    /* a new bucket is full (5 s of the budget), a batch within it does not wait */
+    const int rate = 2000;
+    CHECK(a.Take("back", rate) < 0.2);
+    a.Charge("back", rate, 4000LL * 1024);
+    CHECK(b.Take("back", rate) < 0.2);
+    CHECK(access((dir + "/.good_bucket.back").c_str(), 0) == 0);
+
+    /* the debt of 1000 KB charged by one process is waited for by the other (0.5 s at 2000 KB/s) */
+    b.Charge("back", rate, 7000LL * 1024);
+    double secs = a.Take("back", rate);
+    CHECK(secs > 0.3 && secs < 2.0);
+
+    /* the budget classes have buckets of their own */
+    b.Charge("back", rate, 20000LL * 1024);
+    CHECK(a.Take("inter", rate) < 0.2);
+    CHECK(access((dir + "/.good_bucket.back.lock").c_str(), 0) == -1);
+
+    cmd = "rm -rf " + dir;
+    std::system(cmd.c_str());
+
+    return TestResult("test_bucket");
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+/*------------------------------------------------------------------------------
+* test_cache.cpp : the negative cache is saved and loaded again, merged between the processes, and removed from
+*                  disk once it is empty
+*
+* usage : test_cache
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "CacheUtil.h"
+#include "TestUtil.h"
+
+/* a negative cache entry */
+static missent_t Entry(const string &name, int mjd, double sod, int count)
+{
+    missent_t ent;
+    ent.name = name;
+    ent.expire.mjd = mjd;
+    ent.expire.sod = sod;
+    ent.count = count;
+
+    return ent;
+}
+
+/* whether two entries are equal field by field */
+static bool IsEqual(const missent_t &a, const missent_t &b)
+{
+    return a.name == b.name && a.expire.mjd == b.expire.mjd && a.expire.sod == b.expire.sod && a.count == b.count;
+}
+
+int main()
+{
+    const string dir = "test_cache.tmp", missFile = dir + "/.good_missing";
+    string cmd = "rm -rf " + dir + " && mkdir -p " + dir;
+    std::system(cmd.c_str());
+
+    /* save and load again, the expiry is kept to the second */
+    CacheUtil miss;
+    missent_t ent, igr = Entry("igr21000.sp3", 60600, 61200.0, 1), brdm = Entry("brdm0010.24p", 60601, 3600.0, 3);
+    CHECK(!miss.Load(dir));
+    CHECK(miss.Dir() == dir);
+    miss.Update(igr);
+    miss.Update(brdm);
+    CHECK(miss.Save());
+    CHECK(miss.Load(dir));
+    CHECK(miss.Find("igr21000.sp3", ent) && IsEqual(ent, igr));
+    CHECK(miss.Find("brdm0010.24p", ent) && IsEqual(ent, brdm));
+
+    /* one process removes an entry that has landed, another one adds an entry: both changes are kept */
+    CacheUtil a, b;
+    a.Load(dir);
+    b.Load(dir);
+    missent_t cod = Entry("cod21000.sp3", 60602, 0.0, 2);
+    CHECK(a.Remove("igr21000.sp3"));
+    CHECK(!a.Remove("igr21000.sp3"));
+    b.Update(cod);
+    CHECK(a.Save() && b.Save());
+    miss.Load(dir);
+    CHECK(!miss.Find("igr21000.sp3", ent));
+    CHECK(miss.Find("cod21000.sp3", ent) && IsEqual(ent, cod));
+    CHECK(miss.Find("brdm0010.24p", ent) && IsEqual(ent, brdm));
+
+    /* a cache without entries is not kept on disk */
+    CHECK(miss.Remove("cod21000.sp3") && miss.Remove("brdm0010.24p"));
+    CHECK(miss.Save());
+    CHECK(access(missFile.c_str(), 0) == -1);
+    CHECK(access((missFile + ".lock").c_str(), 0) == -1);
+    CHECK(!miss.Load(dir));
+
+    cmd = "rm -rf " + dir;
+    std::system(cmd.c_str());
+
+    return TestResult("test_cache");
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+/*------------------------------------------------------------------------------
+* test_catalog.cpp : the freshness catalog is saved and loaded again, merged between the processes and the
+*                    shards, and compares the remote versions
+*
+* usage : test_catalog
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "CatalogUtil.h"
+#include "TestUtil.h"
+
+/* a catalog entry */
+static catent_t Entry(const string &name, long long size, const string &mtime, const string &etag)
+{
+    catent_t ent = { name, name + ".gz", size, mtime, etag };
+
+    return ent;
+}
+
+/* whether two entries are equal field by field */
+static bool IsEqual(const catent_t &a, const catent_t &b)
+{
+    return a.name == b.name && a.remote == b.remote && a.size == b.size && a.mtime == b.mtime && a.etag == b.etag;
+}
+
+int main()
+{
+    const string dir = "test_catalog.tmp";
+    string cmd = "rm -rf " + dir + " && mkdir -p " + dir;
+    std::system(cmd.c_str());
+
+    /* save and load again */
+    CatalogUtil cat;
+    catent_t ent, igu = Entry("igu21000_00.sp3", 151234, "Oct_18_2025", "-");
+    catent_t brdm = Entry("brdm0010.24p", 3456789, "Mon,_01_Jan_2024_12:00:00_GMT", "\"5f-1a2b\"");
+    CHECK(!cat.Load(dir));
+    cat.Update(igu);
+    cat.Update(brdm);
+    CHECK(cat.Save());
+    CHECK(cat.Load(dir));
+    CHECK(cat.Find("igu21000_00.sp3", ent) && IsEqual(ent, igu));
+    CHECK(cat.Find("brdm0010.24p", ent) && IsEqual(ent, brdm));
+    CHECK(!cat.Find("igs21000.sp3", ent));
+
+    /* two processes loaded the catalog before either saved: each keeps the entries of the other */
+    CatalogUtil a, b;
+    a.Load(dir);
+    b.Load(dir);
+    catent_t igr = Entry("igr21000.sp3", 5000000, "Oct_19_2025", "-");
+    catent_t igu2 = Entry("igu21000_00.sp3", 151240, "Oct_19_2025", "-");
+    a.Update(igr);
+    b.Update(igu2);
+    CHECK(a.Save() && b.Save());
+    cat.Load(dir);
+    CHECK(cat.Find("igr21000.sp3", ent) && IsEqual(ent, igr));
+    CHECK(cat.Find("igu21000_00.sp3", ent) && IsEqual(ent, igu2));
+    CHECK(cat.Find("brdm0010.24p", ent) && IsEqual(ent, brdm));
+    CHECK(access((dir + "/.good_catalog.lock").c_str(), 0) == -1);
+
+    /* the same version: the ETag wins, then the size and the time; the unknown fields are not compared */
+    catent_t x = brdm;
+    CHECK(cat.IsSame(brdm, x));
+    x.size = 1;
+    CHECK(cat.IsSame(brdm, x));
+    x.etag = "\"5f-ffff\"";
+    CHECK(!cat.IsSame(brdm, x));
+    x = igu;
+    x.mtime = "Oct_20_2025";
+    CHECK(!cat.IsSame(igu, x));
+    x.mtime = "-";
+    CHECK(cat.IsSame(igu, x));
+    x.size = igu.size + 1;
+    CHECK(!cat.IsSame(igu, x));
+    x = igu;
+    x.remote = "igu21000_00.sp3.Z";
+    CHECK(!cat.IsSame(igu, x));
+
+    /* a shard saves only its own entries, it still finds the ones of the directory */
+    CatalogUtil shard;
+    catent_t cod = Entry("cod21000.sp3", 4000000, "Oct_21_2025", "-");
+    shard.Load(dir, "1of2");
+    shard.Update(cod);
+    CHECK(shard.Save());
+    CHECK(shard.Find("brdm0010.24p", ent) && shard.Find("cod21000.sp3", ent));
+    std::vector<string> lines;
+    StringUtil str;
+    CHECK(str.ReadLines(dir + "/.good_catalog.1of2", lines) && lines.size() == 1);
+    cat.Load(dir);
+    CHECK(!cat.Find("cod21000.sp3", ent));
+
+    /* the merge takes the shard in and removes its file, the files that are not of a shard are left */
+    CHECK(str.IsShardTag("1of2") && str.IsShardTag("12of16"));
+    CHECK(!str.IsShardTag("of2") && !str.IsShardTag("1of") && !str.IsShardTag("1ofx") && !str.IsShardTag("lock"));
+    CHECK(str.WriteFile(dir + "/.good_catalog.bak", "# not a shard\n"));
+    CHECK(cat.Merge(dir) == 1);
+    CHECK(access((dir + "/.good_catalog.1of2").c_str(), 0) == -1);
+    CHECK(access((dir + "/.good_catalog.bak").c_str(), 0) == 0);
+    cat.Load(dir);
+    CHECK(cat.Find("cod21000.sp3", ent) && IsEqual(ent, cod));
+    CHECK(cat.Find("igr21000.sp3", ent));
+    CHECK(cat.Merge(dir) == 0);
+
+    cmd = "rm -rf " + dir;
+    std::system(cmd.c_str());
+
+    return TestResult("test_catalog");
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+/*------------------------------------------------------------------------------
+* test_check.cpp : the invariants of the downloaded files, the quarantine and the re-queue of the invalid ones
+*
+* usage : test_check
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "TimeUtil.h"
+#include "StringUtil.h"
+#include "CatalogUtil.h"
+#include "CacheUtil.h"
+#include "RateUtil.h"
+#include "BucketUtil.h"
+#include "StoreUtil.h"
+#include "LockUtil.h"
+#include "ZstdUtil.h"
+#include "IndexUtil.h"
+#include "FilterUtil.h"
+#include "CheckUtil.h"
+#include "InventUtil.h"
+#include "SiteUtil.h"
+#include "PlanUtil.h"
+#include "FtpUtil.h"
+#include "PreProcess.h"
+#include "TestUtil.h"
+
+/* the validation pass of the downloader, which is a friend of the test */
+class FtpUtilTest
+{
+public:
+    FtpUtil ftp;
+    FtpUtilTest()
+	{
+		ftp.init();
+	}
+    void NotifyFile(const ftpopt_t *fopt, const string &file)
+    {
+        ftp.NotifyFile(fopt, file);
+    }
+    void ValidateFiles(const ftpopt_t *fopt)
+    {
+        ftp.ValidateFiles(fopt);
+    }
+};
+
+/* a header line with its label in column 61 */
+static string Head(const string &text, const string &label)
+{
+    string line = text;
+    line.resize(60, ' ');
+
+    return line + label;
+}
+
+/* RINEX 3: 2 epochs of 30 s with 2 satellites */
+static std::vector<string> Rinex3()
+{
+    return { Head("     3.04           OBSERVATION DATA    M", "RINEX VERSION / TYPE"),
+        Head("G    2 C1C L1C", "SYS / # / OBS TYPES"), Head("", "END OF HEADER"),
+        "> 2024 01 01 00 00  0.0000000  0  2", "G01  20000000.000   105000000.000  ",
+        "G02  21000000.000   110000000.000  ", "> 2024 01 01 00 00 30.0000000  0  2",
+        "G01  20000000.000   105000000.000  ", "G02  21000000.000   110000000.000  " };
+}
+
+/* SP3: 2 epochs of 15 min, 'nDecl' of them declared in the first line */
+static std::vector<string> Sp3(int nDecl)
+{
+    char buff[MAXCHARS];
+    snprintf(buff, sizeof(buff), "#dP2024  1  1  0  0  0.00000000 %6d ORBIT IGS20 HLM  IGS", nDecl);
+
+    return { buff, "* 2024  1  1  0  0  0.00000000", "PG01  10000.000000  20000.000000  10000.000000      1.000000",
+        "* 2024  1  1  0 15  0.00000000", "PG01  10001.000000  20001.000000  10001.000000      1.000000", "EOF" };
+}
+
+/* check the lines of a file, "" if it is valid */
+static string Check(const string &file, const std::vector<string> &lines)
+{
+    CheckUtil chk;
+    chk.Reset(file);
+    for (const string &line : lines)
+    {
+        if (!chk.Put(line)) break;
+    }
+    string why;
+    chk.Finish(why);
+
+    return why;
+}
+
+/* write the lines of a file */
+static bool WriteLines(const string &file, const std::vector<string> &lines)
+{
+    string text;
+    for (const string &line : lines) text += line + "\n";
+    StringUtil str;
+
+    return str.WriteFile(file, text);
+}
+
+int main()
+{
+    /* RINEX observation: a complete file, a truncated last record and epochs out of order */
+    std::vector<string> obs = Rinex3();
+    CHECK(Check("abmf0010.24o", obs).empty());
+    CHECK(Check("ABMF00GLP_R_20240010000_01D_30S_MO.rnx.gz", obs).empty());
+    std::vector<string> bad(obs.begin(), obs.end() - 1);
+    CHECK(Check("abmf0010.24o", bad) == "the last epoch record is truncated");
+    bad = obs;
+    bad[6] = "> 2023 12 31 23 59 30.0000000  0  2";
+    CHECK(Check("abmf0010.24o", bad).find("epochs not in increasing order") == 0);
+    bad.assign(obs.begin(), obs.begin() + 2);
+    CHECK(Check("abmf0010.24o", bad) == "no 'END OF HEADER' line");
+    bad.assign(obs.begin(), obs.begin() + 3);
+    CHECK(Check("abmf0010.24o", bad) == "no epochs");
+
+    /* SP3: the epochs as many as declared and the 'EOF' line, also behind a compression extension */
+    CHECK(Check("igs22000.sp3", Sp3(2)).empty());
+    CHECK(Check("igs22000.sp3.Z", Sp3(2)).empty());
+    CHECK(Check("igs22000.sp3", Sp3(3)) == "2 epochs, but 3 in the header");
+    std::vector<string> sp3 = Sp3(2);
+    sp3.pop_back();
+    CHECK(Check("igs22000.sp3", sp3) == "no 'EOF' line");
+
+    /* any format: not empty and not an error page of the server */
+    CHECK(Check("igs20.atx", { "<!DOCTYPE html>", "<html>" }) == "an HTML or XML page");
+    CHECK(Check("igs22000.sp3", {}) == "empty file");
+    CHECK(Check("igs20.atx", { "     1.4            M                   ANTEX VERSION / SYST" }).empty());
+
+    /* the validation pass: a valid file is reported, an invalid one is quarantined and re-queued until
+       'validRetry' is used up */
+    char cwd[MAXSTRPATH] = { '\0' };
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) return 1;
+    string root = string(cwd) + "/test_check.tmp";
+    string cmd = "rm -rf " + root + " && mkdir -p " + root;
+    std::system(cmd.c_str());
+    CHECK(chdir(root.c_str()) == 0);
+
+    prcopt_t popt;
+    ftpopt_t fopt;
+    PreProcess preProc;
+    preProc.init(&popt, &fopt);
+    fopt.validate = true;
+    fopt.validRetry = 1;
+    fopt.validThreads = 2;
+    std::vector<std::pair<string, bool> > reported;
+    fopt.onFile = [&reported](const char *file, bool ok) { reported.push_back(std::make_pair(string(file), ok)); };
+    FtpUtilTest ftp;
+    CHECK(WriteLines("abmf0010.24o", obs));
+    CHECK(WriteLines("bake0010.24o", std::vector<string>(obs.begin(), obs.end() - 1)));
+    ftp.NotifyFile(&fopt, "abmf0010.24o");
+    ftp.NotifyFile(&fopt, "bake0010.24o");
+    CHECK(reported.empty());
+    ftp.ValidateFiles(&fopt);
+    CHECK(reported.size() == 1 && reported[0].first == root + "/abmf0010.24o" && reported[0].second);
+    CHECK(access("abmf0010.24o", 0) == 0);
+    CHECK(access("bake0010.24o", 0) == -1 && access("quarantine/bake0010.24o", 0) == 0);
+    CHECK(ftp.ftp.IsRequeued());
+
+    /* downloaded again and still invalid: given up and reported as failed */
+    CHECK(WriteLines("bake0010.24o", std::vector<string>(obs.begin(), obs.end() - 1)));
+    ftp.NotifyFile(&fopt, "bake0010.24o");
+    ftp.ValidateFiles(&fopt);
+    CHECK(reported.size() == 2 && reported.back().first == root + "/bake0010.24o" && !reported.back().second);
+    CHECK(access("bake0010.24o", 0) == -1 && access("quarantine/bake0010.24o", 0) == 0);
+
+    if (chdir(cwd) == 0)
+    {
+        cmd = "rm -rf " + root;
+        std::system(cmd.c_str());
+    }
+
+    return TestResult("test_check");
+}
\ No newline at end of file
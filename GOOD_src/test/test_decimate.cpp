@@ -0,0 +1,116 @@
+/*------------------------------------------------------------------------------
+* test_decimate.cpp : the decimation of the observation files on the fly
+*
+* usage : test_decimate
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "FilterUtil.h"
+#include "TestUtil.h"
+
+/* a header line with its label in column 61 */
+static string Head(const string &text, const string &label)
+{
+    string line = text;
+    line.resize(60, ' ');
+
+    return line + label;
+}
+
+/* run the lines through a filter */
+static std::vector<string> Filter(FilterUtil &filter, const std::vector<string> &lines)
+{
+    ostringstream out;
+    filter.Reset();
+    for (const string &line : lines) filter.Put(line, out);
+    filter.Finish(out);
+
+    std::vector<string> result;
+    istringstream in(out.str());
+    string line;
+    while (getline(in, line)) result.push_back(line);
+
+    return result;
+}
+
+/* number of the lines starting with a prefix */
+static int Count(const std::vector<string> &lines, const string &prefix)
+{
+    int n = 0;
+    for (const string &line : lines) n += line.compare(0, prefix.size(), prefix) == 0 ? 1 : 0;
+
+    return n;
+}
+
+/* RINEX 3: 4 epochs of 30 s with a GPS and a Galileo satellite, an event with a comment after the second one */
+static std::vector<string> Rinex3()
+{
+    std::vector<string> lines = { Head("     3.04           OBSERVATION DATA    M", "RINEX VERSION / TYPE"),
+        Head("G    4 C1C L1C C2W L2W", "SYS / # / OBS TYPES"), Head("E    2 C1X L1X", "SYS / # / OBS TYPES"),
+        Head("    30.000", "INTERVAL"), Head("", "END OF HEADER") };
+    char buff[MAXCHARS];
+    for (int i = 0; i < 4; i++)
+    {
+        snprintf(buff, sizeof(buff), "> 2024 01 01 00 %02d %10.7f  0  2", i / 2, (i % 2) * 30.0);
+        lines.push_back(buff);
+        lines.push_back("G01  20000000.100   105000000.200    20000000.300    82000000.400  ");
+        lines.push_back("E11  21000000.500   110000000.600  ");
+        if (i == 1)
+        {
+            lines.push_back(">                              4  1");
+            lines.push_back(Head("ANTENNA MOVED", "COMMENT"));
+        }
+    }
+
+    return lines;
+}
+
+/* RINEX 2: 3 epochs of 30 s with 13 satellites over 2 epoch lines, the last one 3 ms early */
+static std::vector<string> Rinex2()
+{
+    std::vector<string> lines = { Head("     2.11           OBSERVATION DATA    G (GPS)", "RINEX VERSION / TYPE"),
+        Head("     2    C1    L1", "# / TYPES OF OBSERV"), Head("", "END OF HEADER") };
+    const double secs[3] = { 0.0, 30.0, 59.997 };
+    char buff[MAXCHARS];
+    for (int i = 0; i < 3; i++)
+    {
+        snprintf(buff, sizeof(buff), " 24  1  1  0  0 %10.7f  0 13G01G02G03G04G05G06G07G08G09G10G11G12", secs[i]);
+        lines.push_back(buff);
+        lines.push_back("                                G13");
+        for (int k = 0; k < 13; k++) lines.push_back("  20000000.000 7 105000000.000 7");
+    }
+
+    return lines;
+}
+
+int main()
+{
+    FilterUtil filter;
+    filter.Set(0, "", "");
+    CHECK(!filter.IsOn());
+
+    /* the epochs on the 60 s grid, the event is kept as it is and the interval of the header is changed */
+    filter.Set(60, "", "");
+    CHECK(filter.IsOn());
+    std::vector<string> out = Filter(filter, Rinex3());
+    CHECK(Count(out, "> 2024") == 2);
+    CHECK(Count(out, "> 2024 01 01 00 00  0.0000000") == 1 && Count(out, "> 2024 01 01 00 01  0.0000000") == 1);
+    CHECK(Count(out, "G01") == 2 && Count(out, "E11") == 2);
+    CHECK(Count(out, ">                              4  1") == 1 && Count(out, "ANTENNA MOVED") == 1);
+    CHECK(Count(out, "    60.000") == 1 && Count(out, "    30.000") == 0);
+
+    /* an interval shorter than the one of the file keeps all the epochs */
+    filter.Set(15, "", "");
+    out = Filter(filter, Rinex3());
+    CHECK(Count(out, "> 2024") == 4 && Count(out, "G01") == 4);
+
+    /* RINEX 2: the continuation and the data lines go with their epoch, 3 ms off the grid is on it */
+    filter.Set(60, "", "");
+    out = Filter(filter, Rinex2());
+    CHECK(Count(out, " 24  1  1") == 2);
+    CHECK(Count(out, "                                G13") == 2);
+    CHECK(Count(out, "  20000000.000") == 26);
+    CHECK(Count(out, " 24  1  1  0  0 30.0000000") == 0 && Count(out, " 24  1  1  0  0 59.9970000") == 1);
+
+    return TestResult("test_decimate");
+}
\ No newline at end of file
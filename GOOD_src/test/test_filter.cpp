@@ -0,0 +1,123 @@
+/*------------------------------------------------------------------------------
+* test_filter.cpp : the system and code filters of the observation files
+*
+* usage : test_filter
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "FilterUtil.h"
+#include "TestUtil.h"
+
+/* a header line with its label in column 61 */
+static string Head(const string &text, const string &label)
+{
+    string line = text;
+    line.resize(60, ' ');
+
+    return line + label;
+}
+
+/* run the lines through a filter */
+static std::vector<string> Filter(FilterUtil &filter, const std::vector<string> &lines)
+{
+    ostringstream out;
+    filter.Reset();
+    for (const string &line : lines) filter.Put(line, out);
+    filter.Finish(out);
+
+    std::vector<string> result;
+    istringstream in(out.str());
+    string line;
+    while (getline(in, line)) result.push_back(line);
+
+    return result;
+}
+
+/* number of the lines starting with a prefix */
+static int Count(const std::vector<string> &lines, const string &prefix)
+{
+    int n = 0;
+    for (const string &line : lines) n += line.compare(0, prefix.size(), prefix) == 0 ? 1 : 0;
+
+    return n;
+}
+
+/* RINEX 3: 4 epochs of 30 s with a GPS and a Galileo satellite, an event with a comment after the second one */
+static std::vector<string> Rinex3()
+{
+    std::vector<string> lines = { Head("     3.04           OBSERVATION DATA    M", "RINEX VERSION / TYPE"),
+        Head("G    4 C1C L1C C2W L2W", "SYS / # / OBS TYPES"), Head("E    2 C1X L1X", "SYS / # / OBS TYPES"),
+        Head("    30.000", "INTERVAL"), Head("", "END OF HEADER") };
+    char buff[MAXCHARS];
+    for (int i = 0; i < 4; i++)
+    {
+        snprintf(buff, sizeof(buff), "> 2024 01 01 00 %02d %10.7f  0  2", i / 2, (i % 2) * 30.0);
+        lines.push_back(buff);
+        lines.push_back("G01  20000000.100   105000000.200    20000000.300    82000000.400  ");
+        lines.push_back("E11  21000000.500   110000000.600  ");
+        if (i == 1)
+        {
+            lines.push_back(">                              4  1");
+            lines.push_back(Head("ANTENNA MOVED", "COMMENT"));
+        }
+    }
+
+    return lines;
+}
+
+int main()
+{
+    FilterUtil filter;
+    filter.Set(0, "", "");
+    CHECK(!filter.IsOn());
+
+    /* GPS only with 'C1C' and 'L1?': the Galileo types and satellites are gone, the GPS types are picked and
+       the tail blanks of the data lines are dropped */
+    filter.Set(0, "G", "C1C,L1?");
+    CHECK(filter.IsOn());
+    std::vector<string> out = Filter(filter, Rinex3());
+    CHECK(Count(out, "G    2 C1C L1C") == 1);
+    CHECK(Count(out, "E    ") == 0 && Count(out, "E11") == 0);
+    CHECK(Count(out, "> 2024") == 4);
+    for (const string &line : out)
+    {
+        if (line.compare(0, 6, "> 2024") == 0) CHECK(line.substr(32, 3) == "  1");
+        if (line.compare(0, 3, "G01") == 0) CHECK(line == "G01  20000000.100   105000000.200");
+    }
+
+    /* GPS and Galileo with 'C1?': one type each, the GLONASS types and satellite of the first epoch are gone */
+    std::vector<string> rnx3 = Rinex3();
+    rnx3.insert(rnx3.begin() + 3, Head("R    2 C1C L1C", "SYS / # / OBS TYPES"));
+    rnx3[6] = "> 2024 01 01 00 00  0.0000000  0  3";
+    rnx3.insert(rnx3.begin() + 9, "R05  22000000.500   120000000.600  ");
+    filter.Set(0, "GE", "C1?");
+    out = Filter(filter, rnx3);
+    CHECK(Count(out, "G    1 C1C") == 1 && Count(out, "E    1 C1X") == 1 && Count(out, "R    ") == 0);
+    CHECK(Count(out, "R05") == 0 && Count(out, "G01  20000000.100") == 4 && Count(out, "E11  21000000.500") == 4);
+    CHECK(Count(out, "> 2024 01 01 00 00  0.0000000  0  2") == 1);
+
+    /* RINEX 2 codes: the types of the header and the columns of the data lines */
+    std::vector<string> codes2 = { Head("     2.11           OBSERVATION DATA    M (MIXED)", "RINEX VERSION / TYPE"),
+        Head("     3    C1    L1    P2", "# / TYPES OF OBSERV"), Head("", "END OF HEADER"),
+        " 24  1  1  0  0  0.0000000  0  2G01R05", "  20000000.000 7 105000000.000 7  20000001.000 7",
+        "  21000000.000 7 110000000.000 7  21000001.000 7" };
+    filter.Set(0, "", "C1,P2");
+    out = Filter(filter, codes2);
+    CHECK(out.size() == 6);
+    CHECK(out.size() == 6 && out[1].compare(0, 18, "     2    C1    P2") == 0);
+    CHECK(out.size() == 6 && out[4] == "  20000000.000 7  20000001.000 7");
+    CHECK(out.size() == 6 && out[5] == "  21000000.000 7  21000001.000 7");
+
+    /* RINEX 2: 13 satellites over 2 epoch lines, only the GLONASS one is kept */
+    std::vector<string> rnx2 = { Head("     2.11           OBSERVATION DATA    M (MIXED)", "RINEX VERSION / TYPE"),
+        Head("     2    C1    L1", "# / TYPES OF OBSERV"), Head("", "END OF HEADER"),
+        " 24  1  1  0  0  0.0000000  0 13G01G02G03G04G05G06G07G08G09G10G11G12",
+        "                                R05" };
+    for (int k = 0; k < 13; k++) rnx2.push_back("  20000000.000 7 105000000.000 7");
+    filter.Set(0, "R", "");
+    out = Filter(filter, rnx2);
+    CHECK(out.size() == 5);
+    CHECK(out.size() == 5 && out[3] == " 24  1  1  0  0  0.0000000  0  1R05");
+
+    return TestResult("test_filter");
+}
\ No newline at end of file
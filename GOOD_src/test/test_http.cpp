@@ -0,0 +1,158 @@
+/*------------------------------------------------------------------------------
+* test_http.cpp : the HTTP(S) transfer layer ('curl') against a local stand-in archive ('python3 -m http.server')
+*
+* usage : test_http (skipped if 'python3' or 'curl' is not found)
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "TimeUtil.h"
+#include "StringUtil.h"
+#include "CatalogUtil.h"
+#include "CacheUtil.h"
+#include "RateUtil.h"
+#include "BucketUtil.h"
+#include "StoreUtil.h"
+#include "LockUtil.h"
+#include "ZstdUtil.h"
+#include "IndexUtil.h"
+#include "FilterUtil.h"
+#include "CheckUtil.h"
+#include "InventUtil.h"
+#include "SiteUtil.h"
+#include "PlanUtil.h"
+#include "FtpUtil.h"
+#include "PreProcess.h"
+#include "TestUtil.h"
+
+/* the HTTP(S) routines of the downloader, which is a friend of the test */
+class FtpUtilTest
+{
+public:
+    FtpUtil ftp;
+    bool HttpBatch(const ftpopt_t *fopt, const string &url, const std::vector<string> &patterns, int conc,
+        int &used, bool &err)
+    {
+        return ftp.HttpBatch(fopt, url, patterns, conc, used, err);
+    }
+    bool HttpMatch(const ftpopt_t *fopt, const string &url, const std::vector<string> &patterns,
+        std::vector<string> &files)
+    {
+        return ftp.HttpMatch(fopt, url, patterns, files);
+    }
+    void FetchBatch(const ftpopt_t *fopt, const string &url, const string &cutDirs, const std::vector<string> &patterns)
+    {
+        ftp.FetchBatch(fopt, url, cutDirs, patterns);
+    }
+    string FetchCmd(const ftpopt_t *fopt, const string &url, const string &cutDirs, const string &accept)
+    {
+        return ftp.FetchCmd(fopt, url, cutDirs, accept);
+    }
+    bool RemoteStat(const ftpopt_t *fopt, const string &url, const string &file, catent_t &ent)
+    {
+        return ftp.RemoteStat(fopt, url, file, ent);
+    }
+};
+
+/* start over in an empty download directory */
+static void CleanDir(const string &dir)
+{
+    string cmd = "rm -rf " + dir + " && mkdir -p " + dir;
+    std::system(cmd.c_str());
+}
+
+int main()
+{
+    if (std::system("python3 --version > /dev/null 2>&1") != 0 || std::system("curl --version > /dev/null 2>&1") != 0)
+    {
+        cout << "SKIPPED: test_http ('python3' or 'curl' is not found)" << endl;
+
+        return 0;
+    }
+
+    char cwd[MAXSTRPATH] = { '\0' };
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) return 1;
+    string root = string(cwd) + "/test_http.tmp", outDir = root + "/out";
+    string cmd = "rm -rf " + root + " && mkdir -p " + root + "/srv/d";
+    std::system(cmd.c_str());
+
+    /* the stand-in archive: three observation files in '/d' */
+    StringUtil str;
+    std::vector<string> names = { "AAAA0010.24o.gz", "BBBB0010.24o.gz", "CCCC0020.24o.gz" };
+    for (const string &name : names) CHECK(str.WriteFile(root + "/srv/d/" + name, "content of " + name + "\n"));
+
+    /* the server runs in the background until the test ends, a port of its own for each test process */
+    string port = to_string(18000 + getpid() % 1000), url = "http://127.0.0.1:" + port + "/d";
+    cmd = "cd " + root + "/srv && { python3 -m http.server " + port + " --bind 127.0.0.1 > ../server.log 2>&1 & " +
+        "echo $! > ../server.pid; }";
+    std::system(cmd.c_str());
+    bool up = false;
+    cmd = "curl -s -f -o /dev/null " + url + "/";
+    for (int i = 0; i < 50 && !up; i++)
+    {
+        up = std::system(cmd.c_str()) == 0;
+        if (!up) usleep(100000);
+    }
+    CHECK(up);
+
+    prcopt_t popt;
+    ftpopt_t fopt;
+    PreProcess preProc;
+    preProc.init(&popt, &fopt);
+    fopt.wgetFull = "wget";
+    fopt.curlFull = "curl";
+    fopt.gzipFull = "gzip";
+    fopt.qr = "-qr";
+    FtpUtilTest ftp;
+
+    CleanDir(outDir);
+    if (up && chdir(outDir.c_str()) != 0) up = false;
+    if (up)
+    {
+        /* exact names: requested without the index, a file that is not there is not an error of the server */
+        std::vector<string> exact = { "AAAA0010.24o.gz", "CCCC0020.24o.gz", "ZZZZ0010.24o.gz" };
+        int used = 0;
+        bool err = false;
+        CHECK(ftp.HttpBatch(&fopt, url, exact, 2, used, err));
+        CHECK(!err && used == 2);
+        CHECK(ReadAll("AAAA0010.24o.gz") == "content of AAAA0010.24o.gz\n");
+        CHECK(ReadAll("CCCC0020.24o.gz") == "content of CCCC0020.24o.gz\n");
+        CHECK(access("BBBB0010.24o.gz", 0) == -1);
+
+        /* wildcards: matched against the directory index of the server */
+        std::vector<string> files;
+        CHECK(ftp.HttpMatch(&fopt, url, { "*0010.24o.gz" }, files));
+        std::sort(files.begin(), files.end());
+        CHECK(files == std::vector<string>({ "AAAA0010.24o.gz", "BBBB0010.24o.gz" }));
+
+        /* the batch of a directory, as the observation routines call it */
+        CleanDir(outDir);
+        CHECK(chdir(outDir.c_str()) == 0);
+        ftp.FetchBatch(&fopt, url, " --cut-dirs=1 ", { "*0010.24o.gz" });
+        CHECK(ReadAll("AAAA0010.24o.gz") == "content of AAAA0010.24o.gz\n");
+        CHECK(ReadAll("BBBB0010.24o.gz") == "content of BBBB0010.24o.gz\n");
+        CHECK(access("CCCC0020.24o.gz", 0) == -1);
+
+        /* a single remote file goes through 'curl' as well */
+        CleanDir(outDir);
+        CHECK(chdir(outDir.c_str()) == 0);
+        cmd = ftp.FetchCmd(&fopt, url + "/CCCC0020.24o.gz", " --cut-dirs=1 ", "");
+        CHECK(cmd.compare(0, 4, "curl") == 0);
+        std::system(cmd.c_str());
+        CHECK(ReadAll("CCCC0020.24o.gz") == "content of CCCC0020.24o.gz\n");
+
+        /* the size of a remote file is taken from the response headers */
+        catent_t ent;
+        CHECK(ftp.RemoteStat(&fopt, url, "AAAA0010.24o.gz", ent));
+        CHECK(ent.size == (long long)string("content of AAAA0010.24o.gz\n").size());
+        CHECK(!ftp.RemoteStat(&fopt, url, "ZZZZ0010.24o", ent));
+    }
+
+    cmd = "kill $(cat " + root + "/server.pid) > /dev/null 2>&1";
+    std::system(cmd.c_str());
+    if (chdir(cwd) == 0)
+    {
+        cmd = "rm -rf " + root;
+        std::system(cmd.c_str());
+    }
+
+    return TestResult("test_http");
+}
\ No newline at end of file
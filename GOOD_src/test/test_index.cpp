@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------------------
+* test_index.cpp : the epoch index of RINEX 2 and 3 observation files finds the records of a time window
+*
+* usage : test_index
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "TimeUtil.h"
+#include "IndexUtil.h"
+#include "TestUtil.h"
+
+/* a header line with its label in column 61 */
+static string Head(const string &text, const string &label)
+{
+    string line = text;
+    line.resize(60, ' ');
+
+    return line + label + "\n";
+}
+
+/* an epoch time of 2024/01/01 */
+static gtime_t Epoch(double sod)
+{
+    double date[6] = { 2024, 1, 1, 0, 0, 0 };
+    date[3] = floor(sod / 3600.0);
+    date[4] = floor((sod - date[3] * 3600.0) / 60.0);
+    date[5] = sod - date[3] * 3600.0 - date[4] * 60.0;
+    TimeUtil tu;
+
+    return tu.ymdhms2time(date);
+}
+
+/* RINEX 3: 4 epochs of 30 s with 2 satellites, an event with a comment after the second one */
+static string Rinex3(std::vector<long long> &offs)
+{
+    string text = Head("     3.04           OBSERVATION DATA    M", "RINEX VERSION / TYPE") +
+        Head("G    2 C1C L1C", "SYS / # / OBS TYPES") + Head("E    2 C1X L1X", "SYS / # / OBS TYPES") +
+        Head("", "END OF HEADER");
+    char buff[MAXCHARS];
+    for (int i = 0; i < 4; i++)
+    {
+        offs.push_back((long long)text.size());
+        snprintf(buff, sizeof(buff), "> 2024 01 01 00 %02d %10.7f  0  2\n", i / 2, (i % 2) * 30.0);
+        text += buff;
+        text += "G01  20000000.000   105000000.000  \nE11  21000000.000   110000000.000  \n";
+        if (i == 1) text += ">                              4  1\n" + Head("ANTENNA MOVED", "COMMENT");
+    }
+
+    return text;
+}
+
+/* RINEX 2: 3 epochs of 30 s with 13 satellites of 6 types, so each epoch has a continuation line and each
+   satellite 2 data lines */
+static string Rinex2(std::vector<long long> &offs)
+{
+    string text = Head("     2.11           OBSERVATION DATA    G (GPS)", "RINEX VERSION / TYPE") +
+        Head("     6    C1    L1    L2    P1    P2    S1", "# / TYPES OF OBSERV") + Head("", "END OF HEADER");
+    char buff[MAXCHARS];
+    for (int i = 0; i < 3; i++)
+    {
+        offs.push_back((long long)text.size());
+        snprintf(buff, sizeof(buff), " 24  1  1  0  %d %10.7f  0 13", i / 2, (i % 2) * 30.0);
+        text += buff;
+        for (int k = 1; k <= 12; k++)
+        {
+            snprintf(buff, sizeof(buff), "G%02d", k);
+            text += buff;
+        }
+        text += "\n                                G13\n";
+        for (int k = 1; k <= 13; k++)
+        {
+            /* a data line that looks like an epoch line must not be taken for one */
+            text += "  20000000.000   105000000.000    82000000.000    20000000.000    20000001.000  \n";
+            text += "        45.000  \n";
+        }
+    }
+
+    return text;
+}
+
+int main()
+{
+    const string rnxFile = "test_index.tmp", idxFile = rnxFile + ".idx";
+    StringUtil str;
+    IndexUtil index;
+    CHECK(index.IdxName("abmf0320.21o.zst") == "abmf0320.21o.idx");
+    CHECK(index.IdxName("abmf0320.21o") == "abmf0320.21o.idx");
+
+    /* RINEX 3: the window [30 s, 90 s) holds the epochs 30 s and 60 s and the event after 30 s */
+    std::vector<long long> offs;
+    string text = Rinex3(offs);
+    CHECK(str.WriteFile(rnxFile, text));
+    CHECK(index.Build(rnxFile, idxFile));
+    long long size = (long long)text.size(), hdrSize, off, len;
+    CHECK(index.Find(idxFile, size, Epoch(30.0), Epoch(90.0), hdrSize, off, len));
+    CHECK(hdrSize == offs[0]);
+    CHECK(off == offs[1] && len == offs[3] - offs[1]);
+    CHECK(text.substr(off, len).find("ANTENNA MOVED") != string::npos);
+
+    /* the last epoch goes up to the end of the file, a window after it is empty */
+    CHECK(index.Find(idxFile, size, Epoch(90.0), Epoch(3600.0), hdrSize, off, len));
+    CHECK(off == offs[3] && off + len == size);
+    CHECK(index.Find(idxFile, size, Epoch(120.0), Epoch(3600.0), hdrSize, off, len));
+    CHECK(len == 0);
+
+    /* the index of a file of another size is stale, a missing index finds nothing */
+    CHECK(!index.Find(idxFile, size + 1, Epoch(0.0), Epoch(3600.0), hdrSize, off, len));
+    CHECK(!index.Find(idxFile + ".none", size, Epoch(0.0), Epoch(3600.0), hdrSize, off, len));
+
+    /* RINEX 2: the records are walked by the number of satellites and types */
+    offs.clear();
+    text = Rinex2(offs);
+    CHECK(str.WriteFile(rnxFile, text));
+    CHECK(index.Build(rnxFile, idxFile));
+    size = (long long)text.size();
+    CHECK(index.Find(idxFile, size, Epoch(30.0), Epoch(60.0), hdrSize, off, len));
+    CHECK(hdrSize == offs[0]);
+    CHECK(off == offs[1] && len == offs[2] - offs[1]);
+    CHECK(index.Find(idxFile, size, Epoch(0.0), Epoch(3600.0), hdrSize, off, len));
+    CHECK(off == offs[0] && off + len == size);
+
+    /* a navigation file is not indexed */
+    CHECK(str.WriteFile(rnxFile, Head("     2.11           N: GPS NAV DATA", "RINEX VERSION / TYPE") +
+        Head("", "END OF HEADER")));
+    CHECK(!index.Build(rnxFile, idxFile + ".nav"));
+
+    remove(rnxFile.c_str());
+    remove(idxFile.c_str());
+
+    return TestResult("test_index");
+}
\ No newline at end of file
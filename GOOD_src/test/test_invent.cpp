@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------------------
+* test_invent.cpp : the inventory of the observation files is taken from their headers, saved as CSV and loaded
+*                   again, merged between the processes and from the shards
+*
+* usage : test_invent
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "InventUtil.h"
+#include "TestUtil.h"
+
+/* a header line with its label in column 61 */
+static string Head(const string &text, const string &label)
+{
+    string line = text;
+    line.resize(60, ' ');
+
+    return line + label;
+}
+
+/* scan the header lines of a file into the inventory, the number of the lines taken */
+static int Scan(InventUtil &invent, const string &name, const std::vector<string> &lines)
+{
+    invent.StartFile(name);
+    int n = 0;
+    for (const string &line : lines)
+    {
+        n++;
+        if (!invent.PutHead(line)) break;
+    }
+
+    return n;
+}
+
+/* RINEX 3 header of a mixed file, the GPS types over a continuation line */
+static std::vector<string> Rinex3()
+{
+    return { "3.0                 COMPACT RINEX FORMAT                    CRINEX VERS   / TYPE",
+        Head("     3.04           OBSERVATION DATA    M", "RINEX VERSION / TYPE"), Head("ABMF", "MARKER NAME"),
+        Head("97103M001", "MARKER NUMBER"),
+        Head("3001234             SEPT POLARX5        5.3.2", "REC # / TYPE / VERS"),
+        Head("1234                TRM57971.00     NONE", "ANT # / TYPE"),
+        Head("  2919785.7120 -5383745.0670  1774604.8690", "APPROX POSITION XYZ"),
+        Head("        0.0000        0.0000        0.0000", "ANTENNA: DELTA H/E/N"),
+        Head("G   16 C1C L1C D1C S1C C2W L2W D2W S2W C2L L2L D2L S2L C5Q", "SYS / # / OBS TYPES"),
+        Head("       L5Q D5Q S5Q", "SYS / # / OBS TYPES"), Head("R    2 C1C L1C", "SYS / # / OBS TYPES"),
+        Head("    30.000", "INTERVAL"),
+        Head("  2021     2     1     0     0    0.0000000     GPS", "TIME OF FIRST OBS"),
+        Head("", "END OF HEADER"), "> 2021 02 01 00 00  0.0000000  0  0" };
+}
+
+int main()
+{
+    const string dir = "test_invent.tmp", invFile = dir + "/inventory.csv";
+    string cmd = "rm -rf " + dir + " && mkdir -p " + dir;
+    std::system(cmd.c_str());
+
+    /* RINEX 3: the lines of the compact RINEX before the header are skipped, the end of the header adds the entry */
+    InventUtil invent;
+    invent_t ent;
+    CHECK(!invent.Load(dir));
+    CHECK(invent.Dir() == dir);
+    std::vector<string> rnx3 = Rinex3();
+    CHECK(Scan(invent, "ABMF00GLP_R_20210320000_01D_30S_MO.crx.gz", rnx3) == (int)rnx3.size() - 1);
+    CHECK(invent.Find("ABMF00GLP_R_20210320000_01D_30S_MO.crx.gz", ent));
+    CHECK(ent.site == "abmf" && ent.marker == "ABMF" && ent.number == "97103M001");
+    CHECK(ent.receiver == "SEPT POLARX5" && ent.firmware == "5.3.2" && ent.antenna == "TRM57971.00     NONE");
+    CHECK(ent.pos[0] == 2919785.712 && ent.pos[1] == -5383745.067 && ent.pos[2] == 1774604.869);
+    CHECK(ent.version == 3.04 && ent.interval == 30.0 && ent.first == "2021-02-01 00:00:00" && ent.systems == "GR");
+    CHECK(ent.types == "G:C1C L1C D1C S1C C2W L2W D2W S2W C2L L2L D2L S2L C5Q L5Q D5Q S5Q;R:C1C L1C");
+
+    /* RINEX 2: the system of the file and the types shared by the systems */
+    std::vector<string> rnx2 = { Head("     2.11           OBSERVATION DATA    M (MIXED)", "RINEX VERSION / TYPE"),
+        Head("HKWS \"NEW\", PILLAR", "MARKER NAME"), Head("     4    C1    L1    L2    P2", "# / TYPES OF OBSERV"),
+        Head("", "END OF HEADER") };
+    Scan(invent, "hkws0320.21o", rnx2);
+    CHECK(invent.Find("hkws0320.21o", ent));
+    CHECK(ent.version == 2.11 && ent.systems == "M" && ent.types == "C1 L1 L2 P2" && ent.interval == 0.0);
+
+    /* a continuation line of the types before any system line is taken without one */
+    std::vector<string> cont = { Head("     3.04           OBSERVATION DATA    G", "RINEX VERSION / TYPE"),
+        Head("       L5Q D5Q", "SYS / # / OBS TYPES"), Head("", "END OF HEADER") };
+    Scan(invent, "bake0320.21o", cont);
+    CHECK(invent.Find("bake0320.21o", ent) && ent.types == "L5Q D5Q");
+
+    /* the quotes and commas of the fields go through the CSV round trip */
+    CHECK(invent.Save());
+    CHECK(ReadAll(invFile).find("\"HKWS \"\"NEW\"\", PILLAR\"") != string::npos);
+    InventUtil again;
+    CHECK(again.Load(dir));
+    CHECK(again.Find("hkws0320.21o", ent) && ent.marker == "HKWS \"NEW\", PILLAR" && ent.types == "C1 L1 L2 P2");
+    CHECK(again.Find("ABMF00GLP_R_20210320000_01D_30S_MO.crx.gz", ent) && ent.pos[1] == -5383745.067);
+    CHECK(ent.types == "G:C1C L1C D1C S1C C2W L2W D2W S2W C2L L2L D2L S2L C5Q L5Q D5Q S5Q;R:C1C L1C");
+    std::vector<invent_t> ents;
+    again.Entries(ents);
+    CHECK(ents.size() == 3 && ents[0].name == "ABMF00GLP_R_20210320000_01D_30S_MO.crx.gz");
+    CHECK(ents.size() == 3 && ents[1].name == "bake0320.21o" && ents[2].name == "hkws0320.21o");
+
+    /* one process removes a row, another one adds a row: both changes are kept */
+    InventUtil a, b;
+    a.Load(dir);
+    b.Load(dir);
+    a.Remove("bake0320.21o");
+    Scan(b, "kir00320.21o", rnx2);
+    CHECK(a.Save() && b.Save());
+    again.Load(dir);
+    CHECK(!again.Find("bake0320.21o", ent) && again.Find("kir00320.21o", ent) && again.Find("hkws0320.21o", ent));
+
+    /* the shards keep their rows apart, a later shard replaces the row of the inventory */
+    InventUtil shard1, shard2;
+    CHECK(!shard1.Load(dir, "1of2") && !shard2.Load(dir, "2of2"));
+    Scan(shard1, "mas10320.21o", rnx2);
+    Scan(shard2, "hkws0320.21o", rnx3);
+    CHECK(shard1.Save() && shard2.Save());
+    const string shardFile1 = dir + "/inventory.1of2.csv", shardFile2 = dir + "/inventory.2of2.csv";
+    CHECK(access(shardFile1.c_str(), 0) == 0 && access(shardFile2.c_str(), 0) == 0);
+    again.Load(dir);
+    CHECK(!again.Find("mas10320.21o", ent));
+    CHECK(again.Merge(dir) == 2);
+    CHECK(access(shardFile1.c_str(), 0) == -1 && access(shardFile2.c_str(), 0) == -1);
+    again.Load(dir);
+    CHECK(again.Find("mas10320.21o", ent) && again.Find("kir00320.21o", ent));
+    CHECK(again.Find("hkws0320.21o", ent) && ent.version == 3.04 && ent.marker == "ABMF");
+    CHECK(again.Merge(dir) == 0);
+
+    cmd = "rm -rf " + dir;
+    std::system(cmd.c_str());
+
+    return TestResult("test_invent");
+}
\ No newline at end of file
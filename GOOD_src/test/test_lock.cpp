@@ -0,0 +1,118 @@
+/*------------------------------------------------------------------------------
+* test_lock.cpp : the locks shared by the processes, the locked save of the tables and the temporary names
+*
+* usage : test_lock
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "LockUtil.h"
+#include "TestUtil.h"
+
+/* another process: try the lock without waiting, exit code 0:locked, 2:held by another process */
+static int RunTry(const string &lockFile)
+{
+    LockUtil lock;
+
+    return lock.Lock(lockFile, false) ? 0 : 2;
+}
+
+/* another process: hold the lock for 'ms' milliseconds, 'lockFile' + '.ready' tells that it is held */
+static int RunHold(const string &lockFile, int ms)
+{
+    LockUtil lock;
+    if (!lock.Lock(lockFile, false)) return 2;
+    StringUtil str;
+    str.WriteFile(lockFile + ".ready", "1\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3 && string(argv[1]) == "try") return RunTry(argv[2]);
+    if (argc == 4 && string(argv[1]) == "hold") return RunHold(argv[2], atoi(argv[3]));
+
+    char cwd[MAXSTRPATH] = { '\0' };
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) return 1;
+    string root = string(cwd) + "/test_lock.tmp", lockFile = root + "/a.lock";
+    string cmd = "rm -rf " + root + " && mkdir -p " + root;
+    std::system(cmd.c_str());
+    string tryCmd = string(argv[0]) + " try " + lockFile;
+
+    /* a lock held by this process, again by this process, not by another one, and its file goes with it */
+    LockUtil lock;
+    CHECK(!lock.IsLocked(lockFile));
+    CHECK(lock.Lock(lockFile, false));
+    CHECK(lock.IsLocked(lockFile) && access(lockFile.c_str(), 0) == 0);
+    CHECK(lock.Lock(lockFile, false));
+    CHECK(std::system(tryCmd.c_str()) != 0);
+    lock.Unlock(lockFile);
+    CHECK(!lock.IsLocked(lockFile) && access(lockFile.c_str(), 0) == -1);
+    CHECK(std::system(tryCmd.c_str()) == 0);
+    lock.Unlock(lockFile);
+
+    /* all the locks go at once, and with the object */
+    CHECK(lock.Lock(lockFile, false) && lock.Lock(root + "/b.lock", false));
+    lock.UnlockAll();
+    CHECK(!lock.IsLocked(lockFile) && !lock.IsLocked(root + "/b.lock"));
+    CHECK(std::system(tryCmd.c_str()) == 0);
+    {
+        LockUtil scoped;
+        CHECK(scoped.Lock(lockFile, false));
+    }
+    CHECK(std::system(tryCmd.c_str()) == 0);
+    CHECK(!lock.Lock(root + "/none/a.lock", false));
+
+    /* a lock held by another process is taken when it is released */
+    cmd = string(argv[0]) + " hold " + lockFile + " 300 &";
+    std::system(cmd.c_str());
+    for (int i = 0; i < 100 && access((lockFile + ".ready").c_str(), 0) == -1; i++) usleep(20000);
+    CHECK(access((lockFile + ".ready").c_str(), 0) == 0);
+    CHECK(!lock.Lock(lockFile, false));
+    CHECK(lock.Lock(lockFile, true));
+    CHECK(lock.IsLocked(lockFile) && access(lockFile.c_str(), 0) == 0);
+    lock.Unlock(lockFile);
+
+    /* the locked save: merged and written, removed on an empty text, and a lock held already is kept */
+    string table = root + "/table";
+    StringUtil str;
+    CHECK(str.WriteFile(table, "a\n"));
+    string merged;
+    CHECK(lock.SaveTable(table, [&](){ merged = ReadAll(table) + "b\n"; }, [&](){ return merged; }));
+    CHECK(ReadAll(table) == "a\nb\n");
+    CHECK(!lock.IsLocked(table + ".lock") && access((table + ".lock").c_str(), 0) == -1);
+    CHECK(lock.Lock(table + ".lock", false));
+    CHECK(lock.SaveTable(table, [](){}, [](){ return string(""); }));
+    CHECK(access(table.c_str(), 0) == -1);
+    CHECK(lock.IsLocked(table + ".lock"));
+    tryCmd = string(argv[0]) + " try " + table + ".lock";
+    CHECK(std::system(tryCmd.c_str()) != 0);
+    lock.UnlockAll();
+
+    /* the temporary names are unique within the process, over the calls and the threads */
+    std::vector<std::vector<string> > names(4);
+    std::vector<std::thread> threads;
+    for (int k = 0; k < 4; k++)
+    {
+        threads.push_back(std::thread([k, &names](){
+            StringUtil tstr;
+            for (int i = 0; i < 100; i++) names[k].push_back(tstr.TmpName("/tmp/.good_catalog"));
+        }));
+    }
+    for (std::thread &t : threads) t.join();
+    std::unordered_set<string> unique;
+    for (const auto &list : names) unique.insert(list.begin(), list.end());
+    CHECK(unique.size() == 400);
+    string name = str.TmpName("/tmp/.good_catalog");
+    CHECK(name.compare(0, 19, "/tmp/.good_catalog.") == 0 && name.size() > 23);
+    CHECK(name.compare(name.size() - 4, 4, ".tmp") == 0 && unique.count(name) == 0);
+
+    if (chdir(cwd) == 0)
+    {
+        cmd = "rm -rf " + root;
+        std::system(cmd.c_str());
+    }
+
+    return TestResult("test_lock");
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*------------------------------------------------------------------------------
+* test_plan.cpp : the size history is saved and loaded again and summed between the processes, and the
+*                 download plan is estimated from it
+*
+* usage : test_plan
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "RateUtil.h"
+#include "LockUtil.h"
+#include "PlanUtil.h"
+#include "TestUtil.h"
+
+/* the report of a plan as it is printed */
+static string Report(PlanUtil &plan, RateUtil &rate)
+{
+    ostringstream out;
+    std::streambuf *buf = cout.rdbuf(out.rdbuf());
+    plan.Report(rate);
+    cout.rdbuf(buf);
+
+    return out.str();
+}
+
+int main()
+{
+    const string dir = "test_plan.tmp", sizeFile = dir + "/.good_sizes";
+    string cmd = "rm -rf " + dir + " && mkdir -p " + dir;
+    std::system(cmd.c_str());
+
+    /* nothing to save to before a load, the nominal sizes without a history */
+    PlanUtil plan;
+    bool guessed = false;
+    CHECK(!plan.Save());
+    CHECK(!plan.Load(dir));
+    CHECK(plan.Size("obs.daily", guessed) == 600000 && guessed);
+    CHECK(plan.Size("unknown", guessed) == 1048576 && guessed);
+
+    /* the recorded files make the history, the empty records are skipped */
+    plan.Record("obs.daily", 2, 1000000);
+    plan.Record("obs.daily", 0, 1000);
+    plan.Record("", 1, 1000);
+    CHECK(plan.Size("obs.daily", guessed) == 500000 && !guessed);
+    CHECK(plan.Save());
+    CHECK(ReadAll(sizeFile) == "# kind  files  bytes\nobs.daily  2  1000000\n");
+    PlanUtil again;
+    CHECK(again.Load(dir));
+    CHECK(again.Size("obs.daily", guessed) == 500000 && !guessed);
+    CHECK(again.Save());
+
+    /* two processes record the same kind: the history on disk is their sum */
+    PlanUtil a, b;
+    a.Load(dir);
+    b.Load(dir);
+    a.Record("obs.daily", 1, 700000);
+    b.Record("obs.daily", 1, 300000);
+    b.Record("nav.daily", 1, 100);
+    CHECK(a.Save() && b.Save());
+    CHECK(again.Load(dir));
+    CHECK(again.Size("obs.daily", guessed) == 500000 && !guessed);
+    CHECK(again.Size("nav.daily", guessed) == 100 && !guessed);
+    CHECK(ReadAll(sizeFile).find("obs.daily  4  2000000\n") != string::npos);
+    CHECK(a.Save() && ReadAll(sizeFile).find("obs.daily  4  2000000\n") != string::npos);
+
+    /* the plan: the files present are not downloaded, the bytes by the history or the nominal sizes, the hosts
+       with the nominal throughput */
+    RateUtil rate;
+    again.Add("obs.daily", "gdc.cddis.eosdis.nasa.gov", 3, 1);
+    again.Add("obs.hourly", "gdc.cddis.eosdis.nasa.gov", 2, 5);
+    again.Add("atx", "igs.ign.fr", 1, 0);
+    again.Unlisted("obs.daily", "gdc.cddis.eosdis.nasa.gov");
+    string report = Report(again, rate);
+    CHECK(report.find("obs.daily     gdc.cddis.eosdis.nasa.gov                 1          3          1          2") !=
+        string::npos);
+    CHECK(report.find("976.6 KB ") != string::npos && report.find("1.9 MB*") != string::npos);
+    CHECK(report.find("1 files are sized by the nominal sizes") != string::npos);
+    CHECK(report.find("unknown on 1 days") != string::npos);
+    CHECK(report.find("gdc.cddis.eosdis.nasa.gov: 2 sessions, 1024.0 KB/s (nominal), 2 s") != string::npos);
+    CHECK(report.find("projected runtime 4 s for 3 files (2.9 MB)") != string::npos);
+    again.Clear();
+    report = Report(again, rate);
+    CHECK(report.find("obs.daily") == string::npos && report.find("projected runtime 0 s for 0 files") != string::npos);
+
+    cmd = "rm -rf " + dir;
+    std::system(cmd.c_str());
+
+    return TestResult("test_plan");
+}
\ No newline at end of file
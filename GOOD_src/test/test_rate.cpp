@@ -0,0 +1,126 @@
+/*------------------------------------------------------------------------------
+* test_rate.cpp : the concurrency of a host follows the throughput (AIMD), the learning is saved, loaded again
+*                 and merged between the processes, and only the errors of the server count against it
+*
+* usage : test_rate ('wget' is played by a shell script that exits with the code given)
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "TimeUtil.h"
+#include "StringUtil.h"
+#include "CatalogUtil.h"
+#include "CacheUtil.h"
+#include "RateUtil.h"
+#include "BucketUtil.h"
+#include "StoreUtil.h"
+#include "LockUtil.h"
+#include "ZstdUtil.h"
+#include "IndexUtil.h"
+#include "FilterUtil.h"
+#include "CheckUtil.h"
+#include "InventUtil.h"
+#include "SiteUtil.h"
+#include "PlanUtil.h"
+#include "FtpUtil.h"
+#include "PreProcess.h"
+#include "TestUtil.h"
+
+/* the FTP batch of the downloader, which is a friend of the test */
+class FtpUtilTest
+{
+public:
+    FtpUtil ftp;
+    void WgetBatch(const ftpopt_t *fopt, const string &url, const std::vector<string> &patterns, int conc,
+        int &used, bool &err)
+    {
+        ftp.WgetBatch(fopt, url, " --cut-dirs=1 ", patterns, conc, used, err);
+    }
+};
+
+/* whether a batch of 'wget' exiting with a code is an error of the host */
+static bool IsHostError(const string &dir, int code, const std::vector<string> &patterns)
+{
+    string script = dir + "/wget.sh";
+    StringUtil str;
+    str.WriteFile(script, "#!/bin/sh\nexit " + to_string(code) + "\n");
+    chmod(script.c_str(), 0755);
+
+    prcopt_t popt;
+    ftpopt_t fopt;
+    PreProcess preProc;
+    preProc.init(&popt, &fopt);
+    fopt.wgetFull = script.c_str();
+    fopt.qr = "-qr";
+    FtpUtilTest ftp;
+    int used = 0;
+    bool err = false;
+    ftp.WgetBatch(&fopt, "ftp://127.0.0.1/d", patterns, 2, used, err);
+
+    return err;
+}
+
+int main()
+{
+    const string dir = "test_rate.tmp", hostFile = dir + "/.good_hosts";
+    const string cddis = "gdc.cddis.eosdis.nasa.gov", ign = "igs.ign.fr";
+    string cmd = "rm -rf " + dir + " && mkdir -p " + dir;
+    std::system(cmd.c_str());
+
+    RateUtil rate;
+    CHECK(rate.Host("ftps://gdc.cddis.eosdis.nasa.gov/pub/gnss/data/daily") == cddis);
+    CHECK(rate.Host("http://127.0.0.1:8000/d") == "127.0.0.1:8000");
+    CHECK(rate.Host("igs.ign.fr") == ign);
+
+    /* an unknown host starts with 2 sessions */
+    CHECK(!rate.Load(dir));
+    CHECK(rate.Conc(cddis) == 2 && rate.Rate(cddis) == 0.0);
+
+    /* additive increase while the throughput improves, decrease by one on a plateau */
+    CHECK(rate.Report(cddis, 2, 20000000, 10.0, false) == 3);
+    CHECK(rate.Report(cddis, 3, 30000000, 10.0, false) == 4);
+    CHECK(rate.Rate(cddis) == 3000000.0);
+    CHECK(rate.Report(cddis, 4, 30500000, 10.0, false) == 3);
+
+    /* a batch that used fewer sessions, or was too short, says nothing about the limit */
+    CHECK(rate.Report(cddis, 1, 90000000, 10.0, false) == 3);
+    CHECK(rate.Report(cddis, 3, 90000000, 1.0, false) == 3);
+
+    /* multiplicative decrease on errors, never below one session */
+    CHECK(rate.Report(cddis, 3, 0, 0.0, true) == 1);
+    CHECK(rate.Rate(cddis) == 0.0);
+    CHECK(rate.Report(cddis, 1, 0, 0.0, true) == 1);
+
+    /* at most 16 sessions */
+    for (int i = 0; i < 20; i++) rate.Report(ign, rate.Conc(ign), (long long)(i + 1) * 100000000, 10.0, false);
+    CHECK(rate.Conc(ign) == 16);
+
+    /* save and load again */
+    CHECK(rate.Save());
+    RateUtil a, b;
+    CHECK(a.Load(dir));
+    CHECK(a.Conc(cddis) == 1 && a.Conc(ign) == 16);
+
+    /* two processes learned of different hosts: each keeps the learning of the other */
+    b.Load(dir);
+    a.Report(cddis, 1, 10000000, 10.0, false);
+    b.Report(ign, 16, 0, 0.0, true);
+    CHECK(a.Save() && b.Save());
+    rate.Load(dir);
+    CHECK(rate.Conc(cddis) == 2 && rate.Conc(ign) == 8);
+
+    /* a concurrency edited out of range is clamped */
+    StringUtil str;
+    CHECK(str.WriteFile(hostFile, "# host  concurrency  throughput(bytes/s)\na.org  40  0\nb.org  0  0\n"));
+    rate.Load(dir);
+    CHECK(rate.Conc("a.org") == 16 && rate.Conc("b.org") == 1);
+
+    /* 'wget' of exact names: an error reply (8) is mostly a file not published yet, only a network failure (4)
+       counts; of wildcards: both count */
+    std::vector<string> exact = { "brdm0010.24p.gz", "brdm0020.24p.gz" }, wild = { "*0010.24d.gz" };
+    CHECK(!IsHostError(dir, 0, exact) && !IsHostError(dir, 8, exact) && IsHostError(dir, 4, exact));
+    CHECK(!IsHostError(dir, 0, wild) && IsHostError(dir, 8, wild) && IsHostError(dir, 4, wild));
+
+    cmd = "rm -rf " + dir;
+    std::system(cmd.c_str());
+
+    return TestResult("test_rate");
+}
\ No newline at end of file
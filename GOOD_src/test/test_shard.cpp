@@ -0,0 +1,177 @@
+/*------------------------------------------------------------------------------
+* test_shard.cpp : the jobs are partitioned among the shards, two shards of one run share the network listing
+*                 of 'all', and the merge releases it
+*
+* usage : test_shard (the shards are run as child processes of the test itself)
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "TimeUtil.h"
+#include "StringUtil.h"
+#include "CatalogUtil.h"
+#include "CacheUtil.h"
+#include "RateUtil.h"
+#include "BucketUtil.h"
+#include "StoreUtil.h"
+#include "LockUtil.h"
+#include "ZstdUtil.h"
+#include "IndexUtil.h"
+#include "FilterUtil.h"
+#include "CheckUtil.h"
+#include "InventUtil.h"
+#include "SiteUtil.h"
+#include "PlanUtil.h"
+#include "FtpUtil.h"
+#include "PreProcess.h"
+#include "TestUtil.h"
+#include <utime.h>
+
+/* the sharding routines of the downloader, which is a friend of the test */
+class FtpUtilTest
+{
+public:
+    FtpUtil ftp;
+    void Shard(int idx, int cnt)
+    {
+        ftp._plan.Shard(idx, cnt);
+    }
+    bool ShardJob(const prcopt_t *popt, int get, ftpopt_t &jopt)
+    {
+        return ftp.ShardJob(popt, get, jopt);
+    }
+    int MergeDir(const string &dir, bool recursive, std::unordered_set<string> &merged)
+    {
+        return ftp.MergeDir(dir, recursive, merged);
+    }
+};
+
+/* the options of one shard of a two-way run of the IGS daily observations of 'all' */
+static void ShardOpt(const string &root, int idx, prcopt_t &popt, ftpopt_t &fopt)
+{
+    PreProcess preProc;
+    preProc.init(&popt, &fopt);
+    TimeUtil tu;
+    popt.ts = tu.TimeNow();
+    StringUtil str;
+    popt.obsDir = str.Intern(root + "/obs");
+    fopt.obsOpt = "all";
+    fopt.obsTyp = OBS_DAILY;
+    fopt.shardIdx = idx;
+    fopt.shardCnt = 2;
+}
+
+/* the cache file of the IGS network listing of the day, as 'NetworkSites' names it */
+static string CacheFile(const string &root)
+{
+    TimeUtil tu;
+    StringUtil str;
+    int yyyy, doy;
+    tu.time2yrdoy(tu.TimeNow(), &yyyy, &doy);
+
+    return root + "/obs/daily/.good_sites_igs" + str.yyyy2str(yyyy) + str.doy2str(doy);
+}
+
+/* one shard: its sites of 'all' are written to 'mine<idx>' */
+static int RunShard(const string &root, int idx)
+{
+    prcopt_t popt;
+    ftpopt_t fopt;
+    ShardOpt(root, idx, popt, fopt);
+    FtpUtilTest ftp;
+    ftp.Shard(idx, 2);
+    ftpopt_t jopt = fopt;
+    bool mine = ftp.ShardJob(&popt, GET_OBS, jopt);
+
+    string text;
+    for (const string &site : jopt.sites) text += site + "\n";
+    StringUtil str;
+    str.WriteFile(root + "/mine" + to_string(idx), mine ? text : "");
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 4 && string(argv[1]) == "shard") return RunShard(argv[2], atoi(argv[3]));
+
+    /* every job of three shards is downloaded by exactly one of them, the site names in any case */
+    PlanUtil plan[3];
+    std::vector<int> nMine(3, 0);
+    for (int k = 0; k < 3; k++) plan[k].Shard(k + 1, 3);
+    std::vector<std::pair<string, string> > cases = { { "abmf", "ABMF" }, { "hkws", "Hkws" } };
+    for (int doy = 101; doy <= 130; doy++)
+    {
+        for (const auto &site : cases)
+        {
+            int n = 0;
+            for (int k = 0; k < 3; k++)
+            {
+                bool mine = plan[k].IsMine("obs", "2024" + to_string(doy), site.first);
+                CHECK(mine == plan[k].IsMine("obs", "2024" + to_string(doy), site.second));
+                n += mine ? 1 : 0;
+                nMine[k] += mine ? 1 : 0;
+            }
+            CHECK(n == 1);
+        }
+    }
+    CHECK(nMine[0] > 0 && nMine[1] > 0 && nMine[2] > 0);
+
+    /* no sharding, or a shard out of range taken as the first one */
+    PlanUtil one;
+    one.Shard(1, 1);
+    CHECK(one.IsMine("obs", "2024101", "abmf") && one.IsMine("nav", "2024101", ""));
+    one.Shard(5, 3);
+    CHECK(one.IsMine("obs", "2024101", "abmf") == plan[0].IsMine("obs", "2024101", "abmf"));
+
+    char cwd[MAXSTRPATH] = { '\0' };
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) return 1;
+    string root = string(cwd) + "/test_shard.tmp";
+    string cmd = "rm -rf " + root + " && mkdir -p " + root + "/obs/daily";
+    std::system(cmd.c_str());
+
+    /* the listing the first shard finds */
+    std::vector<string> sites = { "abmf", "algo", "bake", "brux", "chpi", "dav1", "gold", "hkws", "kir0", "zimm" };
+    string text;
+    for (const string &site : sites) text += site + "\n";
+    StringUtil str;
+    CHECK(str.WriteFile(CacheFile(root), text));
+
+    cmd = string(argv[0]) + " shard " + root + " 1";
+    CHECK(std::system(cmd.c_str()) == 0);
+
+    /* the directory is listed again before the second shard starts: new sites are in, the cache has expired */
+    CHECK(str.WriteFile(CacheFile(root), text + "mas1\nnklg\n"));
+    struct utimbuf ut;
+    ut.actime = ut.modtime = time(nullptr) - 7200;
+    utime(CacheFile(root).c_str(), &ut);
+
+    cmd = string(argv[0]) + " shard " + root + " 2";
+    CHECK(std::system(cmd.c_str()) == 0);
+
+    /* the shards spread the same sites: every site once, none of the later listing */
+    std::vector<string> mine1, mine2;
+    str.ReadLines(root + "/mine1", mine1);
+    str.ReadLines(root + "/mine2", mine2);
+    CHECK(!mine1.empty() && !mine2.empty());
+    CHECK(mine1.size() + mine2.size() == sites.size());
+    std::vector<string> all = mine1;
+    all.insert(all.end(), mine2.begin(), mine2.end());
+    std::sort(all.begin(), all.end());
+    CHECK(all == sites);
+
+    /* the merge after the shards releases the listing of the run */
+    string shardFile = CacheFile(root) + "_of2";
+    CHECK(access(shardFile.c_str(), 0) == 0);
+    FtpUtilTest ftp;
+    std::unordered_set<string> merged;
+    ftp.MergeDir(root + "/obs", true, merged);
+    CHECK(access(shardFile.c_str(), 0) == -1);
+    CHECK(access(CacheFile(root).c_str(), 0) == 0);
+
+    if (chdir(cwd) == 0)
+    {
+        cmd = "rm -rf " + root;
+        std::system(cmd.c_str());
+    }
+
+    return TestResult("test_shard");
+}
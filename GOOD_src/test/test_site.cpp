@@ -0,0 +1,76 @@
+/*------------------------------------------------------------------------------
+* test_site.cpp : the site list is expanded by its names, patterns, networks, bounding boxes and exclusions
+*
+* usage : test_site
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "SiteUtil.h"
+#include "TestUtil.h"
+
+/* a site of the SITE/ID block of a SINEX file */
+static string SinexSite(const string &code, const string &lon, const string &lat)
+{
+    char buff[MAXCHARS];
+    snprintf(buff, sizeof(buff), " %4s  A %9s P %-22s %11s %11s %7.1f", code.c_str(), "00000M000", "TEST SITE",
+        lon.c_str(), lat.c_str(), 10.0);
+
+    return buff;
+}
+
+int main()
+{
+    const string dir = "test_site.tmp", snxFile = dir + "/igs.snx";
+    string cmd = "rm -rf " + dir + " && mkdir -p " + dir;
+    std::system(cmd.c_str());
+
+    /* one selector per line, the comments and the invalid lines are skipped */
+    SiteUtil sel;
+    std::vector<string> lines = { "ABMF", "alg*   # the Algonquin sites", "", "@IGS", "box 30 60 -10 40",
+        "box -50 -40 170 -170", "-brux", "- zimm", "abmf", "@foo", "box 1 2", "box 60 30 0 10", "ab cd", "# comment" };
+    CHECK(sel.Parse(lines) == 8);
+    CHECK(sel.HasBox());
+    std::vector<string> nets;
+    sel.Networks(nets);
+    CHECK(nets == std::vector<string>({ "igs" }));
+
+    /* the candidates: two networks, a position of the inventory and two sites of the station SINEX, one of them
+       east of the 180 degree meridian */
+    sel.AddNetwork("igs", { "ALGO", "abmf", "brux", "hkws", "zimm", "algo" });
+    sel.AddNetwork("mgex", { "alg2", "alic" });
+    const double wtzr[3] = { 4075580.3, 931853.9, 4801568.2 }, brux[3] = { 4027881.6, 306998.6, 4919499.0 };
+    const double none[3] = { 0.0, 0.0, 0.0 };
+    sel.AddPosition("WTZR", wtzr);
+    sel.AddPosition("BRUX", brux);
+    sel.AddPosition("nopo", none);
+    CHECK(sel.AddSinex(snxFile) == -1);
+    StringUtil str;
+    CHECK(str.WriteFile(snxFile, "%=SNX 2.02 IGS\n+SITE/ID\n*CODE PT __DOMES__ T _STATION DESCRIPTION__\n" +
+        SinexSite("MAS1", "344 22  3.5", " 27 45 49.6") + "\n" + SinexSite("CHAT", "183 26 12.1", "-43 57 20.8") +
+        "\n-SITE/ID\n" + SinexSite("KIR0", " 20 58 6.4", " 67 52 39.4") + "\n"));
+    CHECK(sel.AddSinex(snxFile) == 2);
+
+    /* in the order first selected, without duplicates and excluded sites, a name keeps its case */
+    std::vector<string> sites;
+    sel.Resolve(sites);
+    CHECK(sites == std::vector<string>({ "ABMF", "algo", "alg2", "hkws", "wtzr", "chat" }));
+
+    /* a list of names needs no listing, the patterns take the IGS and MGEX networks */
+    CHECK(sel.Parse({ "abmf", "Bake", "ABMF", "-bake" }) == 4);
+    sel.Networks(nets);
+    CHECK(nets.empty() && !sel.HasBox());
+    sel.Resolve(sites);
+    CHECK(sites == std::vector<string>({ "abmf" }));
+    CHECK(sel.Parse({ "hk*", "-hkw?" }) == 2);
+    sel.Networks(nets);
+    CHECK(nets == std::vector<string>({ "igs", "mgex" }));
+    sel.AddNetwork("igs", { "hkws", "hksl" });
+    sel.AddNetwork("mgex", { "hkwS", "hkoh" });
+    sel.Resolve(sites);
+    CHECK(sites == std::vector<string>({ "hksl", "hkoh" }));
+
+    cmd = "rm -rf " + dir;
+    std::system(cmd.c_str());
+
+    return TestResult("test_site");
+}
\ No newline at end of file
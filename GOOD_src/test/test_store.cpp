@@ -0,0 +1,130 @@
+/*------------------------------------------------------------------------------
+* test_store.cpp : the content-addressed store links the products into the download directories, its SHA-256 and
+*                  the FNV-1a of the names and shards match the reference values
+*
+* usage : test_store
+*-----------------------------------------------------------------------------*/
+#include "Good.h"
+#include "StringUtil.h"
+#include "StoreUtil.h"
+#include "TestUtil.h"
+
+/* the SHA-256 of a file holding 'text' */
+static string Sha256(const string &text)
+{
+    const string file = "test_store.hash";
+    StringUtil str;
+    string hash;
+    if (!str.WriteFile(file, text)) return "";
+    StoreUtil store;
+    if (!store.HashFile(file, hash)) hash = "";
+    remove(file.c_str());
+
+    return hash;
+}
+
+/* the inode of a file, 0 if it does not exist */
+static unsigned long long Inode(const string &file)
+{
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0) return 0;
+
+    return (unsigned long long)st.st_ino;
+}
+
+int main()
+{
+    /* FIPS 180-2 test vectors, the 56-byte one needs a second padding block */
+    CHECK(Sha256("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CHECK(Sha256("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK(Sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    /* one million 'a': the file is hashed over several reads */
+    CHECK(Sha256(string(1000000, 'a')) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+    /* a missing file has no hash */
+    StoreUtil store;
+    string hash;
+    CHECK(!store.HashFile("test_store.none", hash));
+
+    /* FNV-1a 32-bit reference values, the shards and the store scopes rely on them being stable */
+    StringUtil str;
+    CHECK(str.Fnv1a("", false) == 0x811c9dc5u);
+    CHECK(str.Fnv1a("a", false) == 0xe40c292cu);
+    CHECK(str.Fnv1a("foobar", false) == 0xbf9cf968u);
+    CHECK(str.Fnv1a("ABMF", true) == str.Fnv1a("abmf", false));
+    CHECK(str.Fnv1a("ABMF", false) != str.Fnv1a("abmf", false));
+
+    /* the store and two download directories, 'Put' and 'Link' work in the current directory */
+    char cwd[MAXSTRPATH] = { '\0' };
+    if (getcwd(cwd, MAXSTRPATH) == nullptr) return 1;
+    string tmpDir = string(cwd) + "/test_store.tmp", root = tmpDir + "/store";
+    string cmd = "rm -rf " + tmpDir + " && mkdir -p " + tmpDir + "/a " + tmpDir + "/b";
+    std::system(cmd.c_str());
+    CHECK(!store.Put("abmf0320.21o"));
+    CHECK(store.Open(root));
+    CHECK(store.Root() == root);
+    store.Scope("obs/../igs//1a2b3c4d");
+    CHECK(store.RefDir() == root + "/refs/obs/igs/1a2b3c4d");
+    CHECK(store.LockFile(".good_catalog") == root + "/locks/obs/igs/1a2b3c4d/.good_catalog.lock");
+    CHECK(access(store.RefDir().c_str(), 0) == 0);
+
+    /* a new product becomes the blob of its content, the local file is the blob */
+    const string text = "abmf0320.21o of 2021/02/01\n";
+    CHECK(chdir((tmpDir + "/a").c_str()) == 0);
+    CHECK(str.WriteFile("abmf0320.21o", text));
+    CHECK(!store.IsLinked("abmf0320.21o"));
+    CHECK(store.Put("abmf0320.21o"));
+    CHECK(store.IsLinked("abmf0320.21o"));
+    CHECK(store.HashFile("abmf0320.21o", hash));
+    string blob = root + "/objects/" + hash.substr(0, 2) + "/" + hash;
+    CHECK(ReadAll(blob) == text);
+    CHECK(ReadAll(store.RefDir() + "/abmf0320.21o") == hash + "\n");
+    CHECK(Inode("abmf0320.21o") == Inode(blob));
+
+    /* another download directory gets the product from the store, a removed local file is linked again */
+    CHECK(chdir((tmpDir + "/b").c_str()) == 0);
+    CHECK(!store.IsLinked("abmf0320.21o"));
+    CHECK(store.Link("abmf0320.21o"));
+    CHECK(ReadAll("abmf0320.21o") == text);
+    CHECK(store.IsLinked("abmf0320.21o"));
+    remove("abmf0320.21o");
+    CHECK(store.Link("abmf0320.21o"));
+    CHECK(ReadAll("abmf0320.21o") == text);
+
+    /* the same content under another name or in another scope shares the blob */
+    CHECK(str.WriteFile("abmf0320.21o.copy", text));
+    CHECK(store.Put("abmf0320.21o.copy"));
+    CHECK(Inode("abmf0320.21o.copy") == Inode(blob));
+    store.Scope("obs/mgex/1a2b3c4d");
+    CHECK(!store.Link("abmf0320.21o"));
+    CHECK(str.WriteFile("abmf0320.21o", text));
+    CHECK(store.Put("abmf0320.21o"));
+    CHECK(Inode("abmf0320.21o") == Inode(blob));
+
+    /* a changed product refers to its new content, the old blob is kept */
+    CHECK(str.WriteFile("abmf0320.21o", text + "changed\n"));
+    CHECK(!store.IsLinked("abmf0320.21o"));
+    CHECK(store.Put("abmf0320.21o"));
+    CHECK(Inode("abmf0320.21o") != Inode(blob));
+    CHECK(ReadAll(blob) == text);
+
+    /* a dropped name is not linked again, the blob stays for the other names */
+    store.Scope("obs/igs/1a2b3c4d");
+    CHECK(store.Drop("abmf0320.21o"));
+    CHECK(!store.Drop("abmf0320.21o"));
+    remove("abmf0320.21o");
+    CHECK(!store.Link("abmf0320.21o"));
+    CHECK(access("abmf0320.21o", 0) == -1);
+    CHECK(store.Link("abmf0320.21o.copy"));
+    CHECK(ReadAll("abmf0320.21o.copy") == text);
+
+    if (chdir(cwd) == 0)
+    {
+        cmd = "rm -rf " + tmpDir;
+        std::system(cmd.c_str());
+    }
+
+    return TestResult("test_store");
+}
\ No newline at end of file